@@ -43,12 +43,14 @@
 #include <rte_cycles.h>
 #include <rte_byteorder.h>
 #include <rte_memzone.h>
+#include <rte_io.h>
 #include <linux/pci.h>
 #include "qdma_user.h"
 #include "qdma_resource_mgmt.h"
 #include "qdma_mbox.h"
 #include "rte_pmd_qdma.h"
 #include "qdma_log.h"
+#include "qdma_access_fixed_ip.h"
 
 #define QDMA_NUM_BARS          (6)
 #define DEFAULT_PF_CONFIG_BAR  (0)
@@ -60,6 +62,54 @@
 #define DEFAULT_QUEUE_BASE	(0)
 
 #define QDMA_MAX_BURST_SIZE (128)
+
+/* Rx/Tx data path implementations, selected per queue at queue start */
+enum qdma_vec_path {
+	QDMA_VEC_PATH_SCALAR,
+	QDMA_VEC_PATH_SSE,
+	QDMA_VEC_PATH_AVX2,
+	QDMA_VEC_PATH_AVX512
+};
+
+struct qdma_rx_queue;
+struct qdma_tx_queue;
+
+/* Per queue burst functions, selected by qdma_set_rx/tx_burst() at queue
+ * setup, start and stop so that the burst path carries no mode checks.
+ * The queues are shared with secondary processes, where function addresses
+ * differ, so they record an index into a per-process table instead.
+ */
+typedef uint16_t (*qdma_rx_burst_t)(struct qdma_rx_queue *rxq,
+				struct rte_mbuf **rx_pkts, uint16_t nb_pkts);
+typedef uint16_t (*qdma_tx_burst_t)(struct qdma_tx_queue *txq,
+				struct rte_mbuf **tx_pkts, uint16_t nb_pkts);
+
+enum qdma_rx_burst_idx {
+	QDMA_RX_BURST_NONE,
+	QDMA_RX_BURST_ST_STOPPED,
+	QDMA_RX_BURST_ST,
+	QDMA_RX_BURST_ST_IMM,
+	QDMA_RX_BURST_MM,
+	QDMA_RX_BURST_TIMED,
+	QDMA_RX_BURST_MAX
+};
+
+enum qdma_tx_burst_idx {
+	QDMA_TX_BURST_NONE,
+	QDMA_TX_BURST_ST,
+	QDMA_TX_BURST_MM,
+#ifdef TEST_64B_DESC_BYPASS
+	QDMA_TX_BURST_64B_BYPASS,
+#endif
+	QDMA_TX_BURST_TIMED,
+	QDMA_TX_BURST_MAX
+};
+
+/* Device of a queue in the calling process. The rte_eth_dev pointer
+ * recorded at queue setup is only valid in the primary process.
+ */
+#define QDMA_QUEUE_DEV(q)	(&rte_eth_devices[(q)->port_id])
+
 #define QDMA_MIN_RXBUFF_SIZE	(256)
 
 /* Descriptor Rings aligned to 4KB boundaries - only supported value */
@@ -71,7 +121,20 @@
 #define MIN_RX_PIDX_UPDATE_THRESHOLD (1)
 #define MIN_TX_PIDX_UPDATE_THRESHOLD (1)
 #define DEFAULT_MM_CMPT_CNT_THRESHOLD	(2)
-#define QDMA_TXQ_PIDX_UPDATE_INTERVAL	(1000) //100 uSec
+/* Reclaim transmitted mbufs once fewer descriptors than this are free */
+#define DEFAULT_TX_FREE_THRESHOLD	(32)
+/* Max mbufs returned to a mempool with one bulk put */
+#define QDMA_TX_FREE_BULK		(64)
+/* With MIN_TX_PIDX_UPDATE_THRESHOLD > 1, pending H2C descriptors are
+ * flushed by the first Tx burst after this deadline
+ */
+#define QDMA_TXQ_PIDX_FLUSH_US		(100)
+
+/* Hardware error poll period, used only when the master PF can not take
+ * the error interrupt. Overridden with the err_poll_ms devarg, 0 disables
+ */
+#define DEFAULT_ERR_POLL_MS		(1000)
+#define MAX_ERR_POLL_MS			(60000)
 
 /** Delays **/
 #define MAILBOX_PF_MSG_DELAY		(20)
@@ -136,6 +199,31 @@ struct qdma_pkt_stats {
 	uint64_t bytes;
 };
 
+/* Per queue extended statistics, maintained by the burst functions */
+struct qdma_rx_xstats {
+	uint64_t mbuf_alloc_errors; /* mbufs that could not be allocated */
+	uint64_t empty_polls; /* bursts with no completion */
+	uint64_t cmpt_pending_max; /* max CMPT ring occupancy seen */
+	uint64_t cmpt_pending_total; /* CMPT occupancy summed over bursts */
+	uint64_t cmpt_errors; /* CMPT entries with error */
+	uint64_t pidx_updates; /* C2H PIDX doorbells */
+	uint64_t cmpt_cidx_updates; /* CMPT CIDX doorbells */
+	uint64_t cntr_th_increments; /* adaptive counter threshold raised */
+	uint64_t cntr_th_decrements; /* adaptive counter threshold lowered */
+	uint64_t timed_bursts; /* bursts sampled with burst_cycles=1 */
+	uint64_t burst_cycles; /* TSC cycles spent in sampled bursts */
+	uint64_t copied_pkts; /* short packets copied to the copy pool */
+	uint64_t copy_alloc_errors; /* copy pool mbufs not allocated */
+};
+
+struct qdma_tx_xstats {
+	uint64_t ring_full; /* bursts that found no free descriptor */
+	uint64_t pkts_rejected; /* packets left to the caller */
+	uint64_t pidx_updates; /* H2C PIDX doorbells */
+	uint64_t timed_bursts; /* bursts sampled with burst_cycles=1 */
+	uint64_t burst_cycles; /* TSC cycles spent in sampled bursts */
+};
+
 /*
  * Structure associated with each CMPT queue.
  */
@@ -162,11 +250,36 @@ struct qdma_cmpt_queue {
 	const struct rte_memzone *cmpt_mz;
 };
 
+/**
+ * State of a MM queue driven through the rte_pmd_qdma_dma_*() copy API.
+ * Ring indexes count descriptors and wrap at 64K, like rte_dmadev.
+ */
+struct qdma_dma_chan {
+	struct qdma_ul_mm_desc		*ring;
+	struct wb_status		*wb_status;
+	struct qdma_q_pidx_reg_info	*pidx_info;
+	uint16_t			port_id;
+	uint16_t			queue_id;
+	uint16_t			ring_sz; /* descriptors in the ring */
+	uint16_t			pidx; /* next descriptor to write */
+	uint16_t			cidx; /* completed up to here */
+	uint16_t			pending; /* written, PIDX not updated */
+	uint16_t			next_idx; /* ring index of next copy */
+	uint16_t			cpl_idx; /* ring index of oldest copy */
+	uint8_t				is_c2h:1;
+	uint8_t				vec:1;
+};
+
 /**
  * Structure associated with each RX queue.
  */
 struct qdma_rx_queue {
+	uint8_t			rx_burst; /**< enum qdma_rx_burst_idx */
 	struct rte_mempool	*mb_pool; /**< mbuf pool to populate RX ring. */
+	/** pool for packets of up to copy_len bytes, see
+	 * rte_pmd_qdma_set_rx_copy_pool()
+	 */
+	struct rte_mempool	*copy_pool;
 	void			*rx_ring; /**< RX ring virtual address */
 	union qdma_ul_st_cmpt_ring	*cmpt_ring;
 	struct wb_status	*wb_status;
@@ -176,6 +289,7 @@ struct qdma_rx_queue {
 	uint16_t		rx_tail;
 	uint16_t		cmpt_desc_len;
 	uint16_t		rx_buff_size;
+	uint16_t		copy_len;
 	uint16_t		nb_rx_desc; /**< number of RX descriptors. */
 	uint16_t		nb_rx_cmpt_desc;
 	uint32_t		queue_id; /**< RX queue index. */
@@ -184,6 +298,8 @@ struct qdma_rx_queue {
 	struct qdma_q_pidx_reg_info	q_pidx_info;
 	struct qdma_q_cmpt_cidx_reg_info cmpt_cidx_info;
 	struct qdma_pkt_stats	stats;
+	struct qdma_rx_xstats	xstats;
+	uint8_t			timed_rx_burst; /**< burst_cycles=1 only */
 
 	uint16_t		port_id; /**< Device port identifier. */
 	uint8_t			status:1;
@@ -195,6 +311,8 @@ struct qdma_rx_queue {
 	uint8_t			en_bypass:1;
 	uint8_t			en_bypass_prefetch:1;
 	uint8_t			dis_overflow_check:1;
+	uint8_t			en_intr:1; /**< Rx interrupt mode */
+	uint8_t			vec_path; /**< enum qdma_vec_path */
 
 	union qdma_ul_st_cmpt_ring cmpt_data[QDMA_MAX_BURST_SIZE];
 
@@ -213,6 +331,8 @@ struct qdma_rx_queue {
 	/* C2H stream mode, completion descriptor result */
 	const struct rte_memzone *rx_cmpt_mz;
 
+	struct qdma_dma_chan	dma_chan; /**< MM copy API state */
+
 #ifdef QDMA_LATENCY_OPTIMIZED
 	/**< pend_pkt_moving_avg: average rate of packets received */
 	unsigned int pend_pkt_moving_avg;
@@ -231,14 +351,17 @@ struct qdma_rx_queue {
  * Structure associated with each TX queue.
  */
 struct qdma_tx_queue {
+	uint8_t				tx_burst; /* enum qdma_tx_burst_idx */
 	void				*tx_ring; /* TX ring virtual address*/
 	struct wb_status		*wb_status;
 	struct rte_mbuf			**sw_ring;/* SW ring virtual address*/
 	struct rte_eth_dev		*dev;
 	uint16_t			tx_fl_tail;
 	uint16_t			tx_desc_pend;
+	uint16_t			tx_free_thresh;
 	uint16_t			nb_tx_desc; /* No of TX descriptors.*/
-	rte_spinlock_t			pidx_update_lock;
+	uint64_t			pidx_flush_tsc; /* PIDX flush deadline */
+	uint64_t			pidx_flush_cycles;
 	struct qdma_q_pidx_reg_info	q_pidx_info;
 	uint64_t			offloads; /* Tx offloads */
 
@@ -246,17 +369,22 @@ struct qdma_tx_queue {
 	uint8_t				tx_deferred_start:1;
 	uint8_t				en_bypass:1;
 	uint8_t				status:1;
+	uint8_t				vec_path; /* enum qdma_vec_path */
 	enum rte_pmd_qdma_bypass_desc_len		bypass_desc_sz:7;
 	uint16_t			port_id; /* Device port identifier. */
 	uint8_t				func_id; /* RX queue index. */
 	int8_t				ringszidx;
 
 	struct qdma_pkt_stats stats;
+	struct qdma_tx_xstats xstats;
+	uint8_t timed_tx_burst; /* burst_cycles=1 only */
 
 	uint64_t			ep_addr;
 	uint32_t			queue_id; /* TX queue index. */
 	uint32_t			num_queues; /* TX queue index. */
 	const struct rte_memzone	*tx_mz;
+
+	struct qdma_dma_chan		dma_chan; /* MM copy API state */
 };
 
 struct qdma_vf_info {
@@ -275,6 +403,8 @@ struct queue_info {
 	enum rte_pmd_qdma_bypass_desc_len tx_bypass_desc_sz:7;
 	uint8_t		timer_count;
 	int8_t		trigger_mode;
+	struct rte_mempool *rx_copy_pool;
+	uint16_t	rx_copy_len;
 };
 
 struct qdma_pci_dev {
@@ -309,6 +439,13 @@ struct qdma_pci_dev {
 	uint8_t is_vf:1;
 	uint8_t is_master:1;
 	uint8_t en_desc_prefetch:1;
+	uint8_t burst_cycles:1; /* sample burst cycles for xstats */
+	uint8_t err_intr_en:1; /* errors reported on the misc vector */
+	uint32_t err_poll_ms;
+
+	/* Duration of the last dev_start, reported through xstats */
+	uint64_t start_us;
+	uint64_t start_ctxt_us; /* programming the queue contexts */
 
 	/* Reset state */
 	uint8_t reset_in_progress;
@@ -342,10 +479,27 @@ struct qdma_pci_dev {
 	int16_t rx_qid_statid_map[RTE_ETHDEV_QUEUE_STAT_CNTRS];
 };
 
+/**
+ * Per-process data of a port, in dev->process_private. The access layer
+ * function table and the BAR mapping in qdma_pci_dev belong to the
+ * primary process, the datapath of each process uses its own copy.
+ */
+struct qdma_proc_private {
+	struct qdma_hw_access hw_access;
+	void *db_base; /* config BAR, holding the queue doorbells */
+};
+
+static inline uint64_t qdma_timer_cycles_to_us(uint64_t cycles)
+{
+	return cycles * US_PER_S / rte_get_timer_hz();
+}
+
 void qdma_dev_ops_init(struct rte_eth_dev *dev);
+int qdma_proc_private_init(struct rte_eth_dev *dev);
+void qdma_proc_private_uninit(struct rte_eth_dev *dev);
 uint32_t qdma_read_reg(uint64_t reg_addr);
 void qdma_write_reg(uint64_t reg_addr, uint32_t val);
-void qdma_txq_pidx_update(void *arg);
+void qdma_txq_pidx_flush(struct qdma_tx_queue *txq);
 int qdma_pf_csr_read(struct rte_eth_dev *dev);
 int qdma_vf_csr_read(struct rte_eth_dev *dev);
 
@@ -367,24 +521,52 @@ void qdma_clr_tx_queue_ctxts(struct rte_eth_dev *dev, uint32_t qid,
 				uint32_t mode);
 void qdma_inv_tx_queue_ctxts(struct rte_eth_dev *dev, uint32_t qid,
 				uint32_t mode);
+int qdma_rx_intr_setup(struct rte_eth_dev *dev);
+void qdma_rx_intr_teardown(struct rte_eth_dev *dev);
+uint16_t qdma_rx_intr_vec(struct rte_eth_dev *dev,
+		struct qdma_rx_queue *rxq, uint16_t qid);
 int qdma_identify_bars(struct rte_eth_dev *dev);
 int qdma_get_hw_version(struct rte_eth_dev *dev);
 
 /* implemented in rxtx.c */
 uint16_t qdma_recv_pkts_st(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 				uint16_t nb_pkts);
+uint16_t qdma_recv_pkts_st_imm(struct qdma_rx_queue *rxq,
+				struct rte_mbuf **rx_pkts, uint16_t nb_pkts);
 uint16_t qdma_recv_pkts_mm(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 				uint16_t nb_pkts);
 uint16_t qdma_xmit_pkts_st(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 				uint16_t nb_pkts);
 uint16_t qdma_xmit_pkts_mm(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 				uint16_t nb_pkts);
+void qdma_set_rx_burst(struct qdma_rx_queue *rxq);
+void qdma_set_tx_burst(struct qdma_tx_queue *txq);
+uint8_t qdma_get_vec_path(void);
+struct rte_mbuf *qdma_prepare_segmented_packet(struct qdma_rx_queue *rxq,
+				uint16_t pkt_length, uint16_t *tail);
+
+/* implemented in rxtx_vec_avx2.c and rxtx_vec_avx512.c */
+uint16_t qdma_prepare_packets_avx2(struct qdma_rx_queue *rxq,
+				struct rte_mbuf **rx_pkts, uint16_t nb_pkts);
+void qdma_rearm_c2h_desc_avx2(struct qdma_rx_queue *rxq, uint16_t id,
+				uint16_t num_desc);
+uint16_t qdma_xmit_st_desc_avx2(struct qdma_tx_queue *txq,
+				struct rte_mbuf **tx_pkts, uint16_t nb_pkts,
+				int avail, uint64_t *pkt_len);
+uint16_t qdma_prepare_packets_avx512(struct qdma_rx_queue *rxq,
+				struct rte_mbuf **rx_pkts, uint16_t nb_pkts);
+void qdma_rearm_c2h_desc_avx512(struct qdma_rx_queue *rxq, uint16_t id,
+				uint16_t num_desc);
+uint16_t qdma_xmit_st_desc_avx512(struct qdma_tx_queue *txq,
+				struct rte_mbuf **tx_pkts, uint16_t nb_pkts,
+				int avail, uint64_t *pkt_len);
 
 uint32_t qdma_pci_read_reg(struct rte_eth_dev *dev, uint32_t bar, uint32_t reg);
 void qdma_pci_write_reg(struct rte_eth_dev *dev, uint32_t bar,
 				uint32_t reg, uint32_t val);
 
 int index_of_array(uint32_t *arr, uint32_t n, uint32_t element);
+int qdma_c2h_buf_sz_fit(uint32_t *arr, uint32_t n, uint32_t limit);
 
 int qdma_check_kvargs(struct rte_devargs *devargs,
 			struct qdma_pci_dev *qdma_dev);
@@ -404,9 +586,50 @@ struct rte_memzone *qdma_zone_reserve(struct rte_eth_dev *dev,
 						socket_id, 0, QDMA_ALIGN);
 }
 
+/*
+ * Datapath queue doorbells. Builds for a single IP variant (see
+ * qdma_access_fixed_ip.h) write the register directly, others go through
+ * the qdma_hw_access function table of the calling process.
+ */
+static inline void qdma_queue_pidx_db(struct rte_eth_dev *dev,
+		uint16_t qid, uint8_t is_c2h,
+		const struct qdma_q_pidx_reg_info *reg_info)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_proc_private *proc = dev->process_private;
+#ifdef QDMA_FIXED_IP
+	uint32_t val;
+	uint32_t reg = qdma_fixed_ip_pidx_reg(qdma_dev->is_vf, qid, is_c2h,
+			reg_info, &val);
+
+	rte_write32_relaxed(val, (uint8_t *)proc->db_base + reg);
+#else
+	proc->hw_access.qdma_queue_pidx_update(dev, qdma_dev->is_vf,
+			qid, is_c2h, reg_info);
+#endif
+}
+
+static inline void qdma_queue_cmpt_cidx_db(struct rte_eth_dev *dev,
+		uint16_t qid, const struct qdma_q_cmpt_cidx_reg_info *reg_info)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_proc_private *proc = dev->process_private;
+#ifdef QDMA_FIXED_IP
+	uint32_t val;
+	uint32_t reg = qdma_fixed_ip_cmpt_cidx_reg(qdma_dev->is_vf, qid,
+			reg_info, &val);
+
+	rte_write32_relaxed(val, (uint8_t *)proc->db_base + reg);
+#else
+	proc->hw_access.qdma_queue_cmpt_cidx_update(dev,
+			qdma_dev->is_vf, qid, reg_info);
+#endif
+}
+
 bool is_qdma_supported(struct rte_eth_dev *dev);
 bool is_vf_device_supported(struct rte_eth_dev *dev);
 bool is_pf_device_supported(struct rte_eth_dev *dev);
 
-void qdma_check_errors(void *arg);
+void qdma_error_monitor_start(struct rte_eth_dev *dev);
+void qdma_error_monitor_stop(struct rte_eth_dev *dev);
 #endif /* ifndef __QDMA_H__ */
@@ -1749,7 +1749,11 @@ static int eqdma_indirect_reg_invalidate(void *dev_hndl,
 {
 	union qdma_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -1759,10 +1763,7 @@ static int eqdma_indirect_reg_invalidate(void *dev_hndl,
 	qdma_reg_write(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -1787,7 +1788,11 @@ static int eqdma_indirect_reg_clear(void *dev_hndl,
 {
 	union qdma_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -1797,10 +1802,7 @@ static int eqdma_indirect_reg_clear(void *dev_hndl,
 	qdma_reg_write(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -1826,7 +1828,11 @@ static int eqdma_indirect_reg_read(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	uint32_t index = 0, reg_addr = EQDMA_IND_CTXT_DATA_ADDR;
 	union qdma_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -1837,10 +1843,7 @@ static int eqdma_indirect_reg_read(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	qdma_reg_write(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR, 1)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -1869,8 +1872,13 @@ static int eqdma_indirect_reg_write(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	uint32_t index, reg_addr;
 	struct qdma_indirect_ctxt_regs regs;
 	uint32_t *wr_data = (uint32_t *)&regs;
+	int mask_needed;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* write the context data */
 	for (index = 0; index < QDMA_IND_CTXT_DATA_NUM_REGS; index++) {
@@ -1887,15 +1895,18 @@ static int eqdma_indirect_reg_write(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	regs.cmd.bits.sel = sel;
 	reg_addr = EQDMA_IND_CTXT_DATA_ADDR;
 
+	mask_needed = qdma_ind_ctxt_mask_needed(dev_hndl);
 	for (index = 0; index < ((2 * QDMA_IND_CTXT_DATA_NUM_REGS) + 1);
-		 index++, reg_addr += sizeof(uint32_t))
+		 index++, reg_addr += sizeof(uint32_t)) {
+		/* the mask registers keep all ones within a context batch */
+		if (!mask_needed && (index >= QDMA_IND_CTXT_DATA_NUM_REGS) &&
+				(index < (2 * QDMA_IND_CTXT_DATA_NUM_REGS)))
+			continue;
 		qdma_reg_write(dev_hndl, reg_addr, wr_data[index]);
+	}
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, EQDMA_IND_CTXT_CMD_ADDR, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -2987,39 +2998,16 @@ static int eqdma_sw_context_write(void *dev_hndl, uint8_t c2h,
 			sw_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * eqdma_sw_context_read() - read sw context
- *
- * @dev_hndl:	device handle
- * @c2h:	is c2h queue
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the output context data
+/*
+ * eqdma_sw_context_decode() - Helper function to decode sw context
+ *                            words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int eqdma_sw_context_read(void *dev_hndl, uint8_t c2h,
-			 uint16_t hw_qid,
-			 struct qdma_descq_sw_ctxt *ctxt)
+ */
+static void eqdma_sw_context_decode(const uint32_t *sw_ctxt,
+		struct qdma_descq_sw_ctxt *ctxt)
 {
-	int rv = QDMA_SUCCESS;
-	uint32_t sw_ctxt[EQDMA_SW_CONTEXT_NUM_WORDS] = {0};
 	uint32_t pasid_l, pasid_h;
 	uint32_t virtio_desc_base_l, virtio_desc_base_m, virtio_desc_base_h;
-	enum ind_ctxt_cmd_sel sel = c2h ?
-			QDMA_CTXT_SEL_SW_C2H : QDMA_CTXT_SEL_SW_H2C;
-
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_handle=%p sw_ctxt=%p NULL, err:%d\n",
-					   __func__, dev_hndl, ctxt,
-					   -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = eqdma_indirect_reg_read(dev_hndl, sel, hw_qid,
-			EQDMA_SW_CONTEXT_NUM_WORDS, sw_ctxt);
-	if (rv < 0)
-		return rv;
 
 	ctxt->pidx = FIELD_GET(SW_IND_CTXT_DATA_W0_PIDX_MASK, sw_ctxt[0]);
 	ctxt->irq_arm =
@@ -3146,6 +3134,41 @@ static int eqdma_sw_context_read(void *dev_hndl, uint8_t c2h,
 
 	qdma_log_debug("%s: vec=%x, intr_aggr=%x\n",
 			__func__, ctxt->vec, ctxt->intr_aggr);
+}
+
+/*****************************************************************************/
+/**
+ * eqdma_sw_context_read() - read sw context
+ *
+ * @dev_hndl:	device handle
+ * @c2h:	is c2h queue
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the output context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int eqdma_sw_context_read(void *dev_hndl, uint8_t c2h,
+			 uint16_t hw_qid,
+			 struct qdma_descq_sw_ctxt *ctxt)
+{
+	int rv = QDMA_SUCCESS;
+	uint32_t sw_ctxt[EQDMA_SW_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = c2h ?
+			QDMA_CTXT_SEL_SW_C2H : QDMA_CTXT_SEL_SW_H2C;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_handle=%p sw_ctxt=%p NULL, err:%d\n",
+					   __func__, dev_hndl, ctxt,
+					   -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = eqdma_indirect_reg_read(dev_hndl, sel, hw_qid,
+			EQDMA_SW_CONTEXT_NUM_WORDS, sw_ctxt);
+	if (rv < 0)
+		return rv;
+
+	eqdma_sw_context_decode(sw_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3271,8 +3294,8 @@ static int eqdma_pfetch_context_write(void *dev_hndl, uint16_t hw_qid,
 	sw_crdt_h =
 		FIELD_GET(QDMA_PFTCH_CTXT_SW_CRDT_GET_H_MASK, ctxt->sw_crdt);
 
-	qdma_log_debug("%s: sw_crdt_l=%u, sw_crdt_h=%u, hw_qid=%hu\n",
-			 __func__, sw_crdt_l, sw_crdt_h, hw_qid);
+	qdma_log_debug("%s: sw_crdt_l=%u, sw_crdt_h=%u\n",
+			 __func__, sw_crdt_l, sw_crdt_h);
 
 	pfetch_ctxt[num_words_count++] =
 		FIELD_SET(PREFETCH_CTXT_DATA_W0_BYPASS_MASK, ctxt->bypass) |
@@ -3302,35 +3325,16 @@ static int eqdma_pfetch_context_write(void *dev_hndl, uint16_t hw_qid,
 			pfetch_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * eqdma_pfetch_context_read() - read prefetch context
- *
- * @dev_hndl:	device handle
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the output context data
+/*
+ * eqdma_pfetch_context_decode() - Helper function to decode prefetch context
+ *                                words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int eqdma_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
+ */
+static void eqdma_pfetch_context_decode(const uint32_t *pfetch_ctxt,
 		struct qdma_descq_prefetch_ctxt *ctxt)
 {
-	int rv = QDMA_SUCCESS;
-	uint32_t pfetch_ctxt[EQDMA_PFETCH_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_PFTCH;
 	uint32_t sw_crdt_l, sw_crdt_h;
 
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_handle or pfetch ctxt NULL, err:%d\n",
-					   __func__, -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = eqdma_indirect_reg_read(dev_hndl, sel, hw_qid,
-			EQDMA_PFETCH_CONTEXT_NUM_WORDS, pfetch_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->bypass =
 		FIELD_GET(PREFETCH_CTXT_DATA_W0_BYPASS_MASK, pfetch_ctxt[0]);
 	ctxt->bufsz_idx =
@@ -3365,13 +3369,44 @@ static int eqdma_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
 		FIELD_SET(QDMA_PFTCH_CTXT_SW_CRDT_GET_L_MASK, sw_crdt_l) |
 		FIELD_SET(QDMA_PFTCH_CTXT_SW_CRDT_GET_H_MASK, sw_crdt_h);
 
-	qdma_log_debug("%s: sw_crdt_l=%u, sw_crdt_h=%u, hw_qid=%hu\n",
-			 __func__, sw_crdt_l, sw_crdt_h, hw_qid);
+	qdma_log_debug("%s: sw_crdt_l=%u, sw_crdt_h=%u\n",
+			 __func__, sw_crdt_l, sw_crdt_h);
 	qdma_log_debug("%s: bypass=%x, bufsz_idx=%x, port_id=%x\n",
 			__func__, ctxt->bypass, ctxt->bufsz_idx, ctxt->port_id);
 	qdma_log_debug("%s: err=%x, pfch_en=%x, pfch=%x, ctxt->valid=%x\n",
 			__func__, ctxt->err, ctxt->pfch_en, ctxt->pfch,
 			ctxt->valid);
+}
+
+/*****************************************************************************/
+/**
+ * eqdma_pfetch_context_read() - read prefetch context
+ *
+ * @dev_hndl:	device handle
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the output context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int eqdma_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
+		struct qdma_descq_prefetch_ctxt *ctxt)
+{
+	int rv = QDMA_SUCCESS;
+	uint32_t pfetch_ctxt[EQDMA_PFETCH_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_PFTCH;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_handle or pfetch ctxt NULL, err:%d\n",
+					   __func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = eqdma_indirect_reg_read(dev_hndl, sel, hw_qid,
+			EQDMA_PFETCH_CONTEXT_NUM_WORDS, pfetch_ctxt);
+	if (rv < 0)
+		return rv;
+
+	eqdma_pfetch_context_decode(pfetch_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3570,36 +3605,17 @@ static int eqdma_cmpt_context_write(void *dev_hndl, uint16_t hw_qid,
 			cmpt_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * eqdma_cmpt_context_read() - read completion context
- *
- * @dev_hndl:	device handle
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the context data
+/*
+ * eqdma_cmpt_context_decode() - Helper function to decode completion context
+ *                              words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int eqdma_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
-			   struct qdma_descq_cmpt_ctxt *ctxt)
+ */
+static void eqdma_cmpt_context_decode(const uint32_t *cmpt_ctxt,
+		struct qdma_descq_cmpt_ctxt *ctxt)
 {
-	int rv = QDMA_SUCCESS;
-	uint32_t cmpt_ctxt[EQDMA_CMPT_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_CMPT;
 	uint32_t baddr4_high_l, baddr4_high_h, baddr4_low,
 			pidx_l, pidx_h, pasid_l, pasid_h;
 
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_handle or cmpt ctxt NULL, err:%d\n",
-					   __func__, -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = eqdma_indirect_reg_read(dev_hndl, sel, hw_qid,
-			EQDMA_CMPT_CONTEXT_NUM_WORDS, cmpt_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->en_stat_desc =
 		FIELD_GET(CMPL_CTXT_DATA_W0_EN_STAT_DESC_MASK, cmpt_ctxt[0]);
 	ctxt->en_int = FIELD_GET(CMPL_CTXT_DATA_W0_EN_INT_MASK, cmpt_ctxt[0]);
@@ -3696,6 +3712,37 @@ static int eqdma_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
 	ctxt->pidx =
 		FIELD_SET(QDMA_COMPL_CTXT_PIDX_GET_L_MASK, pidx_l) |
 		FIELD_SET(QDMA_COMPL_CTXT_PIDX_GET_H_MASK, pidx_h);
+}
+
+/*****************************************************************************/
+/**
+ * eqdma_cmpt_context_read() - read completion context
+ *
+ * @dev_hndl:	device handle
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int eqdma_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
+			   struct qdma_descq_cmpt_ctxt *ctxt)
+{
+	int rv = QDMA_SUCCESS;
+	uint32_t cmpt_ctxt[EQDMA_CMPT_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_CMPT;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_handle or cmpt ctxt NULL, err:%d\n",
+					   __func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = eqdma_indirect_reg_read(dev_hndl, sel, hw_qid,
+			EQDMA_CMPT_CONTEXT_NUM_WORDS, cmpt_ctxt);
+	if (rv < 0)
+		return rv;
+
+	eqdma_cmpt_context_decode(cmpt_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3786,6 +3833,38 @@ int eqdma_cmpt_ctx_conf(void *dev_hndl, uint16_t hw_qid,
 	return rv;
 }
 
+/*
+ * eqdma_hw_context_decode() - Helper function to decode hw context
+ *                            words into structure
+ *
+ */
+static void eqdma_hw_context_decode(const uint32_t *hw_ctxt,
+		struct qdma_descq_hw_ctxt *ctxt)
+{
+	ctxt->cidx = FIELD_GET(HW_IND_CTXT_DATA_W0_CIDX_MASK, hw_ctxt[0]);
+	ctxt->crd_use =
+		(uint16_t)(FIELD_GET(HW_IND_CTXT_DATA_W0_CRD_USE_MASK,
+					hw_ctxt[0]));
+
+	ctxt->dsc_pend =
+		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_DSC_PND_MASK,
+					hw_ctxt[1]));
+	ctxt->idl_stp_b =
+		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_IDL_STP_B_MASK,
+			hw_ctxt[1]));
+	ctxt->evt_pnd =
+		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_EVT_PND_MASK,
+			hw_ctxt[1]));
+	ctxt->fetch_pnd = (uint8_t)
+		(FIELD_GET(HW_IND_CTXT_DATA_W1_DSC_PND_MASK, hw_ctxt[1]));
+
+	qdma_log_debug("%s: cidx=%hu, crd_use=%hu, dsc_pend=%x\n",
+			__func__, ctxt->cidx, ctxt->crd_use, ctxt->dsc_pend);
+	qdma_log_debug("%s: idl_stp_b=%x, evt_pnd=%x, fetch_pnd=%x\n",
+			__func__, ctxt->idl_stp_b, ctxt->evt_pnd,
+			ctxt->fetch_pnd);
+}
+
 /*****************************************************************************/
 /**
  * eqdma_hw_context_read() - read hardware context
@@ -3816,28 +3895,7 @@ static int eqdma_hw_context_read(void *dev_hndl, uint8_t c2h,
 	if (rv < 0)
 		return rv;
 
-	ctxt->cidx = FIELD_GET(HW_IND_CTXT_DATA_W0_CIDX_MASK, hw_ctxt[0]);
-	ctxt->crd_use =
-		(uint16_t)(FIELD_GET(HW_IND_CTXT_DATA_W0_CRD_USE_MASK,
-					hw_ctxt[0]));
-
-	ctxt->dsc_pend =
-		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_DSC_PND_MASK,
-					hw_ctxt[1]));
-	ctxt->idl_stp_b =
-		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_IDL_STP_B_MASK,
-			hw_ctxt[1]));
-	ctxt->evt_pnd =
-		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_EVT_PND_MASK,
-			hw_ctxt[1]));
-	ctxt->fetch_pnd = (uint8_t)
-		(FIELD_GET(HW_IND_CTXT_DATA_W1_DSC_PND_MASK, hw_ctxt[1]));
-
-	qdma_log_debug("%s: cidx=%hu, crd_use=%hu, dsc_pend=%x\n",
-			__func__, ctxt->cidx, ctxt->crd_use, ctxt->dsc_pend);
-	qdma_log_debug("%s: idl_stp_b=%x, evt_pnd=%x, fetch_pnd=%x\n",
-			__func__, ctxt->idl_stp_b, ctxt->evt_pnd,
-			ctxt->fetch_pnd);
+	eqdma_hw_context_decode(hw_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3944,6 +4002,19 @@ int eqdma_hw_ctx_conf(void *dev_hndl, uint8_t c2h, uint16_t hw_qid,
 	return rv;
 }
 
+/*
+ * eqdma_credit_context_decode() - Helper function to decode credit context
+ *                                words into structure
+ *
+ */
+static void eqdma_credit_context_decode(const uint32_t *cr_ctxt,
+		struct qdma_descq_credit_ctxt *ctxt)
+{
+	ctxt->credit = FIELD_GET(CRED_CTXT_DATA_W0_CREDT_MASK, cr_ctxt[0]);
+
+	qdma_log_debug("%s: credit=%u\n", __func__, ctxt->credit);
+}
+
 /*****************************************************************************/
 /**
  * eqdma_credit_context_read() - read credit context
@@ -3976,9 +4047,7 @@ static int eqdma_credit_context_read(void *dev_hndl, uint8_t c2h,
 	if (rv < 0)
 		return rv;
 
-	ctxt->credit = FIELD_GET(CRED_CTXT_DATA_W0_CREDT_MASK, cr_ctxt[0]);
-
-	qdma_log_debug("%s: credit=%u\n", __func__, ctxt->credit);
+	eqdma_credit_context_decode(cr_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -4109,8 +4178,8 @@ static int eqdma_fmap_context_write(void *dev_hndl, uint16_t func_id,
 		return -QDMA_ERR_INV_PARAM;
 	}
 
-	qdma_log_debug("%s: func_id=%hu, qbase=%hu, qmax=%hu\n", __func__,
-				   func_id, config->qbase, config->qmax);
+	qdma_log_debug("%s: qbase=%hu, qmax=%hu\n", __func__,
+				   config->qbase, config->qmax);
 	fmap[num_words_count++] =
 		FIELD_SET(EQDMA_FMAP_CTXT_W0_QID_MASK, config->qbase);
 	fmap[num_words_count++] =
@@ -4120,6 +4189,21 @@ static int eqdma_fmap_context_write(void *dev_hndl, uint16_t func_id,
 			fmap, num_words_count);
 }
 
+/*
+ * eqdma_fmap_context_decode() - Helper function to decode fmap context
+ *                              words into structure
+ *
+ */
+static void eqdma_fmap_context_decode(const uint32_t *fmap,
+		struct qdma_fmap_cfg *config)
+{
+	config->qbase = FIELD_GET(EQDMA_FMAP_CTXT_W0_QID_MASK, fmap[0]);
+	config->qmax = FIELD_GET(EQDMA_FMAP_CTXT_W1_QID_MAX_MASK, fmap[1]);
+
+	qdma_log_debug("%s: qbase=%hu, qmax=%hu\n", __func__,
+				   config->qbase, config->qmax);
+}
+
 /*****************************************************************************/
 /**
  * eqdma_fmap_context_read() - read fmap context
@@ -4149,11 +4233,7 @@ static int eqdma_fmap_context_read(void *dev_hndl, uint16_t func_id,
 	if (rv < 0)
 		return rv;
 
-	config->qbase = FIELD_GET(EQDMA_FMAP_CTXT_W0_QID_MASK, fmap[0]);
-	config->qmax = FIELD_GET(EQDMA_FMAP_CTXT_W1_QID_MAX_MASK, fmap[1]);
-
-	qdma_log_debug("%s: func_id=%hu, qbase=%hu, qmax=%hu\n", __func__,
-				   func_id, config->qbase, config->qmax);
+	eqdma_fmap_context_decode(fmap, config);
 
 	return QDMA_SUCCESS;
 }
@@ -4790,6 +4870,131 @@ int eqdma_read_dump_queue_context(void *dev_hndl,
 	return rv;
 }
 
+/*****************************************************************************/
+/**
+ * eqdma_read_queue_context_raw() - Function to read the contexts of a queue
+ * into a raw snapshot, without decoding them
+ *
+ * @dev_hndl:   device handle
+ * @func_id:	function id for the fmap context
+ * @qid_hw:     queue id
+ * @st:		Queue Mode(ST or MM)
+ * @q_type:	Queue type(H2C/C2H/CMPT)
+ * @raw:	snapshot to be filled
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int eqdma_read_queue_context_raw(void *dev_hndl,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw)
+{
+	/* words per enum qdma_ctxt_raw_type */
+	static const uint32_t num_words[QDMA_CTXT_RAW_MAX] = {
+		EQDMA_SW_CONTEXT_NUM_WORDS,
+		EQDMA_HW_CONTEXT_NUM_WORDS,
+		EQDMA_CR_CONTEXT_NUM_WORDS,
+		EQDMA_PFETCH_CONTEXT_NUM_WORDS,
+		EQDMA_CMPT_CONTEXT_NUM_WORDS,
+		EQDMA_FMAP_NUM_WORDS,
+		0
+	};
+
+	return qdma_read_queue_context_raw(dev_hndl, eqdma_indirect_reg_read,
+			num_words, func_id, qid_hw, st, q_type, raw);
+}
+
+/*****************************************************************************/
+/**
+ * eqdma_decode_queue_context_raw() - Function to decode a queue context
+ * snapshot taken by eqdma_read_queue_context_raw()
+ *
+ * @raw:	queue context snapshot
+ * @ctxt:	decoded context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int eqdma_decode_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt)
+{
+	if (!raw || !ctxt) {
+		qdma_log_error("%s: raw or ctxt is NULL, err:%d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	qdma_memset(ctxt, 0, sizeof(struct qdma_descq_context));
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_SW))
+		eqdma_sw_context_decode(raw->data[QDMA_CTXT_RAW_SW],
+				&ctxt->sw_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_HW))
+		eqdma_hw_context_decode(raw->data[QDMA_CTXT_RAW_HW],
+				&ctxt->hw_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_CR))
+		eqdma_credit_context_decode(raw->data[QDMA_CTXT_RAW_CR],
+				&ctxt->cr_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_PFETCH))
+		eqdma_pfetch_context_decode(raw->data[QDMA_CTXT_RAW_PFETCH],
+				&ctxt->pfetch_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_CMPT))
+		eqdma_cmpt_context_decode(raw->data[QDMA_CTXT_RAW_CMPT],
+				&ctxt->cmpt_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_FMAP))
+		eqdma_fmap_context_decode(raw->data[QDMA_CTXT_RAW_FMAP],
+				&ctxt->fmap);
+
+	return QDMA_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * eqdma_dump_queue_context_raw() - Function to decode a queue context
+ * snapshot into a buffer
+ *
+ * @raw:	queue context snapshot
+ * @buf :       pointer to buffer to be filled
+ * @buflen :    Length of the buffer
+ *
+ * Return:	Length up-till the buffer is filled -success and < 0 - failure
+ *****************************************************************************/
+int eqdma_dump_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen)
+{
+	struct qdma_descq_context context;
+	uint32_t req_buflen = 0;
+	int rv;
+
+	if (!raw || !buf) {
+		qdma_log_error("%s: raw or buf is NULL, err:%d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	if (raw->q_type >= QDMA_DEV_Q_TYPE_MAX) {
+		qdma_log_error("%s: Not supported for q_type, err = %d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = eqdma_context_buf_len(raw->st,
+			(enum qdma_dev_q_type)raw->q_type, &req_buflen);
+	if (rv != QDMA_SUCCESS)
+		return rv;
+
+	if (buflen < req_buflen) {
+		qdma_log_error("%s: Too small buffer(%d), reqd(%d), err:%d\n",
+			__func__, buflen, req_buflen, -QDMA_ERR_NO_MEM);
+		return -QDMA_ERR_NO_MEM;
+	}
+
+	eqdma_decode_queue_context_raw(raw, &context);
+
+	return dump_eqdma_context(&context, raw->st,
+			(enum qdma_dev_q_type)raw->q_type, buf, buflen);
+}
+
 /*****************************************************************************/
 /**
  * eqdma_get_user_bar() - Function to get the AXI Master Lite(user bar) number
@@ -5445,6 +5650,7 @@ int eqdma_init_ctxt_memory(void *dev_hndl)
 	uint32_t data[QDMA_REG_IND_CTXT_REG_COUNT];
 	uint16_t i = 0;
 	struct qdma_dev_attributes dev_info;
+	int rv;
 
 	if (!dev_hndl) {
 		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
@@ -5455,9 +5661,13 @@ int eqdma_init_ctxt_memory(void *dev_hndl)
 	qdma_memset(data, 0, sizeof(uint32_t) * QDMA_REG_IND_CTXT_REG_COUNT);
 	eqdma_get_device_attributes(dev_hndl, &dev_info);
 
+	/* queue up the clear commands instead of waiting for each one */
+	rv = qdma_ctxt_batch_start(dev_hndl);
+	if (rv < 0)
+		return rv;
+
 	for (; i < dev_info.num_qs; i++) {
 		int sel = QDMA_CTXT_SEL_SW_C2H;
-		int rv;
 
 		for (; sel <= QDMA_CTXT_SEL_PFTCH; sel++) {
 			/** if the st mode(h2c/c2h) not enabled
@@ -5475,8 +5685,10 @@ int eqdma_init_ctxt_memory(void *dev_hndl)
 
 			rv = eqdma_indirect_reg_clear(dev_hndl,
 					(enum ind_ctxt_cmd_sel)sel, i);
-			if (rv < 0)
+			if (rv < 0) {
+				qdma_ctxt_batch_end(dev_hndl);
 				return rv;
+			}
 		}
 	}
 
@@ -5485,6 +5697,9 @@ int eqdma_init_ctxt_memory(void *dev_hndl)
 		eqdma_indirect_reg_clear(dev_hndl,
 				QDMA_CTXT_SEL_FMAP, i);
 
+	rv = qdma_ctxt_batch_end(dev_hndl);
+	if (rv < 0)
+		return rv;
 #else
 	if (!dev_hndl) {
 		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
@@ -2053,7 +2053,11 @@ static int qdma_cpm4_indirect_reg_invalidate(void *dev_hndl,
 {
 	union qdma_cpm4_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -2063,10 +2067,7 @@ static int qdma_cpm4_indirect_reg_invalidate(void *dev_hndl,
 	qdma_reg_write(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed, err:%d\n",
 					__func__,
@@ -2091,7 +2092,11 @@ static int qdma_cpm4_indirect_reg_clear(void *dev_hndl,
 {
 	union qdma_cpm4_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -2102,10 +2107,7 @@ static int qdma_cpm4_indirect_reg_clear(void *dev_hndl,
 	qdma_reg_write(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed, err:%d\n",
 					__func__,
@@ -2132,7 +2134,11 @@ static int qdma_cpm4_indirect_reg_read(void *dev_hndl,
 	uint32_t index = 0, reg_addr = QDMA_CPM4_IND_CTXT_DATA_3_ADDR;
 	union qdma_cpm4_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -2142,10 +2148,7 @@ static int qdma_cpm4_indirect_reg_read(void *dev_hndl,
 	qdma_reg_write(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR, 1)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed, err:%d\n",
 					__func__,
@@ -2175,8 +2178,13 @@ static int qdma_cpm4_indirect_reg_write(void *dev_hndl,
 	uint32_t index, reg_addr;
 	struct qdma_cpm4_indirect_ctxt_regs regs;
 	uint32_t *wr_data = (uint32_t *)&regs;
+	int mask_needed;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* write the context data */
 	for (index = 0; index < QDMA_CPM4_IND_CTXT_DATA_NUM_REGS;
@@ -2194,16 +2202,20 @@ static int qdma_cpm4_indirect_reg_write(void *dev_hndl,
 	regs.cmd.bits.sel = sel;
 	reg_addr = QDMA_CPM4_IND_CTXT_DATA_3_ADDR;
 
+	mask_needed = qdma_ind_ctxt_mask_needed(dev_hndl);
 	for (index = 0;
 		index < ((2 * QDMA_CPM4_IND_CTXT_DATA_NUM_REGS) + 1);
-			index++, reg_addr += sizeof(uint32_t))
+			index++, reg_addr += sizeof(uint32_t)) {
+		/* the mask registers keep all ones within a context batch */
+		if (!mask_needed &&
+			(index >= QDMA_CPM4_IND_CTXT_DATA_NUM_REGS) &&
+			(index < (2 * QDMA_CPM4_IND_CTXT_DATA_NUM_REGS)))
+			continue;
 		qdma_reg_write(dev_hndl, reg_addr, wr_data[index]);
+	}
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR,
-			IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_CPM4_IND_CTXT_CMD_ADDR, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed, err:%d\n",
 						__func__,
@@ -2266,6 +2278,30 @@ static int qdma_cpm4_qid2vec_write(void *dev_hndl, uint8_t c2h,
 
 }
 
+/*
+ * qdma_cpm4_qid2vec_decode() - Helper function to decode qid2vec context
+ *                              words into structure
+ *
+ */
+static void qdma_cpm4_qid2vec_decode(const uint32_t *qid2vec, uint8_t c2h,
+		struct qdma_qid2vec *ctxt)
+{
+	if (c2h) {
+		ctxt->c2h_vector = FIELD_GET(C2H_QID2VEC_MAP_C2H_VECTOR_MASK,
+						qid2vec[0]);
+		ctxt->c2h_en_coal =
+			(uint8_t)(FIELD_GET(C2H_QID2VEC_MAP_C2H_EN_COAL_MASK,
+						qid2vec[0]));
+	} else {
+		ctxt->h2c_vector =
+			(uint8_t)(FIELD_GET(QDMA_CPM4_QID2VEC_H2C_VECTOR,
+								qid2vec[0]));
+		ctxt->h2c_en_coal =
+			(uint8_t)(FIELD_GET(QDMA_CPM4_QID2VEC_H2C_COAL_EN,
+								qid2vec[0]));
+	}
+}
+
 /*****************************************************************************/
 /**
  * qdma_cpm4_qid2vec_read() - read qid2vec context
@@ -2295,20 +2331,7 @@ static int qdma_cpm4_qid2vec_read(void *dev_hndl, uint8_t c2h,
 	if (rv < 0)
 		return rv;
 
-	if (c2h) {
-		ctxt->c2h_vector = FIELD_GET(C2H_QID2VEC_MAP_C2H_VECTOR_MASK,
-						qid2vec[0]);
-		ctxt->c2h_en_coal =
-			(uint8_t)(FIELD_GET(C2H_QID2VEC_MAP_C2H_EN_COAL_MASK,
-						qid2vec[0]));
-	} else {
-		ctxt->h2c_vector =
-			(uint8_t)(FIELD_GET(QDMA_CPM4_QID2VEC_H2C_VECTOR,
-								qid2vec[0]));
-		ctxt->h2c_en_coal =
-			(uint8_t)(FIELD_GET(QDMA_CPM4_QID2VEC_H2C_COAL_EN,
-								qid2vec[0]));
-	}
+	qdma_cpm4_qid2vec_decode(qid2vec, c2h, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -2432,6 +2455,20 @@ static int qdma_cpm4_fmap_write(void *dev_hndl, uint16_t func_id,
 	return QDMA_SUCCESS;
 }
 
+/*
+ * qdma_cpm4_fmap_decode() - Helper function to decode fmap register
+ *                           into structure
+ *
+ */
+static void qdma_cpm4_fmap_decode(const uint32_t *fmap,
+		struct qdma_fmap_cfg *config)
+{
+	config->qbase = FIELD_GET(TRQ_SEL_FMAP_0_QID_BASE_MASK, fmap[0]);
+	config->qmax =
+		(uint16_t)(FIELD_GET(TRQ_SEL_FMAP_0_QID_MAX_MASK,
+				fmap[0]));
+}
+
 /*****************************************************************************/
 /**
  * qdma_cpm4_fmap_read() - read fmap context
@@ -2457,10 +2494,7 @@ static int qdma_cpm4_fmap_read(void *dev_hndl, uint16_t func_id,
 	fmap = qdma_reg_read(dev_hndl, QDMA_CPM4_TRQ_SEL_FMAP_0_ADDR +
 			     func_id * QDMA_CPM4_REG_TRQ_SEL_FMAP_STEP);
 
-	config->qbase = FIELD_GET(TRQ_SEL_FMAP_0_QID_BASE_MASK, fmap);
-	config->qmax =
-		(uint16_t)(FIELD_GET(TRQ_SEL_FMAP_0_QID_MAX_MASK,
-				fmap));
+	qdma_cpm4_fmap_decode(&fmap, config);
 
 	return QDMA_SUCCESS;
 }
@@ -2602,39 +2636,14 @@ static int qdma_cpm4_sw_context_write(void *dev_hndl, uint8_t c2h,
 			sw_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * qdma_cpm4_sw_context_read() - read sw context
- *
- * @dev_hndl:	device handle
- * @c2h:	is c2h queue
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the output context data
+/*
+ * qdma_cpm4_sw_context_decode() - Helper function to decode sw context
+ *                                 words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int qdma_cpm4_sw_context_read(void *dev_hndl, uint8_t c2h,
-			 uint16_t hw_qid,
-			 struct qdma_descq_sw_ctxt *ctxt)
+ */
+static void qdma_cpm4_sw_context_decode(const uint32_t *sw_ctxt,
+		struct qdma_descq_sw_ctxt *ctxt)
 {
-	int rv = 0;
-	uint32_t sw_ctxt[QDMA_CPM4_SW_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = c2h ?
-			QDMA_CTXT_SEL_SW_C2H : QDMA_CTXT_SEL_SW_H2C;
-	struct qdma_qid2vec qid2vec_ctxt = {0};
-
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_hndl=%p sw_ctxt=%p, err:%d\n",
-					   __func__, dev_hndl, ctxt,
-					   -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = qdma_cpm4_indirect_reg_read(dev_hndl, sel, hw_qid,
-			QDMA_CPM4_SW_CONTEXT_NUM_WORDS, sw_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->pidx = FIELD_GET(SW_IND_CTXT_DATA_W0_PIDX_MASK, sw_ctxt[0]);
 	ctxt->irq_arm =
 		(uint8_t)(FIELD_GET(SW_IND_CTXT_DATA_W0_IRQ_ARM_MASK,
@@ -2691,6 +2700,42 @@ static int qdma_cpm4_sw_context_read(void *dev_hndl, uint8_t c2h,
 			sw_ctxt[1]));
 
 	ctxt->ring_bs_addr = ((uint64_t)sw_ctxt[3] << 32) | (sw_ctxt[2]);
+}
+
+/*****************************************************************************/
+/**
+ * qdma_cpm4_sw_context_read() - read sw context
+ *
+ * @dev_hndl:	device handle
+ * @c2h:	is c2h queue
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the output context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int qdma_cpm4_sw_context_read(void *dev_hndl, uint8_t c2h,
+			 uint16_t hw_qid,
+			 struct qdma_descq_sw_ctxt *ctxt)
+{
+	int rv = 0;
+	uint32_t sw_ctxt[QDMA_CPM4_SW_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = c2h ?
+			QDMA_CTXT_SEL_SW_C2H : QDMA_CTXT_SEL_SW_H2C;
+	struct qdma_qid2vec qid2vec_ctxt = {0};
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_hndl=%p sw_ctxt=%p, err:%d\n",
+					   __func__, dev_hndl, ctxt,
+					   -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_cpm4_indirect_reg_read(dev_hndl, sel, hw_qid,
+			QDMA_CPM4_SW_CONTEXT_NUM_WORDS, sw_ctxt);
+	if (rv < 0)
+		return rv;
+
+	qdma_cpm4_sw_context_decode(sw_ctxt, ctxt);
 
 	/** Read the QID2VEC Context Data */
 	rv = qdma_cpm4_qid2vec_read(dev_hndl, c2h, hw_qid, &qid2vec_ctxt);
@@ -2705,7 +2750,6 @@ static int qdma_cpm4_sw_context_read(void *dev_hndl, uint8_t c2h,
 		ctxt->intr_aggr = qid2vec_ctxt.h2c_en_coal;
 	}
 
-
 	return QDMA_SUCCESS;
 }
 
@@ -2851,36 +2895,16 @@ static int qdma_cpm4_pfetch_context_write(void *dev_hndl, uint16_t hw_qid,
 			pfetch_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * qdma_cpm4_pfetch_context_read() - read prefetch context
- *
- * @dev_hndl:	device handle
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the output context data
+/*
+ * qdma_cpm4_pfetch_context_decode() - Helper function to decode prefetch
+ *                                    context words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int qdma_cpm4_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
+ */
+static void qdma_cpm4_pfetch_context_decode(const uint32_t *pfetch_ctxt,
 		struct qdma_descq_prefetch_ctxt *ctxt)
 {
-	int rv = 0;
-	uint32_t pfetch_ctxt[QDMA_CPM4_PFETCH_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_PFTCH;
 	uint32_t sw_crdt_l, sw_crdt_h;
 
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_hndl=%p pfetch_ctxt=%p, err:%d\n",
-					   __func__, dev_hndl, ctxt,
-					   -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = qdma_cpm4_indirect_reg_read(dev_hndl, sel, hw_qid,
-			QDMA_CPM4_PFETCH_CONTEXT_NUM_WORDS, pfetch_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->bypass =
 		(uint8_t)(FIELD_GET(PREFETCH_CTXT_DATA_W0_BYPASS_MASK,
 			pfetch_ctxt[0]));
@@ -2914,6 +2938,38 @@ static int qdma_cpm4_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
 		(uint16_t)(FIELD_SET(QDMA_PFTCH_CTXT_SW_CRDT_GET_L_MASK,
 			sw_crdt_l) |
 		FIELD_SET(QDMA_PFTCH_CTXT_SW_CRDT_GET_H_MASK, sw_crdt_h));
+}
+
+/*****************************************************************************/
+/**
+ * qdma_cpm4_pfetch_context_read() - read prefetch context
+ *
+ * @dev_hndl:	device handle
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the output context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int qdma_cpm4_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
+		struct qdma_descq_prefetch_ctxt *ctxt)
+{
+	int rv = 0;
+	uint32_t pfetch_ctxt[QDMA_CPM4_PFETCH_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_PFTCH;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_hndl=%p pfetch_ctxt=%p, err:%d\n",
+					   __func__, dev_hndl, ctxt,
+					   -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_cpm4_indirect_reg_read(dev_hndl, sel, hw_qid,
+			QDMA_CPM4_PFETCH_CONTEXT_NUM_WORDS, pfetch_ctxt);
+	if (rv < 0)
+		return rv;
+
+	qdma_cpm4_pfetch_context_decode(pfetch_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3114,37 +3170,17 @@ static int qdma_cpm4_cmpt_context_write(void *dev_hndl, uint16_t hw_qid,
 
 }
 
-/*****************************************************************************/
-/**
- * qdma_cpm4_cmpt_context_read() - read completion context
- *
- * @dev_hndl:	device handle
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	    pointer to the context data
+/*
+ * qdma_cpm4_cmpt_context_decode() - Helper function to decode completion
+ *                                  context words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int qdma_cpm4_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
-			   struct qdma_descq_cmpt_ctxt *ctxt)
+ */
+static void qdma_cpm4_cmpt_context_decode(const uint32_t *cmpt_ctxt,
+		struct qdma_descq_cmpt_ctxt *ctxt)
 {
-	int rv = 0;
-	uint32_t cmpt_ctxt[QDMA_CPM4_CMPT_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_CMPT;
 	uint32_t baddr_l, baddr_h, baddr_m,
 			 pidx_l, pidx_h;
 
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_hndl=%p cmpt_ctxt=%p, err:%d\n",
-					   __func__, dev_hndl, ctxt,
-					   -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = qdma_cpm4_indirect_reg_read(dev_hndl, sel, hw_qid,
-			QDMA_CPM4_CMPT_CONTEXT_NUM_WORDS, cmpt_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->en_stat_desc =
 		FIELD_GET(CMPL_CTXT_DATA_W0_EN_STAT_DESC_MASK, cmpt_ctxt[0]);
 	ctxt->en_int = FIELD_GET(CMPL_CTXT_DATA_W0_EN_INT_MASK,
@@ -3222,6 +3258,38 @@ static int qdma_cpm4_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
 			pidx_l) |
 		FIELD_SET(QDMA_CPM4_COMPL_CTXT_PIDX_GET_H_MASK,
 			pidx_h));
+}
+
+/*****************************************************************************/
+/**
+ * qdma_cpm4_cmpt_context_read() - read completion context
+ *
+ * @dev_hndl:	device handle
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	    pointer to the context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int qdma_cpm4_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
+			   struct qdma_descq_cmpt_ctxt *ctxt)
+{
+	int rv = 0;
+	uint32_t cmpt_ctxt[QDMA_CPM4_CMPT_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_CMPT;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_hndl=%p cmpt_ctxt=%p, err:%d\n",
+					   __func__, dev_hndl, ctxt,
+					   -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_cpm4_indirect_reg_read(dev_hndl, sel, hw_qid,
+			QDMA_CPM4_CMPT_CONTEXT_NUM_WORDS, cmpt_ctxt);
+	if (rv < 0)
+		return rv;
+
+	qdma_cpm4_cmpt_context_decode(cmpt_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3321,6 +3389,30 @@ int qdma_cpm4_cmpt_ctx_conf(void *dev_hndl, uint16_t hw_qid,
 	return ret_val;
 }
 
+/*
+ * qdma_cpm4_hw_context_decode() - Helper function to decode hw context
+ *                                words into structure
+ *
+ */
+static void qdma_cpm4_hw_context_decode(const uint32_t *hw_ctxt,
+		struct qdma_descq_hw_ctxt *ctxt)
+{
+	ctxt->cidx = FIELD_GET(HW_IND_CTXT_DATA_W0_CIDX_MASK, hw_ctxt[0]);
+	ctxt->crd_use =
+		(uint16_t)(FIELD_GET(HW_IND_CTXT_DATA_W0_CRD_USE_MASK,
+				hw_ctxt[0]));
+
+	ctxt->dsc_pend =
+		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_DSC_PND_MASK,
+				hw_ctxt[1]));
+	ctxt->idl_stp_b =
+		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_IDL_STP_B_MASK,
+			hw_ctxt[1]));
+	ctxt->fetch_pnd =
+		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_FETCH_PND_MASK,
+			hw_ctxt[1]));
+}
+
 /*****************************************************************************/
 /**
  * qdma_cpm4_hw_context_read() - read hardware context
@@ -3352,20 +3444,7 @@ static int qdma_cpm4_hw_context_read(void *dev_hndl, uint8_t c2h,
 	if (rv < 0)
 		return rv;
 
-	ctxt->cidx = FIELD_GET(HW_IND_CTXT_DATA_W0_CIDX_MASK, hw_ctxt[0]);
-	ctxt->crd_use =
-		(uint16_t)(FIELD_GET(HW_IND_CTXT_DATA_W0_CRD_USE_MASK,
-				hw_ctxt[0]));
-
-	ctxt->dsc_pend =
-		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_DSC_PND_MASK,
-				hw_ctxt[1]));
-	ctxt->idl_stp_b =
-		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_IDL_STP_B_MASK,
-			hw_ctxt[1]));
-	ctxt->fetch_pnd =
-		(uint8_t)(FIELD_GET(HW_IND_CTXT_DATA_W1_FETCH_PND_MASK,
-			hw_ctxt[1]));
+	qdma_cpm4_hw_context_decode(hw_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -4434,6 +4513,20 @@ int qdma_cpm4_get_device_attributes(void *dev_hndl,
 }
 
 
+/*
+ * qdma_cpm4_credit_context_decode() - Helper function to decode credit context
+ *                                    words into structure
+ *
+ */
+static void qdma_cpm4_credit_context_decode(const uint32_t *cr_ctxt,
+		struct qdma_descq_credit_ctxt *ctxt)
+{
+	ctxt->credit = FIELD_GET(CRED_CTXT_DATA_W0_CREDT_MASK,
+			cr_ctxt[0]);
+
+	qdma_log_debug("%s: credit=%u\n", __func__, ctxt->credit);
+}
+
 /*****************************************************************************/
 /**
  * qdma_cpm4_credit_context_read() - read credit context
@@ -4466,10 +4559,7 @@ static int qdma_cpm4_credit_context_read(void *dev_hndl, uint8_t c2h,
 	if (rv < 0)
 		return rv;
 
-	ctxt->credit = FIELD_GET(CRED_CTXT_DATA_W0_CREDT_MASK,
-			cr_ctxt[0]);
-
-	qdma_log_debug("%s: credit=%u\n", __func__, ctxt->credit);
+	qdma_cpm4_credit_context_decode(cr_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -4909,6 +4999,153 @@ int qdma_cpm4_read_dump_queue_context(void *dev_hndl,
 	return rv;
 }
 
+/*****************************************************************************/
+/**
+ * qdma_cpm4_read_queue_context_raw() - Function to read the contexts of a queue
+ * into a raw snapshot, without decoding them
+ *
+ * @dev_hndl:   device handle
+ * @func_id:	function id for the fmap context
+ * @qid_hw:     queue id
+ * @st:		Queue Mode(ST or MM)
+ * @q_type:	Queue type(H2C/C2H/CMPT)
+ * @raw:	snapshot to be filled
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_cpm4_read_queue_context_raw(void *dev_hndl,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw)
+{
+	/* words per enum qdma_ctxt_raw_type */
+	static const uint32_t num_words[QDMA_CTXT_RAW_MAX] = {
+		QDMA_CPM4_SW_CONTEXT_NUM_WORDS,
+		QDMA_CPM4_HW_CONTEXT_NUM_WORDS,
+		QDMA_CPM4_CR_CONTEXT_NUM_WORDS,
+		QDMA_CPM4_PFETCH_CONTEXT_NUM_WORDS,
+		QDMA_CPM4_CMPT_CONTEXT_NUM_WORDS,
+		0,
+		QDMA_CPM4_QID2VEC_CONTEXT_NUM_WORDS
+	};
+	int rv;
+
+	rv = qdma_read_queue_context_raw(dev_hndl, qdma_cpm4_indirect_reg_read,
+			num_words, func_id, qid_hw, st, q_type, raw);
+	if (rv < 0)
+		return rv;
+
+	/* CPM4 has no indirect fmap context, the register is snapshotted */
+	raw->data[QDMA_CTXT_RAW_FMAP][0] = qdma_reg_read(dev_hndl,
+			QDMA_CPM4_TRQ_SEL_FMAP_0_ADDR +
+			func_id * QDMA_CPM4_REG_TRQ_SEL_FMAP_STEP);
+	raw->valid |= (1 << QDMA_CTXT_RAW_FMAP);
+
+	return QDMA_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * qdma_cpm4_decode_queue_context_raw() - Function to decode a queue context
+ * snapshot taken by qdma_cpm4_read_queue_context_raw()
+ *
+ * @raw:	queue context snapshot
+ * @ctxt:	decoded context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_cpm4_decode_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt)
+{
+	uint8_t c2h;
+
+	if (!raw || !ctxt) {
+		qdma_log_error("%s: raw or ctxt is NULL, err:%d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	qdma_memset(ctxt, 0, sizeof(struct qdma_descq_context));
+	c2h = (raw->q_type == QDMA_DEV_Q_TYPE_C2H) ? 1 : 0;
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_SW))
+		qdma_cpm4_sw_context_decode(raw->data[QDMA_CTXT_RAW_SW],
+				&ctxt->sw_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_HW))
+		qdma_cpm4_hw_context_decode(raw->data[QDMA_CTXT_RAW_HW],
+				&ctxt->hw_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_CR))
+		qdma_cpm4_credit_context_decode(raw->data[QDMA_CTXT_RAW_CR],
+				&ctxt->cr_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_PFETCH))
+		qdma_cpm4_pfetch_context_decode(raw->data[QDMA_CTXT_RAW_PFETCH],
+				&ctxt->pfetch_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_CMPT))
+		qdma_cpm4_cmpt_context_decode(raw->data[QDMA_CTXT_RAW_CMPT],
+				&ctxt->cmpt_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_FMAP))
+		qdma_cpm4_fmap_decode(raw->data[QDMA_CTXT_RAW_FMAP],
+				&ctxt->fmap);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_QID2VEC)) {
+		qdma_cpm4_qid2vec_decode(raw->data[QDMA_CTXT_RAW_QID2VEC], c2h,
+				&ctxt->qid2vec);
+		ctxt->sw_ctxt.vec = c2h ? ctxt->qid2vec.c2h_vector :
+				ctxt->qid2vec.h2c_vector;
+		ctxt->sw_ctxt.intr_aggr = c2h ? ctxt->qid2vec.c2h_en_coal :
+				ctxt->qid2vec.h2c_en_coal;
+	}
+
+	return QDMA_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * qdma_cpm4_dump_queue_context_raw() - Function to decode a queue context
+ * snapshot into a buffer
+ *
+ * @raw:	queue context snapshot
+ * @buf :       pointer to buffer to be filled
+ * @buflen :    Length of the buffer
+ *
+ * Return:	Length up-till the buffer is filled -success and < 0 - failure
+ *****************************************************************************/
+int qdma_cpm4_dump_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen)
+{
+	struct qdma_descq_context context;
+	uint32_t req_buflen = 0;
+	int rv;
+
+	if (!raw || !buf) {
+		qdma_log_error("%s: raw or buf is NULL, err:%d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	if (raw->q_type >= QDMA_DEV_Q_TYPE_MAX) {
+		qdma_log_error("%s: Not supported for q_type, err = %d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_cpm4_context_buf_len(raw->st,
+			(enum qdma_dev_q_type)raw->q_type, &req_buflen);
+	if (rv != QDMA_SUCCESS)
+		return rv;
+
+	if (buflen < req_buflen) {
+		qdma_log_error("%s: Too small buffer(%d), reqd(%d), err:%d\n",
+			__func__, buflen, req_buflen, -QDMA_ERR_NO_MEM);
+		return -QDMA_ERR_NO_MEM;
+	}
+
+	qdma_cpm4_decode_queue_context_raw(raw, &context);
+
+	return dump_cpm4_context(&context, raw->st,
+			(enum qdma_dev_q_type)raw->q_type, buf, buflen);
+}
+
 /*****************************************************************************/
 /**
  * qdma_cpm4_init_ctxt_memory() - Initialize the context for all queues
@@ -4924,6 +5161,7 @@ int qdma_cpm4_init_ctxt_memory(void *dev_hndl)
 	uint32_t data[QDMA_REG_IND_CTXT_REG_COUNT];
 	uint16_t i = 0;
 	struct qdma_dev_attributes dev_info;
+	int rv;
 
 	if (!dev_hndl) {
 		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
@@ -4933,11 +5171,16 @@ int qdma_cpm4_init_ctxt_memory(void *dev_hndl)
 
 	qdma_memset(data, 0, sizeof(uint32_t) * QDMA_REG_IND_CTXT_REG_COUNT);
 	qdma_cpm4_get_device_attributes(dev_hndl, &dev_info);
+
+	/* queue up the clear commands instead of waiting for each one */
+	rv = qdma_ctxt_batch_start(dev_hndl);
+	if (rv < 0)
+		return rv;
+
 	qdma_log_info("%s: clearing the context for all qs",
 			__func__);
 	for (; i < dev_info.num_qs; i++) {
 		int sel = QDMA_CTXT_SEL_SW_C2H;
-		int rv;
 
 		for (; sel <= QDMA_CTXT_SEL_PFTCH; sel++) {
 			/** if the st mode(h2c/c2h) not enabled
@@ -4955,14 +5198,20 @@ int qdma_cpm4_init_ctxt_memory(void *dev_hndl)
 
 			rv = qdma_cpm4_indirect_reg_clear(dev_hndl,
 					(enum ind_ctxt_cmd_sel)sel, i);
-			if (rv < 0)
+			if (rv < 0) {
+				qdma_ctxt_batch_end(dev_hndl);
 				return rv;
+			}
 		}
 	}
 
 	/* fmap */
 	for (i = 0; i < dev_info.num_pfs; i++)
 		qdma_cpm4_fmap_clear(dev_hndl, i);
+
+	rv = qdma_ctxt_batch_end(dev_hndl);
+	if (rv < 0)
+		return rv;
 #else
 	if (!dev_hndl) {
 		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
@@ -258,6 +258,19 @@ int qdma_cpm4_read_dump_queue_context(void *dev_hndl,
 		enum qdma_dev_q_type q_type,
 		char *buf, uint32_t buflen);
 
+int qdma_cpm4_read_queue_context_raw(void *dev_hndl,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw);
+
+int qdma_cpm4_decode_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt);
+
+int qdma_cpm4_dump_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen);
+
 int qdma_cpm4_dump_config_reg_list(void *dev_hndl,
 		uint32_t total_regs,
 		struct qdma_reg_data *reg_list,
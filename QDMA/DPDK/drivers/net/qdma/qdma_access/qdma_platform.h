@@ -146,6 +146,14 @@ int qdma_reg_access_release(void *dev_hndl);
  *****************************************************************************/
 void qdma_udelay(uint32_t delay_usec);
 
+/*****************************************************************************/
+/**
+ * qdma_get_thread_id() - function to identify the calling thread
+ *
+ * Return:	a non zero value unique to the calling thread
+ *****************************************************************************/
+uint64_t qdma_get_thread_id(void);
+
 /*****************************************************************************/
 /**
  * qdma_get_hw_access() - function to get the qdma_hw_access
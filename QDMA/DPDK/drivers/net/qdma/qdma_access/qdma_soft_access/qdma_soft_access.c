@@ -2296,7 +2296,11 @@ static int qdma_indirect_reg_invalidate(void *dev_hndl,
 {
 	union qdma_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -2306,10 +2310,7 @@ static int qdma_indirect_reg_invalidate(void *dev_hndl,
 	qdma_reg_write(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD,
-			QDMA_IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -2334,7 +2335,11 @@ static int qdma_indirect_reg_clear(void *dev_hndl,
 {
 	union qdma_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -2344,10 +2349,7 @@ static int qdma_indirect_reg_clear(void *dev_hndl,
 	qdma_reg_write(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD,
-			QDMA_IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -2373,7 +2375,11 @@ static int qdma_indirect_reg_read(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	uint32_t index = 0, reg_addr = QDMA_OFFSET_IND_CTXT_DATA;
 	union qdma_ind_ctxt_cmd cmd;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* set command register */
 	cmd.word = 0;
@@ -2383,10 +2389,7 @@ static int qdma_indirect_reg_read(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	qdma_reg_write(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD, cmd.word);
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD,
-			QDMA_IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD, 1)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -2415,8 +2418,13 @@ static int qdma_indirect_reg_write(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	uint32_t index, reg_addr;
 	struct qdma_indirect_ctxt_regs regs;
 	uint32_t *wr_data = (uint32_t *)&regs;
+	int mask_needed;
 
-	qdma_reg_access_lock(dev_hndl);
+	if (qdma_ind_ctxt_cmd_lock(dev_hndl) < 0) {
+		qdma_log_error("%s: previous context command failed, err:%d\n",
+				__func__, -QDMA_ERR_HWACC_BUSY_TIMEOUT);
+		return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
+	}
 
 	/* write the context data */
 	for (index = 0; index < QDMA_IND_CTXT_DATA_NUM_REGS; index++) {
@@ -2433,15 +2441,18 @@ static int qdma_indirect_reg_write(void *dev_hndl, enum ind_ctxt_cmd_sel sel,
 	regs.cmd.bits.sel = sel;
 	reg_addr = QDMA_OFFSET_IND_CTXT_DATA;
 
+	mask_needed = qdma_ind_ctxt_mask_needed(dev_hndl);
 	for (index = 0; index < ((2 * QDMA_IND_CTXT_DATA_NUM_REGS) + 1);
-			index++, reg_addr += sizeof(uint32_t))
+			index++, reg_addr += sizeof(uint32_t)) {
+		/* the mask registers keep all ones within a context batch */
+		if (!mask_needed && (index >= QDMA_IND_CTXT_DATA_NUM_REGS) &&
+				(index < (2 * QDMA_IND_CTXT_DATA_NUM_REGS)))
+			continue;
 		qdma_reg_write(dev_hndl, reg_addr, wr_data[index]);
+	}
 
 	/* check if the operation went through well */
-	if (hw_monitor_reg(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD,
-			QDMA_IND_CTXT_CMD_BUSY_MASK, 0,
-			QDMA_REG_POLL_DFLT_INTERVAL_US,
-			QDMA_REG_POLL_DFLT_TIMEOUT_US)) {
+	if (qdma_ind_ctxt_cmd_wait(dev_hndl, QDMA_OFFSET_IND_CTXT_CMD, 0)) {
 		qdma_reg_access_release(dev_hndl);
 		qdma_log_error("%s: hw_monitor_reg failed with err:%d\n",
 						__func__,
@@ -2519,6 +2530,21 @@ static int qdma_fmap_write(void *dev_hndl, uint16_t func_id,
 			fmap, num_words_count);
 }
 
+/*
+ * qdma_fmap_decode() - Helper function to decode fmap context
+ *                     words into structure
+ *
+ */
+static void qdma_fmap_decode(const uint32_t *fmap,
+		struct qdma_fmap_cfg *config)
+{
+	config->qbase = FIELD_GET(QDMA_FMAP_CTXT_W0_QID_MASK, fmap[0]);
+	config->qmax = FIELD_GET(QDMA_FMAP_CTXT_W1_QID_MAX_MASK, fmap[1]);
+
+	qdma_log_debug("%s: qbase=%hu, qmax=%hu\n", __func__,
+				   config->qbase, config->qmax);
+}
+
 /*****************************************************************************/
 /**
  * qdma_fmap_read() - read fmap context
@@ -2548,11 +2574,7 @@ static int qdma_fmap_read(void *dev_hndl, uint16_t func_id,
 	if (rv < 0)
 		return rv;
 
-	config->qbase = FIELD_GET(QDMA_FMAP_CTXT_W0_QID_MASK, fmap[0]);
-	config->qmax = FIELD_GET(QDMA_FMAP_CTXT_W1_QID_MAX_MASK, fmap[1]);
-
-	qdma_log_debug("%s: func_id=%hu, qbase=%hu, qmax=%hu\n", __func__,
-				   func_id, config->qbase, config->qmax);
+	qdma_fmap_decode(fmap, config);
 
 	return QDMA_SUCCESS;
 }
@@ -2711,38 +2733,14 @@ static int qdma_sw_context_write(void *dev_hndl, uint8_t c2h,
 			sw_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * qdma_sw_context_read() - read sw context
- *
- * @dev_hndl:	device handle
- * @c2h:	is c2h queue
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the output context data
+/*
+ * qdma_sw_context_decode() - Helper function to decode sw context
+ *                           words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int qdma_sw_context_read(void *dev_hndl, uint8_t c2h,
-			 uint16_t hw_qid,
-			 struct qdma_descq_sw_ctxt *ctxt)
+ */
+static void qdma_sw_context_decode(const uint32_t *sw_ctxt,
+		struct qdma_descq_sw_ctxt *ctxt)
 {
-	int rv = QDMA_SUCCESS;
-	uint32_t sw_ctxt[QDMA_SW_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = c2h ?
-			QDMA_CTXT_SEL_SW_C2H : QDMA_CTXT_SEL_SW_H2C;
-
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_handle=%p sw_ctxt=%p NULL, err:%d\n",
-					   __func__, dev_hndl, ctxt,
-					   -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = qdma_indirect_reg_read(dev_hndl, sel, hw_qid,
-			QDMA_SW_CONTEXT_NUM_WORDS, sw_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->pidx = FIELD_GET(QDMA_SW_CTXT_W0_PIDX, sw_ctxt[0]);
 	ctxt->irq_arm =
 		(uint8_t)(FIELD_GET(QDMA_SW_CTXT_W0_IRQ_ARM_MASK, sw_ctxt[0]));
@@ -2814,6 +2812,41 @@ static int qdma_sw_context_read(void *dev_hndl, uint8_t c2h,
 
 	qdma_log_debug("%s: vec=%x, intr_aggr=%x\n",
 			__func__, ctxt->vec, ctxt->intr_aggr);
+}
+
+/*****************************************************************************/
+/**
+ * qdma_sw_context_read() - read sw context
+ *
+ * @dev_hndl:	device handle
+ * @c2h:	is c2h queue
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the output context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int qdma_sw_context_read(void *dev_hndl, uint8_t c2h,
+			 uint16_t hw_qid,
+			 struct qdma_descq_sw_ctxt *ctxt)
+{
+	int rv = QDMA_SUCCESS;
+	uint32_t sw_ctxt[QDMA_SW_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = c2h ?
+			QDMA_CTXT_SEL_SW_C2H : QDMA_CTXT_SEL_SW_H2C;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_handle=%p sw_ctxt=%p NULL, err:%d\n",
+					   __func__, dev_hndl, ctxt,
+					   -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_indirect_reg_read(dev_hndl, sel, hw_qid,
+			QDMA_SW_CONTEXT_NUM_WORDS, sw_ctxt);
+	if (rv < 0)
+		return rv;
+
+	qdma_sw_context_decode(sw_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -2977,35 +3010,16 @@ static int qdma_pfetch_context_write(void *dev_hndl, uint16_t hw_qid,
 			pfetch_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * qdma_pfetch_context_read() - read prefetch context
- *
- * @dev_hndl:	device handle
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the output context data
+/*
+ * qdma_pfetch_context_decode() - Helper function to decode prefetch context
+ *                               words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int qdma_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
+ */
+static void qdma_pfetch_context_decode(const uint32_t *pfetch_ctxt,
 		struct qdma_descq_prefetch_ctxt *ctxt)
 {
-	int rv = QDMA_SUCCESS;
-	uint32_t pfetch_ctxt[QDMA_PFETCH_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_PFTCH;
 	uint32_t sw_crdt_l, sw_crdt_h;
 
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_handle or pfetch ctxt NULL, err:%d\n",
-					   __func__, -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = qdma_indirect_reg_read(dev_hndl, sel, hw_qid,
-			QDMA_PFETCH_CONTEXT_NUM_WORDS, pfetch_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->bypass =
 		FIELD_GET(QDMA_PFTCH_CTXT_W0_BYPASS_MASK, pfetch_ctxt[0]);
 	ctxt->bufsz_idx =
@@ -3034,13 +3048,44 @@ static int qdma_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
 		FIELD_SET(QDMA_PFTCH_CTXT_SW_CRDT_GET_L_MASK, sw_crdt_l) |
 		FIELD_SET(QDMA_PFTCH_CTXT_SW_CRDT_GET_H_MASK, sw_crdt_h);
 
-	qdma_log_debug("%s: sw_crdt_l=%u, sw_crdt_h=%u, hw_qid=%hu\n",
-			 __func__, sw_crdt_l, sw_crdt_h, hw_qid);
+	qdma_log_debug("%s: sw_crdt_l=%u, sw_crdt_h=%u\n",
+			 __func__, sw_crdt_l, sw_crdt_h);
 	qdma_log_debug("%s: bypass=%x, bufsz_idx=%x, port_id=%x\n",
 			__func__, ctxt->bypass, ctxt->bufsz_idx, ctxt->port_id);
 	qdma_log_debug("%s: err=%x, pfch_en=%x, pfch=%x, ctxt->valid=%x\n",
 			__func__, ctxt->err, ctxt->pfch_en, ctxt->pfch,
 			ctxt->valid);
+}
+
+/*****************************************************************************/
+/**
+ * qdma_pfetch_context_read() - read prefetch context
+ *
+ * @dev_hndl:	device handle
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the output context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int qdma_pfetch_context_read(void *dev_hndl, uint16_t hw_qid,
+		struct qdma_descq_prefetch_ctxt *ctxt)
+{
+	int rv = QDMA_SUCCESS;
+	uint32_t pfetch_ctxt[QDMA_PFETCH_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_PFTCH;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_handle or pfetch ctxt NULL, err:%d\n",
+					   __func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_indirect_reg_read(dev_hndl, sel, hw_qid,
+			QDMA_PFETCH_CONTEXT_NUM_WORDS, pfetch_ctxt);
+	if (rv < 0)
+		return rv;
+
+	qdma_pfetch_context_decode(pfetch_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3216,35 +3261,16 @@ static int qdma_cmpt_context_write(void *dev_hndl, uint16_t hw_qid,
 			cmpt_ctxt, num_words_count);
 }
 
-/*****************************************************************************/
-/**
- * qdma_cmpt_context_read() - read completion context
- *
- * @dev_hndl:	device handle
- * @hw_qid:	hardware qid of the queue
- * @ctxt:	pointer to the context data
+/*
+ * qdma_cmpt_context_decode() - Helper function to decode completion context
+ *                             words into structure
  *
- * Return:	0   - success and < 0 - failure
- *****************************************************************************/
-static int qdma_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
-			   struct qdma_descq_cmpt_ctxt *ctxt)
+ */
+static void qdma_cmpt_context_decode(const uint32_t *cmpt_ctxt,
+		struct qdma_descq_cmpt_ctxt *ctxt)
 {
-	int rv = QDMA_SUCCESS;
-	uint32_t cmpt_ctxt[QDMA_CMPT_CONTEXT_NUM_WORDS] = {0};
-	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_CMPT;
 	uint32_t baddr_l, baddr_h, pidx_l, pidx_h;
 
-	if (!dev_hndl || !ctxt) {
-		qdma_log_error("%s: dev_handle or cmpt ctxt NULL, err:%d\n",
-					   __func__, -QDMA_ERR_INV_PARAM);
-		return -QDMA_ERR_INV_PARAM;
-	}
-
-	rv = qdma_indirect_reg_read(dev_hndl, sel, hw_qid,
-			QDMA_CMPT_CONTEXT_NUM_WORDS, cmpt_ctxt);
-	if (rv < 0)
-		return rv;
-
 	ctxt->en_stat_desc =
 		FIELD_GET(QDMA_COMPL_CTXT_W0_EN_STAT_DESC_MASK, cmpt_ctxt[0]);
 	ctxt->en_int = FIELD_GET(QDMA_COMPL_CTXT_W0_EN_INT_MASK, cmpt_ctxt[0]);
@@ -3307,6 +3333,37 @@ static int qdma_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
 	ctxt->pidx =
 		FIELD_SET(QDMA_COMPL_CTXT_PIDX_GET_L_MASK, pidx_l) |
 		FIELD_SET(QDMA_COMPL_CTXT_PIDX_GET_H_MASK, pidx_h);
+}
+
+/*****************************************************************************/
+/**
+ * qdma_cmpt_context_read() - read completion context
+ *
+ * @dev_hndl:	device handle
+ * @hw_qid:	hardware qid of the queue
+ * @ctxt:	pointer to the context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+static int qdma_cmpt_context_read(void *dev_hndl, uint16_t hw_qid,
+			   struct qdma_descq_cmpt_ctxt *ctxt)
+{
+	int rv = QDMA_SUCCESS;
+	uint32_t cmpt_ctxt[QDMA_CMPT_CONTEXT_NUM_WORDS] = {0};
+	enum ind_ctxt_cmd_sel sel = QDMA_CTXT_SEL_CMPT;
+
+	if (!dev_hndl || !ctxt) {
+		qdma_log_error("%s: dev_handle or cmpt ctxt NULL, err:%d\n",
+					   __func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_indirect_reg_read(dev_hndl, sel, hw_qid,
+			QDMA_CMPT_CONTEXT_NUM_WORDS, cmpt_ctxt);
+	if (rv < 0)
+		return rv;
+
+	qdma_cmpt_context_decode(cmpt_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3397,6 +3454,36 @@ int qdma_cmpt_ctx_conf(void *dev_hndl, uint16_t hw_qid,
 	return rv;
 }
 
+/*
+ * qdma_hw_context_decode() - Helper function to decode hw context
+ *                           words into structure
+ *
+ */
+static void qdma_hw_context_decode(const uint32_t *hw_ctxt,
+		struct qdma_descq_hw_ctxt *ctxt)
+{
+	ctxt->cidx = FIELD_GET(QDMA_HW_CTXT_W0_CIDX_MASK, hw_ctxt[0]);
+	ctxt->crd_use =
+		(uint16_t)(FIELD_GET(QDMA_HW_CTXT_W0_CRD_USE_MASK, hw_ctxt[0]));
+
+	ctxt->dsc_pend =
+		(uint8_t)(FIELD_GET(QDMA_HW_CTXT_W1_DSC_PND_MASK, hw_ctxt[1]));
+	ctxt->idl_stp_b =
+		(uint8_t)(FIELD_GET(QDMA_HW_CTXT_W1_IDL_STP_B_MASK,
+			hw_ctxt[1]));
+	ctxt->evt_pnd =
+		(uint8_t)(FIELD_GET(QDMA_HW_CTXT_W1_EVENT_PEND_MASK,
+			hw_ctxt[1]));
+	ctxt->fetch_pnd = (uint8_t)
+		(FIELD_GET(QDMA_HW_CTXT_W1_FETCH_PEND_MASK, hw_ctxt[1]));
+
+	qdma_log_debug("%s: cidx=%hu, crd_use=%hu, dsc_pend=%x\n",
+			__func__, ctxt->cidx, ctxt->crd_use, ctxt->dsc_pend);
+	qdma_log_debug("%s: idl_stp_b=%x, evt_pnd=%x, fetch_pnd=%x\n",
+			__func__, ctxt->idl_stp_b, ctxt->evt_pnd,
+			ctxt->fetch_pnd);
+}
+
 /*****************************************************************************/
 /**
  * qdma_hw_context_read() - read hardware context
@@ -3427,26 +3514,7 @@ static int qdma_hw_context_read(void *dev_hndl, uint8_t c2h,
 	if (rv < 0)
 		return rv;
 
-	ctxt->cidx = FIELD_GET(QDMA_HW_CTXT_W0_CIDX_MASK, hw_ctxt[0]);
-	ctxt->crd_use =
-		(uint16_t)(FIELD_GET(QDMA_HW_CTXT_W0_CRD_USE_MASK, hw_ctxt[0]));
-
-	ctxt->dsc_pend =
-		(uint8_t)(FIELD_GET(QDMA_HW_CTXT_W1_DSC_PND_MASK, hw_ctxt[1]));
-	ctxt->idl_stp_b =
-		(uint8_t)(FIELD_GET(QDMA_HW_CTXT_W1_IDL_STP_B_MASK,
-			hw_ctxt[1]));
-	ctxt->evt_pnd =
-		(uint8_t)(FIELD_GET(QDMA_HW_CTXT_W1_EVENT_PEND_MASK,
-			hw_ctxt[1]));
-	ctxt->fetch_pnd = (uint8_t)
-		(FIELD_GET(QDMA_HW_CTXT_W1_FETCH_PEND_MASK, hw_ctxt[1]));
-
-	qdma_log_debug("%s: cidx=%hu, crd_use=%hu, dsc_pend=%x\n",
-			__func__, ctxt->cidx, ctxt->crd_use, ctxt->dsc_pend);
-	qdma_log_debug("%s: idl_stp_b=%x, evt_pnd=%x, fetch_pnd=%x\n",
-			__func__, ctxt->idl_stp_b, ctxt->evt_pnd,
-			ctxt->fetch_pnd);
+	qdma_hw_context_decode(hw_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -3553,6 +3621,19 @@ int qdma_hw_ctx_conf(void *dev_hndl, uint8_t c2h, uint16_t hw_qid,
 	return rv;
 }
 
+/*
+ * qdma_credit_context_decode() - Helper function to decode credit context
+ *                               words into structure
+ *
+ */
+static void qdma_credit_context_decode(const uint32_t *cr_ctxt,
+		struct qdma_descq_credit_ctxt *ctxt)
+{
+	ctxt->credit = FIELD_GET(QDMA_CR_CTXT_W0_CREDT_MASK, cr_ctxt[0]);
+
+	qdma_log_debug("%s: credit=%u\n", __func__, ctxt->credit);
+}
+
 /*****************************************************************************/
 /**
  * qdma_credit_context_read() - read credit context
@@ -3585,9 +3666,7 @@ static int qdma_credit_context_read(void *dev_hndl, uint8_t c2h,
 	if (rv < 0)
 		return rv;
 
-	ctxt->credit = FIELD_GET(QDMA_CR_CTXT_W0_CREDT_MASK, cr_ctxt[0]);
-
-	qdma_log_debug("%s: credit=%u\n", __func__, ctxt->credit);
+	qdma_credit_context_decode(cr_ctxt, ctxt);
 
 	return QDMA_SUCCESS;
 }
@@ -5099,6 +5178,131 @@ int qdma_soft_read_dump_queue_context(void *dev_hndl,
 
 	return rv;
 }
+
+/*****************************************************************************/
+/**
+ * qdma_soft_read_queue_context_raw() - Function to read the contexts of a queue
+ * into a raw snapshot, without decoding them
+ *
+ * @dev_hndl:   device handle
+ * @func_id:	function id for the fmap context
+ * @qid_hw:     queue id
+ * @st:		Queue Mode(ST or MM)
+ * @q_type:	Queue type(H2C/C2H/CMPT)
+ * @raw:	snapshot to be filled
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_soft_read_queue_context_raw(void *dev_hndl,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw)
+{
+	/* words per enum qdma_ctxt_raw_type */
+	static const uint32_t num_words[QDMA_CTXT_RAW_MAX] = {
+		QDMA_SW_CONTEXT_NUM_WORDS,
+		QDMA_HW_CONTEXT_NUM_WORDS,
+		QDMA_CR_CONTEXT_NUM_WORDS,
+		QDMA_PFETCH_CONTEXT_NUM_WORDS,
+		QDMA_CMPT_CONTEXT_NUM_WORDS,
+		QDMA_FMAP_NUM_WORDS,
+		0
+	};
+
+	return qdma_read_queue_context_raw(dev_hndl, qdma_indirect_reg_read,
+			num_words, func_id, qid_hw, st, q_type, raw);
+}
+
+/*****************************************************************************/
+/**
+ * qdma_soft_decode_queue_context_raw() - Function to decode a queue context
+ * snapshot taken by qdma_soft_read_queue_context_raw()
+ *
+ * @raw:	queue context snapshot
+ * @ctxt:	decoded context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_soft_decode_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt)
+{
+	if (!raw || !ctxt) {
+		qdma_log_error("%s: raw or ctxt is NULL, err:%d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	qdma_memset(ctxt, 0, sizeof(struct qdma_descq_context));
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_SW))
+		qdma_sw_context_decode(raw->data[QDMA_CTXT_RAW_SW],
+				&ctxt->sw_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_HW))
+		qdma_hw_context_decode(raw->data[QDMA_CTXT_RAW_HW],
+				&ctxt->hw_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_CR))
+		qdma_credit_context_decode(raw->data[QDMA_CTXT_RAW_CR],
+				&ctxt->cr_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_PFETCH))
+		qdma_pfetch_context_decode(raw->data[QDMA_CTXT_RAW_PFETCH],
+				&ctxt->pfetch_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_CMPT))
+		qdma_cmpt_context_decode(raw->data[QDMA_CTXT_RAW_CMPT],
+				&ctxt->cmpt_ctxt);
+	if (QDMA_CTXT_RAW_VALID(raw, QDMA_CTXT_RAW_FMAP))
+		qdma_fmap_decode(raw->data[QDMA_CTXT_RAW_FMAP],
+				&ctxt->fmap);
+
+	return QDMA_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * qdma_soft_dump_queue_context_raw() - Function to decode a queue context
+ * snapshot into a buffer
+ *
+ * @raw:	queue context snapshot
+ * @buf :       pointer to buffer to be filled
+ * @buflen :    Length of the buffer
+ *
+ * Return:	Length up-till the buffer is filled -success and < 0 - failure
+ *****************************************************************************/
+int qdma_soft_dump_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen)
+{
+	struct qdma_descq_context context;
+	uint32_t req_buflen = 0;
+	int rv;
+
+	if (!raw || !buf) {
+		qdma_log_error("%s: raw or buf is NULL, err:%d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	if (raw->q_type >= QDMA_DEV_Q_TYPE_MAX) {
+		qdma_log_error("%s: Not supported for q_type, err = %d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_soft_context_buf_len(raw->st,
+			(enum qdma_dev_q_type)raw->q_type, &req_buflen);
+	if (rv != QDMA_SUCCESS)
+		return rv;
+
+	if (buflen < req_buflen) {
+		qdma_log_error("%s: Too small buffer(%d), reqd(%d), err:%d\n",
+			__func__, buflen, req_buflen, -QDMA_ERR_NO_MEM);
+		return -QDMA_ERR_NO_MEM;
+	}
+
+	qdma_soft_decode_queue_context_raw(raw, &context);
+
+	return dump_soft_context(&context, raw->st,
+			(enum qdma_dev_q_type)raw->q_type, buf, buflen);
+}
 /*****************************************************************************/
 /**
  * qdma_is_legacy_intr_pend() - function to get legacy_intr_pending status bit
@@ -5191,6 +5395,7 @@ int qdma_init_ctxt_memory(void *dev_hndl)
 	uint32_t data[QDMA_REG_IND_CTXT_REG_COUNT];
 	uint16_t i = 0;
 	struct qdma_dev_attributes dev_info;
+	int rv;
 
 	if (!dev_hndl) {
 		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
@@ -5201,9 +5406,13 @@ int qdma_init_ctxt_memory(void *dev_hndl)
 	qdma_memset(data, 0, sizeof(uint32_t) * QDMA_REG_IND_CTXT_REG_COUNT);
 	qdma_get_device_attributes(dev_hndl, &dev_info);
 
+	/* queue up the clear commands instead of waiting for each one */
+	rv = qdma_ctxt_batch_start(dev_hndl);
+	if (rv < 0)
+		return rv;
+
 	for (; i < dev_info.num_qs; i++) {
 		int sel = QDMA_CTXT_SEL_SW_C2H;
-		int rv;
 
 		for (; sel <= QDMA_CTXT_SEL_PFTCH; sel++) {
 			/** if the st mode(h2c/c2h) not enabled
@@ -5221,8 +5430,10 @@ int qdma_init_ctxt_memory(void *dev_hndl)
 
 			rv = qdma_indirect_reg_clear(dev_hndl,
 					(enum ind_ctxt_cmd_sel)sel, i);
-			if (rv < 0)
+			if (rv < 0) {
+				qdma_ctxt_batch_end(dev_hndl);
 				return rv;
+			}
 		}
 	}
 
@@ -5231,6 +5442,9 @@ int qdma_init_ctxt_memory(void *dev_hndl)
 		qdma_indirect_reg_clear(dev_hndl,
 				QDMA_CTXT_SEL_FMAP, i);
 
+	rv = qdma_ctxt_batch_end(dev_hndl);
+	if (rv < 0)
+		return rv;
 #else
 	if (!dev_hndl) {
 		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
@@ -32,6 +32,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <rte_malloc.h>
 #include <rte_common.h>
 #include <rte_ethdev_pci.h>
@@ -112,31 +113,27 @@ void qdma_pci_write_reg(struct rte_eth_dev *dev, uint32_t bar,
 
 void qdma_reset_rx_queue(struct qdma_rx_queue *rxq)
 {
-	uint32_t i;
 	uint32_t sz;
 
 	rxq->rx_tail = 0;
 	rxq->q_pidx_info.pidx = 0;
 
-	/* Zero out HW ring memory, For MM Descriptor */
+	/* Zero out HW ring memory, For MM Descriptor. The queue contexts
+	 * are cleared, so the device does not access the rings here.
+	 */
 	if (rxq->st_mode) {  /** if ST-mode **/
 		sz = rxq->cmpt_desc_len;
-		for (i = 0; i < (sz * rxq->nb_rx_cmpt_desc); i++)
-			((volatile char *)rxq->cmpt_ring)[i] = 0;
+		memset(rxq->cmpt_ring, 0, sz * rxq->nb_rx_cmpt_desc);
 
 		sz = sizeof(struct qdma_ul_st_c2h_desc);
-		for (i = 0; i < (sz * rxq->nb_rx_desc); i++)
-			((volatile char *)rxq->rx_ring)[i] = 0;
-
+		memset(rxq->rx_ring, 0, sz * rxq->nb_rx_desc);
 	} else {
 		sz = sizeof(struct qdma_ul_mm_desc);
-		for (i = 0; i < (sz * rxq->nb_rx_desc); i++)
-			((volatile char *)rxq->rx_ring)[i] = 0;
+		memset(rxq->rx_ring, 0, sz * rxq->nb_rx_desc);
 	}
 
 	/* Initialize SW ring entries */
-	for (i = 0; i < rxq->nb_rx_desc; i++)
-		rxq->sw_ring[i] = NULL;
+	memset(rxq->sw_ring, 0, rxq->nb_rx_desc * sizeof(*rxq->sw_ring));
 }
 
 void qdma_inv_rx_queue_ctxts(struct rte_eth_dev *dev,
@@ -260,25 +257,18 @@ fail:
  */
 void qdma_reset_tx_queue(struct qdma_tx_queue *txq)
 {
-	uint32_t i;
 	uint32_t sz;
 
 	txq->tx_fl_tail = 0;
-	if (txq->st_mode) {  /** ST-mode **/
+	if (txq->st_mode)  /** ST-mode **/
 		sz = sizeof(struct qdma_ul_st_h2c_desc);
-		/* Zero out HW ring memory */
-		for (i = 0; i < (sz * (txq->nb_tx_desc)); i++)
-			((volatile char *)txq->tx_ring)[i] = 0;
-	} else {
+	else
 		sz = sizeof(struct qdma_ul_mm_desc);
-		/* Zero out HW ring memory */
-		for (i = 0; i < (sz * (txq->nb_tx_desc)); i++)
-			((volatile char *)txq->tx_ring)[i] = 0;
-	}
+	/* Zero out HW ring memory */
+	memset(txq->tx_ring, 0, sz * txq->nb_tx_desc);
 
 	/* Initialize SW ring entries */
-	for (i = 0; i < txq->nb_tx_desc; i++)
-		txq->sw_ring[i] = NULL;
+	memset(txq->sw_ring, 0, txq->nb_tx_desc * sizeof(*txq->sw_ring));
 }
 
 void qdma_inv_tx_queue_ctxts(struct rte_eth_dev *dev,
@@ -329,6 +319,136 @@ void qdma_clr_tx_queue_ctxts(struct rte_eth_dev *dev,
 	}
 }
 
+/**
+ * Set up the Rx queue interrupts requested through intr_conf.rxq.
+ *
+ * Each Rx queue gets an eventfd backed MSI-X vector, starting after the
+ * vector 0 used by the mailbox. Queues share vectors when the device runs
+ * out of them. Called at device start, before starting the queues.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ *
+ * @return
+ *   0 on success, negative errno value on failure.
+ */
+int qdma_rx_intr_setup(struct rte_eth_dev *dev)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct rte_intr_handle *intr_handle = dev->intr_handle;
+	uint32_t nb_vec, qid;
+
+	if (!dev->data->dev_conf.intr_conf.rxq ||
+			rte_intr_dp_is_en(intr_handle))
+		return 0;
+
+	if (!rte_intr_cap_multiple(intr_handle)) {
+		PMD_DRV_LOG(ERR, "%s-%d(DEVFN) Rx interrupts need MSI-X "
+				"vectors through VFIO\n",
+				qdma_dev->is_vf ? "VF" : "PF",
+				qdma_dev->func_id);
+		return -ENOTSUP;
+	}
+
+	nb_vec = RTE_MIN(dev->data->nb_rx_queues,
+			(uint32_t)RTE_MAX_RXTX_INTR_VEC_ID);
+
+	/* The MSI-X vector set can not grow while enabled */
+	if (qdma_dev->dev_cap.mailbox_intr)
+		rte_intr_disable(intr_handle);
+
+	if (rte_intr_efd_enable(intr_handle, nb_vec) != 0)
+		goto err_out;
+
+	intr_handle->intr_vec = rte_zmalloc("qdma_intr_vec",
+			dev->data->nb_rx_queues * sizeof(int), 0);
+	if (!intr_handle->intr_vec) {
+		rte_intr_efd_disable(intr_handle);
+		goto err_out;
+	}
+
+	for (qid = 0; qid < dev->data->nb_rx_queues; qid++)
+		intr_handle->intr_vec[qid] = RTE_INTR_VEC_RXTX_OFFSET +
+				(qid % intr_handle->nb_efd);
+
+	if (rte_intr_enable(intr_handle) != 0) {
+		qdma_rx_intr_teardown(dev);
+		return -EIO;
+	}
+
+	PMD_DRV_LOG(INFO, "%s-%d(DEVFN) %u Rx interrupt vectors enabled\n",
+			qdma_dev->is_vf ? "VF" : "PF", qdma_dev->func_id,
+			intr_handle->nb_efd);
+	return 0;
+
+err_out:
+	PMD_DRV_LOG(ERR, "%s-%d(DEVFN) Failed to set up %u Rx interrupt "
+			"vectors\n", qdma_dev->is_vf ? "VF" : "PF",
+			qdma_dev->func_id, nb_vec);
+	if (qdma_dev->dev_cap.mailbox_intr)
+		rte_intr_enable(intr_handle);
+	return -ENOMEM;
+}
+
+/**
+ * Release the Rx queue interrupts, called at device stop once the queues
+ * are stopped. The mailbox and error interrupts are left enabled.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ */
+void qdma_rx_intr_teardown(struct rte_eth_dev *dev)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct rte_intr_handle *intr_handle = dev->intr_handle;
+
+	if (!rte_intr_dp_is_en(intr_handle))
+		return;
+
+	rte_intr_disable(intr_handle);
+	rte_intr_efd_disable(intr_handle);
+	rte_free(intr_handle->intr_vec);
+	intr_handle->intr_vec = NULL;
+
+	if (qdma_dev->dev_cap.mailbox_intr)
+		rte_intr_enable(intr_handle);
+}
+
+/**
+ * Get the MSI-X vector of a Rx queue and mark the queue for interrupts.
+ * Only ST queues, whose completion ring raises the interrupt, are
+ * supported.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ * @param rxq
+ *   Pointer to Rx queue specific data structure.
+ * @param qid
+ *   Rx queue index.
+ *
+ * @return
+ *   MSI-X vector to program in the queue contexts.
+ */
+uint16_t qdma_rx_intr_vec(struct rte_eth_dev *dev,
+		struct qdma_rx_queue *rxq, uint16_t qid)
+{
+	struct rte_intr_handle *intr_handle = dev->intr_handle;
+
+	rxq->en_intr = 0;
+	rxq->cmpt_cidx_info.irq_en = 0;
+	if (!rxq->st_mode || !rte_intr_dp_is_en(intr_handle) ||
+			!intr_handle->intr_vec)
+		return 0;
+
+	if (rxq->triggermode == RTE_PMD_QDMA_TRIG_MODE_DISABLE)
+		PMD_DRV_LOG(WARNING, "Rx queue %u: completion trigger mode "
+				"is disabled, no interrupt will be raised\n",
+				qid);
+
+	rxq->en_intr = 1;
+	return intr_handle->intr_vec[qid];
+}
+
 /* Utility function to find index of an element in an array */
 int index_of_array(uint32_t *arr, uint32_t n, uint32_t element)
 {
@@ -341,6 +461,20 @@ int index_of_array(uint32_t *arr, uint32_t n, uint32_t element)
 	return -1;
 }
 
+/* Find the index of the largest non zero element not above limit */
+int qdma_c2h_buf_sz_fit(uint32_t *arr, uint32_t n, uint32_t limit)
+{
+	int index, fit = -1;
+
+	for (index = 0; (uint32_t)index < n; index++) {
+		if (!arr[index] || (arr[index] > limit))
+			continue;
+		if ((fit < 0) || (arr[index] > arr[fit]))
+			fit = index;
+	}
+	return fit;
+}
+
 static int pfetch_check_handler(__rte_unused const char *key,
 					const char *value,  void *opaque)
 {
@@ -453,6 +587,48 @@ static int h2c_byp_mode_check_handler(__rte_unused const char *key,
 
 	return 0;
 }
+static int burst_cycles_handler(__rte_unused const char *key,
+					const char *value,  void *opaque)
+{
+	struct qdma_pci_dev *qdma_dev = (struct qdma_pci_dev *)opaque;
+	char *end = NULL;
+	uint8_t burst_cycles;
+
+	PMD_DRV_LOG(INFO, "QDMA devargs burst_cycles is: %s\n", value);
+	burst_cycles = (uint8_t)strtoul(value, &end, 10);
+
+	if (burst_cycles > 1) {
+		PMD_DRV_LOG(INFO, "QDMA devargs incorrect"
+				" burst_cycles =%d specified\n",
+					burst_cycles);
+		return -1;
+	}
+	qdma_dev->burst_cycles = burst_cycles;
+
+	return 0;
+}
+
+static int err_poll_ms_handler(__rte_unused const char *key,
+					const char *value,  void *opaque)
+{
+	struct qdma_pci_dev *qdma_dev = (struct qdma_pci_dev *)opaque;
+	char *end = NULL;
+	unsigned long err_poll_ms;
+
+	PMD_DRV_LOG(INFO, "QDMA devargs err_poll_ms is: %s\n", value);
+	err_poll_ms = strtoul(value, &end, 10);
+
+	if (err_poll_ms > MAX_ERR_POLL_MS) {
+		PMD_DRV_LOG(INFO, "QDMA devargs incorrect"
+				" err_poll_ms =%lu specified\n",
+					err_poll_ms);
+		return -1;
+	}
+	qdma_dev->err_poll_ms = (uint32_t)err_poll_ms;
+
+	return 0;
+}
+
 #ifdef TANDEM_BOOT_SUPPORTED
 static int en_st_mode_check_handler(__rte_unused const char *key,
 					const char *value,  void *opaque)
@@ -484,6 +660,8 @@ int qdma_check_kvargs(struct rte_devargs *devargs,
 	const char *config_bar_key    = "config_bar";
 	const char *c2h_byp_mode_key  = "c2h_byp_mode";
 	const char *h2c_byp_mode_key  = "h2c_byp_mode";
+	const char *burst_cycles_key  = "burst_cycles";
+	const char *err_poll_ms_key   = "err_poll_ms";
 #ifdef TANDEM_BOOT_SUPPORTED
 	const char *en_st_key         = "en_st";
 #endif
@@ -556,6 +734,26 @@ int qdma_check_kvargs(struct rte_devargs *devargs,
 		}
 	}
 
+	/* process burst_cycles*/
+	if (rte_kvargs_count(kvlist, burst_cycles_key)) {
+		ret = rte_kvargs_process(kvlist, burst_cycles_key,
+					  burst_cycles_handler, qdma_dev);
+		if (ret) {
+			rte_kvargs_free(kvlist);
+			return ret;
+		}
+	}
+
+	/* process err_poll_ms*/
+	if (rte_kvargs_count(kvlist, err_poll_ms_key)) {
+		ret = rte_kvargs_process(kvlist, err_poll_ms_key,
+					  err_poll_ms_handler, qdma_dev);
+		if (ret) {
+			rte_kvargs_free(kvlist);
+			return ret;
+		}
+	}
+
 #ifdef TANDEM_BOOT_SUPPORTED
 	/* Enable ST */
 	if (rte_kvargs_count(kvlist, en_st_key)) {
@@ -657,3 +855,49 @@ int qdma_get_hw_version(struct rte_eth_dev *dev)
 
 	return 0;
 }
+
+/**
+ * Set up the per-process data of a port, in the primary once the device
+ * is initialized and in each secondary process at probe.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ *
+ * @return
+ *   0 on success, negative errno value on failure.
+ */
+int qdma_proc_private_init(struct rte_eth_dev *dev)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct rte_pci_device *pci_dev = RTE_ETH_DEV_TO_PCI(dev);
+	struct qdma_proc_private *proc;
+	int ret;
+
+	proc = rte_zmalloc("qdma_proc_private", sizeof(*proc), 0);
+	if (!proc)
+		return -ENOMEM;
+
+	proc->db_base = pci_dev->mem_resource[qdma_dev->config_bar_idx].addr;
+	if (!proc->db_base) {
+		PMD_DRV_LOG(ERR, "%s-%d(DEVFN) config BAR %d is not mapped\n",
+				qdma_dev->is_vf ? "VF" : "PF",
+				qdma_dev->func_id, qdma_dev->config_bar_idx);
+		rte_free(proc);
+		return -ENODEV;
+	}
+
+	ret = qdma_hw_access_init(dev, qdma_dev->is_vf, &proc->hw_access);
+	if (ret < 0) {
+		rte_free(proc);
+		return -EINVAL;
+	}
+
+	dev->process_private = proc;
+	return 0;
+}
+
+void qdma_proc_private_uninit(struct rte_eth_dev *dev)
+{
+	rte_free(dev->process_private);
+	dev->process_private = NULL;
+}
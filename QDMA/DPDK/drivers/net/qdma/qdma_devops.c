@@ -56,6 +56,11 @@
 #include "qdma_platform.h"
 #include "qdma_devops.h"
 
+static int qdma_txq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid);
+static void qdma_txq_arm(struct rte_eth_dev *dev, uint16_t qid);
+static int qdma_rxq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid);
+static void qdma_rxq_arm(struct rte_eth_dev *dev, uint16_t qid);
+
 #ifdef QDMA_LATENCY_OPTIMIZED
 static void qdma_sort_c2h_cntr_th_values(struct qdma_pci_dev *qdma_dev)
 {
@@ -410,6 +415,8 @@ int qdma_dev_rx_queue_setup(struct rte_eth_dev *dev, uint16_t rx_queue_id,
 		return -ENOTSUP;
 	}
 	rxq->triggermode = qdma_dev->q_info[rx_queue_id].trigger_mode;
+	rxq->copy_pool = qdma_dev->q_info[rx_queue_id].rx_copy_pool;
+	rxq->copy_len = qdma_dev->q_info[rx_queue_id].rx_copy_len;
 	rxq->rx_deferred_start = rx_conf->rx_deferred_start;
 	rxq->dump_immediate_data =
 			qdma_dev->q_info[rx_queue_id].immediate_data_state;
@@ -560,16 +567,29 @@ int qdma_dev_rx_queue_setup(struct rte_eth_dev *dev, uint16_t rx_queue_id,
 			err = -EINVAL;
 			goto rx_setup_err;
 		}
-		/* Find Buffer size index */
-		rxq->buffszidx = index_of_array(qdma_dev->g_c2h_buf_sz,
+		/* Find Buffer size index, the largest C2H buffer size
+		 * that fits in the mbuf data room. A pool sized for the
+		 * largest packets then receives them in a single mbuf.
+		 */
+		rxq->buffszidx = qdma_c2h_buf_sz_fit(qdma_dev->g_c2h_buf_sz,
 						QDMA_NUM_C2H_BUFFER_SIZES,
 						rxq->rx_buff_size);
 		if (rxq->buffszidx < 0) {
-			PMD_DRV_LOG(ERR, "Expected buffer size %d not found\n",
+			PMD_DRV_LOG(ERR, "No buffer size fits in %d bytes\n",
 					rxq->rx_buff_size);
 			err = -EINVAL;
 			goto rx_setup_err;
 		}
+		if (qdma_dev->g_c2h_buf_sz[rxq->buffszidx] !=
+				rxq->rx_buff_size)
+			PMD_DRV_LOG(INFO, "Rx queue %d: using buffer size "
+				"%d of %d bytes data room\n", rx_queue_id,
+				qdma_dev->g_c2h_buf_sz[rxq->buffszidx],
+				rxq->rx_buff_size);
+		rxq->rx_buff_size =
+			(uint16_t)qdma_dev->g_c2h_buf_sz[rxq->buffszidx];
+		if (rxq->copy_len > rxq->rx_buff_size)
+			rxq->copy_len = rxq->rx_buff_size;
 
 		if (rxq->en_bypass &&
 		     (rxq->bypass_desc_sz != 0))
@@ -656,6 +676,7 @@ int qdma_dev_rx_queue_setup(struct rte_eth_dev *dev, uint16_t rx_queue_id,
 
 	qdma_rxq_default_mbuf_init(rxq);
 
+	qdma_set_rx_burst(rxq);
 	dev->data->rx_queues[rx_queue_id] = rxq;
 
 	return 0;
@@ -777,6 +798,11 @@ int qdma_dev_tx_queue_setup(struct rte_eth_dev *dev, uint16_t tx_queue_id,
 	txq->func_id = qdma_dev->func_id;
 	txq->num_queues = dev->data->nb_tx_queues;
 	txq->tx_deferred_start = tx_conf->tx_deferred_start;
+	txq->offloads = tx_conf->offloads | dev->data->dev_conf.txmode.offloads;
+	txq->tx_free_thresh = tx_conf->tx_free_thresh ?
+			tx_conf->tx_free_thresh : DEFAULT_TX_FREE_THRESHOLD;
+	if (txq->tx_free_thresh > (nb_tx_desc - 1))
+		txq->tx_free_thresh = nb_tx_desc - 1;
 
 	txq->ringszidx = index_of_array(qdma_dev->g_ring_sz,
 					QDMA_NUM_RING_SIZES, txq->nb_tx_desc);
@@ -898,7 +924,9 @@ int qdma_dev_tx_queue_setup(struct rte_eth_dev *dev, uint16_t tx_queue_id,
 		goto tx_setup_err;
 	}
 
-	rte_spinlock_init(&txq->pidx_update_lock);
+	txq->pidx_flush_cycles = (rte_get_tsc_hz() * QDMA_TXQ_PIDX_FLUSH_US) /
+			US_PER_S;
+	qdma_set_tx_burst(txq);
 	dev->data->tx_queues[tx_queue_id] = txq;
 
 	return 0;
@@ -922,35 +950,6 @@ tx_setup_err:
 	return err;
 }
 
-#if (MIN_TX_PIDX_UPDATE_THRESHOLD > 1)
-void qdma_txq_pidx_update(void *arg)
-{
-	struct rte_eth_dev *dev = (struct rte_eth_dev *)arg;
-	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
-	struct qdma_tx_queue *txq;
-	uint32_t qid;
-
-	for (qid = 0; qid < dev->data->nb_tx_queues; qid++) {
-		txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
-		if (txq->tx_desc_pend) {
-			rte_spinlock_lock(&txq->pidx_update_lock);
-			if (txq->tx_desc_pend) {
-				qdma_dev->hw_access->qdma_queue_pidx_update(dev,
-					qdma_dev->is_vf,
-					qid, 0, &txq->q_pidx_info);
-
-				txq->tx_desc_pend = 0;
-			}
-			rte_spinlock_unlock(&txq->pidx_update_lock);
-		}
-	}
-	rte_eal_alarm_set(QDMA_TXQ_PIDX_UPDATE_INTERVAL,
-			qdma_txq_pidx_update, (void *)arg);
-}
-#endif
-
-
-
 void qdma_dev_tx_queue_release(void *tqueue)
 {
 	struct qdma_tx_queue *txq = (struct qdma_tx_queue *)tqueue;
@@ -1035,40 +1034,73 @@ void qdma_dev_rx_queue_release(void *rqueue)
  */
 int qdma_dev_start(struct rte_eth_dev *dev)
 {
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_hw_access *hw_access = qdma_dev->hw_access;
 	struct qdma_tx_queue *txq;
 	struct qdma_rx_queue *rxq;
+	uint64_t start_tsc, ctxt_tsc;
 	uint32_t qid;
-	int err;
+	int err, batch_err;
 
 	PMD_DRV_LOG(INFO, "qdma-dev-start: Starting\n");
 
-	/* prepare descriptor rings for operation */
-	for (qid = 0; qid < dev->data->nb_tx_queues; qid++) {
+	start_tsc = rte_get_timer_cycles();
+
+	err = qdma_rx_intr_setup(dev);
+	if (err != 0)
+		return err;
+
+	/* Program the contexts of all the queues started here as a single
+	 * batch, so that the indirect context commands are not waited for
+	 * one by one. No queue is armed before the batch has completed.
+	 */
+	err = hw_access->qdma_ctxt_batch_start(dev);
+	if (err < 0)
+		return hw_access->qdma_get_error_code(err);
+
+	for (qid = 0; (err == 0) && (qid < dev->data->nb_tx_queues); qid++) {
 		txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
 
 		/*Deferred Queues should not start with dev_start*/
-		if (!txq->tx_deferred_start) {
-			err = qdma_dev_tx_queue_start(dev, qid);
-			if (err != 0)
-				return err;
-		}
+		if (!txq->tx_deferred_start)
+			err = qdma_txq_ctxt_program(dev, qid);
 	}
 
-	for (qid = 0; qid < dev->data->nb_rx_queues; qid++) {
+	for (qid = 0; (err == 0) && (qid < dev->data->nb_rx_queues); qid++) {
 		rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
 
 		/*Deferred Queues should not start with dev_start*/
-		if (!rxq->rx_deferred_start) {
-			err = qdma_dev_rx_queue_start(dev, qid);
-			if (err != 0)
-				return err;
-		}
+		if (!rxq->rx_deferred_start)
+			err = qdma_rxq_ctxt_program(dev, qid);
 	}
 
-#if (MIN_TX_PIDX_UPDATE_THRESHOLD > 1)
-	rte_eal_alarm_set(QDMA_TXQ_PIDX_UPDATE_INTERVAL,
-			qdma_txq_pidx_update, (void *)dev);
-#endif
+	batch_err = hw_access->qdma_ctxt_batch_end(dev);
+	if (!err && (batch_err < 0))
+		err = hw_access->qdma_get_error_code(batch_err);
+	if (err != 0)
+		return err;
+
+	ctxt_tsc = rte_get_timer_cycles();
+
+	for (qid = 0; qid < dev->data->nb_tx_queues; qid++) {
+		txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
+		if (!txq->tx_deferred_start)
+			qdma_txq_arm(dev, qid);
+	}
+
+	for (qid = 0; qid < dev->data->nb_rx_queues; qid++) {
+		rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
+		if (!rxq->rx_deferred_start)
+			qdma_rxq_arm(dev, qid);
+	}
+
+	qdma_dev->start_ctxt_us = qdma_timer_cycles_to_us(ctxt_tsc - start_tsc);
+	qdma_dev->start_us =
+		qdma_timer_cycles_to_us(rte_get_timer_cycles() - start_tsc);
+	PMD_DRV_LOG(INFO, "qdma-dev-start: Started in %lu us "
+			"(contexts %lu us)\n",
+			qdma_dev->start_us, qdma_dev->start_ctxt_us);
+
 	return 0;
 }
 
@@ -1110,6 +1142,10 @@ int qdma_dev_infos_get(struct rte_eth_dev *dev,
 	dev_info->max_rx_pktlen = DMA_BRAM_SIZE;
 	dev_info->max_mac_addrs = 1;
 
+	dev_info->tx_queue_offload_capa = DEV_TX_OFFLOAD_MBUF_FAST_FREE;
+	dev_info->tx_offload_capa = dev_info->tx_queue_offload_capa;
+	dev_info->default_txconf.tx_free_thresh = DEFAULT_TX_FREE_THRESHOLD;
+
 	return 0;
 }
 
@@ -1136,11 +1172,7 @@ int qdma_dev_stop(struct rte_eth_dev *dev)
 		qdma_dev_tx_queue_stop(dev, qid);
 	for (qid = 0; qid < dev->data->nb_rx_queues; qid++)
 		qdma_dev_rx_queue_stop(dev, qid);
-
-#if (MIN_TX_PIDX_UPDATE_THRESHOLD > 1)
-	/* Cancel pending PIDX updates */
-	rte_eal_alarm_cancel(qdma_txq_pidx_update, (void *)dev);
-#endif
+	qdma_rx_intr_teardown(dev);
 
 	return 0;
 }
@@ -1262,7 +1294,7 @@ int qdma_dev_close(struct rte_eth_dev *dev)
 
 	/* cancel pending polls*/
 	if (qdma_dev->is_master)
-		rte_eal_alarm_cancel(qdma_check_errors, (void *)dev);
+		qdma_error_monitor_stop(dev);
 
 	return 0;
 }
@@ -1480,7 +1512,8 @@ int qdma_dev_configure(struct rte_eth_dev *dev)
 	return 0;
 }
 
-int qdma_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+/* Reset a Tx queue and program its contexts, the queue stays stopped */
+static int qdma_txq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid)
 {
 	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
 	struct qdma_tx_queue *txq;
@@ -1496,6 +1529,7 @@ int qdma_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 	bypass_desc_sz_idx = qmda_get_desc_sz_idx(txq->bypass_desc_sz);
 
 	qdma_reset_tx_queue(txq);
+	txq->vec_path = qdma_get_vec_path();
 	qdma_clr_tx_queue_ctxts(dev, (qid + queue_base), txq->st_mode);
 
 	if (txq->st_mode) {
@@ -1524,22 +1558,74 @@ int qdma_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 	if (err < 0)
 		return qdma_dev->hw_access->qdma_get_error_code(err);
 
+	return 0;
+}
+
+/* Start a Tx queue whose contexts are programmed */
+static void qdma_txq_arm(struct rte_eth_dev *dev, uint16_t qid)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_tx_queue *txq;
+
+	txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
+
 	txq->q_pidx_info.pidx = 0;
-	hw_access->qdma_queue_pidx_update(dev, qdma_dev->is_vf,
+	qdma_dev->hw_access->qdma_queue_pidx_update(dev, qdma_dev->is_vf,
 		qid, 0, &txq->q_pidx_info);
 
 	dev->data->tx_queue_state[qid] = RTE_ETH_QUEUE_STATE_STARTED;
 	txq->status = RTE_ETH_QUEUE_STATE_STARTED;
+	qdma_set_tx_burst(txq);
+}
+
+/*
+ * Run the context commands issued by prog as one batch, see
+ * qdma_ctxt_batch_start(). The batch completes before returning.
+ */
+static int qdma_queue_ctxt_batch(struct rte_eth_dev *dev,
+		int (*prog)(struct rte_eth_dev *dev, uint16_t qid),
+		uint16_t qid)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_hw_access *hw_access = qdma_dev->hw_access;
+	int err, batch_err;
+
+	err = hw_access->qdma_ctxt_batch_start(dev);
+	if (err < 0)
+		return hw_access->qdma_get_error_code(err);
+
+	err = prog(dev, qid);
+
+	batch_err = hw_access->qdma_ctxt_batch_end(dev);
+	if (!err && (batch_err < 0))
+		err = hw_access->qdma_get_error_code(batch_err);
+
+	return err;
+}
+
+int qdma_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+{
+	int err;
+
+	err = qdma_queue_ctxt_batch(dev, qdma_txq_ctxt_program, qid);
+	if (err != 0)
+		return err;
+
+	qdma_txq_arm(dev, qid);
 	return 0;
 }
 
 
-int qdma_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+/* Reset an Rx queue, fill its ring and program its contexts, the queue
+ * stays stopped
+ */
+static int qdma_rxq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid)
 {
 	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
 	struct qdma_rx_queue *rxq;
 	uint32_t queue_base =  qdma_dev->queue_base;
 	uint8_t cmpt_desc_fmt;
+	uint16_t intr_vec;
 	int err, bypass_desc_sz_idx;
 	struct qdma_descq_sw_ctxt q_sw_ctxt;
 	struct qdma_descq_cmpt_ctxt q_cmpt_ctxt;
@@ -1551,6 +1637,8 @@ int qdma_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 	memset(&q_sw_ctxt, 0, sizeof(struct qdma_descq_sw_ctxt));
 
 	qdma_reset_rx_queue(rxq);
+	rxq->vec_path = qdma_get_vec_path();
+	intr_vec = qdma_rx_intr_vec(dev, rxq, qid);
 	qdma_clr_rx_queue_ctxts(dev, (qid + queue_base), rxq->st_mode);
 
 	bypass_desc_sz_idx = qmda_get_desc_sz_idx(rxq->bypass_desc_sz);
@@ -1602,7 +1690,11 @@ int qdma_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 		q_cmpt_ctxt.valid = 1;
 		if (qdma_dev->dev_cap.cmpt_ovf_chk_dis)
 			q_cmpt_ctxt.ovf_chk_dis = rxq->dis_overflow_check;
-
+		/* Direct interrupt, armed by rx_queue_intr_enable */
+		if (rxq->en_intr) {
+			q_cmpt_ctxt.en_int = 1;
+			q_cmpt_ctxt.vec = intr_vec;
+		}
 
 		q_sw_ctxt.desc_sz = SW_DESC_CNTXT_C2H_STREAM_DMA;
 		q_sw_ctxt.frcd_en = 1;
@@ -1642,7 +1734,21 @@ int qdma_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 				&q_cmpt_ctxt, QDMA_HW_ACCESS_WRITE);
 		if (err < 0)
 			return qdma_dev->hw_access->qdma_get_error_code(err);
+	}
+
+	return 0;
+}
 
+/* Start an Rx queue whose contexts are programmed */
+static void qdma_rxq_arm(struct rte_eth_dev *dev, uint16_t qid)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_hw_access *hw_access = qdma_dev->hw_access;
+	struct qdma_rx_queue *rxq;
+
+	rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
+
+	if (rxq->st_mode) {
 		rte_wmb();
 		/* enable status desc , loading the triggermode,
 		 * thresidx and timeridx passed from the user
@@ -1663,6 +1769,18 @@ int qdma_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 
 	dev->data->rx_queue_state[qid] = RTE_ETH_QUEUE_STATE_STARTED;
 	rxq->status = RTE_ETH_QUEUE_STATE_STARTED;
+	qdma_set_rx_burst(rxq);
+}
+
+int qdma_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+{
+	int err;
+
+	err = qdma_queue_ctxt_batch(dev, qdma_rxq_ctxt_program, qid);
+	if (err != 0)
+		return err;
+
+	qdma_rxq_arm(dev, qid);
 	return 0;
 }
 
@@ -1677,6 +1795,7 @@ int qdma_dev_rx_queue_stop(struct rte_eth_dev *dev, uint16_t qid)
 	rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
 
 	rxq->status = RTE_ETH_QUEUE_STATE_STOPPED;
+	qdma_set_rx_burst(rxq);
 
 	/* Wait for queue to recv all packets. */
 	if (rxq->st_mode) {  /** ST-mode **/
@@ -1738,6 +1857,8 @@ int qdma_dev_tx_queue_stop(struct rte_eth_dev *dev, uint16_t qid)
 	txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
 
 	txq->status = RTE_ETH_QUEUE_STATE_STOPPED;
+	qdma_set_tx_burst(txq);
+	qdma_txq_pidx_flush(txq);
 	/* Wait for TXQ to send out all packets. */
 	while (txq->wb_status->cidx != txq->q_pidx_info.pidx) {
 		usleep(10);
@@ -1892,6 +2013,7 @@ int qdma_dev_stats_get(struct rte_eth_dev *dev,
 		rxq = (struct qdma_rx_queue *)dev->data->rx_queues[i];
 		eth_stats->ipackets += rxq->stats.pkts;
 		eth_stats->ibytes += rxq->stats.bytes;
+		eth_stats->rx_nombuf += rxq->xstats.mbuf_alloc_errors;
 	}
 
 	for (i = 0; i < RTE_ETHDEV_QUEUE_STAT_CNTRS; i++) {
@@ -1936,6 +2058,7 @@ int qdma_dev_stats_reset(struct rte_eth_dev *dev)
 			(struct qdma_rx_queue *)dev->data->rx_queues[i];
 		rxq->stats.pkts = 0;
 		rxq->stats.bytes = 0;
+		memset(&rxq->xstats, 0, sizeof(rxq->xstats));
 	}
 
 	for (i = 0; i < dev->data->nb_tx_queues; i++) {
@@ -1943,10 +2066,161 @@ int qdma_dev_stats_reset(struct rte_eth_dev *dev)
 			(struct qdma_tx_queue *)dev->data->tx_queues[i];
 		txq->stats.pkts = 0;
 		txq->stats.bytes = 0;
+		memset(&txq->xstats, 0, sizeof(txq->xstats));
 	}
 	return 0;
 }
 
+struct qdma_xstats_name_off {
+	char name[RTE_ETH_XSTATS_NAME_SIZE];
+	unsigned int offset;
+};
+
+static const struct qdma_xstats_name_off qdma_rx_xstats_strings[] = {
+	{"mbuf_alloc_errors",
+		offsetof(struct qdma_rx_xstats, mbuf_alloc_errors)},
+	{"empty_polls", offsetof(struct qdma_rx_xstats, empty_polls)},
+	{"cmpt_pending_max",
+		offsetof(struct qdma_rx_xstats, cmpt_pending_max)},
+	{"cmpt_pending_total",
+		offsetof(struct qdma_rx_xstats, cmpt_pending_total)},
+	{"cmpt_errors", offsetof(struct qdma_rx_xstats, cmpt_errors)},
+	{"pidx_updates", offsetof(struct qdma_rx_xstats, pidx_updates)},
+	{"cmpt_cidx_updates",
+		offsetof(struct qdma_rx_xstats, cmpt_cidx_updates)},
+	{"cntr_th_increments",
+		offsetof(struct qdma_rx_xstats, cntr_th_increments)},
+	{"cntr_th_decrements",
+		offsetof(struct qdma_rx_xstats, cntr_th_decrements)},
+	{"timed_bursts", offsetof(struct qdma_rx_xstats, timed_bursts)},
+	{"burst_cycles", offsetof(struct qdma_rx_xstats, burst_cycles)},
+	{"copied_pkts", offsetof(struct qdma_rx_xstats, copied_pkts)},
+	{"copy_alloc_errors",
+		offsetof(struct qdma_rx_xstats, copy_alloc_errors)},
+};
+#define QDMA_NB_RX_XSTATS RTE_DIM(qdma_rx_xstats_strings)
+
+static const struct qdma_xstats_name_off qdma_tx_xstats_strings[] = {
+	{"ring_full", offsetof(struct qdma_tx_xstats, ring_full)},
+	{"pkts_rejected", offsetof(struct qdma_tx_xstats, pkts_rejected)},
+	{"pidx_updates", offsetof(struct qdma_tx_xstats, pidx_updates)},
+	{"timed_bursts", offsetof(struct qdma_tx_xstats, timed_bursts)},
+	{"burst_cycles", offsetof(struct qdma_tx_xstats, burst_cycles)},
+};
+#define QDMA_NB_TX_XSTATS RTE_DIM(qdma_tx_xstats_strings)
+
+static const struct qdma_xstats_name_off qdma_dev_xstats_strings[] = {
+	{"dev_start_us", offsetof(struct qdma_pci_dev, start_us)},
+	{"dev_start_ctxt_us", offsetof(struct qdma_pci_dev, start_ctxt_us)},
+};
+#define QDMA_NB_DEV_XSTATS RTE_DIM(qdma_dev_xstats_strings)
+
+static unsigned int qdma_xstats_count(struct rte_eth_dev *dev)
+{
+	return QDMA_NB_DEV_XSTATS +
+		dev->data->nb_rx_queues * QDMA_NB_RX_XSTATS +
+		dev->data->nb_tx_queues * QDMA_NB_TX_XSTATS;
+}
+
+/**
+ * DPDK callback to retrieve the names of the extended statistics.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ * @param xstats_names
+ *   Array to fill in, NULL to get the number of extended statistics.
+ * @param size
+ *   Number of entries in xstats_names.
+ *
+ * @return
+ *   Number of extended statistics.
+ */
+int qdma_dev_xstats_get_names(struct rte_eth_dev *dev,
+				struct rte_eth_xstat_name *xstats_names,
+				unsigned int size)
+{
+	unsigned int count = qdma_xstats_count(dev);
+	unsigned int i, n, idx = 0;
+
+	if (!xstats_names || size < count)
+		return count;
+
+	for (n = 0; n < QDMA_NB_DEV_XSTATS; n++)
+		strlcpy(xstats_names[idx++].name,
+			qdma_dev_xstats_strings[n].name,
+			sizeof(xstats_names[0].name));
+
+	for (i = 0; i < dev->data->nb_rx_queues; i++)
+		for (n = 0; n < QDMA_NB_RX_XSTATS; n++)
+			snprintf(xstats_names[idx++].name,
+				sizeof(xstats_names[0].name), "rx_q%u_%s",
+				i, qdma_rx_xstats_strings[n].name);
+
+	for (i = 0; i < dev->data->nb_tx_queues; i++)
+		for (n = 0; n < QDMA_NB_TX_XSTATS; n++)
+			snprintf(xstats_names[idx++].name,
+				sizeof(xstats_names[0].name), "tx_q%u_%s",
+				i, qdma_tx_xstats_strings[n].name);
+
+	return count;
+}
+
+/**
+ * DPDK callback to retrieve the extended statistics.
+ *
+ * The counters are per queue and maintained by the burst functions.
+ * Burst cycle sampling is enabled with the burst_cycles=1 devarg.
+ * The device level entries report the duration of the last dev_start.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ * @param xstats
+ *   Array to fill in.
+ * @param n
+ *   Number of entries in xstats.
+ *
+ * @return
+ *   Number of extended statistics.
+ */
+int qdma_dev_xstats_get(struct rte_eth_dev *dev,
+				struct rte_eth_xstat *xstats, unsigned int n)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	unsigned int count = qdma_xstats_count(dev);
+	unsigned int i, k, idx = 0;
+	struct qdma_rx_queue *rxq;
+	struct qdma_tx_queue *txq;
+
+	if (!xstats || n < count)
+		return count;
+
+	for (k = 0; k < QDMA_NB_DEV_XSTATS; k++, idx++) {
+		xstats[idx].id = idx;
+		xstats[idx].value = *(uint64_t *)((char *)qdma_dev +
+				qdma_dev_xstats_strings[k].offset);
+	}
+
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		rxq = (struct qdma_rx_queue *)dev->data->rx_queues[i];
+		for (k = 0; k < QDMA_NB_RX_XSTATS; k++, idx++) {
+			xstats[idx].id = idx;
+			xstats[idx].value = *(uint64_t *)((char *)&rxq->xstats +
+					qdma_rx_xstats_strings[k].offset);
+		}
+	}
+
+	for (i = 0; i < dev->data->nb_tx_queues; i++) {
+		txq = (struct qdma_tx_queue *)dev->data->tx_queues[i];
+		for (k = 0; k < QDMA_NB_TX_XSTATS; k++, idx++) {
+			xstats[idx].id = idx;
+			xstats[idx].value = *(uint64_t *)((char *)&txq->xstats +
+					qdma_tx_xstats_strings[k].offset);
+		}
+	}
+
+	return count;
+}
+
 /**
  * DPDK callback to get Rx Queue info of an Ethernet device.
  *
@@ -2006,10 +2280,66 @@ qdma_dev_txq_info_get(struct rte_eth_dev *dev, uint16_t tx_queue_id,
 	qinfo->conf.offloads = txq->offloads;
 	qinfo->conf.tx_deferred_start = txq->tx_deferred_start;
 	qinfo->conf.tx_rs_thresh = 0;
+	qinfo->conf.tx_free_thresh = txq->tx_free_thresh;
 	qinfo->nb_desc = txq->nb_tx_desc - 1;
 
 }
 
+/**
+ * DPDK callback to enable the interrupt of a Rx queue.
+ *
+ * The interrupt is armed through a CMPT CIDX update and raised once, as
+ * soon as the queue trigger condition is met past the current CIDX.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ * @param rx_queue_id
+ *   The RX queue on the Ethernet device.
+ *
+ * @return
+ *   0 on success, -ENOTSUP if the queue has no interrupt.
+ */
+int qdma_dev_rx_queue_intr_enable(struct rte_eth_dev *dev,
+				uint16_t rx_queue_id)
+{
+	struct qdma_rx_queue *rxq = dev->data->rx_queues[rx_queue_id];
+
+	if (!rxq->en_intr)
+		return -ENOTSUP;
+
+	rxq->cmpt_cidx_info.irq_en = 1;
+	qdma_queue_cmpt_cidx_db(dev, rx_queue_id, &rxq->cmpt_cidx_info);
+
+	return 0;
+}
+
+/**
+ * DPDK callback to disable the interrupt of a Rx queue.
+ *
+ * Further CMPT CIDX updates of the Rx burst no longer re-arm it.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ * @param rx_queue_id
+ *   The RX queue on the Ethernet device.
+ *
+ * @return
+ *   0 on success, -ENOTSUP if the queue has no interrupt.
+ */
+int qdma_dev_rx_queue_intr_disable(struct rte_eth_dev *dev,
+				uint16_t rx_queue_id)
+{
+	struct qdma_rx_queue *rxq = dev->data->rx_queues[rx_queue_id];
+
+	if (!rxq->en_intr)
+		return -ENOTSUP;
+
+	rxq->cmpt_cidx_info.irq_en = 0;
+	qdma_queue_cmpt_cidx_db(dev, rx_queue_id, &rxq->cmpt_cidx_info);
+
+	return 0;
+}
+
 static struct eth_dev_ops qdma_eth_dev_ops = {
 	.dev_configure            = qdma_dev_configure,
 	.dev_infos_get            = qdma_dev_infos_get,
@@ -2026,23 +2356,48 @@ static struct eth_dev_ops qdma_eth_dev_ops = {
 	.rx_queue_stop            = qdma_dev_rx_queue_stop,
 	.tx_queue_start           = qdma_dev_tx_queue_start,
 	.tx_queue_stop            = qdma_dev_tx_queue_stop,
+	.rx_queue_intr_enable     = qdma_dev_rx_queue_intr_enable,
+	.rx_queue_intr_disable    = qdma_dev_rx_queue_intr_disable,
 	.tx_done_cleanup          = qdma_dev_tx_done_cleanup,
 	.queue_stats_mapping_set  = qdma_dev_queue_stats_mapping,
 	.get_reg                  = qdma_dev_get_regs,
 	.stats_get                = qdma_dev_stats_get,
 	.stats_reset              = qdma_dev_stats_reset,
+	.xstats_get               = qdma_dev_xstats_get,
+	.xstats_get_names         = qdma_dev_xstats_get_names,
+	.xstats_reset             = qdma_dev_stats_reset,
+	.rxq_info_get             = qdma_dev_rxq_info_get,
+	.txq_info_get             = qdma_dev_txq_info_get,
+};
+
+/*
+ * Secondary processes run the datapath of queues set up by the primary.
+ * Device and queue control stays with the primary, which owns the access
+ * layer state, so only the ops that read or reset shared state are given.
+ */
+static struct eth_dev_ops qdma_eth_dev_secondary_ops = {
+	.dev_infos_get            = qdma_dev_infos_get,
+	.link_update              = qdma_dev_link_update,
+	.tx_done_cleanup          = qdma_dev_tx_done_cleanup,
+	.stats_get                = qdma_dev_stats_get,
+	.stats_reset              = qdma_dev_stats_reset,
+	.xstats_get               = qdma_dev_xstats_get,
+	.xstats_get_names         = qdma_dev_xstats_get_names,
+	.xstats_reset             = qdma_dev_stats_reset,
 	.rxq_info_get             = qdma_dev_rxq_info_get,
 	.txq_info_get             = qdma_dev_txq_info_get,
 };
 
 void qdma_dev_ops_init(struct rte_eth_dev *dev)
 {
-	dev->dev_ops = &qdma_eth_dev_ops;
-	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
-		dev->rx_pkt_burst = &qdma_recv_pkts;
-		dev->tx_pkt_burst = &qdma_xmit_pkts;
-		dev->rx_queue_count = &qdma_dev_rx_queue_count;
-		dev->rx_descriptor_status = &qdma_dev_rx_descriptor_status;
-		dev->tx_descriptor_status = &qdma_dev_tx_descriptor_status;
-	}
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY)
+		dev->dev_ops = &qdma_eth_dev_ops;
+	else
+		dev->dev_ops = &qdma_eth_dev_secondary_ops;
+
+	dev->rx_pkt_burst = &qdma_recv_pkts;
+	dev->tx_pkt_burst = &qdma_xmit_pkts;
+	dev->rx_queue_count = &qdma_dev_rx_queue_count;
+	dev->rx_descriptor_status = &qdma_dev_rx_descriptor_status;
+	dev->tx_descriptor_status = &qdma_dev_tx_descriptor_status;
 }
@@ -297,6 +297,35 @@ int qdma_dev_stats_get(struct rte_eth_dev *dev,
  */
 int qdma_dev_stats_reset(struct rte_eth_dev *dev);
 
+/**
+ * DPDK callback to retrieve the names of the extended statistics
+ *
+ * @param dev Pointer to Ethernet device structure
+ * @param xstats_names Array to fill in, NULL to get the number of
+ * extended statistics
+ * @param size Number of entries in xstats_names
+ *
+ * @return Number of extended statistics
+ * @ingroup dpdk_devops_func
+ */
+int qdma_dev_xstats_get_names(struct rte_eth_dev *dev,
+				struct rte_eth_xstat_name *xstats_names,
+				unsigned int size);
+
+/**
+ * DPDK callback to retrieve the extended statistics, per queue counters
+ * maintained by the Rx/Tx burst functions
+ *
+ * @param dev Pointer to Ethernet device structure
+ * @param xstats Array to fill in
+ * @param n Number of entries in xstats
+ *
+ * @return Number of extended statistics
+ * @ingroup dpdk_devops_func
+ */
+int qdma_dev_xstats_get(struct rte_eth_dev *dev,
+				struct rte_eth_xstat *xstats, unsigned int n);
+
 /**
  * DPDK callback to set a queue statistics mapping for
  * a tx/rx queue of an Ethernet device.
@@ -450,6 +479,35 @@ int qdma_dev_rx_queue_stop(struct rte_eth_dev *dev, uint16_t qid);
  */
 int qdma_dev_tx_queue_stop(struct rte_eth_dev *dev, uint16_t qid);
 
+/**
+ * DPDK callback to enable the interrupt of a Rx queue
+ *
+ * Arms the completion interrupt of a ST C2H queue, programmed in direct
+ * interrupt mode when the port is configured with intr_conf.rxq.
+ *
+ * @param dev Pointer to Ethernet device structure
+ * @param rx_queue_id Rx queue index
+ *
+ * @return 0 on success, -ENOTSUP if the queue has no interrupt
+ * @ingroup dpdk_devops_func
+ *
+ */
+int qdma_dev_rx_queue_intr_enable(struct rte_eth_dev *dev,
+				uint16_t rx_queue_id);
+
+/**
+ * DPDK callback to disable the interrupt of a Rx queue
+ *
+ * @param dev Pointer to Ethernet device structure
+ * @param rx_queue_id Rx queue index
+ *
+ * @return 0 on success, -ENOTSUP if the queue has no interrupt
+ * @ingroup dpdk_devops_func
+ *
+ */
+int qdma_dev_rx_queue_intr_disable(struct rte_eth_dev *dev,
+				uint16_t rx_queue_id);
+
 
 /**
  * DPDK callback to stop the device.
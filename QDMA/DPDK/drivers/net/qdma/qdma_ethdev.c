@@ -56,9 +56,6 @@
 #include "qdma_mbox.h"
 #include "qdma_devops.h"
 
-/* Poll for QDMA errors every 1 second */
-#define QDMA_ERROR_POLL_FRQ (1000000)
-
 #define PCI_CONFIG_BRIDGE_DEVICE              (6)
 #define PCI_CONFIG_CLASS_CODE_SHIFT        (16)
 
@@ -67,12 +64,86 @@
 static void qdma_device_attributes_get(struct rte_eth_dev *dev);
 
 /* Poll for any QDMA errors */
-void qdma_check_errors(void *arg)
+static void qdma_check_errors(void *arg)
 {
 	struct qdma_pci_dev *qdma_dev;
 	qdma_dev = ((struct rte_eth_dev *)arg)->data->dev_private;
 	qdma_dev->hw_access->qdma_hw_error_process(arg);
-	rte_eal_alarm_set(QDMA_ERROR_POLL_FRQ, qdma_check_errors, arg);
+	rte_eal_alarm_set(qdma_dev->err_poll_ms * 1000ULL,
+			qdma_check_errors, arg);
+}
+
+/* Error interrupt handler. The misc vector is shared with the mailbox,
+ * so this also runs on mailbox interrupts and then finds no error.
+ */
+static void qdma_error_intr_handler(void *arg)
+{
+	struct qdma_pci_dev *qdma_dev;
+	qdma_dev = ((struct rte_eth_dev *)arg)->data->dev_private;
+	qdma_dev->hw_access->qdma_hw_error_process(arg);
+	qdma_dev->hw_access->qdma_hw_error_intr_rearm(arg);
+}
+
+/**
+ * Start reporting hardware errors on the master PF. Errors are routed to
+ * the misc vector (0) when the IP raises misc interrupts, as for the
+ * mailbox, otherwise the error registers are polled every err_poll_ms.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ */
+void qdma_error_monitor_start(struct rte_eth_dev *dev)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct rte_pci_device *pci_dev = RTE_ETH_DEV_TO_PCI(dev);
+	struct rte_intr_handle *intr_handle = &pci_dev->intr_handle;
+	int ret;
+
+	if (qdma_dev->dev_cap.mailbox_intr) {
+		ret = rte_intr_callback_register(intr_handle,
+				qdma_error_intr_handler, dev);
+		if (!ret) {
+			ret = rte_intr_enable(intr_handle);
+			if (!ret)
+				ret = qdma_dev->hw_access->qdma_hw_error_intr_setup(
+						dev, qdma_dev->func_id, 0);
+			if (!ret) {
+				qdma_dev->hw_access->qdma_hw_error_intr_rearm(
+						dev);
+				qdma_dev->err_intr_en = 1;
+				PMD_DRV_LOG(INFO, "PF-%d(DEVFN) hardware errors "
+						"reported by interrupt\n",
+						qdma_dev->func_id);
+				return;
+			}
+			rte_intr_callback_unregister(intr_handle,
+					qdma_error_intr_handler, dev);
+		}
+	}
+
+	if (qdma_dev->err_poll_ms)
+		rte_eal_alarm_set(qdma_dev->err_poll_ms * 1000ULL,
+				qdma_check_errors, (void *)dev);
+}
+
+/**
+ * Stop reporting hardware errors. The misc vector itself is left to the
+ * mailbox, which disables it at its uninit.
+ *
+ * @param dev
+ *   Pointer to Ethernet device structure.
+ */
+void qdma_error_monitor_stop(struct rte_eth_dev *dev)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct rte_pci_device *pci_dev = RTE_ETH_DEV_TO_PCI(dev);
+
+	if (qdma_dev->err_intr_en) {
+		rte_intr_callback_unregister(&pci_dev->intr_handle,
+				qdma_error_intr_handler, dev);
+		qdma_dev->err_intr_en = 0;
+	}
+	rte_eal_alarm_cancel(qdma_check_errors, (void *)dev);
 }
 
 /*
@@ -556,11 +627,11 @@ int qdma_eth_dev_init(struct rte_eth_dev *dev)
 		return -EINVAL;
 
 	/* for secondary processes, we don't initialise any further as primary
-	 * has already done this work.
+	 * has already done this work, only the datapath state of the process.
 	 */
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
 		qdma_dev_ops_init(dev);
-		return 0;
+		return qdma_proc_private_init(dev);
 	}
 
 	/* allocate space for a single Ethernet MAC address */
@@ -580,6 +651,7 @@ int qdma_eth_dev_init(struct rte_eth_dev *dev)
 	dma_priv->is_master = 0;
 	dma_priv->vf_online_count = 0;
 	dma_priv->timer_count = DEFAULT_TIMER_CNT_TRIG_MODE_TIMER;
+	dma_priv->err_poll_ms = DEFAULT_ERR_POLL_MS;
 
 	dma_priv->en_desc_prefetch = 0; //Keep prefetch default to 0
 	dma_priv->cmpt_desc_len = DEFAULT_QDMA_CMPT_DESC_LEN;
@@ -630,6 +702,14 @@ int qdma_eth_dev_init(struct rte_eth_dev *dev)
 		return -EINVAL;
 	}
 
+	/* Datapath view of the device in this process */
+	idx = qdma_proc_private_init(dev);
+	if (idx < 0) {
+		rte_free(dma_priv->hw_access);
+		rte_free(dev->data->mac_addrs);
+		return idx;
+	}
+
 	/* Store BAR address and length of AXI Master Lite BAR(user bar) */
 	if (dma_priv->user_bar_idx >= 0) {
 		baseaddr = (uint8_t *)
@@ -665,6 +745,7 @@ int qdma_eth_dev_init(struct rte_eth_dev *dev)
 	ret = get_max_pci_bus_num(pci_dev->addr.bus, &max_pci_bus);
 	if ((ret != QDMA_SUCCESS) && !max_pci_bus) {
 		PMD_DRV_LOG(ERR, "Failed to get max pci bus number\n");
+		qdma_proc_private_uninit(dev);
 		rte_free(dma_priv->hw_access);
 		rte_free(dev->data->mac_addrs);
 		return -EINVAL;
@@ -675,6 +756,7 @@ int qdma_eth_dev_init(struct rte_eth_dev *dev)
 				qbase, dma_priv->dev_cap.num_qs,
 				&dma_priv->dma_device_index);
 	if (ret == -QDMA_ERR_NO_MEM) {
+		qdma_proc_private_uninit(dev);
 		rte_free(dma_priv->hw_access);
 		rte_free(dev->data->mac_addrs);
 		return -ENOMEM;
@@ -736,8 +818,7 @@ int qdma_eth_dev_init(struct rte_eth_dev *dev)
 			return -EINVAL;
 		}
 
-		rte_eal_alarm_set(QDMA_ERROR_POLL_FRQ, qdma_check_errors,
-							(void *)dev);
+		qdma_error_monitor_start(dev);
 		dma_priv->is_master = 1;
 	}
 
@@ -751,6 +832,7 @@ int qdma_eth_dev_init(struct rte_eth_dev *dev)
 		(ret != -QDMA_ERR_RM_DEV_EXISTS)) {
 		PMD_DRV_LOG(ERR, "PF-%d(DEVFN) qdma_dev_entry_create failed: %d\n",
 			    dma_priv->func_id, ret);
+		qdma_proc_private_uninit(dev);
 		rte_free(dma_priv->hw_access);
 		rte_free(dev->data->mac_addrs);
 		return -ENOMEM;
@@ -797,8 +879,10 @@ int qdma_eth_dev_uninit(struct rte_eth_dev *dev)
 	int i, rv;
 
 	/* only uninitialize in the primary process */
-	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
-		return -EPERM;
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		qdma_proc_private_uninit(dev);
+		return 0;
+	}
 
 	if (qdma_dev->vf_online_count) {
 		for (i = 0; i < pci_dev->max_vfs; i++) {
@@ -854,7 +938,7 @@ int qdma_eth_dev_uninit(struct rte_eth_dev *dev)
 
 	/* cancel pending polls*/
 	if (qdma_dev->is_master)
-		rte_eal_alarm_cancel(qdma_check_errors, (void *)dev);
+		qdma_error_monitor_stop(dev);
 
 	/* Remove the device node from the board list */
 	qdma_dev_entry_destroy(qdma_dev->dma_device_index,
@@ -887,6 +971,7 @@ int qdma_eth_dev_uninit(struct rte_eth_dev *dev)
 		rte_free(qdma_dev->hw_access);
 		qdma_dev->hw_access = NULL;
 	}
+	qdma_proc_private_uninit(dev);
 	return 0;
 }
 
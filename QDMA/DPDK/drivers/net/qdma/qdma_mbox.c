@@ -37,6 +37,7 @@
 #include <rte_malloc.h>
 #include <rte_spinlock.h>
 #include <rte_alarm.h>
+#include <rte_cycles.h>
 
 /*
  * Get index from VF info array of PF device for a given VF funcion id.
@@ -314,31 +315,53 @@ int qdma_mbox_msg_send(struct rte_eth_dev *dev, struct qdma_mbox_msg *msg,
 		       unsigned int timeout_ms)
 {
 	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	uint64_t deadline;
 
 	if (!msg)
 		return -EINVAL;
 
 	msg->retry_cnt = timeout_ms ? ((timeout_ms / MBOX_POLL_FRQ) + 1) :
 			MBOX_SEND_RETRY_COUNT;
+	msg->rsp_wait = (!timeout_ms) ? QDMA_MBOX_RSP_NO_WAIT :
+			QDMA_MBOX_RSP_WAIT;
 	QDMA_LIST_SET_DATA(&msg->node, msg);
 
 	rte_spinlock_lock(&qdma_dev->mbox.list_lock);
 	qdma_list_add_tail(&msg->node, &qdma_dev->mbox.tx_todo_list);
 	rte_spinlock_unlock(&qdma_dev->mbox.list_lock);
 
-	msg->rsp_wait = (!timeout_ms) ? QDMA_MBOX_RSP_NO_WAIT :
-			QDMA_MBOX_RSP_WAIT;
-	rte_eal_alarm_set(MBOX_POLL_FRQ, qdma_mbox_send_task, dev);
+	/* Try to send right away, the send task re-arms itself at
+	 * MBOX_POLL_FRQ only while the mailbox is busy. A NO_WAIT msg
+	 * may be freed once this returns.
+	 */
+	qdma_mbox_send_task(dev);
 
 	if (!timeout_ms)
 		return 0;
 
-	/* if code reached here, caller should free the buffer */
-	while (msg->retry_cnt && !msg->rsp_rcvd)
-		rte_delay_ms(1);
+	/* if code reached here, caller should free the buffer. The response
+	 * usually arrives within tens of us, so poll for it at a fine
+	 * granularity rather than sleeping a whole ms per message.
+	 */
+	deadline = rte_get_timer_cycles() +
+		((uint64_t)timeout_ms * rte_get_timer_hz()) / MS_PER_S;
+	while (msg->retry_cnt && !msg->rsp_rcvd) {
+		if (rte_get_timer_cycles() > deadline)
+			break;
+		rte_delay_us(MBOX_RSP_POLL_US);
+	}
 
-	if (!msg->rsp_rcvd)
-		return  -EPIPE;
+	if (!msg->rsp_rcvd) {
+		/* unlink the msg so that it is not referenced once freed */
+		rte_spinlock_lock(&qdma_dev->mbox.list_lock);
+		if (!msg->rsp_rcvd && msg->retry_cnt) {
+			qdma_list_del(&msg->node);
+			msg->retry_cnt = 0;
+		}
+		rte_spinlock_unlock(&qdma_dev->mbox.list_lock);
+		if (!msg->rsp_rcvd)
+			return  -EPIPE;
+	}
 
 	return 0;
 }
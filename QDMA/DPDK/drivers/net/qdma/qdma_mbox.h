@@ -40,6 +40,7 @@
 #define MBOX_POLL_FRQ 1000
 #define MBOX_OP_RSP_TIMEOUT (10000 * MBOX_POLL_FRQ) /* 10 sec */
 #define MBOX_SEND_RETRY_COUNT (MBOX_OP_RSP_TIMEOUT/MBOX_POLL_FRQ)
+#define MBOX_RSP_POLL_US 10
 
 enum qdma_mbox_rsp_state {
 	QDMA_MBOX_RSP_NO_WAIT,
@@ -36,6 +36,7 @@
 #include "qdma.h"
 #include <rte_malloc.h>
 #include <rte_spinlock.h>
+#include <rte_eal.h>
 
 static rte_spinlock_t resource_lock = RTE_SPINLOCK_INITIALIZER;
 static rte_spinlock_t reg_access_lock = RTE_SPINLOCK_INITIALIZER;
@@ -203,6 +204,17 @@ void qdma_udelay(uint32_t delay_usec)
 	rte_delay_us(delay_usec);
 }
 
+/*****************************************************************************/
+/**
+ * qdma_get_thread_id() - function to identify the calling thread
+ *
+ * Return:	a non zero value unique to the calling thread
+ *****************************************************************************/
+uint64_t qdma_get_thread_id(void)
+{
+	return (uint64_t)rte_gettid();
+}
+
 /*****************************************************************************/
 /**
  * qdma_get_hw_access() - function to get the qdma_hw_access
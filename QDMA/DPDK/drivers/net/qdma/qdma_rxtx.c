@@ -33,6 +33,9 @@
 
 #include <rte_mbuf.h>
 #include <rte_cycles.h>
+#include <rte_vect.h>
+#include <rte_cpuflags.h>
+#include <rte_memcpy.h>
 #include "qdma.h"
 #include "qdma_access_common.h"
 
@@ -62,7 +65,7 @@ static int qdma_ul_extract_st_cmpt_info_v(void *ul_cmpt_entry, void *cmpt_info)
 	return 0;
 }
 
-#ifdef QDMA_RX_VEC_X86_64
+#ifdef RTE_ARCH_X86_64
 /* Vector implementation to get packet length from two completion entries */
 static void qdma_ul_get_cmpt_pkt_len_v(void *ul_cmpt_entry, __m128i *data)
 {
@@ -87,9 +90,7 @@ static void qdma_ul_get_cmpt_pkt_len_v(void *ul_cmpt_entry, __m128i *data)
 	 */
 	data[0] = _mm_srl_epi32(data[0], pkt_len_shift);
 }
-#endif //QDMA_RX_VEC_X86_64
 
-#ifdef QDMA_TX_VEC_X86_64
 /* Vector implementation to update H2C descriptor */
 static int qdma_ul_update_st_h2c_desc_v(void *qhndl, uint64_t q_offloads,
 				struct rte_mbuf *mb)
@@ -147,10 +148,59 @@ static int qdma_ul_update_st_h2c_desc_v(void *qhndl, uint64_t q_offloads,
 
 	return 0;
 }
-#endif //QDMA_TX_VEC_X86_64
+
+/* Vector implementation to write a MM descriptor,
+ * see qdma_ul_update_mm_c2h_desc() and qdma_ul_update_mm_h2c_desc()
+ */
+static __rte_always_inline void qdma_ul_write_mm_desc_v(
+		struct qdma_ul_mm_desc *desc, uint64_t src_addr,
+		uint64_t dst_addr, uint32_t len)
+{
+	/* len, dv, sop and eop share the second quadword */
+	uint64_t ctrl = (uint64_t)len | (0x7ULL << 28);
+
+	RTE_BUILD_BUG_ON(sizeof(struct qdma_ul_mm_desc) != 32);
+
+	_mm_storeu_si128((__m128i *)desc, _mm_set_epi64x(ctrl, src_addr));
+	_mm_storeu_si128((__m128i *)desc + 1, _mm_set_epi64x(0, dst_addr));
+}
+#endif //RTE_ARCH_X86_64
 
 /******** User logic dependent functions end **********/
 
+/**
+ * Select the Rx/Tx data path for a queue being started.
+ *
+ * Picks the widest vector implementation supported by the compiler and the
+ * CPU, within the SIMD bitwidth allowed by the EAL
+ * (--force-max-simd-bitwidth).
+ *
+ * @return
+ *   One of enum qdma_vec_path.
+ */
+uint8_t qdma_get_vec_path(void)
+{
+#ifdef RTE_ARCH_X86_64
+	uint16_t max_simd = rte_vect_get_max_simd_bitwidth();
+
+#ifdef CC_AVX512_SUPPORT
+	if (max_simd >= RTE_VECT_SIMD_512 &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) == 1 &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) == 1)
+		return QDMA_VEC_PATH_AVX512;
+#endif //CC_AVX512_SUPPORT
+#ifdef CC_AVX2_SUPPORT
+	if (max_simd >= RTE_VECT_SIMD_256 &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) == 1)
+		return QDMA_VEC_PATH_AVX2;
+#endif //CC_AVX2_SUPPORT
+	if (max_simd >= RTE_VECT_SIMD_128)
+		return QDMA_VEC_PATH_SSE;
+#endif //RTE_ARCH_X86_64
+
+	return QDMA_VEC_PATH_SCALAR;
+}
+
 /**
  * Poll the QDMA engine for transfer completion.
  *
@@ -228,11 +278,29 @@ static int dma_wb_monitor(void *xq, uint8_t dir, uint16_t expected_count)
 	return -1;
 }
 
+/* Queue a freed mbuf for a bulk put to its pool, flushing the batch when
+ * it is full or when the mbuf belongs to a different pool
+ */
+static inline void tx_free_bulk_add(struct rte_mbuf **bulk, uint16_t *nb_bulk,
+			struct rte_mbuf *m)
+{
+	if (*nb_bulk == QDMA_TX_FREE_BULK ||
+			(*nb_bulk && bulk[0]->pool != m->pool)) {
+		rte_mempool_put_bulk(bulk[0]->pool, (void **)bulk, *nb_bulk);
+		*nb_bulk = 0;
+	}
+	bulk[(*nb_bulk)++] = m;
+}
+
 static int reclaim_tx_mbuf(struct qdma_tx_queue *txq,
 			uint16_t cidx, uint16_t free_cnt)
 {
+	struct rte_mbuf *bulk[QDMA_TX_FREE_BULK];
+	struct rte_mbuf *m, *seg, *next;
+	uint16_t nb_bulk = 0;
+	uint64_t fast_free;
 	int fl_desc = 0;
-	uint16_t count;
+	int count;
 	int id;
 
 	id = txq->tx_fl_tail;
@@ -243,31 +311,65 @@ static int reclaim_tx_mbuf(struct qdma_tx_queue *txq,
 	if (free_cnt && (fl_desc > free_cnt))
 		fl_desc = free_cnt;
 
-	if ((id + fl_desc) < (txq->nb_tx_desc - 1)) {
-		for (count = 0; count < ((uint16_t)fl_desc & 0xFFFF);
-				count++) {
-			rte_pktmbuf_free(txq->sw_ring[id]);
-			txq->sw_ring[id++] = NULL;
-		}
-	} else {
-		fl_desc -= (txq->nb_tx_desc - 1 - id);
-		for (; id < (txq->nb_tx_desc - 1); id++) {
-			rte_pktmbuf_free(txq->sw_ring[id]);
-			txq->sw_ring[id] = NULL;
+	/* With DEV_TX_OFFLOAD_MBUF_FAST_FREE the application guarantees that
+	 * the mbufs of the queue are direct, not shared and from one pool
+	 */
+	fast_free = txq->offloads & DEV_TX_OFFLOAD_MBUF_FAST_FREE;
+
+	for (count = 0; count < fl_desc; count++) {
+		m = txq->sw_ring[id];
+		txq->sw_ring[id] = NULL;
+		if (++id == (txq->nb_tx_desc - 1))
+			id = 0;
+
+		/* Only the first descriptor of a packet holds its mbuf */
+		if (!m)
+			continue;
+
+		if (fast_free && (m->nb_segs == 1)) {
+			tx_free_bulk_add(bulk, &nb_bulk, m);
+			continue;
 		}
 
-		id -= (txq->nb_tx_desc - 1);
-		for (count = 0; count < ((uint16_t)fl_desc & 0xFFFF);
-				count++) {
-			rte_pktmbuf_free(txq->sw_ring[id]);
-			txq->sw_ring[id++] = NULL;
+		for (seg = m; seg; seg = next) {
+			next = seg->next;
+			seg = rte_pktmbuf_prefree_seg(seg);
+			if (seg)
+				tx_free_bulk_add(bulk, &nb_bulk, seg);
 		}
 	}
+	if (nb_bulk)
+		rte_mempool_put_bulk(bulk[0]->pool, (void **)bulk, nb_bulk);
+
 	txq->tx_fl_tail = id;
 
 	return fl_desc;
 }
 
+/* Number of descriptors free for new packets. Transmitted mbufs are only
+ * reclaimed once fewer than tx_free_thresh descriptors are left, so that
+ * they go back to their pools in large batches.
+ */
+static int tx_avail_desc(struct qdma_tx_queue *txq, uint16_t cidx)
+{
+	int avail, in_use;
+
+	in_use = (int)txq->q_pidx_info.pidx - txq->tx_fl_tail;
+	if (in_use < 0)
+		in_use += (txq->nb_tx_desc - 1);
+
+	/* Make 1 less available, otherwise if we allow all descriptors
+	 * to be filled, when nb_pkts = nb_tx_desc - 1, pidx will be same
+	 * as old pidx and HW will treat this as no new descriptors were added.
+	 * Hence, DMA won't happen with new descriptors.
+	 */
+	avail = txq->nb_tx_desc - 2 - in_use;
+	if (avail < txq->tx_free_thresh)
+		avail += reclaim_tx_mbuf(txq, cidx, 0);
+
+	return avail;
+}
+
 #ifdef TEST_64B_DESC_BYPASS
 static uint16_t qdma_xmit_64B_desc_bypass(struct qdma_tx_queue *txq,
 			struct rte_mbuf **tx_pkts, uint16_t nb_pkts)
@@ -276,7 +378,6 @@ static uint16_t qdma_xmit_64B_desc_bypass(struct qdma_tx_queue *txq,
 	uint8_t *tx_ring_st_bypass = NULL;
 	int ofd = -1, ret = 0;
 	char fln[50];
-	struct qdma_pci_dev *qdma_dev = txq->dev->data->dev_private;
 
 	id = txq->q_pidx_info.pidx;
 
@@ -318,8 +419,8 @@ static uint16_t qdma_xmit_64B_desc_bypass(struct qdma_tx_queue *txq,
 	rte_wmb();
 
 	txq->q_pidx_info.pidx = id;
-	qdma_dev->hw_access->qdma_queue_pidx_update(txq->dev, qdma_dev->is_vf,
-		txq->queue_id, 0, &txq->q_pidx_info);
+	qdma_queue_pidx_db(QDMA_QUEUE_DEV(txq), txq->queue_id, 0,
+		&txq->q_pidx_info);
 
 	PMD_DRV_LOG(DEBUG, " xmit completed with count:%d\n", count);
 
@@ -339,7 +440,7 @@ void qdma_get_device_info(void *queue_hndl,
 		enum qdma_ip_type *ip_type)
 {
 	struct qdma_rx_queue *rxq = (struct qdma_rx_queue *)queue_hndl;
-	struct qdma_pci_dev *qdma_dev = rxq->dev->data->dev_private;
+	struct qdma_pci_dev *qdma_dev = QDMA_QUEUE_DEV(rxq)->data->dev_private;
 
 	*device_type = (enum qdma_device_type)qdma_dev->device_type;
 	*ip_type = (enum qdma_ip_type)qdma_dev->ip_type;
@@ -407,7 +508,7 @@ uint64_t get_mm_h2c_ep_addr(void *queue_hndl)
 static void adjust_c2h_cntr_avgs(struct qdma_rx_queue *rxq)
 {
 	int i;
-	struct qdma_pci_dev *qdma_dev = rxq->dev->data->dev_private;
+	struct qdma_pci_dev *qdma_dev = QDMA_QUEUE_DEV(rxq)->data->dev_private;
 
 	if (rxq->sorted_c2h_cntr_idx < 0)
 		return;
@@ -440,7 +541,7 @@ static void adjust_c2h_cntr_avgs(struct qdma_rx_queue *rxq)
 
 static void incr_c2h_cntr_th(struct qdma_rx_queue *rxq)
 {
-	struct qdma_pci_dev *qdma_dev = rxq->dev->data->dev_private;
+	struct qdma_pci_dev *qdma_dev = QDMA_QUEUE_DEV(rxq)->data->dev_private;
 	unsigned char i, c2h_cntr_idx;
 	unsigned char c2h_cntr_val_new;
 	unsigned char c2h_cntr_val_curr;
@@ -468,12 +569,13 @@ static void incr_c2h_cntr_th(struct qdma_rx_queue *rxq)
 		rxq->cmpt_cidx_info.counter_idx = c2h_cntr_idx;
 		rxq->sorted_c2h_cntr_idx = i;
 		adjust_c2h_cntr_avgs(rxq);
+		rxq->xstats.cntr_th_increments++;
 	}
 }
 
 static void decr_c2h_cntr_th(struct qdma_rx_queue *rxq)
 {
-	struct qdma_pci_dev *qdma_dev = rxq->dev->data->dev_private;
+	struct qdma_pci_dev *qdma_dev = QDMA_QUEUE_DEV(rxq)->data->dev_private;
 	unsigned char i, c2h_cntr_idx;
 	unsigned char c2h_cntr_val_new;
 	unsigned char c2h_cntr_val_curr;
@@ -499,6 +601,7 @@ static void decr_c2h_cntr_th(struct qdma_rx_queue *rxq)
 
 	rxq->sorted_c2h_cntr_idx = i;
 	adjust_c2h_cntr_avgs(rxq);
+	rxq->xstats.cntr_th_decrements++;
 }
 
 #define MAX_C2H_CNTR_STAGNANT_CNT 16
@@ -532,103 +635,123 @@ static void adapt_update_counter(struct qdma_rx_queue *rxq,
 }
 #endif //QDMA_LATENCY_OPTIMIZED
 
+/* Update the CMPT CIDX after processing the ring up to rx_cmpt_tail */
+static inline void update_cmpt_cidx(struct qdma_rx_queue *rxq,
+		uint16_t rx_cmpt_tail)
+{
+	rxq->cmpt_cidx_info.wrb_cidx = rx_cmpt_tail;
+	qdma_queue_cmpt_cidx_db(QDMA_QUEUE_DEV(rxq), rxq->queue_id,
+		&rxq->cmpt_cidx_info);
+	rxq->xstats.cmpt_cidx_updates++;
+}
+
 /* Process completion ring */
 static int process_cmpt_ring(struct qdma_rx_queue *rxq,
 		uint16_t num_cmpt_entries)
 {
-	struct qdma_pci_dev *qdma_dev = rxq->dev->data->dev_private;
 	union qdma_ul_st_cmpt_ring *user_cmpt_entry;
 	uint32_t count = 0;
 	int ret = 0;
 	uint16_t rx_cmpt_tail = rxq->cmpt_cidx_info.wrb_cidx;
 
-	if (likely(!rxq->dump_immediate_data)) {
-		if ((rx_cmpt_tail + num_cmpt_entries) <
-			(rxq->nb_rx_cmpt_desc - 1)) {
-			for (count = 0; count < num_cmpt_entries; count++) {
-				user_cmpt_entry =
-				(union qdma_ul_st_cmpt_ring *)
-				((uint64_t)rxq->cmpt_ring +
-				((uint64_t)rx_cmpt_tail * rxq->cmpt_desc_len));
-
-				ret = qdma_ul_extract_st_cmpt_info_v(
-						user_cmpt_entry,
-						&rxq->cmpt_data[count]);
-				if (ret != 0) {
-					PMD_DRV_LOG(ERR, "Error detected on CMPT ring "
-						"at index %d, queue_id = %d\n",
-						rx_cmpt_tail, rxq->queue_id);
-					rxq->err = 1;
-					return -1;
-				}
-				rx_cmpt_tail++;
-			}
-		} else {
-			while (count < num_cmpt_entries) {
-				user_cmpt_entry =
-				(union qdma_ul_st_cmpt_ring *)
-				((uint64_t)rxq->cmpt_ring +
-				((uint64_t)rx_cmpt_tail * rxq->cmpt_desc_len));
-
-				ret = qdma_ul_extract_st_cmpt_info_v(
-						user_cmpt_entry,
-						&rxq->cmpt_data[count]);
-				if (ret != 0) {
-					PMD_DRV_LOG(ERR, "Error detected on CMPT ring "
-						"at index %d, queue_id = %d\n",
-						rx_cmpt_tail, rxq->queue_id);
-					rxq->err = 1;
-					return -1;
-				}
-
-				rx_cmpt_tail++;
-				if (unlikely(rx_cmpt_tail >=
-					(rxq->nb_rx_cmpt_desc - 1)))
-					rx_cmpt_tail -=
-						(rxq->nb_rx_cmpt_desc - 1);
-				count++;
-			}
-		}
-	} else {
-		while (count < num_cmpt_entries) {
+	if ((rx_cmpt_tail + num_cmpt_entries) <
+		(rxq->nb_rx_cmpt_desc - 1)) {
+		for (count = 0; count < num_cmpt_entries; count++) {
 			user_cmpt_entry =
 			(union qdma_ul_st_cmpt_ring *)
 			((uint64_t)rxq->cmpt_ring +
 			((uint64_t)rx_cmpt_tail * rxq->cmpt_desc_len));
 
-			ret = qdma_ul_extract_st_cmpt_info(
+			ret = qdma_ul_extract_st_cmpt_info_v(
 					user_cmpt_entry,
 					&rxq->cmpt_data[count]);
 			if (ret != 0) {
 				PMD_DRV_LOG(ERR, "Error detected on CMPT ring "
-					"at CMPT index %d, queue_id = %d\n",
+					"at index %d, queue_id = %d\n",
 					rx_cmpt_tail, rxq->queue_id);
 				rxq->err = 1;
+				rxq->xstats.cmpt_errors++;
 				return -1;
 			}
+			rx_cmpt_tail++;
+		}
+	} else {
+		while (count < num_cmpt_entries) {
+			user_cmpt_entry =
+			(union qdma_ul_st_cmpt_ring *)
+			((uint64_t)rxq->cmpt_ring +
+			((uint64_t)rx_cmpt_tail * rxq->cmpt_desc_len));
 
-			ret = qdma_ul_process_immediate_data_st((void *)rxq,
-					user_cmpt_entry, rxq->cmpt_desc_len);
-			if (ret < 0) {
-				PMD_DRV_LOG(ERR, "Error processing immediate data "
-					"at CMPT index = %d, queue_id = %d\n",
+			ret = qdma_ul_extract_st_cmpt_info_v(
+					user_cmpt_entry,
+					&rxq->cmpt_data[count]);
+			if (ret != 0) {
+				PMD_DRV_LOG(ERR, "Error detected on CMPT ring "
+					"at index %d, queue_id = %d\n",
 					rx_cmpt_tail, rxq->queue_id);
+				rxq->err = 1;
+				rxq->xstats.cmpt_errors++;
 				return -1;
 			}
 
 			rx_cmpt_tail++;
 			if (unlikely(rx_cmpt_tail >=
 				(rxq->nb_rx_cmpt_desc - 1)))
-				rx_cmpt_tail -= (rxq->nb_rx_cmpt_desc - 1);
+				rx_cmpt_tail -=
+					(rxq->nb_rx_cmpt_desc - 1);
 			count++;
 		}
 	}
 
-	// Update the CPMT CIDX
-	rxq->cmpt_cidx_info.wrb_cidx = rx_cmpt_tail;
-	qdma_dev->hw_access->qdma_queue_cmpt_cidx_update(rxq->dev,
-		qdma_dev->is_vf,
-		rxq->queue_id, &rxq->cmpt_cidx_info);
+	update_cmpt_cidx(rxq, rx_cmpt_tail);
+
+	return 0;
+}
+
+/* Process completion ring, dumping the immediate data of each entry */
+static int process_cmpt_ring_imm(struct qdma_rx_queue *rxq,
+		uint16_t num_cmpt_entries)
+{
+	union qdma_ul_st_cmpt_ring *user_cmpt_entry;
+	uint32_t count = 0;
+	int ret = 0;
+	uint16_t rx_cmpt_tail = rxq->cmpt_cidx_info.wrb_cidx;
+
+	while (count < num_cmpt_entries) {
+		user_cmpt_entry =
+		(union qdma_ul_st_cmpt_ring *)
+		((uint64_t)rxq->cmpt_ring +
+		((uint64_t)rx_cmpt_tail * rxq->cmpt_desc_len));
+
+		ret = qdma_ul_extract_st_cmpt_info(
+				user_cmpt_entry,
+				&rxq->cmpt_data[count]);
+		if (ret != 0) {
+			PMD_DRV_LOG(ERR, "Error detected on CMPT ring "
+				"at CMPT index %d, queue_id = %d\n",
+				rx_cmpt_tail, rxq->queue_id);
+			rxq->err = 1;
+			rxq->xstats.cmpt_errors++;
+			return -1;
+		}
+
+		ret = qdma_ul_process_immediate_data_st((void *)rxq,
+				user_cmpt_entry, rxq->cmpt_desc_len);
+		if (ret < 0) {
+			PMD_DRV_LOG(ERR, "Error processing immediate data "
+				"at CMPT index = %d, queue_id = %d\n",
+				rx_cmpt_tail, rxq->queue_id);
+			return -1;
+		}
+
+		rx_cmpt_tail++;
+		if (unlikely(rx_cmpt_tail >=
+			(rxq->nb_rx_cmpt_desc - 1)))
+			rx_cmpt_tail -= (rxq->nb_rx_cmpt_desc - 1);
+		count++;
+	}
+
+	update_cmpt_cidx(rxq, rx_cmpt_tail);
 
 	return 0;
 }
@@ -755,7 +878,7 @@ qdma_dev_rx_descriptor_status(void *rx_queue, uint16_t offset)
 }
 
 /* Update mbuf for a segmented packet */
-static struct rte_mbuf *prepare_segmented_packet(struct qdma_rx_queue *rxq,
+struct rte_mbuf *qdma_prepare_segmented_packet(struct qdma_rx_queue *rxq,
 		uint16_t pkt_length, uint16_t *tail)
 {
 	struct rte_mbuf *mb;
@@ -779,6 +902,8 @@ static struct rte_mbuf *prepare_segmented_packet(struct qdma_rx_queue *rxq,
 			rte_pktmbuf_data_len(mb) = pkt_length;
 			pkt_length = 0;
 		}
+		/* The vector rearm paths leave data_off to the Rx side */
+		mb->data_off = RTE_PKTMBUF_HEADROOM;
 		rte_mbuf_refcnt_set(mb, 1);
 
 		if (first_seg == NULL) {
@@ -827,6 +952,7 @@ struct rte_mbuf *prepare_single_packet(struct qdma_rx_queue *rxq,
 				id -= (rxq->nb_rx_desc - 1);
 
 			rte_mbuf_refcnt_set(mb, 1);
+			mb->data_off = RTE_PKTMBUF_HEADROOM;
 			mb->nb_segs = 1;
 			mb->port = rxq->port_id;
 			mb->ol_flags = 0;
@@ -834,7 +960,7 @@ struct rte_mbuf *prepare_single_packet(struct qdma_rx_queue *rxq,
 			mb->pkt_len = pkt_length;
 			mb->data_len = pkt_length;
 		} else {
-			mb = prepare_segmented_packet(rxq, pkt_length, &id);
+			mb = qdma_prepare_segmented_packet(rxq, pkt_length, &id);
 		}
 
 		rxq->rx_tail = id;
@@ -842,7 +968,7 @@ struct rte_mbuf *prepare_single_packet(struct qdma_rx_queue *rxq,
 	return mb;
 }
 
-#ifdef QDMA_RX_VEC_X86_64
+#ifdef RTE_ARCH_X86_64
 /* Vector implementation to prepare mbufs for packets.
  * Update this API if HW provides more information to be populated in mbuf.
  */
@@ -940,7 +1066,7 @@ static uint16_t prepare_packets_v(struct qdma_rx_queue *rxq,
 			 * or ring wrap
 			 */
 			if (pktlen1) {
-				mb = prepare_segmented_packet(rxq,
+				mb = qdma_prepare_segmented_packet(rxq,
 					pktlen1, &id);
 				rx_pkts[count_pkts++] = mb;
 				pktlen = _mm_add_epi64(pktlen,
@@ -949,7 +1075,7 @@ static uint16_t prepare_packets_v(struct qdma_rx_queue *rxq,
 			}
 
 			if (pktlen2) {
-				mb = prepare_segmented_packet(rxq,
+				mb = qdma_prepare_segmented_packet(rxq,
 					pktlen2, &id);
 				rx_pkts[count_pkts++] = mb;
 				pktlen = _mm_add_epi64(pktlen,
@@ -972,86 +1098,141 @@ static uint16_t prepare_packets_v(struct qdma_rx_queue *rxq,
 
 	return count_pkts;
 }
-#endif //QDMA_RX_VEC_X86_64
+#endif //RTE_ARCH_X86_64
 
-/* Prepare mbufs with packet information */
-static uint16_t prepare_packets(struct qdma_rx_queue *rxq,
+/* Copy a short packet into an mbuf of the copy pool. Its C2H buffer
+ * goes back to the queue pool, from where the rearm picks it up again.
+ */
+static inline
+struct rte_mbuf *copy_short_packet(struct qdma_rx_queue *rxq,
+		uint16_t pkt_length, uint16_t *tail)
+{
+	struct rte_mbuf *mb, *buf;
+	uint16_t id = *tail;
+
+	mb = rte_pktmbuf_alloc(rxq->copy_pool);
+	if (unlikely(mb == NULL)) {
+		rxq->xstats.copy_alloc_errors++;
+		return qdma_prepare_segmented_packet(rxq, pkt_length, tail);
+	}
+
+	buf = rxq->sw_ring[id];
+	rxq->sw_ring[id++] = NULL;
+	if (unlikely(id >= (rxq->nb_rx_desc - 1)))
+		id -= (rxq->nb_rx_desc - 1);
+
+	rte_memcpy(rte_pktmbuf_mtod(mb, void *),
+		(char *)buf->buf_addr + RTE_PKTMBUF_HEADROOM, pkt_length);
+	/* Taken from the pool raw by the rearm, return it the same way */
+	rte_mempool_put(rxq->mb_pool, buf);
+
+	mb->port = rxq->port_id;
+	mb->pkt_len = pkt_length;
+	mb->data_len = pkt_length;
+	rxq->xstats.copied_pkts++;
+
+	*tail = id;
+	return mb;
+}
+
+/* Prepare mbufs with packet information, copying the short packets */
+static uint16_t prepare_packets_copy(struct qdma_rx_queue *rxq,
 			struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
 {
 	uint16_t count_pkts = 0;
-
-#ifdef QDMA_RX_VEC_X86_64
-	count_pkts = prepare_packets_v(rxq, rx_pkts, nb_pkts);
-#else //QDMA_RX_VEC_X86_64
 	struct rte_mbuf *mb;
 	uint16_t pkt_length;
 	uint16_t count = 0;
+
 	while (count < nb_pkts) {
 		pkt_length = qdma_ul_get_cmpt_pkt_len(
 					&rxq->cmpt_data[count]);
 		if (pkt_length) {
 			rxq->stats.pkts++;
 			rxq->stats.bytes += pkt_length;
-			mb = prepare_segmented_packet(rxq,
-					pkt_length, &rxq->rx_tail);
+			if (pkt_length <= rxq->copy_len)
+				mb = copy_short_packet(rxq, pkt_length,
+						&rxq->rx_tail);
+			else
+				mb = qdma_prepare_segmented_packet(rxq,
+						pkt_length, &rxq->rx_tail);
 			rx_pkts[count_pkts++] = mb;
 		}
 		count++;
 	}
-#endif //QDMA_RX_VEC_X86_64
 
 	return count_pkts;
 }
 
-/* Populate C2H ring with new buffers */
-static int rearm_c2h_ring(struct qdma_rx_queue *rxq, uint16_t num_desc)
+/* Prepare mbufs with packet information */
+static uint16_t prepare_packets(struct qdma_rx_queue *rxq,
+			struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
 {
-	struct qdma_pci_dev *qdma_dev = rxq->dev->data->dev_private;
+	uint16_t count_pkts = 0;
 	struct rte_mbuf *mb;
-	struct qdma_ul_st_c2h_desc *rx_ring_st =
-			(struct qdma_ul_st_c2h_desc *)rxq->rx_ring;
-	uint16_t mbuf_index = 0;
-	uint16_t id;
-	int rearm_descs;
-
-	id = rxq->q_pidx_info.pidx;
+	uint16_t pkt_length;
+	uint16_t count = 0;
 
-	/* Split the C2H ring updation in two parts.
-	 * First handle till end of ring and then
-	 * handle from beginning of ring, if ring wraps
-	 */
-	if ((id + num_desc) < (rxq->nb_rx_desc - 1))
-		rearm_descs = num_desc;
-	else
-		rearm_descs = (rxq->nb_rx_desc - 1) - id;
+	if (rxq->copy_pool != NULL)
+		return prepare_packets_copy(rxq, rx_pkts, nb_pkts);
+
+	switch (rxq->vec_path) {
+#ifdef CC_AVX512_SUPPORT
+	case QDMA_VEC_PATH_AVX512:
+		return qdma_prepare_packets_avx512(rxq, rx_pkts, nb_pkts);
+#endif //CC_AVX512_SUPPORT
+#ifdef CC_AVX2_SUPPORT
+	case QDMA_VEC_PATH_AVX2:
+		return qdma_prepare_packets_avx2(rxq, rx_pkts, nb_pkts);
+#endif //CC_AVX2_SUPPORT
+#ifdef RTE_ARCH_X86_64
+	case QDMA_VEC_PATH_SSE:
+		return prepare_packets_v(rxq, rx_pkts, nb_pkts);
+#endif //RTE_ARCH_X86_64
+	default:
+		break;
+	}
 
-	/* allocate new buffer */
-	if (rte_mempool_get_bulk(rxq->mb_pool, (void *)&rxq->sw_ring[id],
-					rearm_descs) != 0){
-		PMD_DRV_LOG(ERR, "%s(): %d: No MBUFS, queue id = %d,"
-		"mbuf_avail_count = %d,"
-		" mbuf_in_use_count = %d, num_desc_req = %d\n",
-		__func__, __LINE__, rxq->queue_id,
-		rte_mempool_avail_count(rxq->mb_pool),
-		rte_mempool_in_use_count(rxq->mb_pool), rearm_descs);
-		return -1;
+	while (count < nb_pkts) {
+		pkt_length = qdma_ul_get_cmpt_pkt_len(
+					&rxq->cmpt_data[count]);
+		if (pkt_length) {
+			rxq->stats.pkts++;
+			rxq->stats.bytes += pkt_length;
+			mb = qdma_prepare_segmented_packet(rxq,
+					pkt_length, &rxq->rx_tail);
+			rx_pkts[count_pkts++] = mb;
+		}
+		count++;
 	}
 
-#ifdef QDMA_RX_VEC_X86_64
-	int rearm_cnt = rearm_descs & -2;
+	return count_pkts;
+}
+
+#ifdef RTE_ARCH_X86_64
+/* Vector implementation to write C2H descriptors for the buffers
+ * already placed in sw_ring, without ring wrap
+ */
+static void rearm_c2h_desc_v(struct qdma_rx_queue *rxq, uint16_t id,
+		uint16_t num_desc)
+{
+	struct qdma_ul_st_c2h_desc *rx_ring_st =
+			(struct qdma_ul_st_c2h_desc *)rxq->rx_ring;
+	uint16_t rearm_cnt = num_desc & -2;
+	uint16_t mbuf_index;
 	__m128i head_room = _mm_set_epi64x(RTE_PKTMBUF_HEADROOM,
 			RTE_PKTMBUF_HEADROOM);
 
-	for (mbuf_index = 0; mbuf_index < ((uint16_t)rearm_cnt  & 0xFFFF);
+	/* load buf_addr(lo 64bit) and buf_iova(hi 64bit) */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, buf_iova) !=
+			offsetof(struct rte_mbuf, buf_addr) + 8);
+
+	for (mbuf_index = 0; mbuf_index < rearm_cnt;
 			mbuf_index += RTE_QDMA_DESCS_PER_LOOP,
 			id += RTE_QDMA_DESCS_PER_LOOP) {
 		__m128i vaddr0, vaddr1;
 		__m128i dma_addr;
 
-		/* load buf_addr(lo 64bit) and buf_iova(hi 64bit) */
-		RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, buf_iova) !=
-				offsetof(struct rte_mbuf, buf_addr) + 8);
-
 		/* Load two mbufs data addresses */
 		vaddr0 = _mm_loadu_si128(
 				(__m128i *)&(rxq->sw_ring[id]->buf_addr));
@@ -1068,18 +1249,47 @@ static int rearm_c2h_ring(struct qdma_rx_queue *rxq, uint16_t num_desc)
 		_mm_storeu_si128((__m128i *)&rx_ring_st[id], dma_addr);
 	}
 
-	if (rearm_descs & 1) {
-		mb = rxq->sw_ring[id];
-
+	if (num_desc & 1) {
 		/* rearm descriptor */
 		rx_ring_st[id].dst_addr =
-				(uint64_t)mb->buf_iova +
+				(uint64_t)rxq->sw_ring[id]->buf_iova +
 					RTE_PKTMBUF_HEADROOM;
-		id++;
 	}
-#else //QDMA_RX_VEC_X86_64
-	for (mbuf_index = 0; mbuf_index < rearm_descs;
-			mbuf_index++, id++) {
+}
+#endif //RTE_ARCH_X86_64
+
+/* Write C2H descriptors for the buffers already placed in sw_ring,
+ * without ring wrap
+ */
+static void rearm_c2h_desc(struct qdma_rx_queue *rxq, uint16_t id,
+		uint16_t num_desc)
+{
+	struct qdma_ul_st_c2h_desc *rx_ring_st =
+			(struct qdma_ul_st_c2h_desc *)rxq->rx_ring;
+	struct rte_mbuf *mb;
+	uint16_t mbuf_index;
+
+	switch (rxq->vec_path) {
+#ifdef CC_AVX512_SUPPORT
+	case QDMA_VEC_PATH_AVX512:
+		qdma_rearm_c2h_desc_avx512(rxq, id, num_desc);
+		return;
+#endif //CC_AVX512_SUPPORT
+#ifdef CC_AVX2_SUPPORT
+	case QDMA_VEC_PATH_AVX2:
+		qdma_rearm_c2h_desc_avx2(rxq, id, num_desc);
+		return;
+#endif //CC_AVX2_SUPPORT
+#ifdef RTE_ARCH_X86_64
+	case QDMA_VEC_PATH_SSE:
+		rearm_c2h_desc_v(rxq, id, num_desc);
+		return;
+#endif //RTE_ARCH_X86_64
+	default:
+		break;
+	}
+
+	for (mbuf_index = 0; mbuf_index < num_desc; mbuf_index++, id++) {
 		mb = rxq->sw_ring[id];
 		mb->data_off = RTE_PKTMBUF_HEADROOM;
 
@@ -1088,7 +1298,40 @@ static int rearm_c2h_ring(struct qdma_rx_queue *rxq, uint16_t num_desc)
 				(uint64_t)mb->buf_iova +
 					RTE_PKTMBUF_HEADROOM;
 	}
-#endif //QDMA_RX_VEC_X86_64
+}
+
+/* Populate C2H ring with new buffers */
+static int rearm_c2h_ring(struct qdma_rx_queue *rxq, uint16_t num_desc)
+{
+	uint16_t id;
+	int rearm_descs;
+
+	id = rxq->q_pidx_info.pidx;
+
+	/* Split the C2H ring updation in two parts.
+	 * First handle till end of ring and then
+	 * handle from beginning of ring, if ring wraps
+	 */
+	if ((id + num_desc) < (rxq->nb_rx_desc - 1))
+		rearm_descs = num_desc;
+	else
+		rearm_descs = (rxq->nb_rx_desc - 1) - id;
+
+	/* allocate new buffer */
+	if (rte_mempool_get_bulk(rxq->mb_pool, (void *)&rxq->sw_ring[id],
+					rearm_descs) != 0){
+		rxq->xstats.mbuf_alloc_errors += num_desc;
+		PMD_DRV_LOG(ERR, "%s(): %d: No MBUFS, queue id = %d,"
+		"mbuf_avail_count = %d,"
+		" mbuf_in_use_count = %d, num_desc_req = %d\n",
+		__func__, __LINE__, rxq->queue_id,
+		rte_mempool_avail_count(rxq->mb_pool),
+		rte_mempool_in_use_count(rxq->mb_pool), rearm_descs);
+		return -1;
+	}
+
+	rearm_c2h_desc(rxq, id, rearm_descs);
+	id += rearm_descs;
 
 	if (unlikely(id >= (rxq->nb_rx_desc - 1)))
 		id -= (rxq->nb_rx_desc - 1);
@@ -1099,6 +1342,7 @@ static int rearm_c2h_ring(struct qdma_rx_queue *rxq, uint16_t num_desc)
 		/* allocate new buffer */
 		if (rte_mempool_get_bulk(rxq->mb_pool,
 			(void *)&rxq->sw_ring[id], rearm_descs) != 0) {
+			rxq->xstats.mbuf_alloc_errors += rearm_descs;
 			PMD_DRV_LOG(ERR, "%s(): %d: No MBUFS, queue id = %d,"
 			"mbuf_avail_count = %d,"
 			" mbuf_in_use_count = %d, num_desc_req = %d\n",
@@ -1107,24 +1351,15 @@ static int rearm_c2h_ring(struct qdma_rx_queue *rxq, uint16_t num_desc)
 			rte_mempool_in_use_count(rxq->mb_pool), rearm_descs);
 
 			rxq->q_pidx_info.pidx = id;
-			qdma_dev->hw_access->qdma_queue_pidx_update(rxq->dev,
-				qdma_dev->is_vf,
-				rxq->queue_id, 1, &rxq->q_pidx_info);
+			qdma_queue_pidx_db(QDMA_QUEUE_DEV(rxq), rxq->queue_id, 1,
+				&rxq->q_pidx_info);
+			rxq->xstats.pidx_updates++;
 
 			return -1;
 		}
 
-		for (mbuf_index = 0;
-				mbuf_index < ((uint16_t)rearm_descs & 0xFFFF);
-				mbuf_index++, id++) {
-			mb = rxq->sw_ring[id];
-			mb->data_off = RTE_PKTMBUF_HEADROOM;
-
-			/* rearm descriptor */
-			rx_ring_st[id].dst_addr =
-					(uint64_t)mb->buf_iova +
-						RTE_PKTMBUF_HEADROOM;
-		}
+		rearm_c2h_desc(rxq, id, rearm_descs);
+		id += rearm_descs;
 	}
 
 	PMD_DRV_LOG(DEBUG, "%s(): %d: PIDX Update: queue id = %d, "
@@ -1138,45 +1373,37 @@ static int rearm_c2h_ring(struct qdma_rx_queue *rxq, uint16_t num_desc)
 	rte_wmb();
 
 	rxq->q_pidx_info.pidx = id;
-	qdma_dev->hw_access->qdma_queue_pidx_update(rxq->dev,
-		qdma_dev->is_vf,
-		rxq->queue_id, 1, &rxq->q_pidx_info);
+	qdma_queue_pidx_db(QDMA_QUEUE_DEV(rxq), rxq->queue_id, 1,
+		&rxq->q_pidx_info);
+	rxq->xstats.pidx_updates++;
 
 	return 0;
 }
 
-/* Receive API for Streaming mode */
-uint16_t qdma_recv_pkts_st(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
-				uint16_t nb_pkts)
+/* Rx burst function of a queue that is stopped or has failed */
+static uint16_t recv_pkts_none(struct qdma_rx_queue *rxq __rte_unused,
+		struct rte_mbuf **rx_pkts __rte_unused,
+		uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+
+/* Consume up to nb_pkts available CMPT entries.
+ * Returns the number of entries consumed.
+ */
+static __rte_always_inline uint16_t recv_cmpt_st(struct qdma_rx_queue *rxq,
+		uint16_t nb_pkts, const int imm_data)
 {
-	uint16_t count_pkts;
-	struct wb_status *wb_status;
 	uint16_t nb_pkts_avail = 0;
 	uint16_t rx_cmpt_tail = 0;
-	uint16_t cmpt_pidx, c2h_pidx;
-	uint16_t pending_desc;
-#ifdef TEST_64B_DESC_BYPASS
-	int bypass_desc_sz_idx = qmda_get_desc_sz_idx(rxq->bypass_desc_sz);
-#endif
-
-	if (unlikely(rxq->err))
-		return 0;
+	uint16_t cmpt_pidx;
+	int ret;
 
 	PMD_DRV_LOG(DEBUG, "recv start on rx queue-id :%d, on "
 			"tail index:%d number of pkts %d",
 			rxq->queue_id, rxq->rx_tail, nb_pkts);
-	wb_status = rxq->wb_status;
 	rx_cmpt_tail = rxq->cmpt_cidx_info.wrb_cidx;
-
-#ifdef TEST_64B_DESC_BYPASS
-	if (unlikely(rxq->en_bypass &&
-			bypass_desc_sz_idx == SW_DESC_CNTXT_64B_BYPASS_DMA)) {
-		PMD_DRV_LOG(DEBUG, "For  RX ST-mode, example"
-				" design doesn't support 64byte descriptor\n");
-		return 0;
-	}
-#endif
-	cmpt_pidx = wb_status->pidx;
+	cmpt_pidx = rxq->wb_status->pidx;
 
 	if (rx_cmpt_tail < cmpt_pidx)
 		nb_pkts_avail = cmpt_pidx - rx_cmpt_tail;
@@ -1187,9 +1414,14 @@ uint16_t qdma_recv_pkts_st(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 	if (nb_pkts_avail == 0) {
 		PMD_DRV_LOG(DEBUG, "%s(): %d: nb_pkts_avail = 0\n",
 				__func__, __LINE__);
+		rxq->xstats.empty_polls++;
 		return 0;
 	}
 
+	rxq->xstats.cmpt_pending_total += nb_pkts_avail;
+	if (unlikely(nb_pkts_avail > rxq->xstats.cmpt_pending_max))
+		rxq->xstats.cmpt_pending_max = nb_pkts_avail;
+
 	if (nb_pkts > QDMA_MAX_BURST_SIZE)
 		nb_pkts = QDMA_MAX_BURST_SIZE;
 
@@ -1210,14 +1442,32 @@ uint16_t qdma_recv_pkts_st(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 #ifdef QDMA_LATENCY_OPTIMIZED
 	adapt_update_counter(rxq, nb_pkts_avail);
 #endif //QDMA_LATENCY_OPTIMIZED
-	if (process_cmpt_ring(rxq, nb_pkts) != 0)
+	if (imm_data)
+		ret = process_cmpt_ring_imm(rxq, nb_pkts);
+	else
+		ret = process_cmpt_ring(rxq, nb_pkts);
+	if (unlikely(ret != 0)) {
+		/* Stop receiving on a failed queue */
+		qdma_set_rx_burst(rxq);
 		return 0;
+	}
 
-	if (rxq->status != RTE_ETH_QUEUE_STATE_STARTED) {
-		PMD_DRV_LOG(DEBUG, "%s(): %d: rxq->status = %d\n",
-				__func__, __LINE__, rxq->status);
+	return nb_pkts;
+}
+
+/* Receive template for Streaming mode, imm_data is a compile time
+ * constant in each of the instances below
+ */
+static __rte_always_inline uint16_t recv_pkts_st(struct qdma_rx_queue *rxq,
+		struct rte_mbuf **rx_pkts, uint16_t nb_pkts, const int imm_data)
+{
+	uint16_t count_pkts;
+	uint16_t c2h_pidx;
+	uint16_t pending_desc;
+
+	nb_pkts = recv_cmpt_st(rxq, nb_pkts, imm_data);
+	if (nb_pkts == 0)
 		return 0;
-	}
 
 	count_pkts = prepare_packets(rxq, rx_pkts, nb_pkts);
 
@@ -1249,36 +1499,53 @@ uint16_t qdma_recv_pkts_st(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 	return count_pkts;
 }
 
+/* Receive API for Streaming mode */
+uint16_t qdma_recv_pkts_st(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
+				uint16_t nb_pkts)
+{
+	return recv_pkts_st(rxq, rx_pkts, nb_pkts, 0);
+}
+
+/* Receive API for Streaming mode with immediate data dump enabled */
+uint16_t qdma_recv_pkts_st_imm(struct qdma_rx_queue *rxq,
+				struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
+{
+	return recv_pkts_st(rxq, rx_pkts, nb_pkts, 1);
+}
+
+/* Rx burst function of a stopped Streaming mode queue. The CMPT ring is
+ * still consumed so that the queue stop can wait for it to drain, the
+ * packets themselves are dropped on queue reset.
+ */
+static uint16_t recv_pkts_st_stopped(struct qdma_rx_queue *rxq,
+		struct rte_mbuf **rx_pkts __rte_unused, uint16_t nb_pkts)
+{
+	if (rxq->dump_immediate_data)
+		recv_cmpt_st(rxq, nb_pkts, 1);
+	else
+		recv_cmpt_st(rxq, nb_pkts, 0);
+
+	PMD_DRV_LOG(DEBUG, "%s(): %d: rxq->status = %d\n",
+			__func__, __LINE__, rxq->status);
+	return 0;
+}
+
 /* Receive API for Memory mapped mode */
 uint16_t qdma_recv_pkts_mm(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 			uint16_t nb_pkts)
 {
+	struct qdma_ul_mm_desc *rx_ring = (struct qdma_ul_mm_desc *)rxq->rx_ring;
+	uint16_t ring_sz = rxq->nb_rx_desc - 1;
 	struct rte_mbuf *mb;
 	uint32_t count, id;
-	struct qdma_ul_mm_desc *desc;
 	uint32_t len;
 	int ret;
-	struct qdma_pci_dev *qdma_dev = rxq->dev->data->dev_private;
-#ifdef TEST_64B_DESC_BYPASS
-	int bypass_desc_sz_idx = qmda_get_desc_sz_idx(rxq->bypass_desc_sz);
-#endif
-
-	if (rxq->status != RTE_ETH_QUEUE_STATE_STARTED)
-		return 0;
 
 	id = rxq->q_pidx_info.pidx; /* Descriptor index */
 
 	PMD_DRV_LOG(DEBUG, "recv start on rx queue-id :%d, on tail index:%d\n",
 			rxq->queue_id, id);
 
-#ifdef TEST_64B_DESC_BYPASS
-	if (unlikely(rxq->en_bypass &&
-			bypass_desc_sz_idx == SW_DESC_CNTXT_64B_BYPASS_DMA)) {
-		PMD_DRV_LOG(DEBUG, "For MM mode, example design doesn't "
-				"support 64byte descriptor\n");
-		return 0;
-	}
-#endif
 	/* Make 1 less available, otherwise if we allow all descriptors
 	 * to be filled,when nb_pkts = nb_tx_desc - 1, pidx will be same
 	 * as old pidx and HW will treat this as no new descriptors were added.
@@ -1286,39 +1553,49 @@ uint16_t qdma_recv_pkts_mm(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 	 */
 	if (nb_pkts > rxq->nb_rx_desc - 2)
 		nb_pkts = rxq->nb_rx_desc - 2;
+	if (!nb_pkts)
+		return 0;
 
-	for (count = 0; count < nb_pkts; count++) {
-		/* allocate new buffer */
-		if (rte_mempool_get(rxq->mb_pool, (void *)&mb) != 0) {
-			PMD_DRV_LOG(ERR, "%s(): %d: No MBUFS, queue id = %d,"
-			"mbuf_avail_count = %d,"
-			" mbuf_in_use_count = %d\n",
-			__func__, __LINE__, rxq->queue_id,
-			rte_mempool_avail_count(rxq->mb_pool),
-			rte_mempool_in_use_count(rxq->mb_pool));
-			return 0;
-		}
-
-		desc = (struct qdma_ul_mm_desc *)rxq->rx_ring;
-		desc += id;
-		qdma_ul_update_mm_c2h_desc(rxq, mb, desc);
+	/* allocate new buffers for the whole burst */
+	if (rte_mempool_get_bulk(rxq->mb_pool, (void **)rx_pkts,
+				nb_pkts) != 0) {
+		PMD_DRV_LOG(ERR, "%s(): %d: No MBUFS, queue id = %d,"
+		"mbuf_avail_count = %d,"
+		" mbuf_in_use_count = %d, num_desc_req = %d\n",
+		__func__, __LINE__, rxq->queue_id,
+		rte_mempool_avail_count(rxq->mb_pool),
+		rte_mempool_in_use_count(rxq->mb_pool), nb_pkts);
+		rxq->xstats.mbuf_alloc_errors += nb_pkts;
+		return 0;
+	}
 
-		len = (int)rxq->rx_buff_size;
-		rte_pktmbuf_pkt_len(mb) = len;
+	len = rxq->rx_buff_size;
+	for (count = 0; count < nb_pkts; count++) {
+		mb = rx_pkts[count];
 
-		rte_mbuf_refcnt_set(mb, 1);
-		mb->packet_type = 0;
+		/* data_off, refcnt, nb_segs and port in one store */
+		*(uint64_t *)(uintptr_t)&mb->rearm_data =
+				rxq->mbuf_initializer;
 		mb->ol_flags = 0;
-		mb->next = 0;
-		mb->nb_segs = 1;
-		mb->port = rxq->port_id;
+		mb->packet_type = 0;
+		mb->next = NULL;
+		mb->pkt_len = len;
+		mb->data_len = len;
 		mb->vlan_tci = 0;
 		mb->hash.rss = 0;
 
-		rx_pkts[count] = mb;
+#ifdef RTE_ARCH_X86_64
+		if (rxq->vec_path != QDMA_VEC_PATH_SCALAR)
+			qdma_ul_write_mm_desc_v(&rx_ring[id], rxq->ep_addr,
+					mb->buf_iova + RTE_PKTMBUF_HEADROOM,
+					len);
+		else
+#endif //RTE_ARCH_X86_64
+			qdma_ul_update_mm_c2h_desc(rxq, mb, &rx_ring[id]);
 
 		rxq->ep_addr = (rxq->ep_addr + len) % DMA_BRAM_SIZE;
-		id = (id + 1) % (rxq->nb_rx_desc - 1);
+		if (unlikely(++id == ring_sz))
+			id = 0;
 	}
 
 	/* Make sure writes to the C2H descriptors are synchronized
@@ -1327,12 +1604,10 @@ uint16_t qdma_recv_pkts_mm(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 	rte_wmb();
 
 	/* update pidx pointer for MM-mode*/
-	if (count > 0) {
-		rxq->q_pidx_info.pidx = id;
-		qdma_dev->hw_access->qdma_queue_pidx_update(rxq->dev,
-			qdma_dev->is_vf,
-			rxq->queue_id, 1, &rxq->q_pidx_info);
-	}
+	rxq->q_pidx_info.pidx = id;
+	qdma_queue_pidx_db(QDMA_QUEUE_DEV(rxq), rxq->queue_id, 1,
+		&rxq->q_pidx_info);
+	rxq->xstats.pidx_updates++;
 
 	ret = dma_wb_monitor(rxq, DMA_FROM_DEVICE, id);
 	if (ret) {//Error
@@ -1345,6 +1620,20 @@ uint16_t qdma_recv_pkts_mm(struct qdma_rx_queue *rxq, struct rte_mbuf **rx_pkts,
 	}
 	return count;
 }
+
+static uint16_t recv_pkts_timed(struct qdma_rx_queue *rxq,
+		struct rte_mbuf **rx_pkts, uint16_t nb_pkts);
+
+/* Rx burst functions, indexed by enum qdma_rx_burst_idx */
+static const qdma_rx_burst_t qdma_rx_burst_ops[QDMA_RX_BURST_MAX] = {
+	[QDMA_RX_BURST_NONE]		= recv_pkts_none,
+	[QDMA_RX_BURST_ST_STOPPED]	= recv_pkts_st_stopped,
+	[QDMA_RX_BURST_ST]		= qdma_recv_pkts_st,
+	[QDMA_RX_BURST_ST_IMM]		= qdma_recv_pkts_st_imm,
+	[QDMA_RX_BURST_MM]		= qdma_recv_pkts_mm,
+	[QDMA_RX_BURST_TIMED]		= recv_pkts_timed,
+};
+
 /**
  * DPDK callback for receiving packets in burst.
  *
@@ -1362,16 +1651,68 @@ uint16_t qdma_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts,
 			uint16_t nb_pkts)
 {
 	struct qdma_rx_queue *rxq = rx_queue;
-	uint32_t count;
 
-	if (rxq->st_mode)
-		count = qdma_recv_pkts_st(rxq, rx_pkts, nb_pkts);
-	else
-		count = qdma_recv_pkts_mm(rxq, rx_pkts, nb_pkts);
+	return qdma_rx_burst_ops[rxq->rx_burst](rxq, rx_pkts, nb_pkts);
+}
+
+/* Rx burst wrapper sampling the TSC cycles of the queue burst function */
+static uint16_t recv_pkts_timed(struct qdma_rx_queue *rxq,
+		struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
+{
+	uint64_t tsc = rte_rdtsc();
+	uint16_t count = qdma_rx_burst_ops[rxq->timed_rx_burst](rxq, rx_pkts,
+			nb_pkts);
 
+	rxq->xstats.burst_cycles += rte_rdtsc() - tsc;
+	rxq->xstats.timed_bursts++;
 	return count;
 }
 
+/**
+ * Select the Rx burst function matching the current mode and state of
+ * the queue. Called at queue setup, start and stop, and when the queue
+ * fails.
+ *
+ * @param rxq
+ *   Pointer to Rx queue specific data structure.
+ */
+void qdma_set_rx_burst(struct qdma_rx_queue *rxq)
+{
+	struct qdma_pci_dev *qdma_dev = QDMA_QUEUE_DEV(rxq)->data->dev_private;
+	enum qdma_rx_burst_idx rx_burst;
+
+	if (unlikely(rxq->err)) {
+		rx_burst = QDMA_RX_BURST_NONE;
+#ifdef TEST_64B_DESC_BYPASS
+	} else if (rxq->en_bypass &&
+			qmda_get_desc_sz_idx(rxq->bypass_desc_sz) ==
+			SW_DESC_CNTXT_64B_BYPASS_DMA) {
+		PMD_DRV_LOG(DEBUG, "For RX %s-mode, example design doesn't "
+				"support 64byte descriptor\n",
+				rxq->st_mode ? "ST" : "MM");
+		rx_burst = QDMA_RX_BURST_NONE;
+#endif
+	} else if (rxq->status != RTE_ETH_QUEUE_STATE_STARTED) {
+		rx_burst = rxq->st_mode ? QDMA_RX_BURST_ST_STOPPED :
+				QDMA_RX_BURST_NONE;
+	} else if (!rxq->st_mode) {
+		rx_burst = QDMA_RX_BURST_MM;
+	} else if (rxq->dump_immediate_data) {
+		rx_burst = QDMA_RX_BURST_ST_IMM;
+	} else {
+		rx_burst = QDMA_RX_BURST_ST;
+	}
+
+	if (rxq->status == RTE_ETH_QUEUE_STATE_STARTED &&
+			rx_burst != QDMA_RX_BURST_NONE &&
+			qdma_dev->burst_cycles) {
+		rxq->timed_rx_burst = rx_burst;
+		rx_burst = QDMA_RX_BURST_TIMED;
+	}
+
+	rxq->rx_burst = rx_burst;
+}
+
 /**
  * DPDK callback to request the driver to free mbufs
  * currently cached by the driver.
@@ -1447,47 +1788,36 @@ qdma_dev_tx_descriptor_status(void *tx_queue, uint16_t offset)
 	return RTE_ETH_TX_DESC_FULL;
 }
 
-/* Transmit API for Streaming mode */
-uint16_t qdma_xmit_pkts_st(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
-			uint16_t nb_pkts)
+/* Update the H2C PIDX with the descriptors written so far */
+static inline void tx_pidx_flush(struct qdma_tx_queue *txq)
 {
-	struct rte_mbuf *mb;
-	uint64_t pkt_len = 0;
-	int avail, in_use, ret, nsegs;
-	uint16_t cidx = 0;
-	uint16_t count = 0, id;
-	struct qdma_pci_dev *qdma_dev = txq->dev->data->dev_private;
-#ifdef TEST_64B_DESC_BYPASS
-	int bypass_desc_sz_idx = qmda_get_desc_sz_idx(txq->bypass_desc_sz);
-
-	if (unlikely(txq->en_bypass &&
-			bypass_desc_sz_idx == SW_DESC_CNTXT_64B_BYPASS_DMA)) {
-		return qdma_xmit_64B_desc_bypass(txq, tx_pkts, nb_pkts);
-	}
-#endif
-
-	id = txq->q_pidx_info.pidx;
-	cidx = txq->wb_status->cidx;
-	PMD_DRV_LOG(DEBUG, "Xmit start on tx queue-id:%d, tail index:%d\n",
-			txq->queue_id, id);
-
-	/* Free transmitted mbufs back to pool */
-	reclaim_tx_mbuf(txq, cidx, 0);
+	qdma_queue_pidx_db(QDMA_QUEUE_DEV(txq), txq->queue_id, 0,
+			&txq->q_pidx_info);
+	txq->xstats.pidx_updates++;
+	txq->tx_desc_pend = 0;
+}
 
-	in_use = (int)id - cidx;
-	if (in_use < 0)
-		in_use += (txq->nb_tx_desc - 1);
+/**
+ * Update the H2C PIDX of a ST queue with the descriptors the Tx burst
+ * function left pending, see MIN_TX_PIDX_UPDATE_THRESHOLD.
+ *
+ * @param txq
+ *   Pointer to Tx queue specific data structure.
+ */
+void qdma_txq_pidx_flush(struct qdma_tx_queue *txq)
+{
+	if (txq->tx_desc_pend)
+		tx_pidx_flush(txq);
+}
 
-	/* Make 1 less available, otherwise if we allow all descriptors
-	 * to be filled, when nb_pkts = nb_tx_desc - 1, pidx will be same
-	 * as old pidx and HW will treat this as no new descriptors were added.
-	 * Hence, DMA won't happen with new descriptors.
-	 */
-	avail = txq->nb_tx_desc - 2 - in_use;
-	if (!avail) {
-		PMD_DRV_LOG(DEBUG, "Tx queue full, in_use = %d", in_use);
-		return 0;
-	}
+/* Write H2C descriptors for as many packets as fit in avail descriptors */
+static uint16_t xmit_st_desc(struct qdma_tx_queue *txq,
+		struct rte_mbuf **tx_pkts, uint16_t nb_pkts, int avail,
+		uint64_t *pkt_len)
+{
+	struct rte_mbuf *mb;
+	uint16_t count, id;
+	int ret, nsegs;
 
 	for (count = 0; count < nb_pkts; count++) {
 		mb = tx_pkts[count];
@@ -1502,19 +1832,74 @@ uint16_t qdma_xmit_pkts_st(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 		avail -= nsegs;
 		id = txq->q_pidx_info.pidx;
 		txq->sw_ring[id] = mb;
-		pkt_len += rte_pktmbuf_pkt_len(mb);
+		*pkt_len += rte_pktmbuf_pkt_len(mb);
 
-#ifdef QDMA_TX_VEC_X86_64
-		ret = qdma_ul_update_st_h2c_desc_v(txq, txq->offloads, mb);
-#else
-		ret = qdma_ul_update_st_h2c_desc(txq, txq->offloads, mb);
+#ifdef RTE_ARCH_X86_64
+		if (txq->vec_path != QDMA_VEC_PATH_SCALAR)
+			ret = qdma_ul_update_st_h2c_desc_v(txq, txq->offloads,
+					mb);
+		else
 #endif //RTE_ARCH_X86_64
+			ret = qdma_ul_update_st_h2c_desc(txq, txq->offloads,
+					mb);
 		if (ret < 0)
 			break;
 	}
 
+	return count;
+}
+
+/* Transmit API for Streaming mode */
+uint16_t qdma_xmit_pkts_st(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
+			uint16_t nb_pkts)
+{
+	uint64_t pkt_len = 0;
+	int avail;
+	uint16_t cidx = 0;
+	uint16_t count = 0;
+
+	cidx = txq->wb_status->cidx;
+	PMD_DRV_LOG(DEBUG, "Xmit start on tx queue-id:%d, tail index:%d\n",
+			txq->queue_id, txq->q_pidx_info.pidx);
+
+#if (MIN_TX_PIDX_UPDATE_THRESHOLD > 1)
+	/* Flush the descriptors pending from earlier bursts once their
+	 * deadline has passed
+	 */
+	if (txq->tx_desc_pend && rte_rdtsc() >= txq->pidx_flush_tsc)
+		tx_pidx_flush(txq);
+#endif
+
+	/* Free transmitted mbufs back to pool */
+	avail = tx_avail_desc(txq, cidx);
+	if (!avail) {
+		PMD_DRV_LOG(DEBUG, "Tx queue full, cidx = %d", cidx);
+		txq->xstats.ring_full++;
+		txq->xstats.pkts_rejected += nb_pkts;
+		return 0;
+	}
+
+	switch (txq->vec_path) {
+#ifdef CC_AVX512_SUPPORT
+	case QDMA_VEC_PATH_AVX512:
+		count = qdma_xmit_st_desc_avx512(txq, tx_pkts, nb_pkts,
+				avail, &pkt_len);
+		break;
+#endif //CC_AVX512_SUPPORT
+#ifdef CC_AVX2_SUPPORT
+	case QDMA_VEC_PATH_AVX2:
+		count = qdma_xmit_st_desc_avx2(txq, tx_pkts, nb_pkts,
+				avail, &pkt_len);
+		break;
+#endif //CC_AVX2_SUPPORT
+	default:
+		count = xmit_st_desc(txq, tx_pkts, nb_pkts, avail, &pkt_len);
+		break;
+	}
+
 	txq->stats.pkts += count;
 	txq->stats.bytes += pkt_len;
+	txq->xstats.pkts_rejected += nb_pkts - count;
 
 	/* Make sure writes to the H2C descriptors are synchronized
 	 * before updating PIDX
@@ -1522,23 +1907,17 @@ uint16_t qdma_xmit_pkts_st(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 	rte_wmb();
 
 #if (MIN_TX_PIDX_UPDATE_THRESHOLD > 1)
-	rte_spinlock_lock(&txq->pidx_update_lock);
+	/* Descriptors left pending must reach the HW by the deadline */
+	if (!txq->tx_desc_pend && count)
+		txq->pidx_flush_tsc = rte_rdtsc() + txq->pidx_flush_cycles;
 #endif
 	txq->tx_desc_pend += count;
 
 	/* Send PIDX update only if pending desc is more than threshold
 	 * Saves frequent Hardware transactions
 	 */
-	if (txq->tx_desc_pend >= MIN_TX_PIDX_UPDATE_THRESHOLD) {
-		qdma_dev->hw_access->qdma_queue_pidx_update(txq->dev,
-			qdma_dev->is_vf,
-			txq->queue_id, 0, &txq->q_pidx_info);
-
-		txq->tx_desc_pend = 0;
-	}
-#if (MIN_TX_PIDX_UPDATE_THRESHOLD > 1)
-	rte_spinlock_unlock(&txq->pidx_update_lock);
-#endif
+	if (txq->tx_desc_pend >= MIN_TX_PIDX_UPDATE_THRESHOLD)
+		tx_pidx_flush(txq);
 	PMD_DRV_LOG(DEBUG, " xmit completed with count:%d\n", count);
 
 	return count;
@@ -1548,68 +1927,64 @@ uint16_t qdma_xmit_pkts_st(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 uint16_t qdma_xmit_pkts_mm(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 			uint16_t nb_pkts)
 {
+	struct qdma_ul_mm_desc *tx_ring = (struct qdma_ul_mm_desc *)txq->tx_ring;
+	uint16_t ring_sz = txq->nb_tx_desc - 1;
 	struct rte_mbuf *mb;
 	uint32_t count, id;
 	uint64_t	len = 0;
-	int avail, in_use;
+	int avail;
 	int ret;
-	struct qdma_pci_dev *qdma_dev = txq->dev->data->dev_private;
 	uint16_t cidx = 0;
 
-#ifdef TEST_64B_DESC_BYPASS
-	int bypass_desc_sz_idx = qmda_get_desc_sz_idx(txq->bypass_desc_sz);
-#endif
-
 	id = txq->q_pidx_info.pidx;
 	PMD_DRV_LOG(DEBUG, "Xmit start on tx queue-id:%d, tail index:%d\n",
 			txq->queue_id, id);
 
-#ifdef TEST_64B_DESC_BYPASS
-	if (unlikely(txq->en_bypass &&
-			bypass_desc_sz_idx == SW_DESC_CNTXT_64B_BYPASS_DMA)) {
-		PMD_DRV_LOG(DEBUG, "For MM mode, example design doesn't "
-				"support 64B bypass testing\n");
-		return 0;
-	}
-#endif
 	cidx = txq->wb_status->cidx;
 	/* Free transmitted mbufs back to pool */
-	reclaim_tx_mbuf(txq, cidx, 0);
-	in_use = (int)id - cidx;
-	if (in_use < 0)
-		in_use += (txq->nb_tx_desc - 1);
-
-	/* Make 1 less available, otherwise if we allow all descriptors to be
-	 * filled, when nb_pkts = nb_tx_desc - 1, pidx will be same as old pidx
-	 * and HW will treat this as no new descriptors were added.
-	 * Hence, DMA won't happen with new descriptors.
-	 */
-	avail = txq->nb_tx_desc - 2 - in_use;
+	avail = tx_avail_desc(txq, cidx);
 	if (!avail) {
-		PMD_DRV_LOG(ERR, "Tx queue full, in_use = %d", in_use);
+		PMD_DRV_LOG(ERR, "Tx queue full, cidx = %d", cidx);
+		txq->xstats.ring_full++;
+		txq->xstats.pkts_rejected += nb_pkts;
 		return 0;
 	}
 
-	if (nb_pkts > avail)
+	if (nb_pkts > avail) {
+		txq->xstats.pkts_rejected += nb_pkts - avail;
 		nb_pkts = avail;
+	}
 
 	// Set the xmit descriptors and control bits
 	for (count = 0; count < nb_pkts; count++) {
 
 		mb = tx_pkts[count];
 		txq->sw_ring[id] = mb;
+		len = rte_pktmbuf_data_len(mb);
+
 		/*Update the descriptor control feilds*/
-		qdma_ul_update_mm_h2c_desc(txq, mb);
+#ifdef RTE_ARCH_X86_64
+		if (txq->vec_path != QDMA_VEC_PATH_SCALAR) {
+			qdma_ul_write_mm_desc_v(&tx_ring[id],
+					mb->buf_iova + mb->data_off,
+					txq->ep_addr, len);
+		} else
+#endif //RTE_ARCH_X86_64
+		{
+			txq->q_pidx_info.pidx = id;
+			qdma_ul_update_mm_h2c_desc(txq, mb);
+		}
 
-		len = rte_pktmbuf_data_len(mb);
 		PMD_DRV_LOG(DEBUG, "xmit number of bytes:%ld, count:%d ",
 				len, count);
 
 #ifndef TANDEM_BOOT_SUPPORTED
 		txq->ep_addr = (txq->ep_addr + len) % DMA_BRAM_SIZE;
 #endif
-		id = txq->q_pidx_info.pidx;
+		if (unlikely(++id == ring_sz))
+			id = 0;
 	}
+	txq->q_pidx_info.pidx = id;
 
 	/* Make sure writes to the H2C descriptors are synchronized before
 	 * updating PIDX
@@ -1619,9 +1994,9 @@ uint16_t qdma_xmit_pkts_mm(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 	/* update pidx pointer */
 	if (count > 0) {
 		PMD_DRV_LOG(INFO, "tx PIDX=%d", txq->q_pidx_info.pidx);
-		qdma_dev->hw_access->qdma_queue_pidx_update(txq->dev,
-			qdma_dev->is_vf,
-			txq->queue_id, 0, &txq->q_pidx_info);
+		qdma_queue_pidx_db(QDMA_QUEUE_DEV(txq), txq->queue_id, 0,
+			&txq->q_pidx_info);
+		txq->xstats.pidx_updates++;
 	}
 
 	ret = dma_wb_monitor(txq, DMA_TO_DEVICE, id);
@@ -1636,6 +2011,28 @@ uint16_t qdma_xmit_pkts_mm(struct qdma_tx_queue *txq, struct rte_mbuf **tx_pkts,
 	PMD_DRV_LOG(DEBUG, " xmit completed with count:%d", count);
 	return count;
 }
+/* Tx burst function of a stopped queue */
+static uint16_t xmit_pkts_none(struct qdma_tx_queue *txq __rte_unused,
+		struct rte_mbuf **tx_pkts __rte_unused,
+		uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+
+static uint16_t xmit_pkts_timed(struct qdma_tx_queue *txq,
+		struct rte_mbuf **tx_pkts, uint16_t nb_pkts);
+
+/* Tx burst functions, indexed by enum qdma_tx_burst_idx */
+static const qdma_tx_burst_t qdma_tx_burst_ops[QDMA_TX_BURST_MAX] = {
+	[QDMA_TX_BURST_NONE]		= xmit_pkts_none,
+	[QDMA_TX_BURST_ST]		= qdma_xmit_pkts_st,
+	[QDMA_TX_BURST_MM]		= qdma_xmit_pkts_mm,
+#ifdef TEST_64B_DESC_BYPASS
+	[QDMA_TX_BURST_64B_BYPASS]	= qdma_xmit_64B_desc_bypass,
+#endif
+	[QDMA_TX_BURST_TIMED]		= xmit_pkts_timed,
+};
+
 /**
  * DPDK callback for transmitting packets in burst.
  *
@@ -1653,15 +2050,235 @@ uint16_t qdma_xmit_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
 			uint16_t nb_pkts)
 {
 	struct qdma_tx_queue *txq = tx_queue;
-	uint16_t count;
 
-	if (txq->status != RTE_ETH_QUEUE_STATE_STARTED)
-		return 0;
+	return qdma_tx_burst_ops[txq->tx_burst](txq, tx_pkts, nb_pkts);
+}
 
-	if (txq->st_mode)
-		count =	qdma_xmit_pkts_st(txq, tx_pkts, nb_pkts);
-	else
-		count =	qdma_xmit_pkts_mm(txq, tx_pkts, nb_pkts);
+/* Tx burst wrapper sampling the TSC cycles of the queue burst function */
+static uint16_t xmit_pkts_timed(struct qdma_tx_queue *txq,
+		struct rte_mbuf **tx_pkts, uint16_t nb_pkts)
+{
+	uint64_t tsc = rte_rdtsc();
+	uint16_t count = qdma_tx_burst_ops[txq->timed_tx_burst](txq, tx_pkts,
+			nb_pkts);
 
+	txq->xstats.burst_cycles += rte_rdtsc() - tsc;
+	txq->xstats.timed_bursts++;
 	return count;
 }
+
+/**
+ * Select the Tx burst function matching the current mode and state of
+ * the queue. Called at queue setup, start and stop.
+ *
+ * @param txq
+ *   Pointer to Tx queue specific data structure.
+ */
+void qdma_set_tx_burst(struct qdma_tx_queue *txq)
+{
+	struct qdma_pci_dev *qdma_dev = QDMA_QUEUE_DEV(txq)->data->dev_private;
+	enum qdma_tx_burst_idx tx_burst;
+
+	if (txq->status != RTE_ETH_QUEUE_STATE_STARTED) {
+		tx_burst = QDMA_TX_BURST_NONE;
+#ifdef TEST_64B_DESC_BYPASS
+	} else if (txq->en_bypass &&
+			qmda_get_desc_sz_idx(txq->bypass_desc_sz) ==
+			SW_DESC_CNTXT_64B_BYPASS_DMA) {
+		if (txq->st_mode) {
+			tx_burst = QDMA_TX_BURST_64B_BYPASS;
+		} else {
+			PMD_DRV_LOG(DEBUG, "For MM mode, example design "
+					"doesn't support 64B bypass testing\n");
+			tx_burst = QDMA_TX_BURST_NONE;
+		}
+#endif
+	} else if (txq->st_mode) {
+		tx_burst = QDMA_TX_BURST_ST;
+	} else {
+		tx_burst = QDMA_TX_BURST_MM;
+	}
+
+	if (txq->status == RTE_ETH_QUEUE_STATE_STARTED &&
+			tx_burst != QDMA_TX_BURST_NONE &&
+			qdma_dev->burst_cycles) {
+		txq->timed_tx_burst = tx_burst;
+		tx_burst = QDMA_TX_BURST_TIMED;
+	}
+
+	txq->tx_burst = tx_burst;
+}
+
+/* Descriptors of a MM copy API queue free for new copies */
+static inline uint16_t dma_chan_free_desc(struct qdma_dma_chan *chan)
+{
+	int in_use = (int)chan->pidx - chan->cidx;
+
+	if (in_use < 0)
+		in_use += chan->ring_sz;
+
+	/* Make 1 less available so that pidx never catches up with cidx */
+	return chan->ring_sz - 1 - in_use;
+}
+
+/* Write one MM descriptor of the copy API queue */
+static __rte_always_inline void dma_chan_write_desc(struct qdma_dma_chan *chan,
+		uint64_t src, uint64_t dst, uint32_t len)
+{
+	struct qdma_ul_mm_desc *desc = &chan->ring[chan->pidx];
+
+#ifdef RTE_ARCH_X86_64
+	if (chan->vec) {
+		qdma_ul_write_mm_desc_v(desc, src, dst, len);
+	} else
+#endif //RTE_ARCH_X86_64
+	{
+		desc->src_addr = src;
+		desc->dst_addr = dst;
+		desc->len = len;
+		desc->dv = 1;
+		desc->sop = 1;
+		desc->eop = 1;
+	}
+
+	if (unlikely(++chan->pidx == chan->ring_sz))
+		chan->pidx = 0;
+	chan->pending++;
+}
+
+int rte_pmd_qdma_dma_submit(void *chan)
+{
+	struct qdma_dma_chan *dma_chan = chan;
+
+	if (!dma_chan->pending)
+		return 0;
+
+	/* Make sure writes to the descriptors are synchronized
+	 * before updating PIDX
+	 */
+	rte_wmb();
+
+	dma_chan->pidx_info->pidx = dma_chan->pidx;
+	qdma_queue_pidx_db(QDMA_QUEUE_DEV(dma_chan), dma_chan->queue_id,
+			dma_chan->is_c2h, dma_chan->pidx_info);
+	dma_chan->pending = 0;
+
+	return 0;
+}
+
+int rte_pmd_qdma_dma_copy(void *chan, rte_iova_t src, rte_iova_t dst,
+		uint32_t length, uint64_t flags)
+{
+	struct qdma_dma_chan *dma_chan = chan;
+
+	if (unlikely(!length || length > RTE_PMD_QDMA_DMA_MAX_LEN))
+		return -EINVAL;
+	if (unlikely(!dma_chan_free_desc(dma_chan)))
+		return -ENOSPC;
+
+	dma_chan_write_desc(dma_chan, src, dst, length);
+	if (flags & RTE_PMD_QDMA_DMA_OP_FLAG_SUBMIT)
+		rte_pmd_qdma_dma_submit(chan);
+
+	return (uint16_t)dma_chan->next_idx++;
+}
+
+/* Walk the scatter-gather lists of a copy, one descriptor per contiguous
+ * piece, and write the descriptors if asked to.
+ * Returns the number of descriptors or -EINVAL if the total lengths differ.
+ */
+static int dma_chan_sg(struct qdma_dma_chan *chan,
+		const struct rte_pmd_qdma_dma_sge *src,
+		const struct rte_pmd_qdma_dma_sge *dst,
+		uint16_t nb_src, uint16_t nb_dst, int write)
+{
+	uint32_t s_off = 0, d_off = 0, len;
+	uint16_t s = 0, d = 0;
+	int nb_desc = 0;
+
+	for (;;) {
+		while (s < nb_src && s_off == src[s].length) {
+			s++;
+			s_off = 0;
+		}
+		while (d < nb_dst && d_off == dst[d].length) {
+			d++;
+			d_off = 0;
+		}
+		if (s == nb_src || d == nb_dst)
+			break;
+
+		len = RTE_MIN(src[s].length - s_off, dst[d].length - d_off);
+		len = RTE_MIN(len, RTE_PMD_QDMA_DMA_MAX_LEN);
+		if (write)
+			dma_chan_write_desc(chan, src[s].addr + s_off,
+					dst[d].addr + d_off, len);
+		s_off += len;
+		d_off += len;
+		nb_desc++;
+	}
+
+	if (s != nb_src || d != nb_dst)
+		return -EINVAL;
+
+	return nb_desc;
+}
+
+int rte_pmd_qdma_dma_copy_sg(void *chan,
+		const struct rte_pmd_qdma_dma_sge *src,
+		const struct rte_pmd_qdma_dma_sge *dst,
+		uint16_t nb_src, uint16_t nb_dst, uint64_t flags)
+{
+	struct qdma_dma_chan *dma_chan = chan;
+	int nb_desc;
+
+	if (unlikely(!src || !dst))
+		return -EINVAL;
+
+	/* Count the descriptors first so that the copy is either fully
+	 * enqueued or not at all
+	 */
+	nb_desc = dma_chan_sg(dma_chan, src, dst, nb_src, nb_dst, 0);
+	if (unlikely(nb_desc <= 0))
+		return -EINVAL;
+	if (unlikely(nb_desc > dma_chan_free_desc(dma_chan)))
+		return -ENOSPC;
+
+	dma_chan_sg(dma_chan, src, dst, nb_src, nb_dst, 1);
+	if (flags & RTE_PMD_QDMA_DMA_OP_FLAG_SUBMIT)
+		rte_pmd_qdma_dma_submit(chan);
+
+	dma_chan->next_idx += nb_desc;
+
+	return (uint16_t)(dma_chan->next_idx - 1);
+}
+
+uint16_t rte_pmd_qdma_dma_completed(void *chan, uint16_t nb_cpls,
+		uint16_t *last_idx, bool *has_error)
+{
+	struct qdma_dma_chan *dma_chan = chan;
+	int nb_done;
+
+	nb_done = (int)dma_chan->wb_status->cidx - dma_chan->cidx;
+	if (nb_done < 0)
+		nb_done += dma_chan->ring_sz;
+	if (nb_done > nb_cpls)
+		nb_done = nb_cpls;
+
+	dma_chan->cidx += nb_done;
+	if (dma_chan->cidx >= dma_chan->ring_sz)
+		dma_chan->cidx -= dma_chan->ring_sz;
+	dma_chan->cpl_idx += nb_done;
+
+	if (last_idx)
+		*last_idx = dma_chan->cpl_idx - 1;
+	if (has_error)
+		*has_error = false;
+
+	return nb_done;
+}
+
+uint16_t rte_pmd_qdma_dma_burst_capacity(void *chan)
+{
+	return dma_chan_free_desc(chan);
+}
@@ -0,0 +1,329 @@
+/*-
+ * BSD LICENSE
+ *
+ * Copyright (c) 2017-2022 Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+#include "qdma.h"
+
+#include <immintrin.h>
+
+/* Completion entries or descriptors handled per loop iteration */
+#define QDMA_AVX2_DESCS_PER_LOOP (4)
+
+/* H2C descriptor control word for a single segment packet,
+ * see qdma_ul_update_st_h2c_desc()
+ */
+static __rte_always_inline uint64_t h2c_desc_ctrl(struct rte_mbuf *mb)
+{
+	return (uint64_t)mb->data_len << 16 |
+		(uint64_t)mb->data_len << 32 |
+		(uint64_t)(S_H2C_DESC_F_SOP | S_H2C_DESC_F_EOP) << 48;
+}
+
+/* AVX2 implementation to prepare mbufs for packets, four completion
+ * entries per iteration.
+ * Update this API if HW provides more information to be populated in mbuf.
+ */
+uint16_t qdma_prepare_packets_avx2(struct qdma_rx_queue *rxq,
+			struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
+{
+	struct rte_mbuf *mb;
+	struct rte_mbuf **sw_ring = rxq->sw_ring;
+	uint16_t count = 0, count_pkts = 0;
+	uint16_t n_pkts = nb_pkts & ~(QDMA_AVX2_DESCS_PER_LOOP - 1);
+	uint16_t id = rxq->rx_tail;
+	uint16_t ring_sz = rxq->nb_rx_desc - 1;
+	uint16_t pkt_length;
+	uint64_t bytes = 0;
+	/* mask to shuffle the packet length of the completion entry in
+	 * each 128 bit lane to rx_descriptor_fields1
+	 */
+	const __m256i shuf_msk = _mm256_set_epi8(
+			0xFF, 0xFF, 0xFF, 0xFF,  /* skip 32bits rss */
+			0xFF, 0xFF,      /* skip 16 bits vlan_tci */
+			1, 0,      /* octet 0~1, 16 bits data_len */
+			0xFF, 0xFF,  /* skip high 16 bits pkt_len, zero out */
+			1, 0,      /* octet 0~1, low 16 bits pkt_len */
+			0xFF, 0xFF,  /* skip 32 bit pkt_type */
+			0xFF, 0xFF,
+			0xFF, 0xFF, 0xFF, 0xFF,
+			0xFF, 0xFF,
+			1, 0,
+			0xFF, 0xFF,
+			1, 0,
+			0xFF, 0xFF,
+			0xFF, 0xFF
+			);
+	/* rearm_data in the low 64 bits and ol_flags cleared */
+	const __m256i mbuf_init = _mm256_set_epi64x(0, rxq->mbuf_initializer,
+			0, rxq->mbuf_initializer);
+	const __m256i len_msk = _mm256_set1_epi64x(0xFFFF);
+	const __m256i max_len = _mm256_set1_epi64x(rxq->rx_buff_size + 1);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i bytes_acc = _mm256_setzero_si256();
+
+	/* compile-time check */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, pkt_len) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 4);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_len) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, ol_flags) !=
+			offsetof(struct rte_mbuf, rearm_data) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, rx_descriptor_fields1) !=
+			offsetof(struct rte_mbuf, rearm_data) + 16);
+	RTE_BUILD_BUG_ON(sizeof(union qdma_ul_st_cmpt_ring) != 8);
+
+	for (count = 0; count < n_pkts; count += QDMA_AVX2_DESCS_PER_LOOP) {
+		__m256i cmpt, len, valid;
+		__m256i mbp, len01, len23;
+		struct rte_mbuf **pkts;
+		int i;
+
+		/* Packet lengths of four completion entries, the length is
+		 * zeroed when the entry consumed no C2H descriptor
+		 */
+		cmpt = _mm256_loadu_si256(
+				(const __m256i *)&rxq->cmpt_data[count]);
+		len = _mm256_and_si256(_mm256_srli_epi64(cmpt, 4), len_msk);
+		valid = _mm256_and_si256(_mm256_cmpgt_epi64(len, zero),
+				_mm256_cmpgt_epi64(max_len, len));
+
+		/* Check if packets are segmented across descriptors */
+		if (unlikely(_mm256_movemask_epi8(valid) != -1 ||
+				(id + QDMA_AVX2_DESCS_PER_LOOP) >= ring_sz)) {
+			/* Handle packets segmented
+			 * across multiple descriptors
+			 * or ring wrap
+			 */
+			for (i = 0; i < QDMA_AVX2_DESCS_PER_LOOP; i++) {
+				pkt_length = qdma_ul_get_cmpt_pkt_len(
+						&rxq->cmpt_data[count + i]);
+				if (!pkt_length)
+					continue;
+				mb = qdma_prepare_segmented_packet(rxq,
+						pkt_length, &id);
+				rx_pkts[count_pkts++] = mb;
+				bytes += pkt_length;
+			}
+			continue;
+		}
+
+		pkts = &rx_pkts[count_pkts];
+
+		/* Move four mbuf pointers from sw_ring to rx_pkts */
+		mbp = _mm256_loadu_si256((const __m256i *)&sw_ring[id]);
+		_mm256_storeu_si256((__m256i *)pkts, mbp);
+		_mm256_storeu_si256((__m256i *)&sw_ring[id], zero);
+
+		/* One packet length per 128 bit lane, converted from
+		 * completion entry to pktmbuf format
+		 */
+		len01 = _mm256_permute4x64_epi64(len, _MM_SHUFFLE(1, 1, 0, 0));
+		len23 = _mm256_permute4x64_epi64(len, _MM_SHUFFLE(3, 3, 2, 2));
+		len01 = _mm256_shuffle_epi8(len01, shuf_msk);
+		len23 = _mm256_shuffle_epi8(len23, shuf_msk);
+
+		/* Write rearm data, ol_flags and packet length of each
+		 * mbuf in one 32 byte write
+		 */
+		_mm256_storeu_si256((__m256i *)&pkts[0]->rearm_data,
+			_mm256_permute2x128_si256(mbuf_init, len01, 0x20));
+		_mm256_storeu_si256((__m256i *)&pkts[1]->rearm_data,
+			_mm256_permute2x128_si256(mbuf_init, len01, 0x30));
+		_mm256_storeu_si256((__m256i *)&pkts[2]->rearm_data,
+			_mm256_permute2x128_si256(mbuf_init, len23, 0x20));
+		_mm256_storeu_si256((__m256i *)&pkts[3]->rearm_data,
+			_mm256_permute2x128_si256(mbuf_init, len23, 0x30));
+
+		/* Accumulate packet length counter */
+		bytes_acc = _mm256_add_epi64(bytes_acc, len);
+
+		count_pkts += QDMA_AVX2_DESCS_PER_LOOP;
+		id += QDMA_AVX2_DESCS_PER_LOOP;
+	}
+
+	/* Handle remaining packets, if any pending */
+	for (; count < nb_pkts; count++) {
+		pkt_length = qdma_ul_get_cmpt_pkt_len(&rxq->cmpt_data[count]);
+		if (!pkt_length)
+			continue;
+		mb = qdma_prepare_segmented_packet(rxq, pkt_length, &id);
+		rx_pkts[count_pkts++] = mb;
+		bytes += pkt_length;
+	}
+
+	bytes += _mm256_extract_epi64(bytes_acc, 0) +
+		_mm256_extract_epi64(bytes_acc, 1) +
+		_mm256_extract_epi64(bytes_acc, 2) +
+		_mm256_extract_epi64(bytes_acc, 3);
+
+	rxq->stats.pkts += count_pkts;
+	rxq->stats.bytes += bytes;
+	rxq->rx_tail = id;
+
+	return count_pkts;
+}
+
+/* AVX2 implementation to write C2H descriptors for the buffers already
+ * placed in sw_ring, four descriptors per iteration, without ring wrap
+ */
+void qdma_rearm_c2h_desc_avx2(struct qdma_rx_queue *rxq, uint16_t id,
+		uint16_t num_desc)
+{
+	struct qdma_ul_st_c2h_desc *rx_ring_st =
+			(struct qdma_ul_st_c2h_desc *)rxq->rx_ring + id;
+	struct rte_mbuf **sw_ring = &rxq->sw_ring[id];
+	uint16_t rearm_cnt = num_desc & ~(QDMA_AVX2_DESCS_PER_LOOP - 1);
+	uint16_t mbuf_index;
+	const __m256i head_room = _mm256_set1_epi64x(RTE_PKTMBUF_HEADROOM);
+
+	/* load buf_addr(lo 64bit) and buf_iova(hi 64bit) */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, buf_iova) !=
+			offsetof(struct rte_mbuf, buf_addr) + 8);
+
+	for (mbuf_index = 0; mbuf_index < rearm_cnt;
+			mbuf_index += QDMA_AVX2_DESCS_PER_LOOP) {
+		struct rte_mbuf **mbp = &sw_ring[mbuf_index];
+		__m128i vaddr0, vaddr1, vaddr2, vaddr3;
+		__m256i vaddr02, vaddr13, dma_addr;
+
+		/* Load four mbufs data addresses */
+		vaddr0 = _mm_loadu_si128((__m128i *)&mbp[0]->buf_addr);
+		vaddr1 = _mm_loadu_si128((__m128i *)&mbp[1]->buf_addr);
+		vaddr2 = _mm_loadu_si128((__m128i *)&mbp[2]->buf_addr);
+		vaddr3 = _mm_loadu_si128((__m128i *)&mbp[3]->buf_addr);
+
+		vaddr02 = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(vaddr0), vaddr2, 1);
+		vaddr13 = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(vaddr1), vaddr3, 1);
+
+		/* Extract physical addresses of four mbufs */
+		dma_addr = _mm256_unpackhi_epi64(vaddr02, vaddr13);
+
+		/* Add headroom to dma_addr */
+		dma_addr = _mm256_add_epi64(dma_addr, head_room);
+
+		/* Write C2H desc with physical dma_addr */
+		_mm256_storeu_si256((__m256i *)&rx_ring_st[mbuf_index],
+				dma_addr);
+	}
+
+	for (; mbuf_index < num_desc; mbuf_index++)
+		rx_ring_st[mbuf_index].dst_addr =
+				(uint64_t)sw_ring[mbuf_index]->buf_iova +
+					RTE_PKTMBUF_HEADROOM;
+}
+
+/* AVX2 implementation to write H2C descriptors, four single segment
+ * packets per iteration. Multi segment packets, ring wrap and the burst
+ * tail go through qdma_ul_update_st_h2c_desc().
+ *
+ * Returns the number of packets queued within avail descriptors.
+ */
+uint16_t qdma_xmit_st_desc_avx2(struct qdma_tx_queue *txq,
+		struct rte_mbuf **tx_pkts, uint16_t nb_pkts, int avail,
+		uint64_t *pkt_len)
+{
+	struct qdma_ul_st_h2c_desc *tx_ring_st =
+			(struct qdma_ul_st_h2c_desc *)txq->tx_ring;
+	uint16_t ring_sz = txq->nb_tx_desc - 1;
+	uint16_t count = 0, id = txq->q_pidx_info.pidx;
+	uint64_t bytes = 0;
+	struct rte_mbuf *mb;
+
+	RTE_BUILD_BUG_ON(sizeof(struct qdma_ul_st_h2c_desc) != 16);
+
+	while (count < nb_pkts) {
+		struct rte_mbuf **pkts = &tx_pkts[count];
+
+		if ((nb_pkts - count) >= QDMA_AVX2_DESCS_PER_LOOP &&
+			avail >= QDMA_AVX2_DESCS_PER_LOOP &&
+			(id + QDMA_AVX2_DESCS_PER_LOOP) <= ring_sz &&
+			(pkts[0]->nb_segs | pkts[1]->nb_segs |
+			 pkts[2]->nb_segs | pkts[3]->nb_segs) == 1) {
+			__m256i desc01, desc23;
+
+			_mm256_storeu_si256((__m256i *)&txq->sw_ring[id],
+				_mm256_loadu_si256((const __m256i *)pkts));
+
+			desc01 = _mm256_set_epi64x(
+					pkts[1]->buf_iova + pkts[1]->data_off,
+					h2c_desc_ctrl(pkts[1]),
+					pkts[0]->buf_iova + pkts[0]->data_off,
+					h2c_desc_ctrl(pkts[0]));
+			desc23 = _mm256_set_epi64x(
+					pkts[3]->buf_iova + pkts[3]->data_off,
+					h2c_desc_ctrl(pkts[3]),
+					pkts[2]->buf_iova + pkts[2]->data_off,
+					h2c_desc_ctrl(pkts[2]));
+			_mm256_storeu_si256((__m256i *)&tx_ring_st[id], desc01);
+			_mm256_storeu_si256((__m256i *)&tx_ring_st[id + 2],
+					desc23);
+
+			bytes += pkts[0]->data_len + pkts[1]->data_len +
+				pkts[2]->data_len + pkts[3]->data_len;
+
+			count += QDMA_AVX2_DESCS_PER_LOOP;
+			avail -= QDMA_AVX2_DESCS_PER_LOOP;
+			id += QDMA_AVX2_DESCS_PER_LOOP;
+			if (unlikely(id >= ring_sz))
+				id -= ring_sz;
+			continue;
+		}
+
+		mb = pkts[0];
+		if (mb->nb_segs > avail) {
+			/* Number of segments in current mbuf are greater
+			 * than number of descriptors available,
+			 * hence update PIDX and return
+			 */
+			break;
+		}
+
+		txq->q_pidx_info.pidx = id;
+		if (qdma_ul_update_st_h2c_desc(txq, txq->offloads, mb) < 0)
+			break;
+
+		txq->sw_ring[id] = mb;
+		avail -= mb->nb_segs;
+		bytes += rte_pktmbuf_pkt_len(mb);
+		id = txq->q_pidx_info.pidx;
+		count++;
+	}
+
+	txq->q_pidx_info.pidx = id;
+	*pkt_len += bytes;
+
+	return count;
+}
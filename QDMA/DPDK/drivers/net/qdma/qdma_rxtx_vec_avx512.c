@@ -0,0 +1,354 @@
+/*-
+ * BSD LICENSE
+ *
+ * Copyright (c) 2017-2022 Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+#include "qdma.h"
+
+#include <immintrin.h>
+
+/* Completion entries or descriptors handled per loop iteration */
+#define QDMA_AVX512_DESCS_PER_LOOP (8)
+
+/* H2C descriptor control word for a single segment packet,
+ * see qdma_ul_update_st_h2c_desc()
+ */
+static __rte_always_inline uint64_t h2c_desc_ctrl(struct rte_mbuf *mb)
+{
+	return (uint64_t)mb->data_len << 16 |
+		(uint64_t)mb->data_len << 32 |
+		(uint64_t)(S_H2C_DESC_F_SOP | S_H2C_DESC_F_EOP) << 48;
+}
+
+/* Write rearm data, ol_flags and packet length of four mbufs, one
+ * 32 byte write per mbuf
+ */
+static __rte_always_inline void rx_mbuf_init_x4(struct rte_mbuf **pkts,
+		__m256i len, __m256i mbuf_init, __m256i shuf_msk)
+{
+	__m256i len01, len23;
+
+	/* One packet length per 128 bit lane, converted from
+	 * completion entry to pktmbuf format
+	 */
+	len01 = _mm256_permute4x64_epi64(len, _MM_SHUFFLE(1, 1, 0, 0));
+	len23 = _mm256_permute4x64_epi64(len, _MM_SHUFFLE(3, 3, 2, 2));
+	len01 = _mm256_shuffle_epi8(len01, shuf_msk);
+	len23 = _mm256_shuffle_epi8(len23, shuf_msk);
+
+	_mm256_storeu_si256((__m256i *)&pkts[0]->rearm_data,
+		_mm256_permute2x128_si256(mbuf_init, len01, 0x20));
+	_mm256_storeu_si256((__m256i *)&pkts[1]->rearm_data,
+		_mm256_permute2x128_si256(mbuf_init, len01, 0x30));
+	_mm256_storeu_si256((__m256i *)&pkts[2]->rearm_data,
+		_mm256_permute2x128_si256(mbuf_init, len23, 0x20));
+	_mm256_storeu_si256((__m256i *)&pkts[3]->rearm_data,
+		_mm256_permute2x128_si256(mbuf_init, len23, 0x30));
+}
+
+/* AVX-512 implementation to prepare mbufs for packets, eight completion
+ * entries per iteration.
+ * Update this API if HW provides more information to be populated in mbuf.
+ */
+uint16_t qdma_prepare_packets_avx512(struct qdma_rx_queue *rxq,
+			struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
+{
+	struct rte_mbuf *mb;
+	struct rte_mbuf **sw_ring = rxq->sw_ring;
+	uint16_t count = 0, count_pkts = 0;
+	uint16_t n_pkts = nb_pkts & ~(QDMA_AVX512_DESCS_PER_LOOP - 1);
+	uint16_t id = rxq->rx_tail;
+	uint16_t ring_sz = rxq->nb_rx_desc - 1;
+	uint16_t pkt_length;
+	uint64_t bytes = 0;
+	/* mask to shuffle the packet length of the completion entry in
+	 * each 128 bit lane to rx_descriptor_fields1
+	 */
+	const __m256i shuf_msk = _mm256_set_epi8(
+			0xFF, 0xFF, 0xFF, 0xFF,  /* skip 32bits rss */
+			0xFF, 0xFF,      /* skip 16 bits vlan_tci */
+			1, 0,      /* octet 0~1, 16 bits data_len */
+			0xFF, 0xFF,  /* skip high 16 bits pkt_len, zero out */
+			1, 0,      /* octet 0~1, low 16 bits pkt_len */
+			0xFF, 0xFF,  /* skip 32 bit pkt_type */
+			0xFF, 0xFF,
+			0xFF, 0xFF, 0xFF, 0xFF,
+			0xFF, 0xFF,
+			1, 0,
+			0xFF, 0xFF,
+			1, 0,
+			0xFF, 0xFF,
+			0xFF, 0xFF
+			);
+	/* rearm_data in the low 64 bits and ol_flags cleared */
+	const __m256i mbuf_init = _mm256_set_epi64x(0, rxq->mbuf_initializer,
+			0, rxq->mbuf_initializer);
+	const __m512i len_msk = _mm512_set1_epi64(0xFFFF);
+	const __m512i max_len = _mm512_set1_epi64(rxq->rx_buff_size);
+	const __m512i zero = _mm512_setzero_si512();
+	__m512i bytes_acc = _mm512_setzero_si512();
+
+	/* compile-time check */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, pkt_len) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 4);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_len) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, ol_flags) !=
+			offsetof(struct rte_mbuf, rearm_data) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, rx_descriptor_fields1) !=
+			offsetof(struct rte_mbuf, rearm_data) + 16);
+	RTE_BUILD_BUG_ON(sizeof(union qdma_ul_st_cmpt_ring) != 8);
+
+	for (count = 0; count < n_pkts; count += QDMA_AVX512_DESCS_PER_LOOP) {
+		__m512i cmpt, len;
+		__mmask8 valid;
+		struct rte_mbuf **pkts;
+		int i;
+
+		/* Packet lengths of eight completion entries, the length is
+		 * zeroed when the entry consumed no C2H descriptor
+		 */
+		cmpt = _mm512_loadu_si512(&rxq->cmpt_data[count]);
+		len = _mm512_and_si512(_mm512_srli_epi64(cmpt, 4), len_msk);
+		valid = _mm512_cmpgt_epu64_mask(len, zero) &
+			_mm512_cmple_epu64_mask(len, max_len);
+
+		/* Check if packets are segmented across descriptors */
+		if (unlikely(valid != 0xFF ||
+				(id + QDMA_AVX512_DESCS_PER_LOOP) >= ring_sz)) {
+			/* Handle packets segmented
+			 * across multiple descriptors
+			 * or ring wrap
+			 */
+			for (i = 0; i < QDMA_AVX512_DESCS_PER_LOOP; i++) {
+				pkt_length = qdma_ul_get_cmpt_pkt_len(
+						&rxq->cmpt_data[count + i]);
+				if (!pkt_length)
+					continue;
+				mb = qdma_prepare_segmented_packet(rxq,
+						pkt_length, &id);
+				rx_pkts[count_pkts++] = mb;
+				bytes += pkt_length;
+			}
+			continue;
+		}
+
+		pkts = &rx_pkts[count_pkts];
+
+		/* Move eight mbuf pointers from sw_ring to rx_pkts */
+		_mm512_storeu_si512(pkts, _mm512_loadu_si512(&sw_ring[id]));
+		_mm512_storeu_si512(&sw_ring[id], zero);
+
+		rx_mbuf_init_x4(&pkts[0], _mm512_castsi512_si256(len),
+				mbuf_init, shuf_msk);
+		rx_mbuf_init_x4(&pkts[4], _mm512_extracti64x4_epi64(len, 1),
+				mbuf_init, shuf_msk);
+
+		/* Accumulate packet length counter */
+		bytes_acc = _mm512_add_epi64(bytes_acc, len);
+
+		count_pkts += QDMA_AVX512_DESCS_PER_LOOP;
+		id += QDMA_AVX512_DESCS_PER_LOOP;
+	}
+
+	/* Handle remaining packets, if any pending */
+	for (; count < nb_pkts; count++) {
+		pkt_length = qdma_ul_get_cmpt_pkt_len(&rxq->cmpt_data[count]);
+		if (!pkt_length)
+			continue;
+		mb = qdma_prepare_segmented_packet(rxq, pkt_length, &id);
+		rx_pkts[count_pkts++] = mb;
+		bytes += pkt_length;
+	}
+
+	bytes += _mm512_reduce_add_epi64(bytes_acc);
+
+	rxq->stats.pkts += count_pkts;
+	rxq->stats.bytes += bytes;
+	rxq->rx_tail = id;
+
+	return count_pkts;
+}
+
+/* AVX-512 implementation to write C2H descriptors for the buffers already
+ * placed in sw_ring, eight descriptors per iteration, without ring wrap
+ */
+void qdma_rearm_c2h_desc_avx512(struct qdma_rx_queue *rxq, uint16_t id,
+		uint16_t num_desc)
+{
+	struct qdma_ul_st_c2h_desc *rx_ring_st =
+			(struct qdma_ul_st_c2h_desc *)rxq->rx_ring + id;
+	struct rte_mbuf **sw_ring = &rxq->sw_ring[id];
+	uint16_t rearm_cnt = num_desc & ~(QDMA_AVX512_DESCS_PER_LOOP - 1);
+	uint16_t mbuf_index;
+	const __m512i head_room = _mm512_set1_epi64(RTE_PKTMBUF_HEADROOM);
+
+	/* load buf_addr(lo 64bit) and buf_iova(hi 64bit) */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, buf_iova) !=
+			offsetof(struct rte_mbuf, buf_addr) + 8);
+
+	for (mbuf_index = 0; mbuf_index < rearm_cnt;
+			mbuf_index += QDMA_AVX512_DESCS_PER_LOOP) {
+		struct rte_mbuf **mbp = &sw_ring[mbuf_index];
+		__m512i vaddr_even, vaddr_odd, dma_addr;
+
+		/* Load eight mbufs data addresses, even mbufs in one
+		 * register and odd mbufs in the other
+		 */
+		vaddr_even = _mm512_castsi128_si512(
+			_mm_loadu_si128((__m128i *)&mbp[0]->buf_addr));
+		vaddr_even = _mm512_inserti32x4(vaddr_even,
+			_mm_loadu_si128((__m128i *)&mbp[2]->buf_addr), 1);
+		vaddr_even = _mm512_inserti32x4(vaddr_even,
+			_mm_loadu_si128((__m128i *)&mbp[4]->buf_addr), 2);
+		vaddr_even = _mm512_inserti32x4(vaddr_even,
+			_mm_loadu_si128((__m128i *)&mbp[6]->buf_addr), 3);
+		vaddr_odd = _mm512_castsi128_si512(
+			_mm_loadu_si128((__m128i *)&mbp[1]->buf_addr));
+		vaddr_odd = _mm512_inserti32x4(vaddr_odd,
+			_mm_loadu_si128((__m128i *)&mbp[3]->buf_addr), 1);
+		vaddr_odd = _mm512_inserti32x4(vaddr_odd,
+			_mm_loadu_si128((__m128i *)&mbp[5]->buf_addr), 2);
+		vaddr_odd = _mm512_inserti32x4(vaddr_odd,
+			_mm_loadu_si128((__m128i *)&mbp[7]->buf_addr), 3);
+
+		/* Extract physical addresses of eight mbufs */
+		dma_addr = _mm512_unpackhi_epi64(vaddr_even, vaddr_odd);
+
+		/* Add headroom to dma_addr */
+		dma_addr = _mm512_add_epi64(dma_addr, head_room);
+
+		/* Write C2H desc with physical dma_addr */
+		_mm512_storeu_si512(&rx_ring_st[mbuf_index], dma_addr);
+	}
+
+	for (; mbuf_index < num_desc; mbuf_index++)
+		rx_ring_st[mbuf_index].dst_addr =
+				(uint64_t)sw_ring[mbuf_index]->buf_iova +
+					RTE_PKTMBUF_HEADROOM;
+}
+
+/* AVX-512 implementation to write H2C descriptors, eight single segment
+ * packets per iteration. Multi segment packets, ring wrap and the burst
+ * tail go through qdma_ul_update_st_h2c_desc().
+ *
+ * Returns the number of packets queued within avail descriptors.
+ */
+uint16_t qdma_xmit_st_desc_avx512(struct qdma_tx_queue *txq,
+		struct rte_mbuf **tx_pkts, uint16_t nb_pkts, int avail,
+		uint64_t *pkt_len)
+{
+	struct qdma_ul_st_h2c_desc *tx_ring_st =
+			(struct qdma_ul_st_h2c_desc *)txq->tx_ring;
+	uint16_t ring_sz = txq->nb_tx_desc - 1;
+	uint16_t count = 0, id = txq->q_pidx_info.pidx;
+	uint64_t bytes = 0;
+	struct rte_mbuf *mb;
+	int i;
+
+	RTE_BUILD_BUG_ON(sizeof(struct qdma_ul_st_h2c_desc) != 16);
+
+	while (count < nb_pkts) {
+		struct rte_mbuf **pkts = &tx_pkts[count];
+		uint16_t segs = 0;
+
+		if ((nb_pkts - count) >= QDMA_AVX512_DESCS_PER_LOOP &&
+			avail >= QDMA_AVX512_DESCS_PER_LOOP &&
+			(id + QDMA_AVX512_DESCS_PER_LOOP) <= ring_sz) {
+			for (i = 0; i < QDMA_AVX512_DESCS_PER_LOOP; i++)
+				segs |= pkts[i]->nb_segs;
+		}
+
+		if (segs == 1) {
+			__m512i desc0123, desc4567;
+
+			_mm512_storeu_si512(&txq->sw_ring[id],
+					_mm512_loadu_si512(pkts));
+
+			desc0123 = _mm512_set_epi64(
+					pkts[3]->buf_iova + pkts[3]->data_off,
+					h2c_desc_ctrl(pkts[3]),
+					pkts[2]->buf_iova + pkts[2]->data_off,
+					h2c_desc_ctrl(pkts[2]),
+					pkts[1]->buf_iova + pkts[1]->data_off,
+					h2c_desc_ctrl(pkts[1]),
+					pkts[0]->buf_iova + pkts[0]->data_off,
+					h2c_desc_ctrl(pkts[0]));
+			desc4567 = _mm512_set_epi64(
+					pkts[7]->buf_iova + pkts[7]->data_off,
+					h2c_desc_ctrl(pkts[7]),
+					pkts[6]->buf_iova + pkts[6]->data_off,
+					h2c_desc_ctrl(pkts[6]),
+					pkts[5]->buf_iova + pkts[5]->data_off,
+					h2c_desc_ctrl(pkts[5]),
+					pkts[4]->buf_iova + pkts[4]->data_off,
+					h2c_desc_ctrl(pkts[4]));
+			_mm512_storeu_si512(&tx_ring_st[id], desc0123);
+			_mm512_storeu_si512(&tx_ring_st[id + 4], desc4567);
+
+			for (i = 0; i < QDMA_AVX512_DESCS_PER_LOOP; i++)
+				bytes += pkts[i]->data_len;
+
+			count += QDMA_AVX512_DESCS_PER_LOOP;
+			avail -= QDMA_AVX512_DESCS_PER_LOOP;
+			id += QDMA_AVX512_DESCS_PER_LOOP;
+			if (unlikely(id >= ring_sz))
+				id -= ring_sz;
+			continue;
+		}
+
+		mb = pkts[0];
+		if (mb->nb_segs > avail) {
+			/* Number of segments in current mbuf are greater
+			 * than number of descriptors available,
+			 * hence update PIDX and return
+			 */
+			break;
+		}
+
+		txq->q_pidx_info.pidx = id;
+		if (qdma_ul_update_st_h2c_desc(txq, txq->offloads, mb) < 0)
+			break;
+
+		txq->sw_ring[id] = mb;
+		avail -= mb->nb_segs;
+		bytes += rte_pktmbuf_pkt_len(mb);
+		id = txq->q_pidx_info.pidx;
+		count++;
+	}
+
+	txq->q_pidx_info.pidx = id;
+	*pkt_len += bytes;
+
+	return count;
+}
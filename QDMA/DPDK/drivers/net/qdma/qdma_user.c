@@ -33,6 +33,7 @@
 
 #include <rte_mbuf.h>
 #include <rte_cycles.h>
+#include <rte_memcpy.h>
 #include <rte_ethdev.h>
 #include "qdma_user.h"
 #include "qdma_access_common.h"
@@ -291,3 +292,44 @@ int qdma_ul_process_immediate_data(void *cmpt_entry, uint16_t cmpt_desc_len,
 
 	return 0;
 }
+
+/**
+ * Processes a run of completion entries that are contiguous in the
+ * completion ring: the run is copied with a single rte_memcpy() and only
+ * the first byte of each entry is fixed up afterwards.
+ *
+ * @param cmpt_entry
+ *   Pointer to the first completion entry of the run.
+ * @param cmpt_desc_len
+ *   Completion descriptor length.
+ * @param nb_entries
+ *   Number of completion entries in the run.
+ * @param cmpt_buff
+ *   Pointer to the data buffer to which the data will be extracted,
+ *   nb_entries * cmpt_desc_len bytes long.
+ *
+ * @return
+ *   Number of entries processed, less than nb_entries when an entry
+ *   with an error is found.
+ */
+uint16_t qdma_ul_process_immediate_data_burst(void *cmpt_entry,
+		uint16_t cmpt_desc_len, uint16_t nb_entries, char *cmpt_buff)
+{
+	struct qdma_ul_cmpt_ring *cmpt_desc;
+	uint16_t count, i;
+
+	for (count = 0; count < nb_entries; count++) {
+		cmpt_desc = (struct qdma_ul_cmpt_ring *)((char *)cmpt_entry +
+				(size_t)count * cmpt_desc_len);
+		if (unlikely(cmpt_desc->err || cmpt_desc->data_frmt))
+			break;
+	}
+	if (!count)
+		return 0;
+
+	rte_memcpy(cmpt_buff, cmpt_entry, (size_t)count * cmpt_desc_len);
+	for (i = 0; i < count; i++)
+		cmpt_buff[(size_t)i * cmpt_desc_len] &= 0xF0;
+
+	return count;
+}
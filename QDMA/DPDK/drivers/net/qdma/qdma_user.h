@@ -250,4 +250,23 @@ int qdma_ul_update_mm_h2c_desc(void *qhndl, struct rte_mbuf *mb);
 int qdma_ul_process_immediate_data(void *cmpt_entry, uint16_t cmpt_desc_len,
 			char *cmpt_buff);
 
+/**
+ * Processes a run of completion entries that are contiguous in the
+ * completion ring.
+ *
+ * @param cmpt_entry
+ *   Pointer to the first completion entry of the run.
+ * @param cmpt_desc_len
+ *   Completion descriptor length.
+ * @param nb_entries
+ *   Number of completion entries in the run.
+ * @param cmpt_buff
+ *   Pointer to the data buffer to which the data will be extracted.
+ *
+ * @return
+ *   Number of entries processed, stops before an entry with an error.
+ */
+uint16_t qdma_ul_process_immediate_data_burst(void *cmpt_entry,
+		uint16_t cmpt_desc_len, uint16_t nb_entries, char *cmpt_buff);
+
 #endif /* ifndef __QDMA_USER_H__ */
@@ -58,6 +58,10 @@
 
 static int eth_qdma_vf_dev_init(struct rte_eth_dev *dev);
 static int eth_qdma_vf_dev_uninit(struct rte_eth_dev *dev);
+static int qdma_vf_txq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid);
+static void qdma_vf_txq_arm(struct rte_eth_dev *dev, uint16_t qid);
+static int qdma_vf_rxq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid);
+static void qdma_vf_rxq_arm(struct rte_eth_dev *dev, uint16_t qid);
 
 /*
  * The set of PCI devices this driver supports
@@ -417,7 +421,9 @@ static int qdma_rxq_context_setup(struct rte_eth_dev *dev, uint16_t qid)
 		descq_conf.cmpt_ringsz =
 				qdma_dev->g_ring_sz[rxq->cmpt_ringszidx] - 1;
 		descq_conf.bufsz = qdma_dev->g_c2h_buf_sz[rxq->buffszidx];
-		descq_conf.cmpt_int_en = 0;
+		/* Direct interrupt, armed by rx_queue_intr_enable */
+		descq_conf.intr_id = qdma_rx_intr_vec(dev, rxq, qid);
+		descq_conf.cmpt_int_en = rxq->en_intr;
 		descq_conf.cmpl_stat_en = rxq->st_mode;
 		descq_conf.pfch_en = rxq->en_prefetch;
 		descq_conf.en_bypass_prefetch = rxq->en_bypass_prefetch;
@@ -538,19 +544,28 @@ err_out:
 
 static int qdma_vf_dev_start(struct rte_eth_dev *dev)
 {
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
 	struct qdma_tx_queue *txq;
 	struct qdma_rx_queue *rxq;
+	uint64_t start_tsc, ctxt_tsc;
 	uint32_t qid;
 	int err;
 
 	PMD_DRV_LOG(INFO, "qdma_dev_start: Starting\n");
-	/* prepare descriptor rings for operation */
+
+	start_tsc = rte_get_timer_cycles();
+
+	err = qdma_rx_intr_setup(dev);
+	if (err != 0)
+		return err;
+
+	/* Have all the contexts programmed before arming any queue */
 	for (qid = 0; qid < dev->data->nb_tx_queues; qid++) {
 		txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
 
 		/*Deferred Queues should not start with dev_start*/
 		if (!txq->tx_deferred_start) {
-			err = qdma_vf_dev_tx_queue_start(dev, qid);
+			err = qdma_vf_txq_ctxt_program(dev, qid);
 			if (err != 0)
 				return err;
 		}
@@ -561,11 +576,33 @@ static int qdma_vf_dev_start(struct rte_eth_dev *dev)
 
 		/*Deferred Queues should not start with dev_start*/
 		if (!rxq->rx_deferred_start) {
-			err = qdma_vf_dev_rx_queue_start(dev, qid);
+			err = qdma_vf_rxq_ctxt_program(dev, qid);
 			if (err != 0)
 				return err;
 		}
 	}
+
+	ctxt_tsc = rte_get_timer_cycles();
+
+	for (qid = 0; qid < dev->data->nb_tx_queues; qid++) {
+		txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
+		if (!txq->tx_deferred_start)
+			qdma_vf_txq_arm(dev, qid);
+	}
+
+	for (qid = 0; qid < dev->data->nb_rx_queues; qid++) {
+		rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
+		if (!rxq->rx_deferred_start)
+			qdma_vf_rxq_arm(dev, qid);
+	}
+
+	qdma_dev->start_ctxt_us = qdma_timer_cycles_to_us(ctxt_tsc - start_tsc);
+	qdma_dev->start_us =
+		qdma_timer_cycles_to_us(rte_get_timer_cycles() - start_tsc);
+	PMD_DRV_LOG(INFO, "qdma_dev_start: Started in %lu us "
+			"(contexts %lu us)\n",
+			qdma_dev->start_us, qdma_dev->start_ctxt_us);
+
 	return 0;
 }
 
@@ -593,6 +630,10 @@ static int qdma_vf_dev_infos_get(__rte_unused struct rte_eth_dev *dev,
 	dev_info->max_rx_pktlen = DMA_BRAM_SIZE;
 	dev_info->max_mac_addrs = 1;
 
+	dev_info->tx_queue_offload_capa = DEV_TX_OFFLOAD_MBUF_FAST_FREE;
+	dev_info->tx_offload_capa = dev_info->tx_queue_offload_capa;
+	dev_info->default_txconf.tx_free_thresh = DEFAULT_TX_FREE_THRESHOLD;
+
 	return 0;
 }
 
@@ -610,6 +651,7 @@ static int qdma_vf_dev_stop(struct rte_eth_dev *dev)
 		qdma_vf_dev_tx_queue_stop(dev, qid);
 	for (qid = 0; qid < dev->data->nb_rx_queues; qid++)
 		qdma_vf_dev_rx_queue_stop(dev, qid);
+	qdma_rx_intr_teardown(dev);
 
 	return 0;
 }
@@ -845,35 +887,59 @@ static int qdma_vf_dev_configure(struct rte_eth_dev *dev)
 	return ret;
 }
 
-int qdma_vf_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+/* Reset a Tx queue and have the PF program its contexts */
+static int qdma_vf_txq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid)
 {
-	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
 	struct qdma_tx_queue *txq;
 
 	txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
 	qdma_reset_tx_queue(txq);
+	txq->vec_path = qdma_get_vec_path();
 
 	if (qdma_txq_context_setup(dev, qid) < 0)
 		return -1;
 
+	return 0;
+}
+
+/* Start a Tx queue whose contexts are programmed */
+static void qdma_vf_txq_arm(struct rte_eth_dev *dev, uint16_t qid)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_tx_queue *txq;
+
+	txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
+
 	txq->q_pidx_info.pidx = 0;
 	qdma_dev->hw_access->qdma_queue_pidx_update(dev, qdma_dev->is_vf,
 			qid, 0, &txq->q_pidx_info);
 
 	dev->data->tx_queue_state[qid] = RTE_ETH_QUEUE_STATE_STARTED;
 	txq->status = RTE_ETH_QUEUE_STATE_STARTED;
+	qdma_set_tx_burst(txq);
+}
 
+int qdma_vf_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+{
+	int err;
+
+	err = qdma_vf_txq_ctxt_program(dev, qid);
+	if (err != 0)
+		return err;
+
+	qdma_vf_txq_arm(dev, qid);
 	return 0;
 }
 
-int qdma_vf_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+/* Reset an Rx queue, fill its ring and have the PF program its contexts */
+static int qdma_vf_rxq_ctxt_program(struct rte_eth_dev *dev, uint16_t qid)
 {
-	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
 	struct qdma_rx_queue *rxq;
 	int err;
 
 	rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
 	qdma_reset_rx_queue(rxq);
+	rxq->vec_path = qdma_get_vec_path();
 
 	err = qdma_init_rx_queue(rxq);
 	if (err != 0)
@@ -884,6 +950,17 @@ int qdma_vf_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 		return -1;
 	}
 
+	return 0;
+}
+
+/* Start an Rx queue whose contexts are programmed */
+static void qdma_vf_rxq_arm(struct rte_eth_dev *dev, uint16_t qid)
+{
+	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
+	struct qdma_rx_queue *rxq;
+
+	rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
+
 	if (rxq->st_mode) {
 		rxq->cmpt_cidx_info.counter_idx = rxq->threshidx;
 		rxq->cmpt_cidx_info.timer_idx = rxq->timeridx;
@@ -899,6 +976,18 @@ int qdma_vf_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
 
 	dev->data->rx_queue_state[qid] = RTE_ETH_QUEUE_STATE_STARTED;
 	rxq->status = RTE_ETH_QUEUE_STATE_STARTED;
+	qdma_set_rx_burst(rxq);
+}
+
+int qdma_vf_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t qid)
+{
+	int err;
+
+	err = qdma_vf_rxq_ctxt_program(dev, qid);
+	if (err != 0)
+		return err;
+
+	qdma_vf_rxq_arm(dev, qid);
 	return 0;
 }
 
@@ -910,6 +999,7 @@ int qdma_vf_dev_rx_queue_stop(struct rte_eth_dev *dev, uint16_t qid)
 	rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
 
 	rxq->status = RTE_ETH_QUEUE_STATE_STOPPED;
+	qdma_set_rx_burst(rxq);
 
 	/* Wait for queue to recv all packets. */
 	if (rxq->st_mode) {  /** ST-mode **/
@@ -964,6 +1054,8 @@ int qdma_vf_dev_tx_queue_stop(struct rte_eth_dev *dev, uint16_t qid)
 	txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
 
 	txq->status = RTE_ETH_QUEUE_STATE_STOPPED;
+	qdma_set_tx_burst(txq);
+	qdma_txq_pidx_flush(txq);
 	/* Wait for TXQ to send out all packets. */
 	while (txq->wb_status->cidx != txq->q_pidx_info.pidx) {
 		usleep(10);
@@ -999,7 +1091,24 @@ static struct eth_dev_ops qdma_vf_eth_dev_ops = {
 	.rx_queue_stop        = qdma_vf_dev_rx_queue_stop,
 	.tx_queue_start       = qdma_vf_dev_tx_queue_start,
 	.tx_queue_stop        = qdma_vf_dev_tx_queue_stop,
+	.rx_queue_intr_enable = qdma_dev_rx_queue_intr_enable,
+	.rx_queue_intr_disable = qdma_dev_rx_queue_intr_disable,
 	.stats_get            = qdma_dev_stats_get,
+	.stats_reset          = qdma_dev_stats_reset,
+	.xstats_get           = qdma_dev_xstats_get,
+	.xstats_get_names     = qdma_dev_xstats_get_names,
+	.xstats_reset         = qdma_dev_stats_reset,
+};
+
+/* Secondary processes only run the datapath, see qdma_dev_ops_init() */
+static struct eth_dev_ops qdma_vf_eth_dev_secondary_ops = {
+	.dev_infos_get        = qdma_vf_dev_infos_get,
+	.link_update          = qdma_vf_dev_link_update,
+	.stats_get            = qdma_dev_stats_get,
+	.stats_reset          = qdma_dev_stats_reset,
+	.xstats_get           = qdma_dev_xstats_get,
+	.xstats_get_names     = qdma_dev_xstats_get_names,
+	.xstats_reset         = qdma_dev_stats_reset,
 };
 
 /**
@@ -1035,11 +1144,13 @@ static int eth_qdma_vf_dev_init(struct rte_eth_dev *dev)
 		return -EINVAL;
 
 	/* for secondary processes, we don't initialise any further as primary
-	 * has already done this work.
+	 * has already done this work, only the datapath state of the process.
 	 */
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
-		dev->dev_ops = &qdma_vf_eth_dev_ops;
-		return 0;
+		dev->dev_ops = &qdma_vf_eth_dev_secondary_ops;
+		dev->rx_pkt_burst = &qdma_recv_pkts;
+		dev->tx_pkt_burst = &qdma_xmit_pkts;
+		return qdma_proc_private_init(dev);
 	}
 
 	if (once) {
@@ -1117,6 +1228,14 @@ static int eth_qdma_vf_dev_init(struct rte_eth_dev *dev)
 		return -EINVAL;
 	}
 
+	/* Datapath view of the device in this process */
+	idx = qdma_proc_private_init(dev);
+	if (idx < 0) {
+		rte_free(dma_priv->hw_access);
+		rte_free(dev->data->mac_addrs);
+		return idx;
+	}
+
 	/* Store BAR address and length of AXI Master Lite BAR(user bar)*/
 	if (dma_priv->user_bar_idx >= 0) {
 		baseaddr = (uint8_t *)
@@ -1134,6 +1253,7 @@ static int eth_qdma_vf_dev_init(struct rte_eth_dev *dev)
 	qdma_mbox_init(dev);
 	idx = qdma_ethdev_online(dev);
 	if (idx < 0) {
+		qdma_proc_private_uninit(dev);
 		rte_free(dma_priv->hw_access);
 		rte_free(dev->data->mac_addrs);
 		return -EINVAL;
@@ -1174,8 +1294,10 @@ static int eth_qdma_vf_dev_uninit(struct rte_eth_dev *dev)
 	struct qdma_pci_dev *qdma_dev = dev->data->dev_private;
 
 	/* only uninitialize in the primary process */
-	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
-		return -EPERM;
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		qdma_proc_private_uninit(dev);
+		return 0;
+	}
 
 	if (qdma_dev->dev_configured)
 		qdma_vf_dev_close(dev);
@@ -1201,6 +1323,7 @@ static int eth_qdma_vf_dev_uninit(struct rte_eth_dev *dev)
 		qdma_dev->q_info = NULL;
 	}
 
+	qdma_proc_private_uninit(dev);
 	return 0;
 }
 
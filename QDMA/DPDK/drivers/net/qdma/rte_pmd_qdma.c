@@ -876,6 +876,87 @@ int rte_pmd_qdma_set_c2h_descriptor_prefetch(int port_id, uint32_t qid,
 	return ret;
 }
 
+/******************************************************************************/
+/**
+ *Function Name:	rte_pmd_qdma_set_rx_copy_pool
+ *Description:		Sets the mbuf pool into which the short packets of
+ *			a streaming mode Rx queue are copied
+ *
+ * @param	port_id : Port ID.
+ * @param	qid : Queue ID.
+ * @param	copy_pool : Pool for the short packets, NULL to disable.
+ * @param	copy_len : Largest packet length copied.
+ *
+ * @return	'0' on success and '<0' on failure.
+ *
+ * @note	Application can call this API after successful
+ *		call to rte_eth_dev_configure() API. Application can
+ *		also call this API after successful call to
+ *		rte_eth_rx_queue_setup() API, only if rx queue
+ *		is not in start state.
+ ******************************************************************************/
+int rte_pmd_qdma_set_rx_copy_pool(int port_id, uint32_t qid,
+		struct rte_mempool *copy_pool, uint16_t copy_len)
+{
+	struct rte_eth_dev *dev;
+	struct qdma_pci_dev *qdma_dev;
+	struct qdma_rx_queue *rxq;
+	int ret = 0;
+
+	ret = validate_qdma_dev_info(port_id, qid);
+	if (ret != QDMA_SUCCESS) {
+		PMD_DRV_LOG(ERR,
+			"QDMA device validation failed for port id %d\n",
+			port_id);
+		return ret;
+	}
+	dev = &rte_eth_devices[port_id];
+	qdma_dev = dev->data->dev_private;
+	if (qid >= dev->data->nb_rx_queues) {
+		PMD_DRV_LOG(ERR, "Invalid Queue id passed for %s, "
+				"Queue ID = %d\n", __func__, qid);
+		return -EINVAL;
+	}
+
+	if (qdma_dev->q_info[qid].queue_mode ==
+			RTE_PMD_QDMA_MEMORY_MAPPED_MODE) {
+		PMD_DRV_LOG(ERR, "%s() not supported for qid %d in MM mode",
+				__func__, qid);
+		return -ENOTSUP;
+	}
+
+	if (copy_pool == NULL) {
+		copy_len = 0;
+	} else if ((copy_len == 0) ||
+			((uint32_t)copy_len + RTE_PKTMBUF_HEADROOM >
+			rte_pktmbuf_data_room_size(copy_pool))) {
+		PMD_DRV_LOG(ERR, "%s(): copy length %d does not fit in "
+				"the data room of pool %s\n", __func__,
+				copy_len, copy_pool->name);
+		return -EINVAL;
+	}
+
+	rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
+
+	if ((rxq != NULL) && (dev->data->rx_queue_state[qid] !=
+			RTE_ETH_QUEUE_STATE_STOPPED)) {
+		PMD_DRV_LOG(ERR,
+			"Cannot configure when Qid %d is in start state\n",
+			qid);
+		return -EINVAL;
+	}
+
+	qdma_dev->q_info[qid].rx_copy_pool = copy_pool;
+	qdma_dev->q_info[qid].rx_copy_len = copy_len;
+	if (rxq != NULL) {
+		/* The queue keeps the C2H buffer size picked at setup */
+		rxq->copy_pool = copy_pool;
+		rxq->copy_len = RTE_MIN(copy_len, rxq->rx_buff_size);
+	}
+
+	return ret;
+}
+
 /*****************************************************************************/
 /**
  * Function Name:	rte_pmd_qdma_set_mm_endpoint_addr
@@ -1680,6 +1761,49 @@ int rte_pmd_qdma_dev_cmptq_stop(int port_id, uint32_t qid)
 		return qdma_pf_cmptq_context_invalidate(dev, qid);
 }
 
+static int qdma_mm_cmptq_get(int port_id, uint32_t qid,
+		struct qdma_cmpt_queue **cmptq)
+{
+	struct qdma_pci_dev *qdma_dev;
+	int ret;
+
+	ret = validate_qdma_dev_info(port_id, qid);
+	if (ret != QDMA_SUCCESS) {
+		PMD_DRV_LOG(ERR,
+			"QDMA device validation failed for port id %d\n",
+			port_id);
+		return ret;
+	}
+	qdma_dev = rte_eth_devices[port_id].data->dev_private;
+	if (qdma_dev->q_info[qid].queue_mode !=
+			RTE_PMD_QDMA_MEMORY_MAPPED_MODE) {
+		PMD_DRV_LOG(ERR, "Qid %d is not configured in MM-mode\n", qid);
+		return -EINVAL;
+	}
+
+	*cmptq = (struct qdma_cmpt_queue *)qdma_dev->cmpt_queues[qid];
+	return 0;
+}
+
+/* Number of entries written by the HW and not yet consumed */
+static inline uint16_t qdma_mm_cmptq_avail(struct qdma_cmpt_queue *cmptq)
+{
+	uint16_t cmpt_tail = cmptq->cmpt_cidx_info.wrb_cidx;
+	uint16_t cmpt_pidx = cmptq->wb_status->pidx;
+	uint16_t nb_entries_avail = 0;
+
+	if (cmpt_tail < cmpt_pidx)
+		nb_entries_avail = cmpt_pidx - cmpt_tail;
+	else if (cmpt_tail > cmpt_pidx)
+		nb_entries_avail = cmptq->nb_cmpt_desc - 1 - cmpt_tail +
+			cmpt_pidx;
+
+	/* Read the entries only after the PIDX that covers them */
+	rte_rmb();
+
+	return nb_entries_avail;
+}
+
 /*****************************************************************************/
 /**
  * Function Name:   rte_pmd_qdma_mm_cmpt_process
@@ -1687,61 +1811,39 @@ int rte_pmd_qdma_dev_cmptq_stop(int port_id, uint32_t qid)
  *
  * @param   port_id : Port ID.
  * @param   qid : Queue ID.
- * @param   cmpt_buff : User buffer pointer to store the completion data.
+ * @param   cmpt_buff : User buffer pointer to store the completion data,
+ *                      one completion entry size per entry.
  * @param   nb_entries: Number of compeltion entries to process.
  *
  * @return  'number of entries processed' on success and '< 0' on failure.
  *
  * @note    Application can call this API after successful call to
  *	    rte_pmd_qdma_dev_cmptq_start() API.
+ *	    The entries are copied in at most two runs, split by the ring
+ *	    wrap, and the CIDX is updated once for the whole burst.
  ******************************************************************************/
 
 uint16_t rte_pmd_qdma_mm_cmpt_process(int port_id, uint32_t qid,
 					void *cmpt_buff, uint16_t nb_entries)
 {
-	struct rte_eth_dev *dev;
-	struct qdma_pci_dev *qdma_dev;
 	struct qdma_cmpt_queue *cmptq;
 	uint32_t count = 0;
-	struct qdma_ul_cmpt_ring *cmpt_entry;
-	struct wb_status *wb_status;
-	uint16_t nb_entries_avail = 0;
-	uint16_t cmpt_tail = 0;
-	uint16_t cmpt_pidx;
+	uint16_t nb_entries_avail;
+	uint16_t cmpt_tail, ring_sz;
+	uint16_t run, done;
+	char *cmpt_entry;
 	int ret = 0;
 
-	ret = validate_qdma_dev_info(port_id, qid);
-	if (ret != QDMA_SUCCESS) {
-		PMD_DRV_LOG(ERR,
-			"QDMA device validation failed for port id %d\n",
-			port_id);
+	ret = qdma_mm_cmptq_get(port_id, qid, &cmptq);
+	if (ret)
 		return ret;
-	}
-	dev = &rte_eth_devices[port_id];
-	qdma_dev = dev->data->dev_private;
-	if (qdma_dev->q_info[qid].queue_mode !=
-			RTE_PMD_QDMA_MEMORY_MAPPED_MODE) {
-		PMD_DRV_LOG(ERR, "Qid %d is not configured in MM-mode\n", qid);
-		return -EINVAL;
-	}
-
-	cmptq = (struct qdma_cmpt_queue *)qdma_dev->cmpt_queues[qid];
 
 	if (cmpt_buff == NULL) {
 		PMD_DRV_LOG(ERR, "Invalid user buffer pointer from user");
 		return 0;
 	}
 
-	wb_status = cmptq->wb_status;
-	cmpt_tail = cmptq->cmpt_cidx_info.wrb_cidx;
-	cmpt_pidx = wb_status->pidx;
-
-	if (cmpt_tail < cmpt_pidx)
-		nb_entries_avail = cmpt_pidx - cmpt_tail;
-	else if (cmpt_tail > cmpt_pidx)
-		nb_entries_avail = cmptq->nb_cmpt_desc - 1 - cmpt_tail +
-			cmpt_pidx;
-
+	nb_entries_avail = qdma_mm_cmptq_avail(cmptq);
 	if (nb_entries_avail == 0) {
 		PMD_DRV_LOG(DEBUG, "%s(): %d: nb_entries_avail = 0\n",
 				__func__, __LINE__);
@@ -1751,35 +1853,286 @@ uint16_t rte_pmd_qdma_mm_cmpt_process(int port_id, uint32_t qid,
 	if (nb_entries > nb_entries_avail)
 		nb_entries = nb_entries_avail;
 
+	cmpt_tail = cmptq->cmpt_cidx_info.wrb_cidx;
+	ring_sz = cmptq->nb_cmpt_desc - 1;
 	while (count < nb_entries) {
-		cmpt_entry =
-		(struct qdma_ul_cmpt_ring *)((uint64_t)cmptq->cmpt_ring +
-		((uint64_t)cmpt_tail * cmptq->cmpt_desc_len));
-
-		ret = qdma_ul_process_immediate_data(cmpt_entry,
-				cmptq->cmpt_desc_len, cmpt_buff);
-		if (ret < 0) {
+		run = RTE_MIN((uint16_t)(nb_entries - count),
+				(uint16_t)(ring_sz - cmpt_tail));
+		cmpt_entry = (char *)cmptq->cmpt_ring +
+			(size_t)cmpt_tail * cmptq->cmpt_desc_len;
+
+		done = qdma_ul_process_immediate_data_burst(cmpt_entry,
+				cmptq->cmpt_desc_len, run,
+				(char *)cmpt_buff +
+				(size_t)count * cmptq->cmpt_desc_len);
+		count += done;
+		cmpt_tail += done;
+		if (cmpt_tail >= ring_sz)
+			cmpt_tail -= ring_sz;
+
+		if (unlikely(done < run)) {
 			PMD_DRV_LOG(ERR, "Error detected on CMPT ring at "
 					"index %d, queue_id = %d\n",
 					cmpt_tail,
 					cmptq->queue_id);
-			return 0;
+			break;
 		}
-		cmpt_tail++;
-		if (unlikely(cmpt_tail >= (cmptq->nb_cmpt_desc - 1)))
-			cmpt_tail -= (cmptq->nb_cmpt_desc - 1);
-		count++;
 	}
 
+	if (!count)
+		return 0;
+
 	// Update the CPMT CIDX
 	cmptq->cmpt_cidx_info.wrb_cidx = cmpt_tail;
-	qdma_dev->hw_access->qdma_queue_cmpt_cidx_update(cmptq->dev,
-			qdma_dev->is_vf,
-			cmptq->queue_id,
-			&cmptq->cmpt_cidx_info);
+	qdma_queue_cmpt_cidx_db(QDMA_QUEUE_DEV(cmptq), cmptq->queue_id,
+		&cmptq->cmpt_cidx_info);
 	return count;
 }
 
+/*****************************************************************************/
+/**
+ * Function Name:   rte_pmd_qdma_mm_cmpt_peek
+ * Description:     Get the MM Completion queue entries in place, without
+ *                  copying or consuming them.
+ *
+ * @param   port_id : Port ID.
+ * @param   qid : Queue ID.
+ * @param   cmpt_entries : Set to the first available entry in the ring.
+ * @param   nb_entries: Max number of completion entries to return.
+ *
+ * @return  'number of contiguous entries at *cmpt_entries' on success
+ *          and '< 0' on failure.
+ *
+ * @note    Application can call this API after successful call to
+ *	    rte_pmd_qdma_dev_cmptq_start() API.
+ ******************************************************************************/
+int rte_pmd_qdma_mm_cmpt_peek(int port_id, uint32_t qid,
+		void **cmpt_entries, uint16_t nb_entries)
+{
+	struct qdma_cmpt_queue *cmptq;
+	uint16_t nb_entries_avail;
+	uint16_t cmpt_tail;
+	int ret;
+
+	ret = qdma_mm_cmptq_get(port_id, qid, &cmptq);
+	if (ret)
+		return ret;
+
+	if (cmpt_entries == NULL) {
+		PMD_DRV_LOG(ERR, "Invalid entries pointer from user");
+		return -EINVAL;
+	}
+
+	nb_entries_avail = qdma_mm_cmptq_avail(cmptq);
+	cmpt_tail = cmptq->cmpt_cidx_info.wrb_cidx;
+
+	/* Stop at the ring end, the next peek returns the wrapped part */
+	nb_entries = RTE_MIN(nb_entries, nb_entries_avail);
+	nb_entries = RTE_MIN(nb_entries,
+			(uint16_t)(cmptq->nb_cmpt_desc - 1 - cmpt_tail));
+
+	*cmpt_entries = (char *)cmptq->cmpt_ring +
+		(size_t)cmpt_tail * cmptq->cmpt_desc_len;
+
+	return nb_entries;
+}
+
+/*****************************************************************************/
+/**
+ * Function Name:   rte_pmd_qdma_mm_cmpt_release
+ * Description:     Hand MM Completion queue entries returned by
+ *                  rte_pmd_qdma_mm_cmpt_peek() back to the HW.
+ *
+ * @param   port_id : Port ID.
+ * @param   qid : Queue ID.
+ * @param   nb_entries: Number of completion entries to release.
+ *
+ * @return  '0' on success and '< 0' on failure.
+ *
+ * @note    nb_entries shall not exceed the count returned by the last
+ *          rte_pmd_qdma_mm_cmpt_peek() call.
+ ******************************************************************************/
+int rte_pmd_qdma_mm_cmpt_release(int port_id, uint32_t qid,
+		uint16_t nb_entries)
+{
+	struct qdma_cmpt_queue *cmptq;
+	uint16_t cmpt_tail, ring_sz;
+	int ret;
+
+	ret = qdma_mm_cmptq_get(port_id, qid, &cmptq);
+	if (ret)
+		return ret;
+
+	if (nb_entries == 0)
+		return 0;
+
+	ring_sz = cmptq->nb_cmpt_desc - 1;
+	if (nb_entries > ring_sz)
+		return -EINVAL;
+
+	cmpt_tail = cmptq->cmpt_cidx_info.wrb_cidx + nb_entries;
+	if (cmpt_tail >= ring_sz)
+		cmpt_tail -= ring_sz;
+
+	cmptq->cmpt_cidx_info.wrb_cidx = cmpt_tail;
+	qdma_queue_cmpt_cidx_db(QDMA_QUEUE_DEV(cmptq), cmptq->queue_id,
+		&cmptq->cmpt_cidx_info);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+ * Function Name:   rte_pmd_qdma_tx_flush
+ * Description:     Update the PIDX of a ST Tx queue with the descriptors
+ *                  left pending by rte_eth_tx_burst().
+ *
+ * @param   port_id : Port ID.
+ * @param   qid : Queue ID.
+ *
+ * @return  '0' on success and '< 0' on failure.
+ *
+ * @note    Must be called from the thread transmitting on the queue.
+ ******************************************************************************/
+int rte_pmd_qdma_tx_flush(int port_id, uint32_t qid)
+{
+	struct rte_eth_dev *dev;
+	struct qdma_tx_queue *txq;
+	int ret = 0;
+
+	ret = validate_qdma_dev_info(port_id, qid);
+	if (ret != QDMA_SUCCESS) {
+		PMD_DRV_LOG(ERR,
+			"QDMA device validation failed for port id %d\n",
+			port_id);
+		return ret;
+	}
+	dev = &rte_eth_devices[port_id];
+	if (qid >= dev->data->nb_tx_queues ||
+			dev->data->tx_queues[qid] == NULL) {
+		PMD_DRV_LOG(ERR, "Tx qid %d is not set up\n", qid);
+		return -EINVAL;
+	}
+
+	txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
+	if (txq->status != RTE_ETH_QUEUE_STATE_STARTED)
+		return -EINVAL;
+
+	qdma_txq_pidx_flush(txq);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+ * Function Name:   rte_pmd_qdma_dma_chan_get
+ * Description:     Get the handle to drive a MM queue through the
+ *                  rte_pmd_qdma_dma_*() copy API.
+ *
+ * @param   port_id : Port ID.
+ * @param   qid : Queue ID.
+ * @param   dir : Direction i.e. Tx (H2C) or Rx (C2H).
+ * @param   chan : Pointer to store the handle of the queue.
+ *
+ * @return  '0' on success and '< 0' on failure.
+ *
+ * @note    The queue must be started in MM mode without bypass and must
+ *	    not be used with rte_eth_tx_burst()/rte_eth_rx_burst() afterwards.
+ ******************************************************************************/
+int rte_pmd_qdma_dma_chan_get(int port_id, uint32_t qid,
+		enum rte_pmd_qdma_dir_type dir, void **chan)
+{
+	struct rte_eth_dev *dev;
+	struct qdma_pci_dev *qdma_dev;
+	struct qdma_dma_chan *dma_chan;
+	struct qdma_tx_queue *txq;
+	struct qdma_rx_queue *rxq;
+	int ret = 0;
+
+	ret = validate_qdma_dev_info(port_id, qid);
+	if (ret != QDMA_SUCCESS) {
+		PMD_DRV_LOG(ERR,
+			"QDMA device validation failed for port id %d\n",
+			port_id);
+		return ret;
+	}
+	dev = &rte_eth_devices[port_id];
+	qdma_dev = dev->data->dev_private;
+	if (qdma_dev->q_info[qid].queue_mode !=
+			RTE_PMD_QDMA_MEMORY_MAPPED_MODE) {
+		PMD_DRV_LOG(ERR, "Qid %d is not configured in MM-mode\n", qid);
+		return -EINVAL;
+	}
+
+	if (chan == NULL) {
+		PMD_DRV_LOG(ERR, "Invalid chan pointer from user");
+		return -EINVAL;
+	}
+
+	if (dir == RTE_PMD_QDMA_TX) {
+		if (qid >= dev->data->nb_tx_queues ||
+				dev->data->tx_queues[qid] == NULL) {
+			PMD_DRV_LOG(ERR, "Tx qid %d is not set up\n", qid);
+			return -EINVAL;
+		}
+		txq = (struct qdma_tx_queue *)dev->data->tx_queues[qid];
+		if (txq->status != RTE_ETH_QUEUE_STATE_STARTED ||
+				txq->en_bypass) {
+			PMD_DRV_LOG(ERR, "Tx qid %d is not started or is in "
+					"bypass mode\n", qid);
+			return -EINVAL;
+		}
+		dma_chan = &txq->dma_chan;
+		dma_chan->ring = (struct qdma_ul_mm_desc *)txq->tx_ring;
+		dma_chan->wb_status = txq->wb_status;
+		dma_chan->pidx_info = &txq->q_pidx_info;
+		dma_chan->ring_sz = txq->nb_tx_desc - 1;
+		dma_chan->is_c2h = 0;
+		dma_chan->vec = (txq->vec_path != QDMA_VEC_PATH_SCALAR);
+	} else if (dir == RTE_PMD_QDMA_RX) {
+		if (qid >= dev->data->nb_rx_queues ||
+				dev->data->rx_queues[qid] == NULL) {
+			PMD_DRV_LOG(ERR, "Rx qid %d is not set up\n", qid);
+			return -EINVAL;
+		}
+		rxq = (struct qdma_rx_queue *)dev->data->rx_queues[qid];
+		if (rxq->status != RTE_ETH_QUEUE_STATE_STARTED ||
+				rxq->en_bypass) {
+			PMD_DRV_LOG(ERR, "Rx qid %d is not started or is in "
+					"bypass mode\n", qid);
+			return -EINVAL;
+		}
+		dma_chan = &rxq->dma_chan;
+		dma_chan->ring = (struct qdma_ul_mm_desc *)rxq->rx_ring;
+		dma_chan->wb_status = rxq->wb_status;
+		dma_chan->pidx_info = &rxq->q_pidx_info;
+		dma_chan->ring_sz = rxq->nb_rx_desc - 1;
+		dma_chan->is_c2h = 1;
+		dma_chan->vec = (rxq->vec_path != QDMA_VEC_PATH_SCALAR);
+	} else {
+		PMD_DRV_LOG(ERR, "Invalid direction specified,"
+			"Direction is %d\n", dir);
+		return -EINVAL;
+	}
+
+	if (dma_chan->wb_status->cidx != dma_chan->pidx_info->pidx) {
+		PMD_DRV_LOG(ERR, "Qid %d has transfers in flight\n", qid);
+		return -EBUSY;
+	}
+
+	dma_chan->port_id = port_id;
+	dma_chan->queue_id = qid;
+	dma_chan->pidx = dma_chan->pidx_info->pidx;
+	dma_chan->cidx = dma_chan->pidx;
+	dma_chan->pending = 0;
+	dma_chan->next_idx = 0;
+	dma_chan->cpl_idx = 0;
+
+	*chan = dma_chan;
+
+	return 0;
+}
+
 /*****************************************************************************/
 /**
  * Function Name:   rte_pmd_qdma_dev_close
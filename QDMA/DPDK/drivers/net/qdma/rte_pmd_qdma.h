@@ -40,6 +40,7 @@
 #include <rte_log.h>
 #include <rte_byteorder.h>
 #include <rte_memzone.h>
+#include <stdbool.h>
 #include <linux/pci.h>
 
 #ifdef __cplusplus
@@ -293,6 +294,24 @@ struct rte_pmd_qdma_dev_attributes {
 	enum rte_pmd_qdma_ip_type ip_type;
 };
 
+/**
+ * Scatter-gather entry for rte_pmd_qdma_dma_copy_sg()
+ *
+ * @ingroup rte_pmd_qdma_struct
+ */
+struct rte_pmd_qdma_dma_sge {
+	/** Host IOVA or card address */
+	rte_iova_t addr;
+	/** Length in bytes */
+	uint32_t length;
+};
+
+/** Update the PIDX after enqueueing the copy, see rte_pmd_qdma_dma_submit() */
+#define RTE_PMD_QDMA_DMA_OP_FLAG_SUBMIT	(1ULL << 0)
+
+/** Max length of a single MM descriptor */
+#define RTE_PMD_QDMA_DMA_MAX_LEN	((1U << 28) - 1)
+
 
 /******************************************************************************/
 /**
@@ -570,6 +589,37 @@ int rte_pmd_qdma_set_cmpt_timer(int port_id, uint32_t qid, uint32_t value);
 int rte_pmd_qdma_set_c2h_descriptor_prefetch(int port_id, uint32_t qid,
 			uint8_t enable);
 
+/******************************************************************************/
+/**
+ * Sets a second mbuf pool for the short packets of a streaming mode Rx
+ * queue.
+ *
+ * The C2H buffer size of a queue is fixed, the largest one that fits in
+ * the data room of the pool given to rte_eth_rx_queue_setup(). With a
+ * pool sized for the largest packets, large packets are received in a
+ * single mbuf. Packets of up to copy_len bytes are then copied into an
+ * mbuf of copy_pool and their C2H buffer is reused right away, so that
+ * short packets do not hold large buffers. Packets are copied only while
+ * copy_pool has free mbufs.
+ *
+ *@param	port_id   Port ID
+ *@param	qid       Queue ID
+ *@param	copy_pool Pool for the short packets, NULL to disable copying
+ *@param	copy_len  Largest packet length copied, must fit in the data
+ *			  room of copy_pool
+ *
+ *@return	'0' on success and '< 0' on failure
+ *
+ *@note		Application can call this API after successful call to
+ *		rte_eth_dev_configure() API, and after rte_eth_rx_queue_setup()
+ *		only if the Rx queue is not started. The Rx burst of the queue
+ *		does not use the vector packet preparation while a copy pool
+ *		is set.
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_set_rx_copy_pool(int port_id, uint32_t qid,
+			struct rte_mempool *copy_pool, uint16_t copy_len);
+
 /*****************************************************************************/
 /**
  * Sets the PCIe endpoint memory offset at which to
@@ -712,7 +762,8 @@ int rte_pmd_qdma_dev_cmptq_stop(int port_id, uint32_t qid);
  *
  * @param   port_id Port ID
  * @param   qid  Queue ID
- * @param   cmpt_buff  User buffer pointer to store the completion data
+ * @param   cmpt_buff  User buffer pointer to store the completion data,
+ *                     nb_entries * completion entry size bytes long
  * @param   nb_entries Number of compeltion entries to process
  *
  * @return  'number of entries processed' on success and '< 0' on failure
@@ -724,6 +775,176 @@ int rte_pmd_qdma_dev_cmptq_stop(int port_id, uint32_t qid);
 uint16_t rte_pmd_qdma_mm_cmpt_process(int port_id, uint32_t qid,
 		void *cmpt_buff, uint16_t nb_entries);
 
+/******************************************************************************/
+/**
+ * Gets the available MM Completion queue entries in place, without copying
+ * them to a user buffer or returning them to the HW. The entries are laid
+ * out every completion entry size bytes, as set with
+ * rte_pmd_qdma_set_cmpt_descriptor_size(), and keep the status bits of the
+ * user logic format (see struct qdma_ul_cmpt_ring) that
+ * rte_pmd_qdma_mm_cmpt_process() checks and masks.
+ *
+ * Only the entries up to the ring end are returned; once those are
+ * released, the next call returns the entries after the ring wrap.
+ *
+ * @param	port_id Port ID
+ * @param	qid  Queue ID
+ * @param	cmpt_entries Set to the first available completion entry
+ * @param	nb_entries Max number of completion entries to return
+ *
+ * @return	'number of contiguous entries at *cmpt_entries' on success
+ *		and '< 0' on failure
+ *
+ * @note	Application can call this API after successful call to
+ *		rte_pmd_qdma_dev_cmptq_start() API
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_mm_cmpt_peek(int port_id, uint32_t qid,
+		void **cmpt_entries, uint16_t nb_entries);
+
+/******************************************************************************/
+/**
+ * Releases MM Completion queue entries obtained with
+ * rte_pmd_qdma_mm_cmpt_peek() and updates the CIDX once for all of them.
+ * The entries shall not be accessed after this call.
+ *
+ * @param	port_id Port ID
+ * @param	qid  Queue ID
+ * @param	nb_entries Number of completion entries to release, at most
+ *		the count returned by the last rte_pmd_qdma_mm_cmpt_peek()
+ *
+ * @return	'0' on success and '< 0' on failure
+ *
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_mm_cmpt_release(int port_id, uint32_t qid,
+		uint16_t nb_entries);
+
+/******************************************************************************/
+/**
+ * Updates the PIDX of a ST Tx queue with the descriptors that
+ * rte_eth_tx_burst() left pending. Only needed when the driver is built
+ * with MIN_TX_PIDX_UPDATE_THRESHOLD > 1 and the application stops
+ * transmitting on the queue; otherwise pending descriptors are flushed by
+ * the next Tx burst once QDMA_TXQ_PIDX_FLUSH_US has passed.
+ *
+ * @param	port_id Port ID
+ * @param	qid  Queue ID
+ *
+ * @return	'0' on success and '< 0' on failure
+ *
+ * @note	Must be called from the thread transmitting on the queue
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_tx_flush(int port_id, uint32_t qid);
+
+/******************************************************************************/
+/**
+ * Gets the handle to drive a MM queue through the rte_pmd_qdma_dma_*() copy
+ * API, without mbufs. The H2C queue copies host memory to card memory and
+ * the C2H queue copies card memory to host memory.
+ *
+ * @param	port_id Port ID
+ * @param	qid  Queue ID
+ * @param	dir Direction i.e. Tx (H2C) or Rx (C2H)
+ * @param	chan Pointer to store the handle of the queue
+ *
+ * @return	'0' on success and '< 0' on failure
+ *
+ * @note	The queue must be started in MM mode without bypass and must
+ *		not be used with rte_eth_tx_burst() or rte_eth_rx_burst()
+ *		afterwards. The handle stays valid until the queue is
+ *		stopped.
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_dma_chan_get(int port_id, uint32_t qid,
+		enum rte_pmd_qdma_dir_type dir, void **chan);
+
+/******************************************************************************/
+/**
+ * Enqueues a copy on a MM queue, one descriptor per copy
+ *
+ * @param	chan Handle from rte_pmd_qdma_dma_chan_get()
+ * @param	src Source host IOVA (H2C) or card address (C2H)
+ * @param	dst Destination card address (H2C) or host IOVA (C2H)
+ * @param	length Length in bytes, up to RTE_PMD_QDMA_DMA_MAX_LEN
+ * @param	flags RTE_PMD_QDMA_DMA_OP_FLAG_* flags
+ *
+ * @return	ring index of the copy on success, -ENOSPC if the ring is
+ *		full and -EINVAL on invalid length
+ *
+ * @note	Not thread safe for the same queue
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_dma_copy(void *chan, rte_iova_t src, rte_iova_t dst,
+		uint32_t length, uint64_t flags);
+
+/******************************************************************************/
+/**
+ * Enqueues a scatter-gather copy on a MM queue. The source and destination
+ * lists must have the same total length; one descriptor is used for each
+ * contiguous piece and each descriptor takes one ring index.
+ *
+ * @param	chan Handle from rte_pmd_qdma_dma_chan_get()
+ * @param	src Source entries
+ * @param	dst Destination entries
+ * @param	nb_src Number of source entries
+ * @param	nb_dst Number of destination entries
+ * @param	flags RTE_PMD_QDMA_DMA_OP_FLAG_* flags
+ *
+ * @return	ring index of the last descriptor of the copy on success,
+ *		-ENOSPC if the ring is full and -EINVAL on invalid lists
+ *
+ * @note	Not thread safe for the same queue
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_dma_copy_sg(void *chan,
+		const struct rte_pmd_qdma_dma_sge *src,
+		const struct rte_pmd_qdma_dma_sge *dst,
+		uint16_t nb_src, uint16_t nb_dst, uint64_t flags);
+
+/******************************************************************************/
+/**
+ * Updates the queue PIDX for all copies enqueued so far, so that the
+ * engine starts them
+ *
+ * @param	chan Handle from rte_pmd_qdma_dma_chan_get()
+ *
+ * @return	'0' on success
+ *
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+int rte_pmd_qdma_dma_submit(void *chan);
+
+/******************************************************************************/
+/**
+ * Returns the number of copies completed since the last call
+ *
+ * @param	chan Handle from rte_pmd_qdma_dma_chan_get()
+ * @param	nb_cpls Max number of completions to return
+ * @param	last_idx Ring index of the last completed copy
+ * @param	has_error Set if a completed copy failed. MM queues do not
+ *		report per descriptor errors, so this is always false
+ *
+ * @return	number of completed copies
+ *
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+uint16_t rte_pmd_qdma_dma_completed(void *chan, uint16_t nb_cpls,
+		uint16_t *last_idx, bool *has_error);
+
+/******************************************************************************/
+/**
+ * Returns the number of descriptors free for new copies
+ *
+ * @param	chan Handle from rte_pmd_qdma_dma_chan_get()
+ *
+ * @return	number of free descriptors
+ *
+ * @ingroup rte_pmd_qdma_func
+ ******************************************************************************/
+uint16_t rte_pmd_qdma_dma_burst_capacity(void *chan);
+
 /*****************************************************************************/
 /**
  * DPDK PMD function to close the device.
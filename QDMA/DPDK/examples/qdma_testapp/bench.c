@@ -0,0 +1,344 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright (c) 2017-2022 Xilinx, Inc. All rights reserved.
+ *   Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Throughput benchmark. Rx/Tx workers run on the worker lcores, each one
+ * owning every nb_lcores-th queue of the port, while the command line
+ * lcore reports per queue rates every second. Tx mbufs come from the port
+ * mempool, filled once with a pattern before the run, so that the
+ * datapath does no file I/O.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_ethdev.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_cycles.h>
+#include <rte_spinlock.h>
+#include <cmdline.h>
+
+#include "testapp.h"
+
+#define BENCH_BURST_SZ		64
+#define BENCH_FILL_PATTERN	0xA5
+
+struct bench_qstats {
+	uint64_t rx_pkts;
+	uint64_t rx_bytes;
+	uint64_t rx_cycles; /* TSC cycles spent in rte_eth_rx_burst() */
+	uint64_t rx_calls;  /* rte_eth_rx_burst() calls, empty polls included */
+	uint64_t tx_pkts;
+	uint64_t tx_bytes;
+	uint64_t tx_cycles; /* TSC cycles spent in rte_eth_tx_burst() */
+	uint64_t tx_calls;  /* rte_eth_tx_burst() calls */
+} __rte_cache_aligned;
+
+static struct {
+	uint16_t port_id;
+	uint16_t pkt_size;
+	unsigned int dir;
+	unsigned int nb_queues;
+	unsigned int nb_workers;
+	struct rte_mempool *mp;
+	struct bench_qstats *qstats;
+	volatile int stop;
+} bench;
+
+static void bench_fill_mbuf(struct rte_mempool *mp __rte_unused,
+		void *arg __rte_unused, void *obj, unsigned int idx __rte_unused)
+{
+	struct rte_mbuf *mb = obj;
+
+	memset((char *)mb->buf_addr + RTE_PKTMBUF_HEADROOM,
+			BENCH_FILL_PATTERN,
+			mb->buf_len - RTE_PKTMBUF_HEADROOM);
+}
+
+static void bench_xmit(uint16_t queueid, struct bench_qstats *st)
+{
+	struct rte_mbuf *pkts[BENCH_BURST_SZ];
+	uint64_t tsc;
+	uint16_t nb_tx, i;
+
+	if (rte_pktmbuf_alloc_bulk(bench.mp, pkts, BENCH_BURST_SZ))
+		return;
+
+	for (i = 0; i < BENCH_BURST_SZ; i++) {
+		rte_pktmbuf_data_len(pkts[i]) = bench.pkt_size;
+		rte_pktmbuf_pkt_len(pkts[i]) = bench.pkt_size;
+	}
+
+	tsc = rte_rdtsc();
+	nb_tx = rte_eth_tx_burst(bench.port_id, queueid, pkts, BENCH_BURST_SZ);
+	st->tx_cycles += rte_rdtsc() - tsc;
+	st->tx_calls++;
+	st->tx_pkts += nb_tx;
+	st->tx_bytes += (uint64_t)nb_tx * bench.pkt_size;
+
+	if (nb_tx < BENCH_BURST_SZ)
+		rte_pktmbuf_free_bulk(&pkts[nb_tx], BENCH_BURST_SZ - nb_tx);
+}
+
+static void bench_recv(uint16_t queueid, struct bench_qstats *st)
+{
+	struct rte_mbuf *pkts[BENCH_BURST_SZ];
+	uint64_t tsc;
+	uint16_t nb_rx, i;
+
+	tsc = rte_rdtsc();
+	nb_rx = rte_eth_rx_burst(bench.port_id, queueid, pkts, BENCH_BURST_SZ);
+	st->rx_cycles += rte_rdtsc() - tsc;
+	st->rx_calls++;
+	if (!nb_rx)
+		return;
+
+	for (i = 0; i < nb_rx; i++)
+		st->rx_bytes += rte_pktmbuf_pkt_len(pkts[i]);
+	st->rx_pkts += nb_rx;
+
+	rte_pktmbuf_free_bulk(pkts, nb_rx);
+}
+
+static int bench_worker(void *arg)
+{
+	unsigned int first = (unsigned int)(uintptr_t)arg;
+	unsigned int q;
+
+	while (!bench.stop) {
+		for (q = first; q < bench.nb_queues; q += bench.nb_workers) {
+			if (bench.dir & BENCH_DIR_TX)
+				bench_xmit(q, &bench.qstats[q]);
+			if (bench.dir & BENCH_DIR_RX)
+				bench_recv(q, &bench.qstats[q]);
+		}
+	}
+
+	return 0;
+}
+
+static void bench_print_row(const char *qname, const char *dir,
+		uint64_t pkts, uint64_t bytes, uint64_t cycles,
+		uint64_t calls, double secs)
+{
+	printf("%8s%6s%14.4lf%14.4lf%14.1lf%14.1lf\n", qname, dir,
+			(double)pkts / secs / 1000000,
+			(double)bytes * 8 / secs / 1000000000,
+			pkts ? (double)cycles / pkts : 0.0,
+			calls ? (double)cycles / calls : 0.0);
+}
+
+/* Print the rates between two snapshots of the queue counters */
+static void bench_report(const struct bench_qstats *cur,
+		const struct bench_qstats *prev, double secs)
+{
+	struct bench_qstats tot;
+	char qname[16];
+	unsigned int q;
+
+	memset(&tot, 0, sizeof(tot));
+	printf("\n%8s%6s%14s%14s%14s%14s\n", "Queue", "Dir", "Mpps", "Gbps",
+			"Cycles/pkt", "Cycles/call");
+	for (q = 0; q < bench.nb_queues; q++) {
+		uint64_t pkts, bytes, cycles, calls;
+
+		snprintf(qname, sizeof(qname), "%u", q);
+		if (bench.dir & BENCH_DIR_RX) {
+			pkts = cur[q].rx_pkts - prev[q].rx_pkts;
+			bytes = cur[q].rx_bytes - prev[q].rx_bytes;
+			cycles = cur[q].rx_cycles - prev[q].rx_cycles;
+			calls = cur[q].rx_calls - prev[q].rx_calls;
+			bench_print_row(qname, "rx", pkts, bytes, cycles, calls,
+					secs);
+			tot.rx_pkts += pkts;
+			tot.rx_bytes += bytes;
+			tot.rx_cycles += cycles;
+			tot.rx_calls += calls;
+		}
+		if (bench.dir & BENCH_DIR_TX) {
+			pkts = cur[q].tx_pkts - prev[q].tx_pkts;
+			bytes = cur[q].tx_bytes - prev[q].tx_bytes;
+			cycles = cur[q].tx_cycles - prev[q].tx_cycles;
+			calls = cur[q].tx_calls - prev[q].tx_calls;
+			bench_print_row(qname, "tx", pkts, bytes, cycles, calls,
+					secs);
+			tot.tx_pkts += pkts;
+			tot.tx_bytes += bytes;
+			tot.tx_cycles += cycles;
+			tot.tx_calls += calls;
+		}
+	}
+
+	if (bench.dir & BENCH_DIR_RX)
+		bench_print_row("total", "rx", tot.rx_pkts, tot.rx_bytes,
+				tot.rx_cycles, tot.rx_calls, secs);
+	if (bench.dir & BENCH_DIR_TX)
+		bench_print_row("total", "tx", tot.tx_pkts, tot.tx_bytes,
+				tot.tx_cycles, tot.tx_calls, secs);
+}
+
+int do_bench(int port_id, unsigned int dir, unsigned int nb_queues,
+		unsigned int nb_lcores, unsigned int pkt_size,
+		unsigned int duration)
+{
+	struct bench_qstats *snap[2] = { NULL, NULL };
+	unsigned int lcore_id, w, sec;
+	unsigned int lcores[RTE_MAX_LCORE];
+	uint64_t start_tsc, prev_tsc, cur_tsc;
+	size_t sz;
+	int ret = -1;
+
+	if (rte_eth_devices[port_id].device == NULL) {
+		printf("Port id %d already removed. "
+			"Relaunch application to use the port again\n",
+			port_id);
+		return -1;
+	}
+
+	if (nb_queues == 0 || nb_queues > pinfo[port_id].num_queues) {
+		printf("Error: num-queues:%u, port %d has %u queues\n",
+				nb_queues, port_id, pinfo[port_id].num_queues);
+		return -1;
+	}
+
+	if (nb_lcores == 0 || nb_lcores > rte_lcore_count() - 1) {
+		printf("Error: num-lcores:%u, %u worker lcores available\n",
+				nb_lcores, rte_lcore_count() - 1);
+		return -1;
+	}
+	if (nb_lcores > nb_queues)
+		nb_lcores = nb_queues;
+
+	if (pkt_size == 0 || pkt_size > pinfo[port_id].buff_size) {
+		printf("Error: pkt-size:%u, shall be 1 to %u\n",
+				pkt_size, pinfo[port_id].buff_size);
+		return -1;
+	}
+
+	if (duration == 0) {
+		printf("Error: duration shall be at least 1 second\n");
+		return -1;
+	}
+
+	bench.mp = rte_mempool_lookup(pinfo[port_id].mem_pool);
+	if (bench.mp == NULL) {
+		printf("Could not find mempool with name %s\n",
+				pinfo[port_id].mem_pool);
+		return -1;
+	}
+
+	sz = nb_queues * sizeof(struct bench_qstats);
+	bench.qstats = rte_zmalloc("bench_qstats", sz, RTE_CACHE_LINE_SIZE);
+	snap[0] = rte_zmalloc("bench_snap", sz, RTE_CACHE_LINE_SIZE);
+	snap[1] = rte_zmalloc("bench_snap", sz, RTE_CACHE_LINE_SIZE);
+	if (!bench.qstats || !snap[0] || !snap[1]) {
+		printf("Error: Could not allocate benchmark stats\n");
+		goto out_free;
+	}
+
+	rte_spinlock_lock(&pinfo[port_id].port_update_lock);
+
+	if (dir & BENCH_DIR_TX)
+		rte_mempool_obj_iter(bench.mp, bench_fill_mbuf, NULL);
+
+	bench.port_id = port_id;
+	bench.pkt_size = pkt_size;
+	bench.dir = dir;
+	bench.nb_queues = nb_queues;
+	bench.nb_workers = nb_lcores;
+	bench.stop = 0;
+
+	printf("bench on port %d: %s, %u queues on %u lcores, "
+			"pkt-size %u, %u seconds\n", port_id,
+			dir == BENCH_DIR_RX ? "rx" :
+			dir == BENCH_DIR_TX ? "tx" : "rxtx",
+			nb_queues, nb_lcores, pkt_size, duration);
+
+	w = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (w == nb_lcores)
+			break;
+		if (rte_eal_remote_launch(bench_worker,
+				(void *)(uintptr_t)w, lcore_id)) {
+			printf("Error: lcore %u is busy\n", lcore_id);
+			break;
+		}
+		lcores[w++] = lcore_id;
+	}
+
+	if (w == nb_lcores) {
+		start_tsc = prev_tsc = rte_rdtsc();
+		for (sec = 0; sec < duration; sec++) {
+			struct bench_qstats *cur = snap[(sec + 1) & 1];
+			struct bench_qstats *prev = snap[sec & 1];
+
+			sleep(1);
+			cur_tsc = rte_rdtsc();
+			memcpy(cur, bench.qstats, sz);
+			bench_report(cur, prev, (double)(cur_tsc - prev_tsc) /
+					rte_get_tsc_hz());
+			prev_tsc = cur_tsc;
+		}
+		ret = 0;
+	}
+
+	bench.stop = 1;
+	while (w)
+		rte_eal_wait_lcore(lcores[--w]);
+
+	if (!ret) {
+		/* Averages over the whole run */
+		cur_tsc = rte_rdtsc();
+		memcpy(snap[0], bench.qstats, sz);
+		memset(snap[1], 0, sz);
+		printf("\nAverage over %u seconds:", duration);
+		bench_report(snap[0], snap[1], (double)(cur_tsc - start_tsc) /
+				rte_get_tsc_hz());
+	}
+
+	rte_spinlock_unlock(&pinfo[port_id].port_update_lock);
+
+out_free:
+	rte_free(snap[1]);
+	rte_free(snap[0]);
+	rte_free(bench.qstats);
+	bench.qstats = NULL;
+	return ret;
+}
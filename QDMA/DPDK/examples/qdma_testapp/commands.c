@@ -175,6 +175,18 @@ static void cmd_help_parsed(__attribute__((unused)) void *parsed_result,
 			"queue-number\n"
 			"\tload_cmds            <file-name> "
 			":To execute the list of commands from file\n"
+			"\tstream_to_device     <port-id> <queue-id> "
+						"<input-filename> "
+			"<dst_addr> <size>   "
+			":To Transmit with overlapped file I/O\n"
+			"\tstream_from_device   <port-id> <queue-id> "
+						"<output-filename> "
+			"<src_addr> <size>  "
+			":To Receive with overlapped file I/O\n"
+			"\tbench                <port-id> <rx|tx|rxtx> "
+						"<num-queues> <num-lcores> "
+			"<pkt-size> <duration>  "
+			":Throughput benchmark on worker lcores\n"
 			"\thelp\n"
 			"\tCtrl-d                           "
 			": To quit from this command-line type Ctrl+d\n"
@@ -1359,6 +1371,160 @@ cmdline_parse_inst_t cmd_obj_load_cmds = {
 
 };
 
+/* Command file streaming */
+
+struct cmd_obj_stream_result {
+	cmdline_fixed_string_t action;
+	cmdline_fixed_string_t port_id;
+	cmdline_fixed_string_t queue_id;
+	cmdline_fixed_string_t filename;
+	cmdline_fixed_string_t addr;
+	cmdline_fixed_string_t size;
+};
+
+static void cmd_obj_stream_parsed(void *parsed_result,
+			       struct cmdline *cl,
+			       __attribute__((unused)) void *data)
+{
+	struct cmd_obj_stream_result *res = parsed_result;
+	int port_id = atoi(res->port_id);
+	int queue_id = atoi(res->queue_id);
+	uint64_t addr = strtoull(res->addr, NULL, 0);
+	uint64_t size = strtoull(res->size, NULL, 0);
+	int ret;
+
+	if (port_id >= num_ports) {
+		cmdline_printf(cl, "Error: port-id:%d not supported\n "
+						"Please enter valid port-id\n",
+						port_id);
+		return;
+	}
+
+	if (size == 0) {
+		cmdline_printf(cl, "Error: Please enter valid size\n");
+		return;
+	}
+
+	if (!strcmp(res->action, "stream_to_device"))
+		ret = do_stream_to_device(port_id, queue_id, res->filename,
+				addr, size);
+	else
+		ret = do_stream_from_device(port_id, queue_id, res->filename,
+				addr, size);
+	if (ret < 0)
+		cmdline_printf(cl, "Error: %s on port-id:%d queue-id:%d "
+				"failed\n", res->action, port_id, queue_id);
+}
+
+cmdline_parse_token_string_t cmd_obj_action_stream =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_stream_result, action,
+					"stream_to_device#stream_from_device");
+cmdline_parse_token_string_t cmd_obj_stream_port_id =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_stream_result, port_id, NULL);
+cmdline_parse_token_string_t cmd_obj_stream_queue_id =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_stream_result, queue_id, NULL);
+cmdline_parse_token_string_t cmd_obj_stream_filename =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_stream_result, filename, NULL);
+cmdline_parse_token_string_t cmd_obj_stream_addr =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_stream_result, addr, NULL);
+cmdline_parse_token_string_t cmd_obj_stream_size =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_stream_result, size, NULL);
+
+cmdline_parse_inst_t cmd_obj_stream = {
+	.f = cmd_obj_stream_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = "stream_to_device|stream_from_device port-id queue-id "
+			"filename ep_addr size",
+	.tokens = {        /* token list, NULL terminated */
+		(void *)&cmd_obj_action_stream,
+		(void *)&cmd_obj_stream_port_id,
+		(void *)&cmd_obj_stream_queue_id,
+		(void *)&cmd_obj_stream_filename,
+		(void *)&cmd_obj_stream_addr,
+		(void *)&cmd_obj_stream_size,
+		NULL,
+	},
+
+};
+
+/* Command throughput benchmark */
+
+struct cmd_obj_bench_result {
+	cmdline_fixed_string_t action;
+	cmdline_fixed_string_t port_id;
+	cmdline_fixed_string_t dir;
+	cmdline_fixed_string_t num_queues;
+	cmdline_fixed_string_t num_lcores;
+	cmdline_fixed_string_t pkt_size;
+	cmdline_fixed_string_t duration;
+};
+
+static void cmd_obj_bench_parsed(void *parsed_result,
+			       struct cmdline *cl,
+			       __attribute__((unused)) void *data)
+{
+	struct cmd_obj_bench_result *res = parsed_result;
+	int port_id = atoi(res->port_id);
+	unsigned int dir;
+
+	if (port_id >= num_ports) {
+		cmdline_printf(cl, "Error: port-id:%d not supported\n "
+						"Please enter valid port-id\n",
+						port_id);
+		return;
+	}
+
+	if (!strcmp(res->dir, "rx"))
+		dir = BENCH_DIR_RX;
+	else if (!strcmp(res->dir, "tx"))
+		dir = BENCH_DIR_TX;
+	else
+		dir = BENCH_DIR_RX | BENCH_DIR_TX;
+
+	if (do_bench(port_id, dir, atoi(res->num_queues),
+			atoi(res->num_lcores), atoi(res->pkt_size),
+			atoi(res->duration)) < 0)
+		cmdline_printf(cl, "Error: bench on port-id:%d failed\n",
+				port_id);
+}
+
+cmdline_parse_token_string_t cmd_obj_action_bench =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_bench_result, action,
+								"bench");
+cmdline_parse_token_string_t cmd_obj_bench_port_id =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_bench_result, port_id, NULL);
+cmdline_parse_token_string_t cmd_obj_bench_dir =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_bench_result, dir,
+								"rx#tx#rxtx");
+cmdline_parse_token_string_t cmd_obj_bench_num_queues =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_bench_result, num_queues,
+									NULL);
+cmdline_parse_token_string_t cmd_obj_bench_num_lcores =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_bench_result, num_lcores,
+									NULL);
+cmdline_parse_token_string_t cmd_obj_bench_pkt_size =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_bench_result, pkt_size, NULL);
+cmdline_parse_token_string_t cmd_obj_bench_duration =
+	TOKEN_STRING_INITIALIZER(struct cmd_obj_bench_result, duration, NULL);
+
+cmdline_parse_inst_t cmd_obj_bench = {
+	.f = cmd_obj_bench_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = "bench port-id rx|tx|rxtx num-queues num-lcores "
+			"pkt-size duration",
+	.tokens = {        /* token list, NULL terminated */
+		(void *)&cmd_obj_action_bench,
+		(void *)&cmd_obj_bench_port_id,
+		(void *)&cmd_obj_bench_dir,
+		(void *)&cmd_obj_bench_num_queues,
+		(void *)&cmd_obj_bench_num_lcores,
+		(void *)&cmd_obj_bench_pkt_size,
+		(void *)&cmd_obj_bench_duration,
+		NULL,
+	},
+
+};
+
 /* CONTEXT (list of instruction) */
 
 cmdline_parse_ctx_t main_ctx[] = {
@@ -1375,6 +1541,8 @@ cmdline_parse_ctx_t main_ctx[] = {
 	(cmdline_parse_inst_t *)&cmd_obj_queue_dump,
 	(cmdline_parse_inst_t *)&cmd_obj_desc_dump,
 	(cmdline_parse_inst_t *)&cmd_obj_load_cmds,
+	(cmdline_parse_inst_t *)&cmd_obj_stream,
+	(cmdline_parse_inst_t *)&cmd_obj_bench,
 	(cmdline_parse_inst_t *)&cmd_help,
 	NULL,
 };
@@ -0,0 +1,689 @@
+/*-
+ *   BSD LICENSE
+ *
+ *   Copyright (c) 2017-2022 Xilinx, Inc. All rights reserved.
+ *   Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * File streaming. The file I/O runs on a worker lcore and the DMA on the
+ * command line lcore, with an rte_ring of mbufs between the two, so that
+ * a transfer is bound by the slower of disk and PCIe rather than by
+ * their sum.
+ *
+ * To the device, the reader fills IOVA contiguous chunks with O_DIRECT
+ * reads and attaches the mbufs to them as external buffers: the data is
+ * DMA'd straight from the buffer the disk wrote, and a chunk is recycled
+ * once the PMD has freed the last mbuf pointing into it. The chunk state
+ * lives in its memzone and the chunks are found again by name, so chunks
+ * the PMD still holds when a stream ends stay valid until it frees them.
+ *
+ * From the device, the received mbufs are handed to a writer that
+ * gathers them into writev() calls.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* O_DIRECT */
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_memzone.h>
+#include <rte_ring.h>
+#include <rte_cycles.h>
+#include <rte_pause.h>
+#include <rte_spinlock.h>
+#include <cmdline.h>
+
+#include "pcierw.h"
+#include "testapp.h"
+#include "../../drivers/net/qdma/rte_pmd_qdma.h"
+
+#define STREAM_CHUNK_SZ		(4 * 1024 * 1024)
+#define STREAM_NB_CHUNKS	8
+#define STREAM_RING_SZ		8192
+#define STREAM_BURST_SZ		64
+#define STREAM_DIO_ALIGN	4096
+#define STREAM_RECLAIM_MS	1000
+
+/* At the end of the memzone of the chunk, past STREAM_CHUNK_SZ */
+struct stream_chunk {
+	struct rte_mbuf_ext_shared_info shinfo;
+	const struct rte_memzone *mz;
+	struct rte_ring *free_chunks;
+};
+
+struct stream_ctx {
+	uint16_t port_id;
+	uint16_t queue_id;
+	int fd;
+	uint64_t size;
+	unsigned int seg_size;
+	struct rte_mempool *mp;
+	struct rte_ring *ring;		/* mbufs between the two lcores */
+	struct rte_ring *free_chunks;	/* chunks with no mbuf attached */
+	uint64_t io_cycles;		/* TSC cycles spent in file I/O */
+	volatile int done;		/* producer has queued all the mbufs */
+	volatile int error;
+};
+
+static struct stream_ctx stream;
+
+/* Last mbuf attached to a chunk freed, hand it back to the reader */
+static void stream_chunk_free(void *addr __rte_unused, void *opaque)
+{
+	struct stream_chunk *chunk = opaque;
+
+	rte_ring_enqueue(chunk->free_chunks, chunk);
+}
+
+static void stream_enqueue(struct stream_ctx *ctx, struct rte_mbuf **pkts,
+		unsigned int nb_pkts)
+{
+	unsigned int n = 0;
+
+	while (n < nb_pkts && !ctx->error) {
+		n += rte_ring_enqueue_burst(ctx->ring, (void **)&pkts[n],
+				nb_pkts - n, NULL);
+		if (n < nb_pkts)
+			rte_pause();
+	}
+	if (n < nb_pkts)
+		rte_pktmbuf_free_bulk(&pkts[n], nb_pkts - n);
+}
+
+/* Wrap bytes [0, len) of a chunk in mbufs and queue them for Tx */
+static int stream_attach_chunk(struct stream_ctx *ctx,
+		struct stream_chunk *chunk, unsigned int len)
+{
+	struct rte_mbuf *pkts[STREAM_BURST_SZ];
+	unsigned int nb_segs = (len + ctx->seg_size - 1) / ctx->seg_size;
+	unsigned int off = 0, nb, i;
+	uint16_t seg_len;
+
+	rte_mbuf_ext_refcnt_set(&chunk->shinfo, nb_segs);
+
+	while (nb_segs) {
+		nb = RTE_MIN(nb_segs, (unsigned int)STREAM_BURST_SZ);
+		while (rte_pktmbuf_alloc_bulk(ctx->mp, pkts, nb)) {
+			if (!ctx->error) {
+				rte_pause();
+				continue;
+			}
+			/* Drop the references of the mbufs never attached */
+			if (!rte_mbuf_ext_refcnt_update(&chunk->shinfo,
+					-(int16_t)nb_segs))
+				stream_chunk_free(chunk->mz->addr, chunk);
+			return -1;
+		}
+
+		for (i = 0; i < nb; i++) {
+			seg_len = RTE_MIN(ctx->seg_size, len - off);
+			rte_pktmbuf_attach_extbuf(pkts[i],
+					(char *)chunk->mz->addr + off,
+					chunk->mz->iova + off, seg_len,
+					&chunk->shinfo);
+			rte_pktmbuf_data_len(pkts[i]) = seg_len;
+			rte_pktmbuf_pkt_len(pkts[i]) = seg_len;
+			off += seg_len;
+		}
+
+		stream_enqueue(ctx, pkts, nb);
+		nb_segs -= nb;
+	}
+
+	return 0;
+}
+
+static int stream_file_reader(void *arg)
+{
+	struct stream_ctx *ctx = arg;
+	struct stream_chunk *chunk;
+	uint64_t offset = 0, tsc;
+	size_t rlen;
+	ssize_t ret;
+	unsigned int len;
+
+	while (offset < ctx->size && !ctx->error) {
+		if (rte_ring_dequeue(ctx->free_chunks, (void **)&chunk)) {
+			rte_pause();
+			continue;
+		}
+
+		len = RTE_MIN(ctx->size - offset, (uint64_t)STREAM_CHUNK_SZ);
+		/* O_DIRECT wants the length aligned, EOF ends the read */
+		rlen = RTE_ALIGN_CEIL(len, STREAM_DIO_ALIGN);
+
+		tsc = rte_rdtsc();
+		ret = pread(ctx->fd, chunk->mz->addr, rlen, offset);
+		ctx->io_cycles += rte_rdtsc() - tsc;
+		if (ret < (ssize_t)len) {
+			printf("Error: read of input-file at offset %" PRIu64
+					" failed: %s\n", offset,
+					ret < 0 ? strerror(errno) :
+					"short read");
+			ctx->error = 1;
+			break;
+		}
+
+		if (stream_attach_chunk(ctx, chunk, len))
+			break;
+		offset += len;
+	}
+
+	ctx->done = 1;
+	return 0;
+}
+
+static int stream_writev(struct stream_ctx *ctx, struct iovec *iov,
+		unsigned int nb_iov, size_t len)
+{
+	uint64_t tsc = rte_rdtsc();
+	ssize_t ret;
+
+	ret = writev(ctx->fd, iov, nb_iov);
+	ctx->io_cycles += rte_rdtsc() - tsc;
+	if (ret != (ssize_t)len) {
+		printf("Error: write to output-file failed: %s\n",
+				ret < 0 ? strerror(errno) : "short write");
+		ctx->error = 1;
+		return -1;
+	}
+
+	return 0;
+}
+
+static int stream_file_writer(void *arg)
+{
+	struct stream_ctx *ctx = arg;
+	struct rte_mbuf *pkts[STREAM_BURST_SZ];
+	struct iovec iov[STREAM_BURST_SZ];
+	struct rte_mbuf *seg;
+	uint64_t remain = ctx->size, tsc;
+	unsigned int nb, i, nb_iov;
+	size_t len;
+
+	while (!ctx->error) {
+		nb = rte_ring_dequeue_burst(ctx->ring, (void **)pkts,
+				STREAM_BURST_SZ, NULL);
+		if (!nb) {
+			if (ctx->done && rte_ring_empty(ctx->ring))
+				break;
+			rte_pause();
+			continue;
+		}
+
+		/* Buffers are full sized, drop what is past the file end */
+		nb_iov = 0;
+		len = 0;
+		for (i = 0; i < nb && remain && !ctx->error; i++) {
+			for (seg = pkts[i]; seg && remain; seg = seg->next) {
+				iov[nb_iov].iov_base =
+					rte_pktmbuf_mtod(seg, void *);
+				iov[nb_iov].iov_len = RTE_MIN(
+					(uint64_t)rte_pktmbuf_data_len(seg),
+					remain);
+				remain -= iov[nb_iov].iov_len;
+				len += iov[nb_iov].iov_len;
+				if (++nb_iov == RTE_DIM(iov)) {
+					if (stream_writev(ctx, iov, nb_iov,
+							len))
+						break;
+					nb_iov = 0;
+					len = 0;
+				}
+			}
+		}
+		if (nb_iov && !ctx->error)
+			stream_writev(ctx, iov, nb_iov, len);
+		rte_pktmbuf_free_bulk(pkts, nb);
+	}
+
+	tsc = rte_rdtsc();
+	fsync(ctx->fd);
+	ctx->io_cycles += rte_rdtsc() - tsc;
+
+	return 0;
+}
+
+/* Run fn on the first idle worker lcore, return the lcore or -1 */
+static int stream_launch(lcore_function_t *fn, struct stream_ctx *ctx)
+{
+	unsigned int lcore_id;
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (!rte_eal_remote_launch(fn, ctx, lcore_id))
+			return lcore_id;
+	}
+
+	printf("Error: streaming needs an idle worker lcore\n");
+	return -1;
+}
+
+/* Return 0, -errno if the file could not be opened or -1 on other errors */
+static int stream_ctx_init(struct stream_ctx *ctx, int port_id,
+		int queueid, const char *filename, int flags, uint64_t size)
+{
+	char name[RTE_MEMZONE_NAMESIZE];
+	int err;
+
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->fd = -1;
+
+	if (rte_eth_devices[port_id].device == NULL) {
+		printf("Port id %d already removed. "
+			"Relaunch application to use the port again\n",
+			port_id);
+		return -1;
+	}
+
+	if ((unsigned int)queueid >= pinfo[port_id].num_queues) {
+		printf("Error: queue-id:%d, port %d has %u queues\n",
+				queueid, port_id, pinfo[port_id].num_queues);
+		return -1;
+	}
+
+	ctx->mp = rte_mempool_lookup(pinfo[port_id].mem_pool);
+	if (ctx->mp == NULL) {
+		printf("Could not find mempool with name %s\n",
+				pinfo[port_id].mem_pool);
+		return -1;
+	}
+
+	ctx->fd = open(filename, flags, 0666);
+	if (ctx->fd < 0) {
+		err = errno;
+		printf("Error: Could not open file %s: %s\n", filename,
+				strerror(err));
+		return -err;
+	}
+
+	snprintf(name, sizeof(name), "stream_ring_%d_%d", port_id, queueid);
+	ctx->ring = rte_ring_create(name, STREAM_RING_SZ, rte_socket_id(),
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (ctx->ring == NULL) {
+		printf("Error: Could not create ring %s\n", name);
+		return -1;
+	}
+
+	ctx->port_id = port_id;
+	ctx->queue_id = queueid;
+	ctx->size = size;
+	ctx->seg_size = pinfo[port_id].buff_size;
+
+	return 0;
+}
+
+/* Free the chunks of a port queue and their ring, by name */
+static void stream_chunks_free(int port_id, int queueid,
+		struct rte_ring *free_chunks)
+{
+	char name[RTE_MEMZONE_NAMESIZE];
+	unsigned int i;
+
+	for (i = 0; i < STREAM_NB_CHUNKS; i++) {
+		snprintf(name, sizeof(name), "stream_buf_%d_%d_%u",
+				port_id, queueid, i);
+		rte_memzone_free(rte_memzone_lookup(name));
+	}
+	rte_ring_free(free_chunks);
+}
+
+static int stream_chunks_alloc(struct stream_ctx *ctx, int port_id,
+		int queueid)
+{
+	char name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	struct stream_chunk *chunk;
+	struct rte_ring *r;
+	unsigned int i;
+
+	/* Left over by a stream that ended with chunks held by the PMD */
+	snprintf(name, sizeof(name), "stream_free_%d_%d", port_id, queueid);
+	r = rte_ring_lookup(name);
+	if (r) {
+		if (rte_ring_count(r) < STREAM_NB_CHUNKS) {
+			printf("Error: %u stream buffers of port %d queue %d "
+				"still in use by the device\n",
+				STREAM_NB_CHUNKS - rte_ring_count(r),
+				port_id, queueid);
+			return -1;
+		}
+		stream_chunks_free(port_id, queueid, r);
+	}
+
+	/* Chunks are released from whichever lcore frees the last mbuf */
+	ctx->free_chunks = rte_ring_create(name, STREAM_NB_CHUNKS * 2,
+			rte_socket_id(), RING_F_SC_DEQ);
+	if (ctx->free_chunks == NULL) {
+		printf("Error: Could not create ring %s\n", name);
+		return -1;
+	}
+
+	for (i = 0; i < STREAM_NB_CHUNKS; i++) {
+		snprintf(name, sizeof(name), "stream_buf_%d_%d_%u",
+				port_id, queueid, i);
+		mz = rte_memzone_reserve_aligned(name,
+				STREAM_CHUNK_SZ + sizeof(*chunk),
+				rte_socket_id(), RTE_MEMZONE_IOVA_CONTIG,
+				STREAM_DIO_ALIGN);
+		if (mz == NULL) {
+			printf("Error: Could not allocate stream buffer %s\n",
+					name);
+			stream_chunks_free(port_id, queueid,
+					ctx->free_chunks);
+			ctx->free_chunks = NULL;
+			return -1;
+		}
+		chunk = (struct stream_chunk *)
+				((char *)mz->addr + STREAM_CHUNK_SZ);
+		memset(chunk, 0, sizeof(*chunk));
+		chunk->mz = mz;
+		chunk->free_chunks = ctx->free_chunks;
+		chunk->shinfo.free_cb = stream_chunk_free;
+		chunk->shinfo.fcb_opaque = chunk;
+		rte_ring_enqueue(ctx->free_chunks, chunk);
+	}
+
+	return 0;
+}
+
+/* Have the PMD free the sent mbufs until all the chunks are back */
+static void stream_chunks_reclaim(struct stream_ctx *ctx)
+{
+	uint64_t end = rte_get_timer_cycles() +
+			rte_get_timer_hz() * STREAM_RECLAIM_MS / 1000;
+
+	while (rte_ring_count(ctx->free_chunks) < STREAM_NB_CHUNKS &&
+			rte_get_timer_cycles() < end) {
+		rte_eth_tx_done_cleanup(ctx->port_id, ctx->queue_id, 0);
+		rte_delay_us(1);
+	}
+}
+
+static void stream_ctx_fini(struct stream_ctx *ctx)
+{
+	struct rte_mbuf *pkts[STREAM_BURST_SZ];
+	unsigned int nb;
+
+	/* Left over by an aborted transfer */
+	if (ctx->ring) {
+		while ((nb = rte_ring_dequeue_burst(ctx->ring, (void **)pkts,
+				STREAM_BURST_SZ, NULL)))
+			rte_pktmbuf_free_bulk(pkts, nb);
+		rte_ring_free(ctx->ring);
+	}
+
+	/*
+	 * A chunk may only go once the PMD released its mbufs: otherwise
+	 * keep the chunks and their ring for the PMD to return them to,
+	 * the next stream on the queue frees them.
+	 */
+	if (ctx->free_chunks) {
+		if (rte_ring_count(ctx->free_chunks) == STREAM_NB_CHUNKS)
+			stream_chunks_free(ctx->port_id, ctx->queue_id,
+					ctx->free_chunks);
+		else
+			printf("Warning: %u stream buffers still in use by "
+				"the device, freed by the next stream\n",
+				STREAM_NB_CHUNKS -
+				rte_ring_count(ctx->free_chunks));
+	}
+
+	if (ctx->fd >= 0)
+		close(ctx->fd);
+}
+
+static void stream_report(const char *dir, uint64_t bytes,
+		uint64_t cycles, uint64_t io_cycles)
+{
+	double secs = (double)cycles / rte_get_tsc_hz();
+
+	printf("%s: %" PRIu64 " bytes in %.3lf s, %.4lf Gbps, "
+			"file I/O busy %.1lf%% of the time\n", dir, bytes,
+			secs, secs ? (double)bytes * 8 / secs / 1000000000 : 0,
+			cycles ? (double)io_cycles * 100 / cycles : 0);
+}
+
+int do_stream_to_device(int port_id, int queueid, const char *filename,
+		uint64_t dst_addr, uint64_t size)
+{
+	struct stream_ctx *ctx = &stream;
+	struct rte_mbuf *pkts[STREAM_BURST_SZ];
+	uint64_t start_tsc, bytes = 0;
+	unsigned int nb, nb_tx, i, retry;
+	int user_bar_idx, reg_val, lcore, err, ret = -1;
+	struct stat st;
+
+	/* Not every file system takes O_DIRECT, fall back to buffered */
+	err = stream_ctx_init(ctx, port_id, queueid, filename,
+			O_RDONLY | O_DIRECT, size);
+	if (err == -EINVAL) {
+		stream_ctx_fini(ctx);
+		err = stream_ctx_init(ctx, port_id, queueid, filename,
+				O_RDONLY, size);
+	}
+	if (err)
+		goto out;
+
+	if (fstat(ctx->fd, &st) == 0 && (uint64_t)st.st_size < size) {
+		printf("Error: size %" PRIu64 " is larger than the %" PRIu64
+				" bytes of %s\n", size, (uint64_t)st.st_size,
+				filename);
+		goto out;
+	}
+
+	if (stream_chunks_alloc(ctx, port_id, queueid))
+		goto out;
+
+	rte_spinlock_lock(&pinfo[port_id].port_update_lock);
+
+	if ((unsigned int)queueid >= pinfo[port_id].st_queues &&
+			rte_pmd_qdma_set_mm_endpoint_addr(port_id, queueid,
+				RTE_PMD_QDMA_TX, dst_addr) < 0)
+		goto out_unlock;
+
+	user_bar_idx = pinfo[port_id].user_bar_idx;
+#ifndef TANDEM_BOOT_SUPPORTED
+	PciWrite(user_bar_idx, C2H_ST_QID_REG,
+			(queueid + pinfo[port_id].queue_base), port_id);
+#endif
+
+	lcore = stream_launch(stream_file_reader, ctx);
+	if (lcore < 0)
+		goto out_unlock;
+
+	start_tsc = rte_rdtsc();
+	while (!ctx->error) {
+		nb = rte_ring_dequeue_burst(ctx->ring, (void **)pkts,
+				STREAM_BURST_SZ, NULL);
+		if (!nb) {
+			if (ctx->done && rte_ring_empty(ctx->ring))
+				break;
+			continue;
+		}
+
+		nb_tx = 0;
+		retry = RX_TX_MAX_RETRY;
+		while (nb_tx < nb && retry--) {
+			nb_tx += rte_eth_tx_burst(port_id, queueid,
+					&pkts[nb_tx], nb - nb_tx);
+			if (nb_tx < nb)
+				rte_delay_us(1);
+		}
+		for (i = 0; i < nb_tx; i++)
+			bytes += rte_pktmbuf_pkt_len(pkts[i]);
+		if (nb_tx < nb) {
+			printf("ERROR: rte_eth_tx_burst failed for port %d "
+					"queue %d\n", port_id, queueid);
+			rte_pktmbuf_free_bulk(&pkts[nb_tx], nb - nb_tx);
+			ctx->error = 1;
+		}
+	}
+	rte_eal_wait_lcore(lcore);
+
+	/* Get the last chunks back from the PMD */
+	stream_chunks_reclaim(ctx);
+
+	stream_report("stream_to_device", bytes, rte_rdtsc() - start_tsc,
+			ctx->io_cycles);
+
+#ifndef TANDEM_BOOT_SUPPORTED
+	reg_val = PciRead(user_bar_idx, C2H_CONTROL_REG, port_id);
+	reg_val &= C2H_CONTROL_REG_MASK;
+	if (!(reg_val & ST_LOOPBACK_EN)) {
+		reg_val = PciRead(user_bar_idx, H2C_STATUS_REG, port_id);
+		printf("BAR-%d is the QDMA H2C transfer match: 0x%x,\n",
+			user_bar_idx, reg_val);
+
+		/** TO clear H2C DMA write **/
+		PciWrite(user_bar_idx, H2C_CONTROL_REG, 0x1, port_id);
+	}
+#else
+	RTE_SET_USED(reg_val);
+#endif
+
+	if (!ctx->error)
+		ret = 0;
+
+out_unlock:
+	rte_spinlock_unlock(&pinfo[port_id].port_update_lock);
+out:
+	stream_ctx_fini(ctx);
+	return ret;
+}
+
+int do_stream_from_device(int port_id, int queueid, const char *filename,
+		uint64_t src_addr, uint64_t size)
+{
+	struct stream_ctx *ctx = &stream;
+	struct rte_mbuf *pkts[STREAM_BURST_SZ];
+	uint64_t start_tsc, bytes = 0, nb_bufs;
+	unsigned int nb, nb_rx, i, retry;
+	int user_bar_idx, reg_val = 0, loopback_en = 1, lcore, ret = -1;
+	int is_st = (unsigned int)queueid < pinfo[port_id].st_queues;
+
+	if (stream_ctx_init(ctx, port_id, queueid, filename,
+			O_WRONLY | O_CREAT | O_TRUNC, size))
+		goto out;
+
+	/* Every buffer comes back full, the writer truncates the last one */
+	nb_bufs = (size + ctx->seg_size - 1) / ctx->seg_size;
+	if (is_st && nb_bufs > UINT32_MAX) {
+		printf("Error: size %" PRIu64 " too large for the ST "
+				"packet generator\n", size);
+		goto out;
+	}
+
+	rte_spinlock_lock(&pinfo[port_id].port_update_lock);
+
+	user_bar_idx = pinfo[port_id].user_bar_idx;
+	if (!is_st) {
+		if (rte_pmd_qdma_set_mm_endpoint_addr(port_id, queueid,
+				RTE_PMD_QDMA_RX, src_addr) < 0)
+			goto out_unlock;
+	} else {
+		PciWrite(user_bar_idx, C2H_ST_QID_REG,
+				(queueid + pinfo[port_id].queue_base), port_id);
+		reg_val = PciRead(user_bar_idx, C2H_CONTROL_REG, port_id);
+		reg_val &= C2H_CONTROL_REG_MASK;
+		loopback_en = reg_val & ST_LOOPBACK_EN;
+	}
+
+	lcore = stream_launch(stream_file_writer, ctx);
+	if (lcore < 0)
+		goto out_unlock;
+
+	/* Have the example design generate one packet per buffer */
+	if (!loopback_en) {
+		PciWrite(user_bar_idx, C2H_PACKET_COUNT_REG, nb_bufs, port_id);
+		PciWrite(user_bar_idx, C2H_ST_LEN_REG, ctx->seg_size, port_id);
+		reg_val |= ST_C2H_START_VAL;
+		PciWrite(user_bar_idx, C2H_CONTROL_REG, reg_val, port_id);
+	}
+
+	start_tsc = rte_rdtsc();
+	retry = RX_TX_MAX_RETRY;
+	while (nb_bufs && !ctx->error) {
+		nb = RTE_MIN(nb_bufs, (uint64_t)STREAM_BURST_SZ);
+		nb_rx = rte_eth_rx_burst(port_id, queueid, pkts, nb);
+		if (!nb_rx) {
+			if (!retry--) {
+				printf("ERROR: rte_eth_rx_burst failed for "
+						"port %d queue id %d\n",
+						port_id, queueid);
+				ctx->error = 1;
+				break;
+			}
+			rte_delay_us(1);
+			continue;
+		}
+		retry = RX_TX_MAX_RETRY;
+
+		for (i = 0; i < nb_rx; i++)
+			bytes += rte_pktmbuf_pkt_len(pkts[i]);
+		nb_bufs -= nb_rx;
+		stream_enqueue(ctx, pkts, nb_rx);
+	}
+	ctx->done = 1;
+	rte_eal_wait_lcore(lcore);
+
+	stream_report("stream_from_device", RTE_MIN(bytes, size),
+			rte_rdtsc() - start_tsc, ctx->io_cycles);
+
+	/* Stop the C2H Engine */
+	if (!loopback_en) {
+		reg_val = PciRead(user_bar_idx, C2H_CONTROL_REG, port_id);
+		reg_val &= C2H_CONTROL_REG_MASK;
+		reg_val &= ~(ST_C2H_START_VAL);
+		PciWrite(user_bar_idx, C2H_CONTROL_REG, reg_val, port_id);
+	}
+
+	if (!ctx->error)
+		ret = 0;
+
+out_unlock:
+	rte_spinlock_unlock(&pinfo[port_id].port_update_lock);
+out:
+	stream_ctx_fini(ctx);
+	return ret;
+}
@@ -64,6 +64,10 @@
 #define C2H_STREAM_MARKER_PKT_GEN_VAL     0x22
 #define MARKER_RESPONSE_COMPLETION_BIT    0x1
 
+/* bench directions */
+#define BENCH_DIR_RX		0x1
+#define BENCH_DIR_TX		0x2
+
 extern int num_ports;
 
 struct port_info {
@@ -87,6 +91,13 @@ int do_recv_mm(int port_id, int fd, int queueid,
 		int ld_size, int tot_num_desc);
 int do_xmit(int port_id, int fd, int queueid,
 		int ld_size, int tot_num_desc, int zbyte);
+int do_stream_to_device(int port_id, int queueid, const char *filename,
+		uint64_t dst_addr, uint64_t size);
+int do_stream_from_device(int port_id, int queueid, const char *filename,
+		uint64_t src_addr, uint64_t size);
+int do_bench(int port_id, unsigned int dir, unsigned int nb_queues,
+		unsigned int nb_lcores, unsigned int pkt_size,
+		unsigned int duration);
 void load_file_cmds(struct cmdline *cl);
 void port_close(int port_id);
 int port_reset(int port_id, int num_queues, int st_queues,
@@ -0,0 +1,40 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2018-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is licensed under both the BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree) and the GPLv2 (found
+ * in the COPYING file in the root directory of this source tree).
+ * You may select, at your option, one of the above-listed licenses.
+ */
+
+#ifndef QDMA_SIM_QDMA_PLATFORM_ENV_H_
+#define QDMA_SIM_QDMA_PLATFORM_ENV_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+extern int qdma_sim_log_level;
+
+#define QDMA_SIM_LOG_ERR		1
+#define QDMA_SIM_LOG_INFO		2
+#define QDMA_SIM_LOG_DEBUG		3
+
+#define QDMA_SNPRINTF_S(arg1, arg2, arg3, ...) \
+		snprintf(arg1, arg3, ##__VA_ARGS__)
+
+#define qdma_sim_log(lvl_, x_, ...) \
+	do { \
+		if (qdma_sim_log_level >= (lvl_)) \
+			fprintf(stderr, x_, ##__VA_ARGS__); \
+	} while (0)
+
+#define qdma_log_info(x_, ...) qdma_sim_log(QDMA_SIM_LOG_INFO, x_, ##__VA_ARGS__)
+#define qdma_log_warning(x_, ...) qdma_sim_log(QDMA_SIM_LOG_INFO, x_, ##__VA_ARGS__)
+#define qdma_log_error(x_, ...) qdma_sim_log(QDMA_SIM_LOG_ERR, x_, ##__VA_ARGS__)
+#define qdma_log_debug(x_, ...) qdma_sim_log(QDMA_SIM_LOG_DEBUG, x_, ##__VA_ARGS__)
+
+#endif /* QDMA_SIM_QDMA_PLATFORM_ENV_H_ */
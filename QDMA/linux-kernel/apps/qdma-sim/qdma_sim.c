@@ -0,0 +1,1038 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2018-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is licensed under both the BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree) and the GPLv2 (found
+ * in the COPYING file in the root directory of this source tree).
+ * You may select, at your option, one of the above-listed licenses.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "qdma_sim.h"
+#include "qdma_sim_internal.h"
+#include "qdma_soft_reg.h"
+#include "eqdma_soft_access.h"
+#include "eqdma_soft_reg.h"
+
+/* PF config BAR span covered by the plain register file */
+#define QDMA_SIM_PF_BAR_SIZE		0x24000
+
+/* mailbox register layout, relative to the function's mailbox base */
+#define QDMA_SIM_MBOX_SIZE		0x1000
+#define QDMA_SIM_MBOX_FN_STATUS		0x0
+#define		QDMA_SIM_MBOX_STATUS_IN_MSG	BIT(0)
+#define		QDMA_SIM_MBOX_STATUS_OUT_MSG	BIT(1)
+#define		QDMA_SIM_MBOX_STATUS_ACK	BIT(2)
+#define		QDMA_SIM_MBOX_STATUS_SRC_MASK	GENMASK(15, 4)
+#define QDMA_SIM_MBOX_FN_CMD		0x4
+#define		QDMA_SIM_MBOX_CMD_SND		BIT(0)
+#define		QDMA_SIM_MBOX_CMD_RCV		BIT(1)
+#define QDMA_SIM_MBOX_ISR_VEC		0x8
+#define QDMA_SIM_MBOX_FN_TARGET		0xC
+#define		QDMA_SIM_MBOX_TARGET_ID_MASK	GENMASK(11, 0)
+#define QDMA_SIM_MBOX_ISR_EN		0x10
+#define QDMA_SIM_MBOX_PF_ACK_BASE	0x20
+#define QDMA_SIM_MBOX_PF_ACK_COUNT	8
+#define QDMA_SIM_MBOX_IN_MSG_BASE	0x800
+#define QDMA_SIM_MBOX_OUT_MSG_BASE	0xC00
+#define QDMA_SIM_MBOX_MSG_REGS		32
+
+/* doorbell windows */
+#define QDMA_SIM_VF_MAX_QUEUES		256
+#define QDMA_SIM_DB_REGS_PER_Q		4
+#define QDMA_SIM_DB_INT_CIDX		0
+#define QDMA_SIM_DB_H2C_PIDX		1
+#define QDMA_SIM_DB_C2H_PIDX		2
+#define QDMA_SIM_DB_CMPT_CIDX		3
+
+#define QDMA_SIM_CTXT_SEL_MAX		(QDMA_CTXT_SEL_FMAP + 1)
+
+/* capability values reported by the model */
+#define QDMA_SIM_VIVADO_RELEASE		2	/* 2022.1 */
+#define QDMA_SIM_PFCH_CACHE_DEPTH	64
+#define QDMA_SIM_WRB_COAL_BUF_DEPTH	32
+
+/* local copies of the FMAP context layout, see eqdma_soft_access.c */
+#define QDMA_SIM_FMAP_W0_QID_MASK	GENMASK(10, 0)
+#define QDMA_SIM_FMAP_W1_QID_MAX_MASK	GENMASK(11, 0)
+
+/* descriptor layouts as consumed by the data mover */
+#define QDMA_SIM_MM_DESC_LEN_MASK	GENMASK(27, 0)
+#define QDMA_SIM_H2C_DESC_F_EOP		0x2
+
+struct qdma_sim_mm_desc {
+	uint64_t src_addr;
+	uint32_t flag_len;
+	uint32_t rsvd0;
+	uint64_t dst_addr;
+	uint64_t rsvd1;
+};
+
+struct qdma_sim_h2c_desc {
+	uint16_t cdh_flags;
+	uint16_t pld_len;
+	uint16_t len;
+	uint16_t flags;
+	uint64_t src_addr;
+};
+
+struct qdma_sim_c2h_desc {
+	uint64_t dst_addr;
+};
+
+struct qdma_sim_wb_status {
+	uint16_t pidx;
+	uint16_t cidx;
+	uint32_t color_isr_status;
+};
+
+#define QDMA_SIM_CMPT_F_COLOR_SHIFT	1
+#define QDMA_SIM_CMPT_F_DESC_USED	BIT(3)
+#define QDMA_SIM_CMPT_LEN_SHIFT		4
+#define QDMA_SIM_CMPT_LEN_MASK		0xFFFFU
+
+/**
+ * struct qdma_sim_pkt - ST packet in flight between H2C and C2H
+ */
+struct qdma_sim_pkt {
+	struct qdma_sim_pkt *next;
+	uint32_t len;
+	uint8_t data[];
+};
+
+/**
+ * struct qdma_sim_st_q - per hw queue ST loopback state
+ */
+struct qdma_sim_st_q {
+	struct qdma_sim_pkt *head;
+	struct qdma_sim_pkt *tail;
+	/* packet being assembled from H2C descriptors */
+	uint8_t *asm_buf;
+	uint32_t asm_len;
+	uint32_t asm_cap;
+};
+
+/**
+ * struct qdma_sim_mbox - per function mailbox state
+ *
+ * An outgoing message stays in the sender's OUT_MSG buffer until the
+ * destination acknowledges it with a RCV command, the destination reads
+ * it through its IN_MSG window.
+ */
+struct qdma_sim_mbox {
+	uint32_t out_msg[QDMA_SIM_MBOX_MSG_REGS];
+	uint8_t out_pending;
+	uint16_t out_dst;
+	uint16_t target;
+	uint32_t isr_vec;
+	uint32_t isr_en;
+	uint32_t ack[QDMA_SIM_MBOX_PF_ACK_COUNT];
+};
+
+struct qdma_sim_func {
+	struct qdma_sim_dev *dev;
+	uint16_t func_id;
+	uint8_t is_vf;
+	uint16_t parent_pf;
+	uint16_t max_qs;
+	uint32_t mbox_base;
+	uint32_t db_base;
+	struct qdma_sim_mbox mbox;
+	uint32_t *db;
+	struct qdma_hw_access hw;
+};
+
+struct qdma_sim_dev {
+	struct qdma_sim_config cfg;
+	pthread_mutex_t lock;
+	pthread_mutex_t prg_lock;
+	uint32_t *csr;
+	uint32_t *ctxt;
+	uint32_t num_ctxt;
+	uint64_t ctxt_busy_until;
+	uint8_t *card_mem;
+	struct qdma_sim_st_q *st;
+	struct qdma_sim_func *funcs[QDMA_SIM_MAX_FUNCS];
+	struct qdma_sim_stats stats;
+};
+
+static const struct qdma_sim_config qdma_sim_dflt_cfg = {
+	.num_qs = 512,
+	.num_pfs = 1,
+	.card_mem_size = 1 << 20,
+	.ctxt_cmd_latency_ns = 0,
+	.reg_read_latency_ns = 0,
+};
+
+uint64_t qdma_sim_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+void qdma_sim_spin_ns(uint64_t ns)
+{
+	uint64_t end;
+
+	if (!ns)
+		return;
+
+	end = qdma_sim_now_ns() + ns;
+	while (qdma_sim_now_ns() < end)
+		;
+}
+
+static inline uint32_t *sim_ctxt(struct qdma_sim_dev *dev,
+		uint32_t sel, uint32_t qid)
+{
+	return &dev->ctxt[((sel * dev->num_ctxt) + qid) *
+			QDMA_IND_CTXT_DATA_NUM_REGS];
+}
+
+static inline uint32_t sim_csr(struct qdma_sim_dev *dev, uint32_t off)
+{
+	return dev->csr[off >> 2];
+}
+
+/*
+ * Context programming
+ */
+static void sim_ctxt_cmd(struct qdma_sim_dev *dev, uint32_t val)
+{
+	union qdma_ind_ctxt_cmd cmd;
+	uint32_t *data = &dev->csr[EQDMA_IND_CTXT_DATA_ADDR >> 2];
+	uint32_t *mask = &dev->csr[EQDMA_IND_CTXT_MASK_ADDR >> 2];
+	uint32_t *ctxt;
+	uint64_t now = 0;
+	int i;
+
+	dev->stats.ctxt_cmds++;
+	if (dev->cfg.ctxt_cmd_latency_ns) {
+		now = qdma_sim_now_ns();
+		if (now < dev->ctxt_busy_until)
+			dev->stats.ctxt_cmd_overruns++;
+	}
+
+	cmd.word = val;
+	if ((cmd.bits.sel >= QDMA_SIM_CTXT_SEL_MAX) ||
+			(cmd.bits.qid >= dev->num_ctxt)) {
+		dev->csr[EQDMA_IND_CTXT_CMD_ADDR >> 2] = 0;
+		return;
+	}
+
+	ctxt = sim_ctxt(dev, cmd.bits.sel, cmd.bits.qid);
+	switch (cmd.bits.op) {
+	case QDMA_CTXT_CMD_CLR:
+	case QDMA_CTXT_CMD_INV:
+		memset(ctxt, 0, QDMA_IND_CTXT_DATA_NUM_REGS *
+				sizeof(uint32_t));
+		break;
+	case QDMA_CTXT_CMD_WR:
+		for (i = 0; i < QDMA_IND_CTXT_DATA_NUM_REGS; i++)
+			ctxt[i] = (ctxt[i] & ~mask[i]) | (data[i] & mask[i]);
+		break;
+	case QDMA_CTXT_CMD_RD:
+		memcpy(data, ctxt, QDMA_IND_CTXT_DATA_NUM_REGS *
+				sizeof(uint32_t));
+		break;
+	}
+
+	cmd.bits.busy = 0;
+	if (dev->cfg.ctxt_cmd_latency_ns) {
+		dev->ctxt_busy_until = now + dev->cfg.ctxt_cmd_latency_ns;
+		cmd.bits.busy = 1;
+	}
+	dev->csr[EQDMA_IND_CTXT_CMD_ADDR >> 2] = cmd.word;
+}
+
+static uint32_t sim_ctxt_cmd_read(struct qdma_sim_dev *dev)
+{
+	union qdma_ind_ctxt_cmd cmd;
+
+	cmd.word = dev->csr[EQDMA_IND_CTXT_CMD_ADDR >> 2];
+	if (cmd.bits.busy) {
+		if (qdma_sim_now_ns() >= dev->ctxt_busy_until) {
+			cmd.bits.busy = 0;
+			dev->csr[EQDMA_IND_CTXT_CMD_ADDR >> 2] = cmd.word;
+		} else {
+			dev->stats.ctxt_busy_polls++;
+		}
+	}
+
+	return cmd.word;
+}
+
+/*
+ * Data mover
+ */
+static inline uint32_t sim_ring_size(struct qdma_sim_dev *dev, uint32_t idx)
+{
+	return sim_csr(dev, EQDMA_GLBL_RNG_SZ_1_ADDR + (idx << 2));
+}
+
+static inline void *sim_host_ptr(uint64_t addr)
+{
+	return (void *)(uintptr_t)addr;
+}
+
+static int sim_card_range_ok(struct qdma_sim_dev *dev, uint64_t addr,
+		uint32_t len)
+{
+	return (addr <= dev->cfg.card_mem_size) &&
+		(len <= (dev->cfg.card_mem_size - addr));
+}
+
+static void sim_write_status(uint64_t ring, uint32_t rng_sz,
+		uint32_t desc_bytes, uint16_t pidx, uint16_t cidx,
+		uint32_t color)
+{
+	struct qdma_sim_wb_status *wb = sim_host_ptr(ring +
+			((uint64_t)(rng_sz - 1) * desc_bytes));
+
+	wb->pidx = pidx;
+	wb->cidx = cidx;
+	wb->color_isr_status = color;
+}
+
+static void sim_st_push(struct qdma_sim_st_q *st)
+{
+	struct qdma_sim_pkt *pkt;
+
+	pkt = malloc(sizeof(*pkt) + st->asm_len);
+	if (!pkt)
+		return;
+
+	pkt->next = NULL;
+	pkt->len = st->asm_len;
+	memcpy(pkt->data, st->asm_buf, st->asm_len);
+	if (st->tail)
+		st->tail->next = pkt;
+	else
+		st->head = pkt;
+	st->tail = pkt;
+	st->asm_len = 0;
+}
+
+static int sim_st_append(struct qdma_sim_st_q *st, const void *src,
+		uint32_t len)
+{
+	if (st->asm_len + len > st->asm_cap) {
+		uint32_t cap = st->asm_cap ? st->asm_cap : 4096;
+		uint8_t *buf;
+
+		while (cap < st->asm_len + len)
+			cap <<= 1;
+		buf = realloc(st->asm_buf, cap);
+		if (!buf)
+			return -1;
+		st->asm_buf = buf;
+		st->asm_cap = cap;
+	}
+	memcpy(st->asm_buf + st->asm_len, src, len);
+	st->asm_len += len;
+
+	return 0;
+}
+
+static void sim_st_c2h_process(struct qdma_sim_dev *dev, uint32_t hw_qid)
+{
+	struct qdma_sim_st_q *st = &dev->st[hw_qid];
+	uint32_t *sw = sim_ctxt(dev, QDMA_CTXT_SEL_SW_C2H, hw_qid);
+	uint32_t *hw = sim_ctxt(dev, QDMA_CTXT_SEL_HW_C2H, hw_qid);
+	uint32_t *pf = sim_ctxt(dev, QDMA_CTXT_SEL_PFTCH, hw_qid);
+	uint32_t *cmpt = sim_ctxt(dev, QDMA_CTXT_SEL_CMPT, hw_qid);
+	uint32_t rng_sz, crng_sz, bufsz, cdesc_bytes, avail;
+	uint64_t ring, cring;
+	uint16_t pidx, cidx, cpidx, ccidx;
+	uint32_t color;
+
+	if (!st->head)
+		return;
+	if (!FIELD_GET(SW_IND_CTXT_DATA_W1_QEN_MASK, sw[1]) ||
+			FIELD_GET(SW_IND_CTXT_DATA_W1_IS_MM_MASK, sw[1]) ||
+			!FIELD_GET(CMPL_CTXT_DATA_W3_VALID_MASK, cmpt[3]))
+		return;
+
+	rng_sz = sim_ring_size(dev,
+			FIELD_GET(SW_IND_CTXT_DATA_W1_RNG_SZ_MASK, sw[1]));
+	crng_sz = sim_ring_size(dev,
+			FIELD_GET(CMPL_CTXT_DATA_W0_QSIZE_IX_MASK, cmpt[0]));
+	bufsz = sim_csr(dev, EQDMA_C2H_BUF_SZ_ADDR +
+		(FIELD_GET(PREFETCH_CTXT_DATA_W0_BUF_SZ_IDX_MASK, pf[0]) << 2));
+	if ((rng_sz < 2) || (crng_sz < 2) || !bufsz) {
+		dev->stats.dma_errors++;
+		return;
+	}
+
+	ring = ((uint64_t)sw[3] << 32) | sw[2];
+	cring = ((uint64_t)FIELD_GET(CMPL_CTXT_DATA_W2_BADDR4_HIGH_H_MASK,
+				cmpt[2]) << 38) |
+		((uint64_t)cmpt[1] << 6) |
+		((uint64_t)FIELD_GET(CMPL_CTXT_DATA_W5_BADDR4_LOW_MASK,
+				cmpt[5]) << 2);
+	cdesc_bytes = 8 << FIELD_GET(CMPL_CTXT_DATA_W2_DESC_SIZE_MASK, cmpt[2]);
+
+	pidx = FIELD_GET(SW_IND_CTXT_DATA_W0_PIDX_MASK, sw[0]);
+	cidx = FIELD_GET(HW_IND_CTXT_DATA_W0_CIDX_MASK, hw[0]);
+	cpidx = FIELD_GET(CMPL_CTXT_DATA_W2_PIDX_L_MASK, cmpt[2]) |
+		(FIELD_GET(CMPL_CTXT_DATA_W3_PIDX_H_MASK, cmpt[3]) << 4);
+	ccidx = FIELD_GET(CMPL_CTXT_DATA_W3_CIDX_MASK, cmpt[3]);
+	color = FIELD_GET(CMPL_CTXT_DATA_W0_COLOR_MASK, cmpt[0]);
+	avail = (pidx + (rng_sz - 1) - cidx) % (rng_sz - 1);
+
+	while (st->head) {
+		struct qdma_sim_pkt *pkt = st->head;
+		uint32_t need = pkt->len ? (pkt->len + bufsz - 1) / bufsz : 1;
+		uint32_t off = 0, i;
+		uint32_t *entry;
+
+		if (need > avail)
+			break;
+		if (((cpidx + 1) % (crng_sz - 1)) == ccidx)
+			break;
+
+		for (i = 0; i < need; i++) {
+			struct qdma_sim_c2h_desc *desc = sim_host_ptr(ring +
+					((uint64_t)cidx * sizeof(*desc)));
+			uint32_t len = pkt->len - off;
+
+			if (len > bufsz)
+				len = bufsz;
+			memcpy(sim_host_ptr(desc->dst_addr), pkt->data + off,
+					len);
+			off += len;
+			cidx = (cidx + 1) % (rng_sz - 1);
+		}
+		avail -= need;
+		dev->stats.c2h_descs += need;
+		dev->stats.c2h_bytes += pkt->len;
+
+		entry = sim_host_ptr(cring + ((uint64_t)cpidx * cdesc_bytes));
+		memset(entry, 0, cdesc_bytes);
+		entry[0] = (color << QDMA_SIM_CMPT_F_COLOR_SHIFT) |
+			QDMA_SIM_CMPT_F_DESC_USED |
+			((pkt->len & QDMA_SIM_CMPT_LEN_MASK) <<
+			 QDMA_SIM_CMPT_LEN_SHIFT);
+		dev->stats.cmpt_entries++;
+
+		cpidx = (cpidx + 1) % (crng_sz - 1);
+		if (!cpidx)
+			color ^= 1;
+
+		st->head = pkt->next;
+		if (!st->head)
+			st->tail = NULL;
+		free(pkt);
+	}
+
+	hw[0] = (hw[0] & ~HW_IND_CTXT_DATA_W0_CIDX_MASK) |
+		FIELD_SET(HW_IND_CTXT_DATA_W0_CIDX_MASK, cidx);
+	cmpt[0] = (cmpt[0] & ~CMPL_CTXT_DATA_W0_COLOR_MASK) |
+		FIELD_SET(CMPL_CTXT_DATA_W0_COLOR_MASK, color);
+	cmpt[2] = (cmpt[2] & ~CMPL_CTXT_DATA_W2_PIDX_L_MASK) |
+		FIELD_SET(CMPL_CTXT_DATA_W2_PIDX_L_MASK, (cpidx & 0xF));
+	cmpt[3] = (cmpt[3] & ~CMPL_CTXT_DATA_W3_PIDX_H_MASK) |
+		FIELD_SET(CMPL_CTXT_DATA_W3_PIDX_H_MASK, (cpidx >> 4));
+
+	if (FIELD_GET(SW_IND_CTXT_DATA_W1_WBK_EN_MASK, sw[1]))
+		sim_write_status(ring, rng_sz, sizeof(struct qdma_sim_c2h_desc),
+				pidx, cidx, 0);
+	if (FIELD_GET(CMPL_CTXT_DATA_W0_EN_STAT_DESC_MASK, cmpt[0]))
+		sim_write_status(cring, crng_sz, cdesc_bytes, cpidx, ccidx,
+				color);
+}
+
+static void sim_queue_process(struct qdma_sim_dev *dev, uint32_t hw_qid,
+		uint8_t c2h)
+{
+	uint32_t *sw = sim_ctxt(dev, c2h ? QDMA_CTXT_SEL_SW_C2H :
+			QDMA_CTXT_SEL_SW_H2C, hw_qid);
+	uint32_t *hw = sim_ctxt(dev, c2h ? QDMA_CTXT_SEL_HW_C2H :
+			QDMA_CTXT_SEL_HW_H2C, hw_qid);
+	uint32_t rng_sz, desc_bytes;
+	uint16_t pidx, cidx;
+	uint64_t ring;
+	uint8_t is_mm;
+
+	if (!FIELD_GET(SW_IND_CTXT_DATA_W1_QEN_MASK, sw[1])) {
+		dev->stats.dma_errors++;
+		return;
+	}
+
+	is_mm = FIELD_GET(SW_IND_CTXT_DATA_W1_IS_MM_MASK, sw[1]);
+	if (c2h && !is_mm) {
+		/* ST C2H: new buffers posted, try to drain pending packets */
+		sim_st_c2h_process(dev, hw_qid);
+		return;
+	}
+
+	rng_sz = sim_ring_size(dev,
+			FIELD_GET(SW_IND_CTXT_DATA_W1_RNG_SZ_MASK, sw[1]));
+	if (rng_sz < 2) {
+		dev->stats.dma_errors++;
+		return;
+	}
+	desc_bytes = 8 << FIELD_GET(SW_IND_CTXT_DATA_W1_DSC_SZ_MASK, sw[1]);
+	ring = ((uint64_t)sw[3] << 32) | sw[2];
+	pidx = FIELD_GET(SW_IND_CTXT_DATA_W0_PIDX_MASK, sw[0]);
+	cidx = FIELD_GET(HW_IND_CTXT_DATA_W0_CIDX_MASK, hw[0]);
+
+	while (cidx != pidx) {
+		void *d = sim_host_ptr(ring + ((uint64_t)cidx * desc_bytes));
+
+		if (is_mm) {
+			struct qdma_sim_mm_desc *desc = d;
+			uint32_t len = FIELD_GET(QDMA_SIM_MM_DESC_LEN_MASK,
+					desc->flag_len);
+			uint64_t card = c2h ? desc->src_addr : desc->dst_addr;
+
+			if (!sim_card_range_ok(dev, card, len)) {
+				dev->stats.dma_errors++;
+			} else if (c2h) {
+				memcpy(sim_host_ptr(desc->dst_addr),
+						dev->card_mem + card, len);
+				dev->stats.c2h_descs++;
+				dev->stats.c2h_bytes += len;
+			} else {
+				memcpy(dev->card_mem + card,
+						sim_host_ptr(desc->src_addr), len);
+				dev->stats.h2c_descs++;
+				dev->stats.h2c_bytes += len;
+			}
+		} else {
+			struct qdma_sim_h2c_desc *desc = d;
+			struct qdma_sim_st_q *st = &dev->st[hw_qid];
+
+			if (sim_st_append(st, sim_host_ptr(desc->src_addr),
+					desc->len) < 0)
+				dev->stats.dma_errors++;
+			else if (desc->flags & QDMA_SIM_H2C_DESC_F_EOP)
+				sim_st_push(st);
+			dev->stats.h2c_descs++;
+			dev->stats.h2c_bytes += desc->len;
+		}
+		cidx = (cidx + 1) % (rng_sz - 1);
+	}
+
+	hw[0] = (hw[0] & ~HW_IND_CTXT_DATA_W0_CIDX_MASK) |
+		FIELD_SET(HW_IND_CTXT_DATA_W0_CIDX_MASK, cidx);
+	if (FIELD_GET(SW_IND_CTXT_DATA_W1_WBK_EN_MASK, sw[1]))
+		sim_write_status(ring, rng_sz, desc_bytes, pidx, cidx, 0);
+
+	if (!c2h && !is_mm)
+		sim_st_c2h_process(dev, hw_qid);
+}
+
+static void sim_doorbell_write(struct qdma_sim_func *func, uint32_t off,
+		uint32_t val)
+{
+	struct qdma_sim_dev *dev = func->dev;
+	uint32_t idx = (off - func->db_base) >> 2;
+	uint32_t qid = idx / QDMA_SIM_DB_REGS_PER_Q;
+	uint32_t *fmap = sim_ctxt(dev, QDMA_CTXT_SEL_FMAP, func->func_id);
+	uint32_t qbase = FIELD_GET(QDMA_SIM_FMAP_W0_QID_MASK, fmap[0]);
+	uint32_t qmax = FIELD_GET(QDMA_SIM_FMAP_W1_QID_MAX_MASK, fmap[1]);
+	uint32_t hw_qid = qbase + qid;
+	uint32_t *ctxt;
+
+	func->db[idx] = val;
+
+	if ((qid >= qmax) || (hw_qid >= dev->cfg.num_qs)) {
+		dev->stats.dma_errors++;
+		return;
+	}
+
+	switch (idx % QDMA_SIM_DB_REGS_PER_Q) {
+	case QDMA_SIM_DB_H2C_PIDX:
+	case QDMA_SIM_DB_C2H_PIDX:
+	{
+		uint8_t c2h = ((idx % QDMA_SIM_DB_REGS_PER_Q) ==
+				QDMA_SIM_DB_C2H_PIDX);
+
+		ctxt = sim_ctxt(dev, c2h ? QDMA_CTXT_SEL_SW_C2H :
+				QDMA_CTXT_SEL_SW_H2C, hw_qid);
+		ctxt[0] = (ctxt[0] & ~SW_IND_CTXT_DATA_W0_PIDX_MASK) |
+			FIELD_SET(SW_IND_CTXT_DATA_W0_PIDX_MASK,
+				FIELD_GET(QDMA_DMA_SEL_DESC_PIDX_MASK, val));
+		sim_queue_process(dev, hw_qid, c2h);
+	}
+	break;
+	case QDMA_SIM_DB_CMPT_CIDX:
+		ctxt = sim_ctxt(dev, QDMA_CTXT_SEL_CMPT, hw_qid);
+		ctxt[3] = (ctxt[3] & ~CMPL_CTXT_DATA_W3_CIDX_MASK) |
+			FIELD_SET(CMPL_CTXT_DATA_W3_CIDX_MASK,
+				FIELD_GET(QDMA_DMAP_SEL_CMPT_WRB_CIDX_MASK,
+					val));
+		sim_st_c2h_process(dev, hw_qid);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Mailbox
+ */
+static struct qdma_sim_func *sim_mbox_peer(struct qdma_sim_func *func)
+{
+	struct qdma_sim_dev *dev = func->dev;
+	uint16_t id = func->is_vf ? func->parent_pf : func->mbox.target;
+
+	if (id >= QDMA_SIM_MAX_FUNCS)
+		return NULL;
+
+	return dev->funcs[id];
+}
+
+/* function whose outgoing message is waiting for @func, if any */
+static struct qdma_sim_func *sim_mbox_in_src(struct qdma_sim_func *func)
+{
+	struct qdma_sim_dev *dev = func->dev;
+	int i;
+
+	for (i = 0; i < QDMA_SIM_MAX_FUNCS; i++) {
+		struct qdma_sim_func *src = dev->funcs[i];
+
+		if (src && src->mbox.out_pending &&
+				(src->mbox.out_dst == func->func_id))
+			return src;
+	}
+
+	return NULL;
+}
+
+static uint32_t sim_mbox_status(struct qdma_sim_func *func)
+{
+	struct qdma_sim_func *src = sim_mbox_in_src(func);
+	uint32_t val = 0;
+	int i;
+
+	if (src) {
+		val |= QDMA_SIM_MBOX_STATUS_IN_MSG;
+		if (!func->is_vf)
+			val |= FIELD_SET(QDMA_SIM_MBOX_STATUS_SRC_MASK,
+					(uint32_t)src->func_id);
+	}
+	if (func->mbox.out_pending)
+		val |= QDMA_SIM_MBOX_STATUS_OUT_MSG;
+	for (i = 0; i < QDMA_SIM_MBOX_PF_ACK_COUNT; i++) {
+		if (func->mbox.ack[i]) {
+			val |= QDMA_SIM_MBOX_STATUS_ACK;
+			break;
+		}
+	}
+
+	return val;
+}
+
+static void sim_mbox_cmd(struct qdma_sim_func *func, uint32_t val)
+{
+	struct qdma_sim_dev *dev = func->dev;
+	struct qdma_sim_func *peer = sim_mbox_peer(func);
+
+	if (val & QDMA_SIM_MBOX_CMD_SND) {
+		if (!func->mbox.out_pending) {
+			func->mbox.out_pending = 1;
+			func->mbox.out_dst = func->is_vf ? func->parent_pf :
+					func->mbox.target;
+			dev->stats.mbox_msgs++;
+		}
+	}
+
+	if ((val & QDMA_SIM_MBOX_CMD_RCV) && peer &&
+			peer->mbox.out_pending &&
+			(peer->mbox.out_dst == func->func_id)) {
+		peer->mbox.out_pending = 0;
+		/* PF sees the ack of the VF in its ack bitmap */
+		if (!peer->is_vf)
+			peer->mbox.ack[func->func_id / 32] |=
+					(1U << (func->func_id % 32));
+	}
+}
+
+static uint32_t sim_mbox_read(struct qdma_sim_func *func, uint32_t off)
+{
+	struct qdma_sim_func *peer;
+
+	if (off >= QDMA_SIM_MBOX_OUT_MSG_BASE)
+		return func->mbox.out_msg[((off - QDMA_SIM_MBOX_OUT_MSG_BASE)
+				>> 2) % QDMA_SIM_MBOX_MSG_REGS];
+
+	if (off >= QDMA_SIM_MBOX_IN_MSG_BASE) {
+		peer = sim_mbox_peer(func);
+		if (!peer || !peer->mbox.out_pending ||
+				(peer->mbox.out_dst != func->func_id))
+			return 0;
+		return peer->mbox.out_msg[((off - QDMA_SIM_MBOX_IN_MSG_BASE)
+				>> 2) % QDMA_SIM_MBOX_MSG_REGS];
+	}
+
+	if ((off >= QDMA_SIM_MBOX_PF_ACK_BASE) && (off <
+			QDMA_SIM_MBOX_PF_ACK_BASE +
+			(QDMA_SIM_MBOX_PF_ACK_COUNT << 2)))
+		return func->mbox.ack[(off - QDMA_SIM_MBOX_PF_ACK_BASE) >> 2];
+
+	switch (off) {
+	case QDMA_SIM_MBOX_FN_STATUS:
+		return sim_mbox_status(func);
+	case QDMA_SIM_MBOX_ISR_VEC:
+		return func->mbox.isr_vec;
+	case QDMA_SIM_MBOX_FN_TARGET:
+		return func->mbox.target;
+	case QDMA_SIM_MBOX_ISR_EN:
+		return func->mbox.isr_en;
+	default:
+		return 0;
+	}
+}
+
+static void sim_mbox_write(struct qdma_sim_func *func, uint32_t off,
+		uint32_t val)
+{
+	if (off >= QDMA_SIM_MBOX_OUT_MSG_BASE) {
+		func->mbox.out_msg[((off - QDMA_SIM_MBOX_OUT_MSG_BASE) >> 2) %
+			QDMA_SIM_MBOX_MSG_REGS] = val;
+		return;
+	}
+
+	if ((off >= QDMA_SIM_MBOX_PF_ACK_BASE) && (off <
+			QDMA_SIM_MBOX_PF_ACK_BASE +
+			(QDMA_SIM_MBOX_PF_ACK_COUNT << 2))) {
+		/* write 1 to clear */
+		func->mbox.ack[(off - QDMA_SIM_MBOX_PF_ACK_BASE) >> 2] &= ~val;
+		return;
+	}
+
+	switch (off) {
+	case QDMA_SIM_MBOX_FN_CMD:
+		sim_mbox_cmd(func, val);
+		break;
+	case QDMA_SIM_MBOX_ISR_VEC:
+		func->mbox.isr_vec = val;
+		break;
+	case QDMA_SIM_MBOX_FN_TARGET:
+		func->mbox.target = FIELD_GET(QDMA_SIM_MBOX_TARGET_ID_MASK, val);
+		break;
+	case QDMA_SIM_MBOX_ISR_EN:
+		func->mbox.isr_en = val;
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Register decode
+ */
+static inline int sim_in_window(uint32_t off, uint32_t base, uint32_t size)
+{
+	return (off >= base) && (off < base + size);
+}
+
+static uint32_t sim_func_reg_read(struct qdma_sim_func *func, uint32_t off)
+{
+	struct qdma_sim_dev *dev = func->dev;
+
+	if (sim_in_window(off, func->mbox_base, QDMA_SIM_MBOX_SIZE) &&
+			(off != EQDMA_OFFSET_VF_VERSION))
+		return sim_mbox_read(func, off - func->mbox_base);
+
+	if (sim_in_window(off, func->db_base,
+			func->max_qs * QDMA_SIM_DB_REGS_PER_Q * 4))
+		return func->db[(off - func->db_base) >> 2];
+
+	if (func->is_vf) {
+		/* EQDMA VFs report the version at 0x5014 only */
+		if (off == EQDMA_OFFSET_VF_VERSION)
+			return FIELD_SET(QDMA_GLBL2_VF_UNIQUE_ID_MASK,
+					QDMA_MAGIC_NUMBER) |
+				FIELD_SET(QDMA_GLBL2_VF_VIVADO_RELEASE_MASK,
+					QDMA_SIM_VIVADO_RELEASE) |
+				FIELD_SET(QDMA_GLBL2_VF_VERSAL_IP_MASK,
+					EQDMA_IP_VERSION_5);
+		return 0;
+	}
+
+	if (off == QDMA_OFFSET_GLBL2_CHANNEL_FUNC_RET)
+		return func->func_id;
+	if (off == EQDMA_IND_CTXT_CMD_ADDR)
+		return sim_ctxt_cmd_read(dev);
+	if (off < QDMA_SIM_PF_BAR_SIZE)
+		return sim_csr(dev, off);
+
+	return 0;
+}
+
+static int sim_reg_read_only(uint32_t off)
+{
+	switch (off) {
+	case QDMA_OFFSET_CONFIG_BLOCK_ID:
+	case QDMA_OFFSET_GLBL2_PF_BARLITE_INT:
+	case EQDMA_GLBL2_CHANNEL_MDMA_ADDR:
+	case EQDMA_GLBL2_CHANNEL_CAP_ADDR:
+	case QDMA_OFFSET_GLBL2_CHANNEL_FUNC_RET:
+	case EQDMA_GLBL2_MISC_CAP_ADDR:
+	case EQDMA_C2H_PFCH_CACHE_DEPTH_ADDR:
+	case EQDMA_C2H_WRB_COAL_BUF_DEPTH_ADDR:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static void sim_func_reg_write(struct qdma_sim_func *func, uint32_t off,
+		uint32_t val)
+{
+	struct qdma_sim_dev *dev = func->dev;
+
+	if (sim_in_window(off, func->mbox_base, QDMA_SIM_MBOX_SIZE)) {
+		sim_mbox_write(func, off - func->mbox_base, val);
+		return;
+	}
+
+	if (sim_in_window(off, func->db_base,
+			func->max_qs * QDMA_SIM_DB_REGS_PER_Q * 4)) {
+		sim_doorbell_write(func, off, val);
+		return;
+	}
+
+	if (func->is_vf || (off >= QDMA_SIM_PF_BAR_SIZE) ||
+			sim_reg_read_only(off))
+		return;
+
+	if (off == EQDMA_IND_CTXT_CMD_ADDR) {
+		sim_ctxt_cmd(dev, val);
+		return;
+	}
+
+	dev->csr[off >> 2] = val;
+}
+
+uint32_t qdma_sim_reg_read(struct qdma_sim_func *func, uint32_t off)
+{
+	struct qdma_sim_dev *dev = func->dev;
+	uint32_t val;
+
+	qdma_sim_spin_ns(dev->cfg.reg_read_latency_ns);
+
+	pthread_mutex_lock(&dev->lock);
+	dev->stats.reg_reads++;
+	val = sim_func_reg_read(func, off & ~0x3U);
+	pthread_mutex_unlock(&dev->lock);
+
+	return val;
+}
+
+void qdma_sim_reg_write(struct qdma_sim_func *func, uint32_t off,
+		uint32_t val)
+{
+	struct qdma_sim_dev *dev = func->dev;
+
+	pthread_mutex_lock(&dev->lock);
+	dev->stats.reg_writes++;
+	sim_func_reg_write(func, off & ~0x3U, val);
+	pthread_mutex_unlock(&dev->lock);
+}
+
+/*
+ * Device and function life cycle
+ */
+static void sim_csr_init(struct qdma_sim_dev *dev)
+{
+	uint32_t barlite = 0;
+	int i;
+
+	for (i = 0; i < dev->cfg.num_pfs; i++)
+		barlite |= BIT(2) << (i * 6);	/* user logic on BAR2 */
+
+	dev->csr[QDMA_OFFSET_CONFIG_BLOCK_ID >> 2] =
+		FIELD_SET(QDMA_CONFIG_BLOCK_ID_MASK, QDMA_MAGIC_NUMBER);
+	dev->csr[QDMA_OFFSET_GLBL2_PF_BARLITE_INT >> 2] = barlite;
+	dev->csr[EQDMA_GLBL2_CHANNEL_MDMA_ADDR >> 2] =
+		GLBL2_CHANNEL_MDMA_C2H_ST_MASK |
+		GLBL2_CHANNEL_MDMA_H2C_ST_MASK |
+		FIELD_SET(GLBL2_CHANNEL_MDMA_C2H_ENG_MASK, 1) |
+		FIELD_SET(GLBL2_CHANNEL_MDMA_H2C_ENG_MASK, 1);
+	dev->csr[EQDMA_GLBL2_CHANNEL_CAP_ADDR >> 2] =
+		FIELD_SET(GLBL2_CHANNEL_CAP_MULTIQ_MAX_MASK,
+				(uint32_t)dev->cfg.num_qs);
+	dev->csr[EQDMA_GLBL2_MISC_CAP_ADDR >> 2] =
+		FIELD_SET(QDMA_GLBL2_VIVADO_RELEASE_MASK,
+				QDMA_SIM_VIVADO_RELEASE) |
+		FIELD_SET(QDMA_GLBL2_VERSAL_IP_MASK, EQDMA_IP_VERSION_5) |
+		QDMA_GLBL2_FLR_PRESENT_MASK | QDMA_GLBL2_MAILBOX_EN_MASK;
+	dev->csr[EQDMA_C2H_PFCH_CACHE_DEPTH_ADDR >> 2] =
+		QDMA_SIM_PFCH_CACHE_DEPTH;
+	dev->csr[EQDMA_C2H_WRB_COAL_BUF_DEPTH_ADDR >> 2] =
+		QDMA_SIM_WRB_COAL_BUF_DEPTH;
+}
+
+struct qdma_sim_dev *qdma_sim_dev_create(const struct qdma_sim_config *cfg)
+{
+	struct qdma_sim_dev *dev;
+
+	if (!cfg)
+		cfg = &qdma_sim_dflt_cfg;
+	if (!cfg->num_qs || (cfg->num_qs > QDMA_SIM_MAX_QUEUES) ||
+			!cfg->num_pfs || (cfg->num_pfs > QDMA_SIM_MAX_PFS))
+		return NULL;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev)
+		return NULL;
+
+	dev->cfg = *cfg;
+	dev->num_ctxt = (cfg->num_qs > QDMA_SIM_MAX_FUNCS) ?
+			cfg->num_qs : QDMA_SIM_MAX_FUNCS;
+	pthread_mutex_init(&dev->lock, NULL);
+	pthread_mutex_init(&dev->prg_lock, NULL);
+
+	dev->csr = calloc(QDMA_SIM_PF_BAR_SIZE >> 2, sizeof(uint32_t));
+	dev->ctxt = calloc((size_t)QDMA_SIM_CTXT_SEL_MAX * dev->num_ctxt *
+			QDMA_IND_CTXT_DATA_NUM_REGS, sizeof(uint32_t));
+	dev->st = calloc(cfg->num_qs, sizeof(struct qdma_sim_st_q));
+	dev->card_mem = calloc(1, cfg->card_mem_size ?
+			cfg->card_mem_size : 1);
+	if (!dev->csr || !dev->ctxt || !dev->st || !dev->card_mem) {
+		qdma_sim_dev_destroy(dev);
+		return NULL;
+	}
+
+	sim_csr_init(dev);
+
+	return dev;
+}
+
+void qdma_sim_dev_destroy(struct qdma_sim_dev *dev)
+{
+	uint32_t i;
+
+	if (!dev)
+		return;
+
+	for (i = 0; i < QDMA_SIM_MAX_FUNCS; i++)
+		qdma_sim_func_destroy(dev->funcs[i]);
+
+	if (dev->st) {
+		for (i = 0; i < dev->cfg.num_qs; i++) {
+			struct qdma_sim_pkt *pkt = dev->st[i].head;
+
+			while (pkt) {
+				struct qdma_sim_pkt *next = pkt->next;
+
+				free(pkt);
+				pkt = next;
+			}
+			free(dev->st[i].asm_buf);
+		}
+	}
+
+	pthread_mutex_destroy(&dev->prg_lock);
+	pthread_mutex_destroy(&dev->lock);
+	free(dev->card_mem);
+	free(dev->st);
+	free(dev->ctxt);
+	free(dev->csr);
+	free(dev);
+}
+
+struct qdma_sim_func *qdma_sim_func_create(struct qdma_sim_dev *dev,
+		uint16_t func_id, uint8_t is_vf, uint16_t parent_pf)
+{
+	struct qdma_sim_func *func;
+
+	if (!dev || (func_id >= QDMA_SIM_MAX_FUNCS) || dev->funcs[func_id])
+		return NULL;
+	if ((!is_vf && (func_id >= dev->cfg.num_pfs)) ||
+			(is_vf && (parent_pf >= dev->cfg.num_pfs)))
+		return NULL;
+
+	func = calloc(1, sizeof(*func));
+	if (!func)
+		return NULL;
+
+	func->dev = dev;
+	func->func_id = func_id;
+	func->is_vf = is_vf;
+	func->parent_pf = is_vf ? parent_pf : func_id;
+	if (is_vf) {
+		func->max_qs = QDMA_SIM_VF_MAX_QUEUES;
+		func->mbox_base = EQDMA_OFFSET_MBOX_BASE_VF;
+		func->db_base = QDMA_OFFSET_VF_DMAP_SEL_INT_CIDX;
+	} else {
+		func->max_qs = QDMA_SIM_MAX_QUEUES;
+		func->mbox_base = EQDMA_OFFSET_MBOX_BASE_PF;
+		func->db_base = QDMA_OFFSET_DMAP_SEL_INT_CIDX;
+	}
+
+	func->db = calloc((size_t)func->max_qs * QDMA_SIM_DB_REGS_PER_Q,
+			sizeof(uint32_t));
+	if (!func->db) {
+		free(func);
+		return NULL;
+	}
+
+	pthread_mutex_lock(&dev->lock);
+	dev->funcs[func_id] = func;
+	pthread_mutex_unlock(&dev->lock);
+
+	return func;
+}
+
+void qdma_sim_func_destroy(struct qdma_sim_func *func)
+{
+	struct qdma_sim_dev *dev;
+
+	if (!func)
+		return;
+
+	dev = func->dev;
+	pthread_mutex_lock(&dev->lock);
+	dev->funcs[func->func_id] = NULL;
+	pthread_mutex_unlock(&dev->lock);
+
+	free(func->db);
+	free(func);
+}
+
+struct qdma_hw_access *qdma_sim_func_hw_access(struct qdma_sim_func *func)
+{
+	return &func->hw;
+}
+
+uint8_t *qdma_sim_card_mem(struct qdma_sim_dev *dev, uint32_t *size)
+{
+	if (size)
+		*size = dev->cfg.card_mem_size;
+
+	return dev->card_mem;
+}
+
+void qdma_sim_stats_get(struct qdma_sim_dev *dev,
+		struct qdma_sim_stats *stats)
+{
+	pthread_mutex_lock(&dev->lock);
+	*stats = dev->stats;
+	pthread_mutex_unlock(&dev->lock);
+}
+
+void qdma_sim_stats_reset(struct qdma_sim_dev *dev)
+{
+	pthread_mutex_lock(&dev->lock);
+	memset(&dev->stats, 0, sizeof(dev->stats));
+	pthread_mutex_unlock(&dev->lock);
+}
+
+pthread_mutex_t *qdma_sim_prg_lock(struct qdma_sim_func *func)
+{
+	return &func->dev->prg_lock;
+}
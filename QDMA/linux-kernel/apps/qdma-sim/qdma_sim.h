@@ -0,0 +1,224 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2018-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is licensed under both the BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree) and the GPLv2 (found
+ * in the COPYING file in the root directory of this source tree).
+ * You may select, at your option, one of the above-listed licenses.
+ */
+
+#ifndef __QDMA_SIM_H__
+#define __QDMA_SIM_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "qdma_access_common.h"
+
+/**
+ * DOC: QDMA software device model
+ *
+ * qdma-sim models the register interface of an EQDMA soft IP
+ * (QDMA 4.0/5.0) well enough to run the unmodified qdma_access layer
+ * in userspace. It implements the platform hooks declared in
+ * qdma_platform.h, so libqdma code is linked against the model instead
+ * of a PCIe BAR.
+ *
+ * Modelled blocks:
+ *	- global CSRs (plain register file with the capability registers
+ *	  preset for the configured number of queues and PFs)
+ *	- indirect context programming (CLR/WR/RD/INV for all context
+ *	  selectors including FMAP, with an optional busy latency)
+ *	- PF and VF mailboxes
+ *	- H2C/C2H PIDX and CMPT CIDX doorbells
+ *	- a data mover executing MM descriptors against on-card memory and
+ *	  looping ST H2C packets back to the ST C2H queue of the same qid,
+ *	  writing completion entries and status descriptors
+ *
+ * Descriptors and rings are addressed with host virtual addresses, i.e.
+ * the ring base and buffer addresses programmed by the caller are plain
+ * pointers cast to uint64_t.
+ */
+
+/** QDMA_SIM_MAX_QUEUES: maximum number of queues a device can model */
+#define QDMA_SIM_MAX_QUEUES		2048
+/** QDMA_SIM_MAX_FUNCS: maximum number of PCIe functions per device */
+#define QDMA_SIM_MAX_FUNCS		256
+/** QDMA_SIM_MAX_PFS: maximum number of physical functions per device */
+#define QDMA_SIM_MAX_PFS		4
+
+/**
+ * struct qdma_sim_config - device model configuration
+ */
+struct qdma_sim_config {
+	/** @num_qs: number of queues reported in GLBL2_CHANNEL_CAP */
+	uint16_t num_qs;
+	/** @num_pfs: number of PFs reported in GLBL2_PF_BARLITE_INT */
+	uint8_t num_pfs;
+	/** @card_mem_size: size of the on-card memory for MM transfers */
+	uint32_t card_mem_size;
+	/** @ctxt_cmd_latency_ns: time the indirect context command
+	 * register stays busy after a command is issued
+	 */
+	uint32_t ctxt_cmd_latency_ns;
+	/** @reg_read_latency_ns: time spent in every register read,
+	 * models the PCIe non-posted read round trip
+	 */
+	uint32_t reg_read_latency_ns;
+};
+
+/**
+ * struct qdma_sim_stats - device model counters
+ */
+struct qdma_sim_stats {
+	/** @reg_reads: number of register reads */
+	uint64_t reg_reads;
+	/** @reg_writes: number of register writes */
+	uint64_t reg_writes;
+	/** @ctxt_cmds: number of indirect context commands */
+	uint64_t ctxt_cmds;
+	/** @ctxt_busy_polls: context command reads that returned busy */
+	uint64_t ctxt_busy_polls;
+	/** @ctxt_cmd_overruns: commands issued while the previous one was
+	 * still busy
+	 */
+	uint64_t ctxt_cmd_overruns;
+	/** @mbox_msgs: number of mailbox messages sent */
+	uint64_t mbox_msgs;
+	/** @h2c_descs: number of H2C descriptors processed */
+	uint64_t h2c_descs;
+	/** @c2h_descs: number of C2H descriptors processed */
+	uint64_t c2h_descs;
+	/** @cmpt_entries: number of completion entries written */
+	uint64_t cmpt_entries;
+	/** @h2c_bytes: bytes moved in the H2C direction */
+	uint64_t h2c_bytes;
+	/** @c2h_bytes: bytes moved in the C2H direction */
+	uint64_t c2h_bytes;
+	/** @dma_errors: descriptors dropped due to invalid queue state or
+	 * out of range card addresses
+	 */
+	uint64_t dma_errors;
+};
+
+/**
+ * struct qdma_sim_dev - opaque device model handle
+ */
+struct qdma_sim_dev;
+
+/**
+ * struct qdma_sim_func - PCIe function of a device model
+ *
+ * A pointer to this structure is the dev_hndl passed to the qdma_access
+ * APIs.
+ */
+struct qdma_sim_func;
+
+/*****************************************************************************/
+/**
+ * qdma_sim_dev_create() - create a device model
+ *
+ * @cfg:	device configuration, NULL selects the defaults
+ *
+ * Return:	device handle or NULL on failure
+ *****************************************************************************/
+struct qdma_sim_dev *qdma_sim_dev_create(const struct qdma_sim_config *cfg);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_dev_destroy() - free a device model and all its functions
+ *
+ * @dev:	device handle
+ *****************************************************************************/
+void qdma_sim_dev_destroy(struct qdma_sim_dev *dev);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_func_create() - attach a PF or VF to the device model
+ *
+ * @dev:	device handle
+ * @func_id:	PCIe function id, PFs must be below num_pfs
+ * @is_vf:	whether the function is a VF
+ * @parent_pf:	PF owning the VF, ignored for PFs
+ *
+ * Return:	function handle or NULL on failure
+ *****************************************************************************/
+struct qdma_sim_func *qdma_sim_func_create(struct qdma_sim_dev *dev,
+		uint16_t func_id, uint8_t is_vf, uint16_t parent_pf);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_func_destroy() - detach a function from the device model
+ *
+ * @func:	function handle
+ *****************************************************************************/
+void qdma_sim_func_destroy(struct qdma_sim_func *func);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_func_hw_access() - hw access table storage of a function
+ *
+ * The table is returned by qdma_get_hw_access() and is meant to be
+ * filled with qdma_hw_access_init().
+ *
+ * @func:	function handle
+ *
+ * Return:	pointer to the function's struct qdma_hw_access
+ *****************************************************************************/
+struct qdma_hw_access *qdma_sim_func_hw_access(struct qdma_sim_func *func);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_reg_read() - read a register in a function's config BAR
+ *
+ * @func:	function handle
+ * @off:	register offset
+ *
+ * Return:	register value
+ *****************************************************************************/
+uint32_t qdma_sim_reg_read(struct qdma_sim_func *func, uint32_t off);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_reg_write() - write a register in a function's config BAR
+ *
+ * @func:	function handle
+ * @off:	register offset
+ * @val:	value to write
+ *****************************************************************************/
+void qdma_sim_reg_write(struct qdma_sim_func *func, uint32_t off,
+		uint32_t val);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_card_mem() - on-card memory used by MM queues
+ *
+ * @dev:	device handle
+ * @size:	returns the memory size, may be NULL
+ *
+ * Return:	pointer to the card memory
+ *****************************************************************************/
+uint8_t *qdma_sim_card_mem(struct qdma_sim_dev *dev, uint32_t *size);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_stats_get() - snapshot the device model counters
+ *
+ * @dev:	device handle
+ * @stats:	counters destination
+ *****************************************************************************/
+void qdma_sim_stats_get(struct qdma_sim_dev *dev,
+		struct qdma_sim_stats *stats);
+
+/*****************************************************************************/
+/**
+ * qdma_sim_stats_reset() - clear the device model counters
+ *
+ * @dev:	device handle
+ *****************************************************************************/
+void qdma_sim_stats_reset(struct qdma_sim_dev *dev);
+
+#endif /* __QDMA_SIM_H__ */
@@ -0,0 +1,30 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2018-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is licensed under both the BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree) and the GPLv2 (found
+ * in the COPYING file in the root directory of this source tree).
+ * You may select, at your option, one of the above-listed licenses.
+ */
+
+#ifndef __QDMA_SIM_INTERNAL_H__
+#define __QDMA_SIM_INTERNAL_H__
+
+#include <stdint.h>
+#include <pthread.h>
+
+struct qdma_sim_func;
+
+/* monotonic time in nanoseconds */
+uint64_t qdma_sim_now_ns(void);
+
+/* busy wait for @ns nanoseconds, models udelay() */
+void qdma_sim_spin_ns(uint64_t ns);
+
+/* lock serializing indirect register programming sequences */
+pthread_mutex_t *qdma_sim_prg_lock(struct qdma_sim_func *func);
+
+#endif /* __QDMA_SIM_INTERNAL_H__ */
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2018-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is licensed under both the BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree) and the GPLv2 (found
+ * in the COPYING file in the root directory of this source tree).
+ * You may select, at your option, one of the above-listed licenses.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "qdma_platform.h"
+#include "qdma_access_errors.h"
+#include "qdma_sim.h"
+#include "qdma_sim_internal.h"
+
+/* qdma_access platform hooks backed by the software device model */
+
+int qdma_sim_log_level = QDMA_SIM_LOG_ERR;
+
+static struct err_code_map error_code_map_list[] = {
+	{QDMA_SUCCESS,				0},
+	{QDMA_ERR_INV_PARAM,			EINVAL},
+	{QDMA_ERR_NO_MEM,			ENOMEM},
+	{QDMA_ERR_HWACC_BUSY_TIMEOUT,		EBUSY},
+	{QDMA_ERR_HWACC_INV_CONFIG_BAR,		EINVAL},
+	{QDMA_ERR_HWACC_NO_PEND_LEGCY_INTR,	EINVAL},
+	{QDMA_ERR_HWACC_BAR_NOT_FOUND,		EINVAL},
+	{QDMA_ERR_HWACC_FEATURE_NOT_SUPPORTED,	EINVAL},
+	{QDMA_ERR_RM_RES_EXISTS,		EPERM},
+	{QDMA_ERR_RM_RES_NOT_EXISTS,		EINVAL},
+	{QDMA_ERR_RM_DEV_EXISTS,		EPERM},
+	{QDMA_ERR_RM_DEV_NOT_EXISTS,		EINVAL},
+	{QDMA_ERR_RM_NO_QUEUES_LEFT,		EPERM},
+	{QDMA_ERR_RM_QMAX_CONF_REJECTED,	EPERM},
+	{QDMA_ERR_MBOX_FMAP_WR_FAILED,		EIO},
+	{QDMA_ERR_MBOX_NUM_QUEUES,		EINVAL},
+	{QDMA_ERR_MBOX_INV_QID,			EINVAL},
+	{QDMA_ERR_MBOX_INV_RINGSZ,		EINVAL},
+	{QDMA_ERR_MBOX_INV_BUFSZ,		EINVAL},
+	{QDMA_ERR_MBOX_INV_CNTR_TH,		EINVAL},
+	{QDMA_ERR_MBOX_INV_TMR_TH,		EINVAL},
+	{QDMA_ERR_MBOX_INV_MSG,			EINVAL},
+	{QDMA_ERR_MBOX_SEND_BUSY,		EBUSY},
+	{QDMA_ERR_MBOX_NO_MSG_IN,		EINVAL},
+	{QDMA_ERR_MBOX_REG_READ_FAILED,		EIO},
+	{QDMA_ERR_MBOX_ALL_ZERO_MSG,		EINVAL},
+};
+
+static pthread_mutex_t res_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void *qdma_calloc(uint32_t num_blocks, uint32_t size)
+{
+	return calloc(num_blocks, size);
+}
+
+void qdma_memfree(void *memptr)
+{
+	free(memptr);
+}
+
+int qdma_resource_lock_init(void)
+{
+	return 0;
+}
+
+void qdma_resource_lock_take(void)
+{
+	pthread_mutex_lock(&res_mutex);
+}
+
+void qdma_resource_lock_give(void)
+{
+	pthread_mutex_unlock(&res_mutex);
+}
+
+void qdma_reg_write(void *dev_hndl, uint32_t reg_offst, uint32_t val)
+{
+	qdma_sim_reg_write((struct qdma_sim_func *)dev_hndl, reg_offst, val);
+}
+
+uint32_t qdma_reg_read(void *dev_hndl, uint32_t reg_offst)
+{
+	return qdma_sim_reg_read((struct qdma_sim_func *)dev_hndl, reg_offst);
+}
+
+int qdma_reg_access_lock(void *dev_hndl)
+{
+	pthread_mutex_lock(qdma_sim_prg_lock((struct qdma_sim_func *)dev_hndl));
+
+	return 0;
+}
+
+int qdma_reg_access_release(void *dev_hndl)
+{
+	pthread_mutex_unlock(
+		qdma_sim_prg_lock((struct qdma_sim_func *)dev_hndl));
+
+	return 0;
+}
+
+void qdma_udelay(uint32_t delay_usec)
+{
+	qdma_sim_spin_ns((uint64_t)delay_usec * 1000);
+}
+
+uint64_t qdma_get_thread_id(void)
+{
+	return (uint64_t)pthread_self();
+}
+
+void qdma_get_hw_access(void *dev_hndl, struct qdma_hw_access **hw)
+{
+	*hw = qdma_sim_func_hw_access((struct qdma_sim_func *)dev_hndl);
+}
+
+void qdma_strncpy(char *dest, const char *src, size_t n)
+{
+	strncpy(dest, src, n);
+}
+
+int qdma_get_err_code(int acc_err_code)
+{
+	acc_err_code *= -1;
+	return -(error_code_map_list[acc_err_code].err_code);
+}
@@ -0,0 +1,1204 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2018-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is licensed under both the BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree) and the GPLv2 (found
+ * in the COPYING file in the root directory of this source tree).
+ * You may select, at your option, one of the above-listed licenses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+
+#include "qdma_sim.h"
+#include "qdma_sim_internal.h"
+#include "qdma_access_common.h"
+#include "qdma_access_fixed_ip.h"
+#include "qdma_mbox_protocol.h"
+#include "qdma_resource_mgmt.h"
+#include "version.h"
+
+#define SIM_TEST_PF_QMAX		64
+#define SIM_TEST_VF_QMAX		8
+#define SIM_TEST_VF_FUNC_ID		4
+
+/* ring size index 1 -> 65 entries (64 descriptors + status) */
+#define SIM_TEST_RNG_SZ_IDX		1
+#define SIM_TEST_RNG_SZ			65
+#define SIM_TEST_RNG_WRAP		(SIM_TEST_RNG_SZ - 1)
+/* C2H buffer size index 0 -> 4096 bytes */
+#define SIM_TEST_BUF_SZ_IDX		0
+#define SIM_TEST_BUF_SZ			4096
+
+#define SIM_TEST_MM_QID			0
+#define SIM_TEST_ST_QID			1
+
+#define SIM_TEST_RM_QUEUES		4096
+#define SIM_TEST_RM_FUNCS		256
+#define SIM_TEST_RM_QMAX		28
+#define SIM_TEST_RM_OPS			100000
+
+#define SIM_TEST_MM_XFERS		200
+#define SIM_TEST_ST_PKTS		300
+
+#define DESC_SZ_8B			0
+#define DESC_SZ_16B			1
+#define DESC_SZ_32B			2
+
+struct sim_mm_desc {
+	uint64_t src_addr;
+	uint32_t flag_len;
+	uint32_t rsvd0;
+	uint64_t dst_addr;
+	uint64_t rsvd1;
+};
+
+struct sim_h2c_desc {
+	uint16_t cdh_flags;
+	uint16_t pld_len;
+	uint16_t len;
+	uint16_t flags;
+	uint64_t src_addr;
+};
+
+struct sim_c2h_desc {
+	uint64_t dst_addr;
+};
+
+struct sim_wb_status {
+	uint16_t pidx;
+	uint16_t cidx;
+	uint32_t color_isr_status;
+};
+
+#define MM_DESC_F_DV			(1U << 28)
+#define MM_DESC_F_SOP			(1U << 29)
+#define MM_DESC_F_EOP			(1U << 30)
+#define H2C_DESC_F_SOP			0x1
+#define H2C_DESC_F_EOP			0x2
+#define CMPT_F_COLOR			(1U << 1)
+#define CMPT_F_DESC_USED		(1U << 3)
+#define CMPT_LEN(x)			(((x) >> 4) & 0xFFFF)
+
+static int verbose;
+static int failures;
+
+#define sim_test_fail(fmt, ...) \
+	do { \
+		fprintf(stderr, "%s:%d: " fmt "\n", __func__, __LINE__, \
+				##__VA_ARGS__); \
+		failures++; \
+	} while (0)
+
+static void sim_test_result(const char *name, int start_failures)
+{
+	printf("%-40s %s\n", name,
+		(failures == start_failures) ? "PASS" : "FAIL");
+}
+
+static void *sim_ring_alloc(uint32_t entries, uint32_t desc_bytes)
+{
+	void *ring = NULL;
+	size_t len = (size_t)entries * desc_bytes;
+
+	len = (len + 4095) & ~(size_t)4095;
+	if (posix_memalign(&ring, 4096, len))
+		return NULL;
+	memset(ring, 0, len);
+
+	return ring;
+}
+
+/*
+ * queue doorbells, written directly in single IP variant builds like the
+ * drivers do
+ */
+static int sim_pidx_update(void *pf, uint16_t qid, uint8_t c2h,
+		const struct qdma_q_pidx_reg_info *pidx_info)
+{
+#ifdef QDMA_FIXED_IP
+	uint32_t val;
+	uint32_t reg = qdma_fixed_ip_pidx_reg(0, qid, c2h, pidx_info, &val);
+
+	qdma_reg_write(pf, reg, val);
+	return 0;
+#else
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+
+	return hw->qdma_queue_pidx_update(pf, 0, qid, c2h, pidx_info);
+#endif
+}
+
+static int sim_cmpt_cidx_update(void *pf, uint16_t qid,
+		const struct qdma_q_cmpt_cidx_reg_info *cidx_info)
+{
+#ifdef QDMA_FIXED_IP
+	uint32_t val;
+	uint32_t reg = qdma_fixed_ip_cmpt_cidx_reg(0, qid, cidx_info, &val);
+
+	qdma_reg_write(pf, reg, val);
+	return 0;
+#else
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+
+	return hw->qdma_queue_cmpt_cidx_update(pf, 0, qid, cidx_info);
+#endif
+}
+
+static int sim_fmap_set(void *pf, uint16_t func_id, uint16_t qbase,
+		uint16_t qmax)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_fmap_cfg fmap;
+
+	fmap.qbase = qbase;
+	fmap.qmax = qmax;
+	return hw->qdma_fmap_conf(pf, func_id, &fmap, QDMA_HW_ACCESS_WRITE);
+}
+
+static int sim_queue_clear(void *pf, uint16_t hw_qid, uint8_t c2h)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	int rv;
+
+	rv = hw->qdma_sw_ctx_conf(pf, c2h, hw_qid, NULL,
+			QDMA_HW_ACCESS_CLEAR);
+	if (rv < 0)
+		return rv;
+	rv = hw->qdma_hw_ctx_conf(pf, c2h, hw_qid, NULL,
+			QDMA_HW_ACCESS_CLEAR);
+	if (rv < 0)
+		return rv;
+
+	return hw->qdma_credit_ctx_conf(pf, c2h, hw_qid, NULL,
+			QDMA_HW_ACCESS_CLEAR);
+}
+
+static int sim_sw_ctxt_write(void *pf, uint16_t hw_qid, uint8_t c2h,
+		void *ring, uint8_t desc_sz, uint8_t is_mm)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_descq_sw_ctxt sw;
+
+	memset(&sw, 0, sizeof(sw));
+	sw.ring_bs_addr = (uint64_t)(uintptr_t)ring;
+	sw.qen = 1;
+	sw.wbk_en = 1;
+	sw.wbi_chk = 1;
+	sw.fetch_max = 4;
+	sw.rngsz_idx = SIM_TEST_RNG_SZ_IDX;
+	sw.desc_sz = desc_sz;
+	sw.is_mm = is_mm;
+	sw.frcd_en = c2h && !is_mm;
+
+	return hw->qdma_sw_ctx_conf(pf, c2h, hw_qid, &sw,
+			QDMA_HW_ACCESS_WRITE);
+}
+
+/*
+ * device bring up through the qdma_access layer
+ */
+static int sim_test_hw_init(void *pf, uint16_t num_qs)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_hw_version_info version;
+	struct qdma_dev_attributes attr;
+	uint64_t t;
+	int start = failures;
+	int rv;
+
+	rv = qdma_hw_access_init(pf, 0, hw);
+	if (rv < 0) {
+		sim_test_fail("qdma_hw_access_init failed %d", rv);
+		goto out;
+	}
+
+	hw->qdma_get_version(pf, 0, &version);
+	if ((version.ip_type != EQDMA_SOFT_IP) ||
+			(version.device_type != QDMA_DEVICE_SOFT))
+		sim_test_fail("unexpected version ip %d device %d",
+				version.ip_type, version.device_type);
+
+	hw->qdma_get_device_attributes(pf, &attr);
+	if ((attr.num_qs != num_qs) || !attr.st_en || !attr.mm_en ||
+			!attr.mailbox_en || (attr.num_pfs != 1))
+		sim_test_fail("unexpected attributes qs %u st %u mm %u",
+				attr.num_qs, attr.st_en, attr.mm_en);
+
+	rv = hw->qdma_set_default_global_csr(pf);
+	if (rv < 0)
+		sim_test_fail("set_default_global_csr failed %d", rv);
+
+	t = qdma_sim_now_ns();
+	rv = hw->qdma_init_ctxt_memory(pf);
+	t = qdma_sim_now_ns() - t;
+	if (rv < 0)
+		sim_test_fail("init_ctxt_memory failed %d", rv);
+	if (verbose)
+		printf("init_ctxt_memory: %u queues in %llu us\n", num_qs,
+				(unsigned long long)(t / 1000));
+
+out:
+	sim_test_result("hw access init", start);
+	return (failures == start) ? 0 : -1;
+}
+
+static void sim_test_ctxt(void *pf)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_descq_sw_ctxt wr, rd;
+	struct qdma_fmap_cfg fmap;
+	int start = failures;
+
+	if (sim_fmap_set(pf, 0, 0, SIM_TEST_PF_QMAX) < 0)
+		sim_test_fail("fmap write failed");
+	memset(&fmap, 0, sizeof(fmap));
+	hw->qdma_fmap_conf(pf, 0, &fmap, QDMA_HW_ACCESS_READ);
+	if ((fmap.qbase != 0) || (fmap.qmax != SIM_TEST_PF_QMAX))
+		sim_test_fail("fmap readback %u/%u", fmap.qbase, fmap.qmax);
+
+	memset(&wr, 0, sizeof(wr));
+	wr.ring_bs_addr = 0x123456789ab000ULL;
+	wr.pidx = 0x55;
+	wr.qen = 1;
+	wr.wbk_en = 1;
+	wr.rngsz_idx = 7;
+	wr.desc_sz = DESC_SZ_32B;
+	wr.is_mm = 1;
+	wr.fnc_id = 0;
+	wr.vec = 3;
+	if (hw->qdma_sw_ctx_conf(pf, 1, 5, &wr, QDMA_HW_ACCESS_WRITE) < 0)
+		sim_test_fail("sw ctxt write failed");
+
+	memset(&rd, 0, sizeof(rd));
+	if (hw->qdma_sw_ctx_conf(pf, 1, 5, &rd, QDMA_HW_ACCESS_READ) < 0)
+		sim_test_fail("sw ctxt read failed");
+	if ((rd.ring_bs_addr != wr.ring_bs_addr) || (rd.pidx != wr.pidx) ||
+			(rd.qen != 1) || (rd.rngsz_idx != wr.rngsz_idx) ||
+			(rd.desc_sz != wr.desc_sz) || (rd.is_mm != 1) ||
+			(rd.vec != wr.vec))
+		sim_test_fail("sw ctxt readback mismatch");
+
+	if (hw->qdma_sw_ctx_conf(pf, 1, 5, NULL, QDMA_HW_ACCESS_CLEAR) < 0)
+		sim_test_fail("sw ctxt clear failed");
+	hw->qdma_sw_ctx_conf(pf, 1, 5, &rd, QDMA_HW_ACCESS_READ);
+	if (rd.qen || rd.ring_bs_addr)
+		sim_test_fail("sw ctxt not cleared");
+
+	sim_test_result("context program/readback", start);
+}
+
+/*
+ * a context batch only defers the commands of the thread that opened it
+ */
+struct sim_batch_peer {
+	void *pf;
+	int start_rv;
+	int write_rv;
+	int end_rv;
+	uint32_t cmd_reg;
+	uint16_t active;
+};
+
+static void *sim_batch_peer_fn(void *arg)
+{
+	struct sim_batch_peer *peer = arg;
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(peer->pf);
+
+	peer->start_rv = hw->qdma_ctxt_batch_start(peer->pf);
+	peer->write_rv = sim_sw_ctxt_write(peer->pf, 7, 0, NULL,
+			DESC_SZ_16B, 1);
+	peer->cmd_reg = hw->ctxt_batch.cmd_reg;
+	peer->active = hw->ctxt_batch.active;
+	peer->end_rv = hw->qdma_ctxt_batch_end(peer->pf);
+
+	return NULL;
+}
+
+static void sim_test_ctxt_batch(void *pf)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct sim_batch_peer peer;
+	pthread_t th;
+	int start = failures;
+
+	if (hw->qdma_ctxt_batch_start(pf) < 0)
+		sim_test_fail("batch start failed");
+	if (sim_queue_clear(pf, 6, 0) < 0)
+		sim_test_fail("batched queue clear failed");
+	if (!hw->ctxt_batch.cmd_reg)
+		sim_test_fail("owner command not left in flight");
+
+	memset(&peer, 0, sizeof(peer));
+	peer.pf = pf;
+	if (pthread_create(&th, NULL, sim_batch_peer_fn, &peer)) {
+		sim_test_fail("pthread_create failed");
+		hw->qdma_ctxt_batch_end(pf);
+		goto out;
+	}
+	pthread_join(th, NULL);
+
+	if (peer.start_rv || peer.write_rv || peer.end_rv)
+		sim_test_fail("peer batch %d, write %d, end %d",
+				peer.start_rv, peer.write_rv, peer.end_rv);
+	if (peer.cmd_reg)
+		sim_test_fail("peer command deferred by another batch");
+	if (peer.active != 1)
+		sim_test_fail("peer batch nested into the owner's, active %u",
+				peer.active);
+
+	if (hw->qdma_ctxt_batch_end(pf) < 0)
+		sim_test_fail("batch end failed");
+	if (hw->ctxt_batch.active || hw->ctxt_batch.owner ||
+			hw->ctxt_batch.cmd_reg)
+		sim_test_fail("batch not closed");
+
+out:
+	sim_test_result("context batch ownership", start);
+}
+
+/*
+ * VF bring up over the mailbox, PF side handled by libqdma
+ */
+static int sim_mbox_xchg(void *pf, void *vf, uint32_t dma_dev_idx,
+		uint32_t *send, uint32_t *resp)
+{
+	uint32_t rcv[MBOX_MSG_REG_MAX];
+	uint32_t pf_resp[MBOX_MSG_REG_MAX];
+	int rv;
+
+	rv = qdma_mbox_send(vf, 1, send);
+	if (rv < 0)
+		return rv;
+
+	rv = qdma_mbox_rcv(pf, 0, rcv);
+	if (rv < 0)
+		return rv;
+
+	memset(pf_resp, 0, sizeof(pf_resp));
+	qdma_mbox_pf_rcv_msg_handler(pf, dma_dev_idx, 0, rcv, pf_resp);
+
+	rv = qdma_mbox_send(pf, 0, pf_resp);
+	if (rv < 0)
+		return rv;
+
+	rv = qdma_mbox_rcv(vf, 1, resp);
+	if (rv < 0)
+		return rv;
+
+	if (!qdma_mbox_is_msg_response(send, resp))
+		return -QDMA_ERR_MBOX_INV_MSG;
+
+	return qdma_mbox_vf_response_status(resp);
+}
+
+static void sim_test_mbox(struct qdma_sim_dev *dev, void *pf,
+		uint16_t num_qs)
+{
+	struct qdma_hw_access *pf_hw = qdma_sim_func_hw_access(pf);
+	uint32_t send[MBOX_MSG_REG_MAX], resp[MBOX_MSG_REG_MAX];
+	struct qdma_sim_func *vf;
+	struct qdma_fmap_cfg fmap;
+	uint32_t dma_dev_idx = 0;
+	uint16_t qmax = 0;
+	int qbase = -1;
+	int start = failures;
+	int rv;
+
+	rv = qdma_master_resource_create(0, 0, 0, num_qs, &dma_dev_idx);
+	if (rv < 0) {
+		sim_test_fail("master resource create failed %d", rv);
+		goto out;
+	}
+	rv = qdma_dev_entry_create(dma_dev_idx, 0);
+	if (rv == 0)
+		rv = qdma_dev_update(dma_dev_idx, 0, SIM_TEST_PF_QMAX, &qbase);
+	if ((rv < 0) || (qbase != 0)) {
+		sim_test_fail("PF queue allocation failed %d qbase %d",
+				rv, qbase);
+		goto out_res;
+	}
+
+	vf = qdma_sim_func_create(dev, SIM_TEST_VF_FUNC_ID, 1, 0);
+	if (!vf) {
+		sim_test_fail("VF create failed");
+		goto out_res;
+	}
+	rv = qdma_hw_access_init(vf, 1, qdma_sim_func_hw_access(vf));
+	if (rv < 0) {
+		sim_test_fail("VF hw access init failed %d", rv);
+		goto out_vf;
+	}
+	qdma_mbox_hw_init(pf, 0);
+	qdma_mbox_hw_init(vf, 1);
+
+	qbase = -1;
+	qmda_mbox_compose_vf_online(SIM_TEST_VF_FUNC_ID, 0, &qbase, send);
+	rv = sim_mbox_xchg(pf, vf, dma_dev_idx, send, resp);
+	if (rv < 0)
+		sim_test_fail("VF hello failed %d", rv);
+
+	qbase = -1;
+	qdma_mbox_compose_vf_qreq(SIM_TEST_VF_FUNC_ID, SIM_TEST_VF_QMAX,
+			qbase, send);
+	rv = sim_mbox_xchg(pf, vf, dma_dev_idx, send, resp);
+	if (rv < 0)
+		sim_test_fail("VF qreq failed %d", rv);
+	qdma_mbox_vf_qinfo_get(resp, &qbase, &qmax);
+	if ((qbase != SIM_TEST_PF_QMAX) || (qmax != SIM_TEST_VF_QMAX))
+		sim_test_fail("VF qinfo %d/%u", qbase, qmax);
+
+	qdma_mbox_compose_vf_fmap_prog(SIM_TEST_VF_FUNC_ID, qmax, qbase,
+			send);
+	rv = sim_mbox_xchg(pf, vf, dma_dev_idx, send, resp);
+	if (rv < 0)
+		sim_test_fail("VF fmap failed %d", rv);
+
+	memset(&fmap, 0, sizeof(fmap));
+	pf_hw->qdma_fmap_conf(pf, SIM_TEST_VF_FUNC_ID, &fmap,
+			QDMA_HW_ACCESS_READ);
+	if ((fmap.qbase != qbase) || (fmap.qmax != qmax))
+		sim_test_fail("VF fmap %u/%u", fmap.qbase, fmap.qmax);
+
+	if (qdma_mbox_out_status(pf, 0) || qdma_mbox_out_status(vf, 1))
+		sim_test_fail("mailbox still busy");
+
+out_vf:
+	qdma_sim_func_destroy(vf);
+out_res:
+	qdma_dev_entry_destroy(dma_dev_idx, SIM_TEST_VF_FUNC_ID);
+	qdma_dev_entry_destroy(dma_dev_idx, 0);
+	qdma_master_resource_destroy(dma_dev_idx);
+out:
+	sim_test_result("VF mailbox bring up", start);
+}
+
+/*
+ * queue resource manager: VF sized allocations on a large device, random
+ * qmax churn checked against a queue ownership map, requested qbase and
+ * coalescing of the free ranges once all functions are gone
+ */
+static int sim_rm_claim(int16_t *owner, uint16_t func_id, int qbase,
+		uint32_t qmax)
+{
+	uint32_t i;
+
+	if (!qmax)
+		return 0;
+	if ((qbase < 0) || ((qbase + qmax) > SIM_TEST_RM_QUEUES))
+		return -1;
+	for (i = qbase; i < qbase + qmax; i++) {
+		if (owner[i] >= 0)
+			return -1;
+		owner[i] = func_id;
+	}
+
+	return 0;
+}
+
+static void sim_rm_release(int16_t *owner, int qbase, uint32_t qmax)
+{
+	uint32_t i;
+
+	for (i = 0; i < qmax; i++)
+		owner[qbase + i] = -1;
+}
+
+static void sim_test_resource_mgmt(void)
+{
+	int16_t owner[SIM_TEST_RM_QUEUES];
+	uint32_t dma_dev_idx = 0;
+	int funcs = 0;
+	uint32_t seed = 1, qmax, new_qmax, allocs = 0;
+	int start = failures;
+	uint16_t func_id;
+	uint64_t t = 0;
+	int qbase;
+	int rv, i;
+
+	memset(owner, 0xFF, sizeof(owner));
+	rv = qdma_master_resource_create(1, 1, 0, SIM_TEST_RM_QUEUES,
+			&dma_dev_idx);
+	if (rv < 0) {
+		sim_test_fail("master resource create failed %d", rv);
+		goto out;
+	}
+
+	for (i = 0; i < SIM_TEST_RM_FUNCS; i++) {
+		qbase = -1;
+		rv = qdma_dev_entry_create(dma_dev_idx, i);
+		if (rv == 0) {
+			funcs++;
+			rv = qdma_dev_update(dma_dev_idx, i,
+					SIM_TEST_RM_QUEUES / SIM_TEST_RM_FUNCS,
+					&qbase);
+		}
+		if ((rv < 0) || sim_rm_claim(owner, i, qbase,
+				SIM_TEST_RM_QUEUES / SIM_TEST_RM_FUNCS)) {
+			sim_test_fail("func %d allocation %d qbase %d", i, rv,
+					qbase);
+			goto out_res;
+		}
+	}
+
+	/* rejected requests are expected here, keep them out of the log */
+	if (!verbose)
+		qdma_sim_log_level = 0;
+	t = qdma_sim_now_ns();
+	for (i = 0; i < SIM_TEST_RM_OPS; i++) {
+		seed = seed * 1103515245 + 12345;
+		func_id = (seed >> 8) % SIM_TEST_RM_FUNCS;
+		new_qmax = (seed >> 20) % (SIM_TEST_RM_QMAX + 1);
+
+		qdma_dev_qinfo_get(dma_dev_idx, func_id, &qbase, &qmax);
+		if (qmax)
+			sim_rm_release(owner, qbase, qmax);
+		qbase = -1;
+		rv = qdma_dev_update(dma_dev_idx, func_id, new_qmax, &qbase);
+		qdma_dev_qinfo_get(dma_dev_idx, func_id, &qbase, &qmax);
+		if (rv == 0) {
+			allocs++;
+			if (qmax != new_qmax)
+				sim_test_fail("func %u qmax %u, expected %u",
+						func_id, qmax, new_qmax);
+		}
+		if (sim_rm_claim(owner, func_id, qbase, qmax)) {
+			sim_test_fail("func %u range %d/%u overlaps",
+					func_id, qbase, qmax);
+			break;
+		}
+	}
+	t = qdma_sim_now_ns() - t;
+	if (!verbose)
+		qdma_sim_log_level = QDMA_SIM_LOG_ERR;
+	if (i < SIM_TEST_RM_OPS)
+		goto out_res;
+
+	for (i = 0; i < SIM_TEST_RM_FUNCS; i++)
+		qdma_dev_entry_destroy(dma_dev_idx, i);
+	funcs = 0;
+
+	/* all ranges must have been merged back into one */
+	qbase = 0;
+	rv = qdma_dev_entry_create(dma_dev_idx, 0);
+	if (rv == 0) {
+		funcs = 1;
+		rv = qdma_dev_update(dma_dev_idx, 0, SIM_TEST_RM_QUEUES,
+				&qbase);
+	}
+	if ((rv < 0) || (qbase != 0))
+		sim_test_fail("full range allocation %d qbase %d", rv, qbase);
+
+	/* requested qbase is honored */
+	qbase = 100;
+	rv = qdma_dev_update(dma_dev_idx, 0, 10, &qbase);
+	if ((rv < 0) || (qbase != 100))
+		sim_test_fail("qbase request %d qbase %d", rv, qbase);
+
+out_res:
+	for (i = 0; i < funcs; i++)
+		qdma_dev_entry_destroy(dma_dev_idx, i);
+	qdma_master_resource_destroy(dma_dev_idx);
+out:
+	sim_test_result("queue resource manager churn", start);
+	printf("  %u functions, %u queues: %.2f us/qmax update, ",
+			SIM_TEST_RM_FUNCS, SIM_TEST_RM_QUEUES,
+			(double)t / 1000 / SIM_TEST_RM_OPS);
+	printf("%u/%u granted\n", allocs, SIM_TEST_RM_OPS);
+}
+
+/*
+ * MM loopback: H2C into card memory and C2H back
+ */
+static int sim_mm_run(void *pf, uint8_t c2h, struct sim_mm_desc *ring,
+		uint8_t *host, uint32_t xfer_len, uint32_t nxfers)
+{
+	struct sim_wb_status *wb = (struct sim_wb_status *)
+			&ring[SIM_TEST_RNG_SZ - 1];
+	struct qdma_q_pidx_reg_info pidx_info;
+	uint16_t pidx = 0;
+	uint32_t i;
+
+	memset(&pidx_info, 0, sizeof(pidx_info));
+	for (i = 0; i < nxfers; i++) {
+		struct sim_mm_desc *desc = &ring[pidx];
+		uint64_t card = (uint64_t)i * xfer_len;
+		uint64_t hptr = (uint64_t)(uintptr_t)(host + card);
+
+		desc->src_addr = c2h ? card : hptr;
+		desc->dst_addr = c2h ? hptr : card;
+		desc->flag_len = xfer_len | MM_DESC_F_DV | MM_DESC_F_SOP |
+				MM_DESC_F_EOP;
+		pidx = (pidx + 1) % SIM_TEST_RNG_WRAP;
+
+		/* ring the doorbell every 16 descriptors and at the end */
+		if (((i + 1) % 16) && (i + 1 != nxfers))
+			continue;
+
+		pidx_info.pidx = pidx;
+		sim_pidx_update(pf, SIM_TEST_MM_QID, c2h, &pidx_info);
+		if (wb->cidx != pidx)
+			return -1;
+	}
+
+	return 0;
+}
+
+static void sim_test_mm(struct qdma_sim_dev *dev, void *pf)
+{
+	uint32_t xfer_len = 2048, card_size = 0;
+	uint32_t nxfers = SIM_TEST_MM_XFERS;
+	struct sim_mm_desc *h2c_ring, *c2h_ring;
+	uint8_t *card = qdma_sim_card_mem(dev, &card_size);
+	uint8_t *src, *dst;
+	int start = failures;
+	uint32_t i;
+
+	if ((uint64_t)xfer_len * nxfers > card_size)
+		nxfers = card_size / xfer_len;
+
+	h2c_ring = sim_ring_alloc(SIM_TEST_RNG_SZ, sizeof(*h2c_ring));
+	c2h_ring = sim_ring_alloc(SIM_TEST_RNG_SZ, sizeof(*c2h_ring));
+	src = malloc((size_t)xfer_len * nxfers);
+	dst = calloc(nxfers, xfer_len);
+	if (!h2c_ring || !c2h_ring || !src || !dst) {
+		sim_test_fail("out of memory");
+		goto out;
+	}
+	for (i = 0; i < xfer_len * nxfers; i++)
+		src[i] = (uint8_t)(i * 7 + 3);
+
+	if ((sim_queue_clear(pf, SIM_TEST_MM_QID, 0) < 0) ||
+			(sim_queue_clear(pf, SIM_TEST_MM_QID, 1) < 0) ||
+			(sim_sw_ctxt_write(pf, SIM_TEST_MM_QID, 0, h2c_ring,
+					DESC_SZ_32B, 1) < 0) ||
+			(sim_sw_ctxt_write(pf, SIM_TEST_MM_QID, 1, c2h_ring,
+					DESC_SZ_32B, 1) < 0)) {
+		sim_test_fail("MM queue setup failed");
+		goto out;
+	}
+
+	if (sim_mm_run(pf, 0, h2c_ring, src, xfer_len, nxfers) < 0)
+		sim_test_fail("H2C status cidx mismatch");
+	if (memcmp(card, src, (size_t)xfer_len * nxfers))
+		sim_test_fail("card memory mismatch");
+	if (sim_mm_run(pf, 1, c2h_ring, dst, xfer_len, nxfers) < 0)
+		sim_test_fail("C2H status cidx mismatch");
+	if (memcmp(dst, src, (size_t)xfer_len * nxfers))
+		sim_test_fail("C2H data mismatch");
+
+out:
+	free(dst);
+	free(src);
+	free(c2h_ring);
+	free(h2c_ring);
+	sim_test_result("MM H2C/C2H loopback", start);
+}
+
+/*
+ * ST loopback: packets sent on H2C show up on the C2H queue
+ */
+struct sim_st_q {
+	struct sim_h2c_desc *h2c_ring;
+	struct sim_c2h_desc *c2h_ring;
+	uint64_t *cmpt_ring;
+	uint8_t *bufs;
+	uint16_t h2c_pidx;
+	uint16_t c2h_pidx;
+	uint16_t c2h_cidx;
+	uint16_t cmpt_cidx;
+	uint8_t color;
+};
+
+static int sim_st_setup(void *pf, struct sim_st_q *q)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_descq_prefetch_ctxt pfetch;
+	struct qdma_descq_cmpt_ctxt cmpt;
+	struct qdma_q_pidx_reg_info pidx_info;
+	struct qdma_q_cmpt_cidx_reg_info cidx_info;
+	int i;
+
+	q->h2c_ring = sim_ring_alloc(SIM_TEST_RNG_SZ, sizeof(*q->h2c_ring));
+	q->c2h_ring = sim_ring_alloc(SIM_TEST_RNG_SZ, sizeof(*q->c2h_ring));
+	q->cmpt_ring = sim_ring_alloc(SIM_TEST_RNG_SZ, sizeof(uint64_t));
+	q->bufs = malloc((size_t)SIM_TEST_RNG_WRAP * SIM_TEST_BUF_SZ);
+	if (!q->h2c_ring || !q->c2h_ring || !q->cmpt_ring || !q->bufs)
+		return -1;
+
+	for (i = 0; i < SIM_TEST_RNG_WRAP; i++)
+		q->c2h_ring[i].dst_addr = (uint64_t)(uintptr_t)
+				(q->bufs + ((size_t)i * SIM_TEST_BUF_SZ));
+
+	if ((sim_queue_clear(pf, SIM_TEST_ST_QID, 0) < 0) ||
+			(sim_queue_clear(pf, SIM_TEST_ST_QID, 1) < 0) ||
+			(hw->qdma_pfetch_ctx_conf(pf, SIM_TEST_ST_QID, NULL,
+					QDMA_HW_ACCESS_CLEAR) < 0) ||
+			(hw->qdma_cmpt_ctx_conf(pf, SIM_TEST_ST_QID, NULL,
+					QDMA_HW_ACCESS_CLEAR) < 0))
+		return -1;
+
+	if ((sim_sw_ctxt_write(pf, SIM_TEST_ST_QID, 0, q->h2c_ring,
+			DESC_SZ_16B, 0) < 0) ||
+			(sim_sw_ctxt_write(pf, SIM_TEST_ST_QID, 1, q->c2h_ring,
+			DESC_SZ_8B, 0) < 0))
+		return -1;
+
+	memset(&pfetch, 0, sizeof(pfetch));
+	pfetch.bufsz_idx = SIM_TEST_BUF_SZ_IDX;
+	pfetch.valid = 1;
+	if (hw->qdma_pfetch_ctx_conf(pf, SIM_TEST_ST_QID, &pfetch,
+			QDMA_HW_ACCESS_WRITE) < 0)
+		return -1;
+
+	memset(&cmpt, 0, sizeof(cmpt));
+	cmpt.bs_addr = (uint64_t)(uintptr_t)q->cmpt_ring;
+	cmpt.en_stat_desc = 1;
+	cmpt.trig_mode = QDMA_CMPT_UPDATE_TRIG_MODE_EVERY;
+	cmpt.color = 1;
+	cmpt.ringsz_idx = SIM_TEST_RNG_SZ_IDX;
+	cmpt.desc_sz = DESC_SZ_8B;
+	cmpt.valid = 1;
+	cmpt.ovf_chk_dis = 1;
+	if (hw->qdma_cmpt_ctx_conf(pf, SIM_TEST_ST_QID, &cmpt,
+			QDMA_HW_ACCESS_WRITE) < 0)
+		return -1;
+
+	q->color = 1;
+	q->c2h_pidx = SIM_TEST_RNG_WRAP - 1;
+	memset(&cidx_info, 0, sizeof(cidx_info));
+	cidx_info.wrb_en = 1;
+	cidx_info.trig_mode = QDMA_CMPT_UPDATE_TRIG_MODE_EVERY;
+	sim_cmpt_cidx_update(pf, SIM_TEST_ST_QID, &cidx_info);
+
+	memset(&pidx_info, 0, sizeof(pidx_info));
+	pidx_info.pidx = q->c2h_pidx;
+	return sim_pidx_update(pf, SIM_TEST_ST_QID, 1, &pidx_info);
+}
+
+static int sim_st_send(void *pf, struct sim_st_q *q, uint8_t *pkt,
+		uint32_t len)
+{
+	struct qdma_q_pidx_reg_info pidx_info;
+	uint32_t off = 0;
+
+	do {
+		struct sim_h2c_desc *desc = &q->h2c_ring[q->h2c_pidx];
+		uint32_t chunk = len - off;
+
+		if (chunk > SIM_TEST_BUF_SZ)
+			chunk = SIM_TEST_BUF_SZ;
+		memset(desc, 0, sizeof(*desc));
+		desc->src_addr = (uint64_t)(uintptr_t)(pkt + off);
+		desc->len = chunk;
+		desc->pld_len = chunk;
+		if (!off)
+			desc->flags |= H2C_DESC_F_SOP;
+		off += chunk;
+		if (off == len)
+			desc->flags |= H2C_DESC_F_EOP;
+		q->h2c_pidx = (q->h2c_pidx + 1) % SIM_TEST_RNG_WRAP;
+	} while (off < len);
+
+	memset(&pidx_info, 0, sizeof(pidx_info));
+	pidx_info.pidx = q->h2c_pidx;
+	return sim_pidx_update(pf, SIM_TEST_ST_QID, 0, &pidx_info);
+}
+
+static int sim_st_recv(void *pf, struct sim_st_q *q, uint8_t *pkt,
+		uint32_t len)
+{
+	struct qdma_q_pidx_reg_info pidx_info;
+	struct qdma_q_cmpt_cidx_reg_info cidx_info;
+	uint64_t entry = q->cmpt_ring[q->cmpt_cidx];
+	uint32_t off = 0, nbufs = 0;
+
+	if (!!(entry & CMPT_F_COLOR) != q->color)
+		return -1;
+	if (!(entry & CMPT_F_DESC_USED) || (CMPT_LEN(entry) != len))
+		return -1;
+
+	while (off < len || !nbufs) {
+		uint32_t chunk = len - off;
+
+		if (chunk > SIM_TEST_BUF_SZ)
+			chunk = SIM_TEST_BUF_SZ;
+		if (memcmp(q->bufs + ((size_t)q->c2h_cidx * SIM_TEST_BUF_SZ),
+				pkt + off, chunk))
+			return -1;
+		off += chunk;
+		nbufs++;
+		q->c2h_cidx = (q->c2h_cidx + 1) % SIM_TEST_RNG_WRAP;
+	}
+
+	q->cmpt_cidx = (q->cmpt_cidx + 1) % SIM_TEST_RNG_WRAP;
+	if (!q->cmpt_cidx)
+		q->color ^= 1;
+
+	/* return consumed completion and buffers */
+	memset(&cidx_info, 0, sizeof(cidx_info));
+	cidx_info.wrb_cidx = q->cmpt_cidx;
+	cidx_info.wrb_en = 1;
+	cidx_info.trig_mode = QDMA_CMPT_UPDATE_TRIG_MODE_EVERY;
+	sim_cmpt_cidx_update(pf, SIM_TEST_ST_QID, &cidx_info);
+
+	q->c2h_pidx = (q->c2h_pidx + nbufs) % SIM_TEST_RNG_WRAP;
+	memset(&pidx_info, 0, sizeof(pidx_info));
+	pidx_info.pidx = q->c2h_pidx;
+	return sim_pidx_update(pf, SIM_TEST_ST_QID, 1, &pidx_info);
+}
+
+static void sim_test_st(void *pf)
+{
+	static const uint32_t lens[] = {64, 1, 4096, 9000, 1500, 8192, 333};
+	struct sim_st_q q;
+	uint8_t *pkt;
+	int start = failures;
+	uint32_t i, j;
+
+	memset(&q, 0, sizeof(q));
+	pkt = malloc(16384);
+	if (!pkt || sim_st_setup(pf, &q) < 0) {
+		sim_test_fail("ST queue setup failed");
+		goto out;
+	}
+
+	for (i = 0; i < SIM_TEST_ST_PKTS; i++) {
+		uint32_t len = lens[i % (sizeof(lens) / sizeof(lens[0]))];
+
+		for (j = 0; j < len; j++)
+			pkt[j] = (uint8_t)(i + j);
+		if (sim_st_send(pf, &q, pkt, len) < 0) {
+			sim_test_fail("packet %u send failed", i);
+			break;
+		}
+		if (sim_st_recv(pf, &q, pkt, len) < 0) {
+			sim_test_fail("packet %u len %u receive failed",
+					i, len);
+			break;
+		}
+	}
+
+out:
+	free(pkt);
+	free(q.bufs);
+	free(q.cmpt_ring);
+	free(q.c2h_ring);
+	free(q.h2c_ring);
+	sim_test_result("ST H2C->C2H loopback", start);
+}
+
+/*
+ * benchmark: context programming cost of a queue start
+ */
+static int sim_queue_start(void *pf, uint16_t hw_qid, void *ring)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_descq_prefetch_ctxt pfetch;
+	struct qdma_descq_cmpt_ctxt cmpt;
+	int rv;
+
+	rv = sim_queue_clear(pf, hw_qid, 0);
+	if (rv == 0)
+		rv = sim_queue_clear(pf, hw_qid, 1);
+	if (rv == 0)
+		rv = hw->qdma_pfetch_ctx_conf(pf, hw_qid, NULL,
+				QDMA_HW_ACCESS_CLEAR);
+	if (rv == 0)
+		rv = hw->qdma_cmpt_ctx_conf(pf, hw_qid, NULL,
+				QDMA_HW_ACCESS_CLEAR);
+	if (rv == 0)
+		rv = sim_sw_ctxt_write(pf, hw_qid, 0, ring, DESC_SZ_16B, 0);
+	if (rv == 0)
+		rv = sim_sw_ctxt_write(pf, hw_qid, 1, ring, DESC_SZ_8B, 0);
+	if (rv < 0)
+		return rv;
+
+	memset(&pfetch, 0, sizeof(pfetch));
+	pfetch.valid = 1;
+	rv = hw->qdma_pfetch_ctx_conf(pf, hw_qid, &pfetch,
+			QDMA_HW_ACCESS_WRITE);
+	if (rv < 0)
+		return rv;
+
+	memset(&cmpt, 0, sizeof(cmpt));
+	cmpt.bs_addr = (uint64_t)(uintptr_t)ring;
+	cmpt.color = 1;
+	cmpt.valid = 1;
+	return hw->qdma_cmpt_ctx_conf(pf, hw_qid, &cmpt,
+			QDMA_HW_ACCESS_WRITE);
+}
+
+static void sim_bench_queue_start(struct qdma_sim_dev *dev, void *pf,
+		uint16_t num_qs, uint8_t batch)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_sim_stats stats;
+	void *ring = sim_ring_alloc(1, 4096);
+	int start = failures;
+	uint64_t t;
+	uint16_t i;
+	int rv;
+
+	qdma_sim_stats_reset(dev);
+	t = qdma_sim_now_ns();
+	for (i = 0; i < num_qs; i++) {
+		if (batch)
+			hw->qdma_ctxt_batch_start(pf);
+		rv = sim_queue_start(pf, i, ring);
+		if (batch && (hw->qdma_ctxt_batch_end(pf) < 0))
+			rv = -1;
+		if (rv < 0) {
+			sim_test_fail("queue %u start failed", i);
+			break;
+		}
+	}
+	t = qdma_sim_now_ns() - t;
+	qdma_sim_stats_get(dev, &stats);
+	free(ring);
+
+	sim_test_result(batch ? "queue start benchmark, batched" :
+			"queue start benchmark", start);
+	printf("  %u queues: %.2f us/queue, %.1f ctxt cmds/queue, ",
+			num_qs, (double)t / 1000 / num_qs,
+			(double)stats.ctxt_cmds / num_qs);
+	printf("%.1f reg reads/queue, %.1f reg writes/queue\n",
+			(double)stats.reg_reads / num_qs,
+			(double)stats.reg_writes / num_qs);
+	printf("  busy polls %llu, cmd overruns %llu\n",
+			(unsigned long long)stats.ctxt_busy_polls,
+			(unsigned long long)stats.ctxt_cmd_overruns);
+}
+
+/*
+ * binary register and context snapshots: decoding them must give the text
+ * and structures of the live dump APIs, at a fraction of the capture cost
+ */
+static void sim_test_snapshot(struct qdma_sim_dev *dev, void *pf,
+		uint16_t num_qs)
+{
+	struct qdma_hw_access *hw = qdma_sim_func_hw_access(pf);
+	struct qdma_descq_ctxt_raw *raw;
+	struct qdma_descq_context ctxt;
+	struct qdma_descq_sw_ctxt sw;
+	struct qdma_reg_data *regs = NULL;
+	struct qdma_sim_stats stats;
+	char *text = NULL, *text_raw = NULL;
+	uint32_t ctxt_len = 0, num_entries = 0;
+	uint64_t t_text, t_raw, t_dec;
+	int reg_len = 0, len, len_raw, n;
+	int start = failures;
+	uint16_t i;
+
+	raw = calloc(num_qs, sizeof(*raw));
+	qdma_acc_context_buf_len(pf, EQDMA_SOFT_IP, QDMA_DEVICE_SOFT, 1,
+			QDMA_DEV_Q_TYPE_C2H, &ctxt_len);
+	qdma_acc_reg_dump_buf_len(pf, EQDMA_SOFT_IP, QDMA_DEVICE_SOFT,
+			&reg_len);
+	if ((uint32_t)reg_len < ctxt_len)
+		reg_len = ctxt_len;
+	text = malloc(reg_len);
+	text_raw = malloc(reg_len);
+	if (!raw || !text || !text_raw) {
+		sim_test_fail("out of memory");
+		goto out;
+	}
+
+	/* config registers */
+	len = hw->qdma_dump_config_regs(pf, 0, text, reg_len);
+	if ((qdma_acc_config_regs_raw_len(EQDMA_SOFT_IP, QDMA_DEVICE_SOFT,
+			&num_entries) < 0) || !num_entries) {
+		sim_test_fail("config regs raw len failed");
+		goto out;
+	}
+	regs = calloc(num_entries, sizeof(*regs));
+	if (!regs) {
+		sim_test_fail("out of memory");
+		goto out;
+	}
+	n = qdma_acc_read_config_regs_raw(pf, 0, EQDMA_SOFT_IP,
+			QDMA_DEVICE_SOFT, regs, num_entries);
+	len_raw = qdma_acc_dump_config_regs_raw(EQDMA_SOFT_IP,
+			QDMA_DEVICE_SOFT, regs, n, text_raw, reg_len);
+	if ((n <= 0) || (len <= 0) || (len != len_raw) ||
+			memcmp(text, text_raw, len))
+		sim_test_fail("config regs: %d entries, text %d raw %d",
+				n, len, len_raw);
+
+	/* queue contexts, text dump of the live device */
+	t_text = qdma_sim_now_ns();
+	for (i = 0; i < num_qs; i++) {
+		if (hw->qdma_read_dump_queue_context(pf, 0, i, 1,
+				QDMA_DEV_Q_TYPE_C2H, text, ctxt_len) < 0)
+			sim_test_fail("queue %u text dump failed", i);
+	}
+	t_text = qdma_sim_now_ns() - t_text;
+
+	/* binary snapshot, decoded later */
+	qdma_sim_stats_reset(dev);
+	t_raw = qdma_sim_now_ns();
+	for (i = 0; i < num_qs; i++) {
+		if (hw->qdma_read_queue_context_raw(pf, 0, i, 1,
+				QDMA_DEV_Q_TYPE_C2H, &raw[i]) < 0)
+			sim_test_fail("queue %u snapshot failed", i);
+	}
+	t_raw = qdma_sim_now_ns() - t_raw;
+	qdma_sim_stats_get(dev, &stats);
+
+	t_dec = qdma_sim_now_ns();
+	for (i = 0; i < num_qs; i++) {
+		if (qdma_acc_dump_queue_context_raw(EQDMA_SOFT_IP,
+				QDMA_DEVICE_SOFT, &raw[i], text_raw,
+				ctxt_len) < 0)
+			sim_test_fail("queue %u raw dump failed", i);
+	}
+	t_dec = qdma_sim_now_ns() - t_dec;
+
+	for (i = 0; i < num_qs; i++) {
+		len = hw->qdma_read_dump_queue_context(pf, 0, i, 1,
+				QDMA_DEV_Q_TYPE_C2H, text, ctxt_len);
+		len_raw = qdma_acc_dump_queue_context_raw(EQDMA_SOFT_IP,
+				QDMA_DEVICE_SOFT, &raw[i], text_raw, ctxt_len);
+		if ((len != len_raw) || memcmp(text, text_raw, len)) {
+			sim_test_fail("queue %u text %d raw %d", i, len,
+					len_raw);
+			break;
+		}
+
+		qdma_acc_decode_queue_context_raw(EQDMA_SOFT_IP,
+				QDMA_DEVICE_SOFT, &raw[i], &ctxt);
+		hw->qdma_sw_ctx_conf(pf, 1, i, &sw, QDMA_HW_ACCESS_READ);
+		if (memcmp(&sw, &ctxt.sw_ctxt, sizeof(sw))) {
+			sim_test_fail("queue %u decoded sw ctxt mismatch", i);
+			break;
+		}
+	}
+
+	sim_test_result("register/context snapshots", start);
+	printf("  %u queues: text dump %.2f us/queue, ", num_qs,
+			(double)t_text / 1000 / num_qs);
+	printf("snapshot %.2f us/queue + decode %.2f us/queue, ",
+			(double)t_raw / 1000 / num_qs,
+			(double)t_dec / 1000 / num_qs);
+	printf("%.1f ctxt cmds/queue\n",
+			(double)stats.ctxt_cmds / num_qs);
+out:
+	free(regs);
+	free(text_raw);
+	free(text);
+	free(raw);
+}
+
+static void usage(const char *name)
+{
+	fprintf(stdout, "%s\n\n", name);
+	fprintf(stdout, "usage: %s [OPTIONS]\n\n", name);
+	fprintf(stdout, "Runs the qdma_access layer against the software ");
+	fprintf(stdout, "QDMA device model.\n\n");
+	fprintf(stdout, "  -q (--queues) number of queues, default 512\n");
+	fprintf(stdout, "  -l (--ctxt-latency) indirect context command ");
+	fprintf(stdout, "busy time in ns, default 0\n");
+	fprintf(stdout, "  -r (--read-latency) register read latency in ");
+	fprintf(stdout, "ns, default 0\n");
+	fprintf(stdout, "  -v (--verbose) verbose output\n");
+	fprintf(stdout, "  -h (--help) print usage help and exit\n");
+	fprintf(stdout, "  -V (--version) print version and exit\n");
+}
+
+static struct option const long_opts[] = {
+	{"queues", required_argument, NULL, 'q'},
+	{"ctxt-latency", required_argument, NULL, 'l'},
+	{"read-latency", required_argument, NULL, 'r'},
+	{"verbose", no_argument, NULL, 'v'},
+	{"help", no_argument, NULL, 'h'},
+	{"version", no_argument, NULL, 'V'},
+	{0, 0, 0, 0}
+};
+
+int main(int argc, char *argv[])
+{
+	struct qdma_sim_config cfg;
+	struct qdma_sim_dev *dev;
+	struct qdma_sim_func *pf;
+	int cmd_opt;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.num_qs = 512;
+	cfg.num_pfs = 1;
+	cfg.card_mem_size = 1 << 20;
+
+	while ((cmd_opt = getopt_long(argc, argv, "q:l:r:vhV", long_opts,
+			NULL)) != -1) {
+		switch (cmd_opt) {
+		case 'q':
+			cfg.num_qs = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			cfg.ctxt_cmd_latency_ns = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			cfg.reg_read_latency_ns = strtoul(optarg, NULL, 0);
+			break;
+		case 'v':
+			verbose = 1;
+			qdma_sim_log_level = QDMA_SIM_LOG_INFO;
+			break;
+		case 'V':
+			printf("%s version %s\n", PROGNAME, VERSION);
+			printf("%s\n", COPYRIGHT);
+			return 0;
+		case 'h':
+		default:
+			usage(argv[0]);
+			return (cmd_opt == 'h') ? 0 : EXIT_FAILURE;
+		}
+	}
+
+	if ((cfg.num_qs < SIM_TEST_PF_QMAX + SIM_TEST_VF_QMAX) ||
+			(cfg.num_qs > QDMA_SIM_MAX_QUEUES)) {
+		fprintf(stderr, "queues must be in [%u, %u]\n",
+				SIM_TEST_PF_QMAX + SIM_TEST_VF_QMAX,
+				QDMA_SIM_MAX_QUEUES);
+		return EXIT_FAILURE;
+	}
+
+	dev = qdma_sim_dev_create(&cfg);
+	if (!dev) {
+		fprintf(stderr, "failed to create device model\n");
+		return EXIT_FAILURE;
+	}
+	pf = qdma_sim_func_create(dev, 0, 0, 0);
+	if (!pf) {
+		fprintf(stderr, "failed to create PF\n");
+		qdma_sim_dev_destroy(dev);
+		return EXIT_FAILURE;
+	}
+
+	if (sim_test_hw_init(pf, cfg.num_qs) == 0) {
+		sim_test_ctxt(pf);
+		sim_test_ctxt_batch(pf);
+		sim_test_mbox(dev, pf, cfg.num_qs);
+		sim_test_resource_mgmt();
+		sim_test_mm(dev, pf);
+		sim_test_st(pf);
+		sim_bench_queue_start(dev, pf, cfg.num_qs, 0);
+		sim_bench_queue_start(dev, pf, cfg.num_qs, 1);
+		sim_test_snapshot(dev, pf, cfg.num_qs);
+	}
+
+	qdma_sim_dev_destroy(dev);
+
+	if (failures) {
+		printf("%d check(s) failed\n", failures);
+		return EXIT_FAILURE;
+	}
+
+	return 0;
+}
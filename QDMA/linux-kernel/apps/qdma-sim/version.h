@@ -0,0 +1,20 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2018-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is licensed under both the BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree) and the GPLv2 (found
+ * in the COPYING file in the root directory of this source tree).
+ * You may select, at your option, one of the above-listed licenses.
+ */
+
+#ifndef __QDMA_SIM_VERSION_H
+#define __QDMA_SIM_VERSION_H
+
+#define PROGNAME "qdma-sim-test"
+#define VERSION "2022.2.0"
+#define COPYRIGHT "Copyright (c) 2018-2022 Xilinx Inc."
+
+#endif
@@ -300,6 +300,19 @@ int eqdma_cpm5_read_dump_queue_context(void *dev_hndl,
 		enum qdma_dev_q_type q_type,
 		char *buf, uint32_t buflen);
 
+int eqdma_cpm5_read_queue_context_raw(void *dev_hndl,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw);
+
+int eqdma_cpm5_decode_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt);
+
+int eqdma_cpm5_dump_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen);
+
 int eqdma_cpm5_get_device_attributes(void *dev_hndl,
 		struct qdma_dev_attributes *dev_info);
 
@@ -23,6 +23,7 @@
 #include "eqdma_soft_access.h"
 #include "eqdma_cpm5_access/eqdma_cpm5_access.h"
 #include "qdma_reg_dump.h"
+#include "qdma_access_fixed_ip.h"
 
 #ifdef ENABLE_WPP_TRACING
 #include "qdma_access_common.tmh"
@@ -46,12 +47,19 @@ enum qdma_ip {
  * hw_monitor_reg() - polling a register repeatly until
  *	(the register value & mask) == val or time is up
  *
+ * The register is read back to back QDMA_REG_POLL_SPIN_CNT times first as
+ * the hardware usually completes within a few hundred ns, after that the
+ * delay between reads starts at QDMA_REG_POLL_MIN_INTERVAL_US and doubles
+ * up to interval_us.
+ *
  * return -QDMA_BUSY_IIMEOUT_ERR if register value didn't match, 0 other wise
  */
 int hw_monitor_reg(void *dev_hndl, uint32_t reg, uint32_t mask,
 		uint32_t val, uint32_t interval_us, uint32_t timeout_us)
 {
-	int count;
+	uint32_t spin = QDMA_REG_POLL_SPIN_CNT;
+	uint32_t delay_us = QDMA_REG_POLL_MIN_INTERVAL_US;
+	uint32_t elapsed_us = 0;
 	uint32_t v;
 
 	if (!interval_us)
@@ -59,18 +67,27 @@ int hw_monitor_reg(void *dev_hndl, uint32_t reg, uint32_t mask,
 	if (!timeout_us)
 		timeout_us = QDMA_REG_POLL_DFLT_TIMEOUT_US;
 
-	count = timeout_us / interval_us;
-
-	do {
+	while (1) {
 		v = qdma_reg_read(dev_hndl, reg);
 		if ((v & mask) == val)
 			return QDMA_SUCCESS;
-		qdma_udelay(interval_us);
-	} while (--count);
 
-	v = qdma_reg_read(dev_hndl, reg);
-	if ((v & mask) == val)
-		return QDMA_SUCCESS;
+		if (spin) {
+			spin--;
+			continue;
+		}
+
+		if (elapsed_us >= timeout_us)
+			break;
+
+		qdma_udelay(delay_us);
+		elapsed_us += delay_us;
+		if (delay_us < interval_us) {
+			delay_us <<= 1;
+			if (delay_us > interval_us)
+				delay_us = interval_us;
+		}
+	}
 
 	qdma_log_error("%s: Reg read=%u Expected=%u, err:%d\n",
 				   __func__, v, val,
@@ -78,6 +95,204 @@ int hw_monitor_reg(void *dev_hndl, uint32_t reg, uint32_t mask,
 	return -QDMA_ERR_HWACC_BUSY_TIMEOUT;
 }
 
+/*
+ * qdma_ind_ctxt_cmd_lock() - take the register access lock for a new
+ *	indirect context command
+ *
+ * A command left in flight by a context batch is waited for first, so that
+ * the data and command registers can be reused. The lock is not held on
+ * failure.
+ *
+ * return -QDMA_ERR_HWACC_BUSY_TIMEOUT if the command in flight did not
+ *	complete, QDMA_SUCCESS other wise
+ */
+int qdma_ind_ctxt_cmd_lock(void *dev_hndl)
+{
+	struct qdma_hw_access *hw = NULL;
+	struct qdma_ctxt_batch *batch;
+	int rv;
+
+	qdma_get_hw_access(dev_hndl, &hw);
+	batch = &hw->ctxt_batch;
+
+	qdma_reg_access_lock(dev_hndl);
+	if (!batch->cmd_reg)
+		return QDMA_SUCCESS;
+
+	rv = hw_monitor_reg(dev_hndl, batch->cmd_reg,
+			QDMA_IND_CTXT_CMD_BUSY_MASK, 0,
+			QDMA_REG_POLL_DFLT_INTERVAL_US,
+			QDMA_REG_POLL_DFLT_TIMEOUT_US);
+	batch->cmd_reg = 0;
+	if (rv < 0) {
+		batch->status = rv;
+		qdma_reg_access_release(dev_hndl);
+	}
+
+	return rv;
+}
+
+/*
+ * qdma_ctxt_batch_owned() - check whether the calling thread has a context
+ *	batch open, called with the register access lock held
+ */
+static int qdma_ctxt_batch_owned(struct qdma_hw_access *hw)
+{
+	return hw->ctxt_batch.active &&
+		(hw->ctxt_batch.owner == qdma_get_thread_id());
+}
+
+/*
+ * qdma_ind_ctxt_cmd_wait() - wait for an indirect context command issued on
+ *	cmd_reg to complete, called with the register access lock held
+ *
+ * While the calling thread has a context batch open, commands that do not
+ * return data (sync == 0) are left in flight and completed by the next
+ * qdma_ind_ctxt_cmd_lock() or by qdma_ctxt_batch_end(). Commands of other
+ * threads are always waited for.
+ *
+ * return -QDMA_ERR_HWACC_BUSY_TIMEOUT if register
+ *	value didn't match, QDMA_SUCCESS other wise
+ */
+int qdma_ind_ctxt_cmd_wait(void *dev_hndl, uint32_t cmd_reg, uint8_t sync)
+{
+	struct qdma_hw_access *hw = NULL;
+	int owned;
+	int rv;
+
+	qdma_get_hw_access(dev_hndl, &hw);
+
+	owned = qdma_ctxt_batch_owned(hw);
+	if (owned && !sync) {
+		hw->ctxt_batch.cmd_reg = cmd_reg;
+		return QDMA_SUCCESS;
+	}
+
+	rv = hw_monitor_reg(dev_hndl, cmd_reg, QDMA_IND_CTXT_CMD_BUSY_MASK, 0,
+			QDMA_REG_POLL_DFLT_INTERVAL_US,
+			QDMA_REG_POLL_DFLT_TIMEOUT_US);
+	if ((rv < 0) && owned)
+		hw->ctxt_batch.status = rv;
+
+	return rv;
+}
+
+/*
+ * qdma_ind_ctxt_mask_needed() - check whether a context write has to
+ *	program the mask registers, called with the register access lock held
+ *
+ * Context writes always use an all ones mask, so while the calling thread
+ * has a batch open the mask registers are only written by its first write.
+ *
+ * return 1 if the mask registers need to be written, 0 other wise
+ */
+int qdma_ind_ctxt_mask_needed(void *dev_hndl)
+{
+	struct qdma_hw_access *hw = NULL;
+
+	qdma_get_hw_access(dev_hndl, &hw);
+
+	if (!qdma_ctxt_batch_owned(hw))
+		return 1;
+
+	if (hw->ctxt_batch.mask_set)
+		return 0;
+
+	hw->ctxt_batch.mask_set = 1;
+	return 1;
+}
+
+/*****************************************************************************/
+/**
+ * qdma_ctxt_batch_start() - open a batch of indirect context commands
+ *
+ * Until qdma_ctxt_batch_end(), the context clear, write and invalidate
+ * commands of the calling thread are not waited for individually: the next
+ * context command waits for its predecessor instead, so composing and
+ * issuing a command overlaps with the hardware processing the previous one,
+ * and the mask registers are written once. Context reads still complete
+ * before returning. Batches nest within a thread.
+ *
+ * One thread at a time owns the batch of a device. While it is open, the
+ * context commands of every other thread complete before returning and
+ * their errors are returned to them only; a batch opened by another thread
+ * in that time is a no-op.
+ *
+ * @dev_hndl:	device handle
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_ctxt_batch_start(void *dev_hndl)
+{
+	struct qdma_hw_access *hw = NULL;
+
+	if (!dev_hndl) {
+		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
+					__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	qdma_get_hw_access(dev_hndl, &hw);
+
+	qdma_reg_access_lock(dev_hndl);
+	if (!hw->ctxt_batch.active) {
+		hw->ctxt_batch.owner = qdma_get_thread_id();
+		hw->ctxt_batch.mask_set = 0;
+		hw->ctxt_batch.status = QDMA_SUCCESS;
+	}
+	if (hw->ctxt_batch.owner == qdma_get_thread_id())
+		hw->ctxt_batch.active++;
+	qdma_reg_access_release(dev_hndl);
+
+	return QDMA_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * qdma_ctxt_batch_end() - close a batch of indirect context commands
+ *
+ * Waits for the command in flight, which completes all commands issued
+ * before it. A no-op for a thread that does not own the batch.
+ *
+ * @dev_hndl:	device handle
+ *
+ * Return:	0   - all commands of the batch completed
+ *		< 0 - failure hit while the batch was open
+ *****************************************************************************/
+int qdma_ctxt_batch_end(void *dev_hndl)
+{
+	struct qdma_hw_access *hw = NULL;
+	int owned;
+	int rv;
+
+	if (!dev_hndl) {
+		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
+					__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	qdma_get_hw_access(dev_hndl, &hw);
+
+	/* only the owner changes the batch state once it is open */
+	qdma_reg_access_lock(dev_hndl);
+	owned = qdma_ctxt_batch_owned(hw);
+	qdma_reg_access_release(dev_hndl);
+	if (!owned)
+		return QDMA_SUCCESS;
+
+	rv = qdma_ind_ctxt_cmd_lock(dev_hndl);
+	if (rv < 0)
+		qdma_reg_access_lock(dev_hndl);
+
+	rv = hw->ctxt_batch.status;
+	hw->ctxt_batch.active--;
+	if (!hw->ctxt_batch.active)
+		hw->ctxt_batch.owner = 0;
+	qdma_reg_access_release(dev_hndl);
+
+	return rv;
+}
+
 /*****************************************************************************/
 /**
  * qdma_get_rtl_version() - Function to get the rtl_version in
@@ -443,6 +658,92 @@ void qdma_memset(void *to, uint8_t val, uint32_t size)
 		_to[i] = val;
 }
 
+/*
+ * qdma_read_queue_context_raw() - Helper function to read the context words
+ *			of a queue into a raw snapshot
+ *
+ * @num_words holds the number of words to read per enum qdma_ctxt_raw_type,
+ * a context with zero words is not read by this helper. The contexts read
+ * for @st and @q_type are the ones read by the read_dump_queue_context APIs.
+ * QDMA_CTXT_RAW_FMAP is read for @func_id, QDMA_CTXT_RAW_QID2VEC through the
+ * FMAP selector for @qid_hw.
+ *
+ * return -QDMA_ERR_INV_PARAM on invalid input, otherwise the result of the
+ *	indirect context reads
+ */
+int qdma_read_queue_context_raw(void *dev_hndl,
+		qdma_ind_ctxt_read_t ind_read,
+		const uint32_t *num_words,
+		uint16_t func_id, uint16_t qid_hw, uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw)
+{
+	uint8_t c2h = (q_type == QDMA_DEV_Q_TYPE_C2H) ? 1 : 0;
+	enum ind_ctxt_cmd_sel sel[QDMA_CTXT_RAW_MAX];
+	uint16_t idx[QDMA_CTXT_RAW_MAX];
+	uint32_t want = 0;
+	int type;
+	int rv;
+
+	if (!dev_hndl || !ind_read || !num_words || !raw) {
+		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
+				__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	if (q_type >= QDMA_DEV_Q_TYPE_MAX) {
+		qdma_log_error("%s: Not supported for q_type, err = %d\n",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	if (q_type != QDMA_DEV_Q_TYPE_CMPT) {
+		want |= (1 << QDMA_CTXT_RAW_SW) | (1 << QDMA_CTXT_RAW_HW) |
+			(1 << QDMA_CTXT_RAW_CR) | (1 << QDMA_CTXT_RAW_QID2VEC);
+		if (st && c2h)
+			want |= (1 << QDMA_CTXT_RAW_PFETCH);
+	}
+	if ((st && c2h) || (!st && (q_type == QDMA_DEV_Q_TYPE_CMPT)))
+		want |= (1 << QDMA_CTXT_RAW_CMPT);
+	want |= (1 << QDMA_CTXT_RAW_FMAP);
+
+	sel[QDMA_CTXT_RAW_SW] = c2h ?
+		QDMA_CTXT_SEL_SW_C2H : QDMA_CTXT_SEL_SW_H2C;
+	sel[QDMA_CTXT_RAW_HW] = c2h ?
+		QDMA_CTXT_SEL_HW_C2H : QDMA_CTXT_SEL_HW_H2C;
+	sel[QDMA_CTXT_RAW_CR] = c2h ?
+		QDMA_CTXT_SEL_CR_C2H : QDMA_CTXT_SEL_CR_H2C;
+	sel[QDMA_CTXT_RAW_PFETCH] = QDMA_CTXT_SEL_PFTCH;
+	sel[QDMA_CTXT_RAW_CMPT] = QDMA_CTXT_SEL_CMPT;
+	sel[QDMA_CTXT_RAW_FMAP] = QDMA_CTXT_SEL_FMAP;
+	sel[QDMA_CTXT_RAW_QID2VEC] = QDMA_CTXT_SEL_FMAP;
+	for (type = 0; type < QDMA_CTXT_RAW_MAX; type++)
+		idx[type] = qid_hw;
+	idx[QDMA_CTXT_RAW_FMAP] = func_id;
+
+	qdma_memset(raw, 0, sizeof(struct qdma_descq_ctxt_raw));
+	raw->qid_hw = qid_hw;
+	raw->func_id = func_id;
+	raw->st = st;
+	raw->q_type = (uint8_t)q_type;
+
+	for (type = 0; type < QDMA_CTXT_RAW_MAX; type++) {
+		if (!(want & (1 << type)) || !num_words[type])
+			continue;
+
+		rv = ind_read(dev_hndl, sel[type], idx[type],
+				num_words[type], raw->data[type]);
+		if (rv < 0) {
+			qdma_log_error("%s: Failed to read context %d, err = %d",
+					__func__, type, rv);
+			return rv;
+		}
+		raw->valid |= (1 << type);
+	}
+
+	return QDMA_SUCCESS;
+}
+
 /*****************************************************************************/
 /**
  * qdma_queue_cmpt_cidx_read() - function to read the CMPT CIDX register
@@ -888,6 +1189,235 @@ int qdma_acc_get_config_regs(void *dev_hndl, uint8_t is_vf,
 	return rv;
 }
 
+/*
+ * qdma_acc_config_reg_table() - Helper function to get the config register
+ *			table of the IP
+ *
+ * @name_idx is set when the register dump of the IP suffixes the register
+ * names with the repeat index and @dbg_filter when it skips the debug
+ * registers outside of debug mode.
+ */
+static int qdma_acc_config_reg_table(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		struct xreg_info **reg_info, uint32_t *num_regs,
+		uint8_t *name_idx, uint8_t *dbg_filter)
+{
+	switch (ip_type) {
+	case QDMA_SOFT_IP:
+		*num_regs = qdma_get_config_num_regs();
+		*reg_info = qdma_get_config_regs();
+		*name_idx = 1;
+		*dbg_filter = 0;
+		break;
+	case QDMA_VERSAL_HARD_IP:
+		if (device_type == QDMA_DEVICE_VERSAL_CPM4) {
+			*num_regs = qdma_cpm4_get_config_num_regs();
+			*reg_info = qdma_cpm4_get_config_regs();
+			*name_idx = 1;
+			*dbg_filter = 0;
+		} else if (device_type == QDMA_DEVICE_VERSAL_CPM5) {
+			*num_regs = eqdma_cpm5_get_config_num_regs();
+			*reg_info = eqdma_cpm5_get_config_regs();
+			*name_idx = 0;
+			*dbg_filter = 1;
+		} else {
+			qdma_log_error("%s: Invalid device type, err = %d",
+				__func__, -QDMA_ERR_INV_PARAM);
+			return -QDMA_ERR_INV_PARAM;
+		}
+		break;
+	case EQDMA_SOFT_IP:
+		*num_regs = eqdma_get_config_num_regs();
+		*reg_info = eqdma_get_config_regs();
+		*name_idx = 0;
+		*dbg_filter = 1;
+		break;
+	default:
+		qdma_log_error("%s: Invalid version number, err = %d",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	return QDMA_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * qdma_acc_config_regs_raw_len() - Function to get the number of entries
+ * needed for a config register snapshot
+ *
+ * @ip_type:	QDMA IP Type
+ * @device_type:QDMA DEVICE Type
+ * @num_entries:pointer to hold the number of entries
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_acc_config_regs_raw_len(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type, uint32_t *num_entries)
+{
+	struct xreg_info *reg_info;
+	uint32_t num_regs, i;
+	uint8_t name_idx, dbg_filter;
+	int rv;
+
+	if (!num_entries) {
+		qdma_log_error("%s: num_entries is NULL, err:%d\n",
+				__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_acc_config_reg_table(ip_type, device_type, &reg_info,
+			&num_regs, &name_idx, &dbg_filter);
+	if (rv < 0)
+		return rv;
+
+	*num_entries = 0;
+	for (i = 0; i < num_regs; i++)
+		*num_entries += reg_info[i].repeat;
+
+	return QDMA_SUCCESS;
+}
+
+int qdma_acc_read_config_regs_raw(void *dev_hndl, uint8_t is_vf,
+		enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		struct qdma_reg_data *reg_list,
+		uint32_t num_entries)
+{
+	struct qdma_hw_access *hw = NULL;
+	struct qdma_dev_attributes dev_cap;
+	struct xreg_info *reg_info;
+	uint32_t num_regs, i, j, count = 0;
+	uint8_t name_idx, dbg_filter;
+	uint8_t cap_mask;
+	int rv;
+
+	if (!dev_hndl || !reg_list) {
+		qdma_log_error("%s: dev_handle is NULL, err:%d\n",
+				__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	if (is_vf) {
+		qdma_log_error("%s: Wrong API used for VF, err:%d\n",
+				__func__,
+				-QDMA_ERR_HWACC_FEATURE_NOT_SUPPORTED);
+		return -QDMA_ERR_HWACC_FEATURE_NOT_SUPPORTED;
+	}
+
+	rv = qdma_acc_config_reg_table(ip_type, device_type, &reg_info,
+			&num_regs, &name_idx, &dbg_filter);
+	if (rv < 0)
+		return rv;
+
+	qdma_get_hw_access(dev_hndl, &hw);
+	if (!hw) {
+		qdma_log_error("%s: hw access is NULL, err:%d\n",
+				__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+	hw->qdma_get_device_attributes(dev_hndl, &dev_cap);
+	cap_mask = GET_CAPABILITY_MASK(dev_cap.mm_en, dev_cap.st_en,
+			dev_cap.mm_cmpt_en, dev_cap.mailbox_en);
+
+	for (i = 0; i < num_regs; i++) {
+		if ((cap_mask & reg_info[i].mode) == 0)
+			continue;
+
+		if (dbg_filter && dev_cap.debug_mode == 0 &&
+				reg_info[i].is_debug_reg == 1)
+			continue;
+
+		if (count + reg_info[i].repeat > num_entries) {
+			qdma_log_error("%s: reg_list too small, err:%d\n",
+					__func__, -QDMA_ERR_NO_MEM);
+			return -QDMA_ERR_NO_MEM;
+		}
+
+		for (j = 0; j < reg_info[i].repeat; j++, count++) {
+			reg_list[count].reg_addr =
+				reg_info[i].addr + (j * 4);
+			reg_list[count].reg_val = qdma_reg_read(dev_hndl,
+					reg_list[count].reg_addr);
+		}
+	}
+
+	return (int)count;
+}
+
+int qdma_acc_dump_config_regs_raw(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		const struct qdma_reg_data *reg_list,
+		uint32_t num_entries,
+		char *buf, uint32_t buflen)
+{
+	struct xreg_info *reg_info;
+	uint32_t num_regs, i = 0, j, n, len = 0;
+	uint32_t tried, addr;
+	uint8_t name_idx, dbg_filter;
+	char name[DEBGFS_GEN_NAME_SZ] = "";
+	int rv;
+
+	if (!reg_list || !buf) {
+		qdma_log_error("%s: buf is NULL, err:%d\n",
+				__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	rv = qdma_acc_config_reg_table(ip_type, device_type, &reg_info,
+			&num_regs, &name_idx, &dbg_filter);
+	if (rv < 0)
+		return rv;
+
+	for (n = 0; n < num_entries; n++) {
+		addr = reg_list[n].reg_addr;
+
+		/* Snapshots are taken in table order, so the entry is
+		 * normally found at the current table position.
+		 */
+		for (tried = 0; tried < num_regs; tried++) {
+			if (addr >= reg_info[i].addr &&
+				addr < reg_info[i].addr +
+					(reg_info[i].repeat * 4))
+				break;
+			i = (i + 1 < num_regs) ? i + 1 : 0;
+		}
+		if (tried == num_regs) {
+			qdma_log_error("%s: register %#x missing in list, err:%d\n",
+					__func__, addr, -QDMA_ERR_INV_PARAM);
+			return -QDMA_ERR_INV_PARAM;
+		}
+
+		j = (addr - reg_info[i].addr) / 4;
+		if (name_idx)
+			rv = QDMA_SNPRINTF_S(name, DEBGFS_GEN_NAME_SZ,
+					DEBGFS_GEN_NAME_SZ,
+					"%s_%d", reg_info[i].name, j);
+		else
+			rv = QDMA_SNPRINTF_S(name, DEBGFS_GEN_NAME_SZ,
+					DEBGFS_GEN_NAME_SZ,
+					"%s", reg_info[i].name);
+		if ((rv < 0) || (rv > DEBGFS_GEN_NAME_SZ)) {
+			qdma_log_error(
+				"%d:%s QDMA_SNPRINTF_S() failed, err:%d\n",
+				__LINE__, __func__,
+				rv);
+			return -QDMA_ERR_NO_MEM;
+		}
+
+		rv = dump_reg(buf + len, buflen - len, addr, name,
+				reg_list[n].reg_val);
+		if (rv < 0) {
+			qdma_log_error("%s Buff too small, err:%d\n",
+					__func__, -QDMA_ERR_NO_MEM);
+			return -QDMA_ERR_NO_MEM;
+		}
+		len += rv;
+	}
+
+	return len;
+}
+
 
 /*****************************************************************************/
 /**
@@ -1123,6 +1653,116 @@ int qdma_acc_read_dump_queue_context(void *dev_hndl,
 	return rv;
 }
 
+int qdma_acc_read_queue_context_raw(void *dev_hndl,
+		enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw)
+{
+	int rv = QDMA_SUCCESS;
+
+	switch (ip_type) {
+	case QDMA_SOFT_IP:
+		rv = qdma_soft_read_queue_context_raw(dev_hndl, func_id, qid_hw,
+				st, q_type, raw);
+		break;
+	case QDMA_VERSAL_HARD_IP:
+		if (device_type == QDMA_DEVICE_VERSAL_CPM4)
+			rv = qdma_cpm4_read_queue_context_raw(dev_hndl, func_id, qid_hw,
+				st, q_type, raw);
+		else if (device_type == QDMA_DEVICE_VERSAL_CPM5)
+			rv = eqdma_cpm5_read_queue_context_raw(dev_hndl, func_id, qid_hw,
+				st, q_type, raw);
+		else {
+			qdma_log_error("%s: Invalid device type, err = %d",
+			__func__, -QDMA_ERR_INV_PARAM);
+			return -QDMA_ERR_INV_PARAM;
+		}
+		break;
+	case EQDMA_SOFT_IP:
+		rv = eqdma_read_queue_context_raw(dev_hndl, func_id, qid_hw,
+				st, q_type, raw);
+		break;
+	default:
+		qdma_log_error("%s: Invalid version number, err = %d",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	return rv;
+}
+
+int qdma_acc_decode_queue_context_raw(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt_data)
+{
+	int rv = QDMA_SUCCESS;
+
+	switch (ip_type) {
+	case QDMA_SOFT_IP:
+		rv = qdma_soft_decode_queue_context_raw(raw, ctxt_data);
+		break;
+	case QDMA_VERSAL_HARD_IP:
+		if (device_type == QDMA_DEVICE_VERSAL_CPM4)
+			rv = qdma_cpm4_decode_queue_context_raw(raw, ctxt_data);
+		else if (device_type == QDMA_DEVICE_VERSAL_CPM5)
+			rv = eqdma_cpm5_decode_queue_context_raw(raw, ctxt_data);
+		else {
+			qdma_log_error("%s: Invalid device type, err = %d",
+			__func__, -QDMA_ERR_INV_PARAM);
+			return -QDMA_ERR_INV_PARAM;
+		}
+		break;
+	case EQDMA_SOFT_IP:
+		rv = eqdma_decode_queue_context_raw(raw, ctxt_data);
+		break;
+	default:
+		qdma_log_error("%s: Invalid version number, err = %d",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	return rv;
+}
+
+int qdma_acc_dump_queue_context_raw(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen)
+{
+	int rv = QDMA_SUCCESS;
+
+	switch (ip_type) {
+	case QDMA_SOFT_IP:
+		rv = qdma_soft_dump_queue_context_raw(raw, buf, buflen);
+		break;
+	case QDMA_VERSAL_HARD_IP:
+		if (device_type == QDMA_DEVICE_VERSAL_CPM4)
+			rv = qdma_cpm4_dump_queue_context_raw(raw, buf, buflen);
+		else if (device_type == QDMA_DEVICE_VERSAL_CPM5)
+			rv = eqdma_cpm5_dump_queue_context_raw(raw, buf, buflen);
+		else {
+			qdma_log_error("%s: Invalid device type, err = %d",
+			__func__, -QDMA_ERR_INV_PARAM);
+			return -QDMA_ERR_INV_PARAM;
+		}
+		break;
+	case EQDMA_SOFT_IP:
+		rv = eqdma_dump_queue_context_raw(raw, buf, buflen);
+		break;
+	default:
+		qdma_log_error("%s: Invalid version number, err = %d",
+			__func__, -QDMA_ERR_INV_PARAM);
+		return -QDMA_ERR_INV_PARAM;
+	}
+
+	return rv;
+}
+
 /*****************************************************************************/
 /**
  * qdma_acc_dump_config_reg_list() - Dump the registers
@@ -1278,6 +1918,28 @@ int qdma_get_error_code(int acc_err_code)
 	return qdma_get_err_code(acc_err_code);
 }
 
+#ifdef QDMA_FIXED_IP
+/*
+ * qdma_fixed_ip_supported() - Helper function to check the device against
+ *			the IP variant the build is specialised for
+ *
+ * return 1 if the doorbell layout of qdma_access_fixed_ip.h applies to the
+ *	device, 0 other wise
+ */
+static int qdma_fixed_ip_supported(
+		const struct qdma_hw_version_info *version_info)
+{
+	int is_cpm4 = (version_info->ip_type == QDMA_VERSAL_HARD_IP) &&
+		(version_info->device_type == QDMA_DEVICE_VERSAL_CPM4);
+
+#ifdef QDMA_FIXED_IP_CPM4
+	return is_cpm4;
+#else
+	return !is_cpm4;
+#endif
+}
+#endif
+
 int qdma_hw_access_init(void *dev_hndl, uint8_t is_vf,
 				struct qdma_hw_access *hw_access)
 {
@@ -1314,6 +1976,8 @@ int qdma_hw_access_init(void *dev_hndl, uint8_t is_vf,
 		hw_access->qdma_get_version = &qdma_get_version;
 
 	hw_access->qdma_init_ctxt_memory = &qdma_init_ctxt_memory;
+	hw_access->qdma_ctxt_batch_start = &qdma_ctxt_batch_start;
+	hw_access->qdma_ctxt_batch_end = &qdma_ctxt_batch_end;
 	hw_access->qdma_fmap_conf = &qdma_fmap_conf;
 	hw_access->qdma_sw_ctx_conf = &qdma_sw_ctx_conf;
 	hw_access->qdma_pfetch_ctx_conf = &qdma_pfetch_ctx_conf;
@@ -1342,6 +2006,8 @@ int qdma_hw_access_init(void *dev_hndl, uint8_t is_vf,
 	hw_access->qdma_dump_queue_context = &qdma_soft_dump_queue_context;
 	hw_access->qdma_read_dump_queue_context =
 					&qdma_soft_read_dump_queue_context;
+	hw_access->qdma_read_queue_context_raw =
+				&qdma_soft_read_queue_context_raw;
 	hw_access->qdma_dump_intr_context = &qdma_dump_intr_context;
 	hw_access->qdma_is_legacy_intr_pend = &qdma_is_legacy_intr_pend;
 	hw_access->qdma_clear_pend_legacy_intr = &qdma_clear_pend_legacy_intr;
@@ -1370,6 +2036,15 @@ int qdma_hw_access_init(void *dev_hndl, uint8_t is_vf,
 	qdma_log_info("Vivado Release: %s\n",
 		qdma_get_vivado_release_id(version_info.vivado_release));
 
+#ifdef QDMA_FIXED_IP
+	if (!qdma_fixed_ip_supported(&version_info)) {
+		qdma_log_error("%s: IP not supported by this build, err:%d\n",
+				__func__,
+				-QDMA_ERR_HWACC_FEATURE_NOT_SUPPORTED);
+		return -QDMA_ERR_HWACC_FEATURE_NOT_SUPPORTED;
+	}
+#endif
+
 	if (version_info.ip_type == QDMA_VERSAL_HARD_IP &&
 			version_info.device_type == QDMA_DEVICE_VERSAL_CPM4) {
 		hw_access->qdma_init_ctxt_memory =
@@ -1414,6 +2089,8 @@ int qdma_hw_access_init(void *dev_hndl, uint8_t is_vf,
 				&qdma_cpm4_dump_queue_context;
 		hw_access->qdma_read_dump_queue_context =
 				&qdma_cpm4_read_dump_queue_context;
+		hw_access->qdma_read_queue_context_raw =
+					&qdma_cpm4_read_queue_context_raw;
 		hw_access->qdma_dump_reg_info = &qdma_cpm4_dump_reg_info;
 		hw_access->qdma_max_errors = QDMA_CPM4_ERRS_ALL;
 	}
@@ -1458,6 +2135,8 @@ int qdma_hw_access_init(void *dev_hndl, uint8_t is_vf,
 				&eqdma_cpm5_dump_queue_context;
 		hw_access->qdma_read_dump_queue_context =
 				&eqdma_cpm5_read_dump_queue_context;
+		hw_access->qdma_read_queue_context_raw =
+					&eqdma_cpm5_read_queue_context_raw;
 		hw_access->qdma_dump_reg_info = &eqdma_cpm5_dump_reg_info;
 		/* All CSR and Queue space register belongs to Window 0.
 		 * Mailbox and MSIX register belongs to Window 1
@@ -1498,6 +2177,8 @@ int qdma_hw_access_init(void *dev_hndl, uint8_t is_vf,
 				&eqdma_dump_queue_context;
 		hw_access->qdma_read_dump_queue_context =
 				&eqdma_read_dump_queue_context;
+		hw_access->qdma_read_queue_context_raw =
+					&eqdma_read_queue_context_raw;
 		hw_access->qdma_dump_reg_info = &eqdma_dump_reg_info;
 		/* All CSR and Queue space register belongs to Window 0.
 		 * Mailbox and MSIX register belongs to Window 1
@@ -122,6 +122,8 @@ enum ind_ctxt_cmd_sel {
 /* polling a register */
 #define	QDMA_REG_POLL_DFLT_INTERVAL_US	10		    /* 10us per poll */
 #define	QDMA_REG_POLL_DFLT_TIMEOUT_US	(500*1000)	/* 500ms */
+#define	QDMA_REG_POLL_SPIN_CNT		4	/* reads before first delay */
+#define	QDMA_REG_POLL_MIN_INTERVAL_US	1	/* first delay, then doubled */
 
 /** Constants */
 #define QDMA_NUM_RING_SIZES                                 16
@@ -179,6 +181,23 @@ struct qdma_indirect_ctxt_regs {
 	union qdma_ind_ctxt_cmd cmd;
 };
 
+/**
+ * struct qdma_ctxt_batch - indirect context command batch state
+ */
+struct qdma_ctxt_batch {
+
+	/** @active - number of batches opened by @owner */
+	uint16_t active;
+	/** @mask_set - context mask registers programmed in this batch */
+	uint8_t mask_set;
+	/** @cmd_reg - command register of the command in flight, 0 if none */
+	uint32_t cmd_reg;
+	/** @status - first error hit in the batch */
+	int status;
+	/** @owner - qdma_get_thread_id() of the thread that opened it */
+	uint64_t owner;
+};
+
 /**
  * struct qdma_fmap_cfg - fmap config data structure
  */
@@ -544,6 +563,55 @@ struct qdma_reg_data {
 	uint32_t reg_val;
 };
 
+/**
+ * enum qdma_ctxt_raw_type - contexts held by a raw queue context snapshot
+ */
+enum qdma_ctxt_raw_type {
+	/** @QDMA_CTXT_RAW_SW: software context */
+	QDMA_CTXT_RAW_SW,
+	/** @QDMA_CTXT_RAW_HW: hardware context */
+	QDMA_CTXT_RAW_HW,
+	/** @QDMA_CTXT_RAW_CR: credit context */
+	QDMA_CTXT_RAW_CR,
+	/** @QDMA_CTXT_RAW_PFETCH: prefetch context */
+	QDMA_CTXT_RAW_PFETCH,
+	/** @QDMA_CTXT_RAW_CMPT: completion context */
+	QDMA_CTXT_RAW_CMPT,
+	/** @QDMA_CTXT_RAW_FMAP: function map context */
+	QDMA_CTXT_RAW_FMAP,
+	/** @QDMA_CTXT_RAW_QID2VEC: qid2vec context (CPM4 only) */
+	QDMA_CTXT_RAW_QID2VEC,
+	/** @QDMA_CTXT_RAW_MAX: number of raw context types */
+	QDMA_CTXT_RAW_MAX
+};
+
+#define QDMA_CTXT_RAW_VALID(raw, type)	((raw)->valid & (1 << (type)))
+
+/**
+ * struct qdma_descq_ctxt_raw - raw context words of a queue
+ *
+ * Binary snapshot of the contexts of a queue as returned by the indirect
+ * context reads. Decoding into struct qdma_descq_context or text is left to
+ * the consumer, see qdma_acc_decode_queue_context_raw() and
+ * qdma_acc_dump_queue_context_raw(), which need no device access.
+ */
+struct qdma_descq_ctxt_raw {
+	/** @qid_hw: hw queue id */
+	uint16_t qid_hw;
+	/** @func_id: function id the fmap context was read for */
+	uint16_t func_id;
+	/** @st: ST or MM */
+	uint8_t st;
+	/** @q_type: queue type, enum qdma_dev_q_type */
+	uint8_t q_type;
+	/** @valid: contexts present, bit per enum qdma_ctxt_raw_type */
+	uint8_t valid;
+	/** @rsvd: reserved */
+	uint8_t rsvd;
+	/** @data: context words per enum qdma_ctxt_raw_type */
+	uint32_t data[QDMA_CTXT_RAW_MAX][QDMA_IND_CTXT_DATA_NUM_REGS];
+};
+
 /**
  * enum qdma_hw_access_type - To hold hw access type
  */
@@ -617,8 +685,29 @@ int hw_monitor_reg(void *dev_hndl, uint32_t reg, uint32_t mask,
 		uint32_t val, uint32_t interval_us,
 		uint32_t timeout_us);
 
+int qdma_ind_ctxt_cmd_lock(void *dev_hndl);
+
+int qdma_ind_ctxt_cmd_wait(void *dev_hndl, uint32_t cmd_reg, uint8_t sync);
+
+int qdma_ind_ctxt_mask_needed(void *dev_hndl);
+
+int qdma_ctxt_batch_start(void *dev_hndl);
+
+int qdma_ctxt_batch_end(void *dev_hndl);
+
 void qdma_memset(void *to, uint8_t val, uint32_t size);
 
+typedef int (*qdma_ind_ctxt_read_t)(void *dev_hndl,
+		enum ind_ctxt_cmd_sel sel, uint16_t hw_qid, uint32_t cnt,
+		uint32_t *data);
+
+int qdma_read_queue_context_raw(void *dev_hndl,
+		qdma_ind_ctxt_read_t ind_read,
+		const uint32_t *num_words,
+		uint16_t func_id, uint16_t qid_hw, uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw);
+
 int qdma_acc_reg_dump_buf_len(void *dev_hndl, enum qdma_ip_type ip_type,
 		enum qdma_device_type device_type, int *buflen);
 
@@ -632,6 +721,9 @@ int qdma_acc_context_buf_len(void *dev_hndl, enum qdma_ip_type ip_type,
 int qdma_acc_get_num_config_regs(void *dev_hndl, enum qdma_ip_type ip_type,
 		enum qdma_device_type device_type, uint32_t *num_regs);
 
+int qdma_acc_config_regs_raw_len(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type, uint32_t *num_entries);
+
 /*
  * struct qdma_hw_access - Structure to hold HW access function pointers
  */
@@ -645,6 +737,8 @@ struct qdma_hw_access {
 					enum qdma_wrb_interval *wb_int,
 					enum qdma_hw_access_type access_type);
 	int (*qdma_init_ctxt_memory)(void *dev_hndl);
+	int (*qdma_ctxt_batch_start)(void *dev_hndl);
+	int (*qdma_ctxt_batch_end)(void *dev_hndl);
 	int (*qdma_qid2vec_conf)(void *dev_hndl, uint8_t c2h, uint16_t hw_qid,
 				 struct qdma_qid2vec *ctxt,
 				 enum qdma_hw_access_type access_type);
@@ -716,6 +810,12 @@ struct qdma_hw_access {
 			uint8_t st,
 			enum qdma_dev_q_type q_type,
 			char *buf, uint32_t buflen);
+	int (*qdma_read_queue_context_raw)(void *dev_hndl,
+			uint16_t func_id,
+			uint16_t qid_hw,
+			uint8_t st,
+			enum qdma_dev_q_type q_type,
+			struct qdma_descq_ctxt_raw *raw);
 	int (*qdma_dump_intr_context)(void *dev_hndl,
 			struct qdma_indirect_intr_ctxt *intr_ctx,
 			int ring_index,
@@ -740,6 +840,7 @@ struct qdma_hw_access {
 	uint32_t mbox_base_pf;
 	uint32_t mbox_base_vf;
 	uint32_t qdma_max_errors;
+	struct qdma_ctxt_batch ctxt_batch;
 };
 
 /*****************************************************************************/
@@ -887,6 +988,112 @@ int qdma_acc_dump_config_reg_list(void *dev_hndl,
 		struct qdma_reg_data *reg_list,
 		char *buf, uint32_t buflen);
 
+/*****************************************************************************/
+/**
+ * qdma_acc_read_config_regs_raw() - Function to take a binary snapshot of
+ * the qdma config registers
+ *
+ * Registers are read in the order of the config register table of the IP,
+ * skipping the ones not applicable to the device capabilities. Use
+ * qdma_acc_config_regs_raw_len() to size the array.
+ *
+ * @dev_hndl:   device handle
+ * @is_vf:      Whether PF or VF
+ * @ip_type:	QDMA IP Type
+ * @device_type:QDMA DEVICE Type
+ * @reg_list:	array of reg addr and reg values to be filled
+ * @num_entries:number of entries in reg_list
+ *
+ * Return:	number of entries filled - success and < 0 - failure
+ *****************************************************************************/
+int qdma_acc_read_config_regs_raw(void *dev_hndl, uint8_t is_vf,
+		enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		struct qdma_reg_data *reg_list,
+		uint32_t num_entries);
+
+/*****************************************************************************/
+/**
+ * qdma_acc_dump_config_regs_raw() - Function to decode a config register
+ * snapshot into a buffer, with register names and bitfields taken from the
+ * config register table of the IP. No device access is done.
+ *
+ * @ip_type:	QDMA IP Type
+ * @device_type:QDMA DEVICE Type
+ * @reg_list:	array of reg addr and reg values
+ * @num_entries:number of entries in reg_list
+ * @buf :       pointer to buffer to be filled
+ * @buflen :    Length of the buffer
+ *
+ * Return:	Length up-till the buffer is filled -success and < 0 - failure
+ *****************************************************************************/
+int qdma_acc_dump_config_regs_raw(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		const struct qdma_reg_data *reg_list,
+		uint32_t num_entries,
+		char *buf, uint32_t buflen);
+
+/*****************************************************************************/
+/**
+ * qdma_acc_read_queue_context_raw() - Function to take a binary snapshot of
+ * the contexts of a queue. This API is valid only for PF.
+ *
+ * @dev_hndl:   device handle
+ * @ip_type:	QDMA IP Type
+ * @device_type:QDMA DEVICE Type
+ * @func_id:	function id for the fmap context
+ * @qid_hw:     queue id
+ * @st:		Queue Mode(ST or MM)
+ * @q_type:	Queue type(H2C/C2H/CMPT)
+ * @raw:	snapshot to be filled
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_acc_read_queue_context_raw(void *dev_hndl,
+		enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw);
+
+/*****************************************************************************/
+/**
+ * qdma_acc_decode_queue_context_raw() - Function to decode a queue context
+ * snapshot. No device access is done.
+ *
+ * @ip_type:	QDMA IP Type
+ * @device_type:QDMA DEVICE Type
+ * @raw:	queue context snapshot
+ * @ctxt_data:	decoded context data
+ *
+ * Return:	0   - success and < 0 - failure
+ *****************************************************************************/
+int qdma_acc_decode_queue_context_raw(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt_data);
+
+/*****************************************************************************/
+/**
+ * qdma_acc_dump_queue_context_raw() - Function to decode a queue context
+ * snapshot into a buffer in the format of qdma_acc_dump_queue_context().
+ * No device access is done.
+ *
+ * @ip_type:	QDMA IP Type
+ * @device_type:QDMA DEVICE Type
+ * @raw:	queue context snapshot
+ * @buf :       pointer to buffer to be filled
+ * @buflen :    Length of the buffer
+ *
+ * Return:	Length up-till the buffer is filled -success and < 0 - failure
+ *****************************************************************************/
+int qdma_acc_dump_queue_context_raw(enum qdma_ip_type ip_type,
+		enum qdma_device_type device_type,
+		const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen);
+
 /*****************************************************************************/
 /**
  * qdma_get_error_code() - function to get the qdma access mapped
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2019-2022, Xilinx, Inc. All rights reserved.
+ * Copyright (c) 2022, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * This source code is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * The full GNU General Public License is included in this distribution in
+ * the file called "COPYING".
+ */
+
+#ifndef __QDMA_ACCESS_FIXED_IP_H_
+#define __QDMA_ACCESS_FIXED_IP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "qdma_access_common.h"
+
+/*
+ * Single IP variant builds
+ *
+ * By default the drivers support every QDMA IP variant and reach the queue
+ * PIDX/CIDX registers through the qdma_hw_access function table, one
+ * indirect call per doorbell. Defining one of
+ *
+ *	QDMA_FIXED_IP_SOFT - QDMA soft, EQDMA soft and Versal CPM5 IPs, which
+ *			     share the same queue register space
+ *	QDMA_FIXED_IP_CPM4 - Versal CPM4 hard IP
+ *
+ * builds the drivers for that variant only: the helpers below encode the
+ * doorbell registers at compile time so that the hot paths write them
+ * directly, and qdma_hw_access_init() rejects devices of other variants.
+ */
+#if defined(QDMA_FIXED_IP_SOFT) && defined(QDMA_FIXED_IP_CPM4)
+#error "QDMA_FIXED_IP_SOFT and QDMA_FIXED_IP_CPM4 are exclusive"
+#endif
+
+#if defined(QDMA_FIXED_IP_SOFT) || defined(QDMA_FIXED_IP_CPM4)
+#define QDMA_FIXED_IP
+
+#ifdef QDMA_FIXED_IP_SOFT
+#define QDMA_FIXED_IP_OFFSET_DMAP_SEL               0x18000
+#else
+#define QDMA_FIXED_IP_OFFSET_DMAP_SEL               0x6400
+#endif
+#define QDMA_FIXED_IP_OFFSET_VF_DMAP_SEL            0x3000
+
+#define QDMA_FIXED_IP_INT_CIDX                      0x0
+#define QDMA_FIXED_IP_H2C_DSC_PIDX                  0x4
+#define QDMA_FIXED_IP_C2H_DSC_PIDX                  0x8
+#define QDMA_FIXED_IP_CMPT_CIDX                     0xC
+
+#define QDMA_FIXED_IP_INT_SW_CIDX_MASK              0x0000FFFFU
+#define QDMA_FIXED_IP_INT_RING_IDX_MASK             0x00FF0000U
+#define QDMA_FIXED_IP_DESC_PIDX_MASK                0x0000FFFFU
+#define QDMA_FIXED_IP_IRQ_EN_MASK                   (1U << 16)
+#define QDMA_FIXED_IP_CMPT_IRQ_EN_MASK              (1U << 28)
+#define QDMA_FIXED_IP_CMPT_STS_DESC_EN_MASK         (1U << 27)
+#define QDMA_FIXED_IP_CMPT_TRG_MODE_MASK            0x07000000U
+#define QDMA_FIXED_IP_CMPT_TMR_CNT_MASK             0x00F00000U
+#define QDMA_FIXED_IP_CMPT_CNT_THRESH_MASK          0x000F0000U
+#define QDMA_FIXED_IP_CMPT_WRB_CIDX_MASK            0x0000FFFFU
+
+static inline uint32_t qdma_fixed_ip_dmap_sel(uint8_t is_vf, uint16_t qid,
+		uint32_t reg)
+{
+	return (is_vf ? QDMA_FIXED_IP_OFFSET_VF_DMAP_SEL :
+			QDMA_FIXED_IP_OFFSET_DMAP_SEL) +
+		(qid * QDMA_PIDX_STEP) + reg;
+}
+
+/*****************************************************************************/
+/**
+ * qdma_fixed_ip_pidx_reg() - encode a desc PIDX update
+ *
+ * @is_vf:	Whether PF or VF
+ * @qid:	Queue id relative to the PF/VF
+ * @is_c2h:	Queue direction. Set 1 for C2H and 0 for H2C
+ * @reg_info:	data needed for the PIDX register update
+ * @reg_val:	value to be written
+ *
+ * Return:	offset of the register to be written
+ *****************************************************************************/
+static inline uint32_t qdma_fixed_ip_pidx_reg(uint8_t is_vf, uint16_t qid,
+		uint8_t is_c2h, const struct qdma_q_pidx_reg_info *reg_info,
+		uint32_t *reg_val)
+{
+	*reg_val = FIELD_SET(QDMA_FIXED_IP_DESC_PIDX_MASK, reg_info->pidx) |
+		FIELD_SET(QDMA_FIXED_IP_IRQ_EN_MASK, reg_info->irq_en);
+
+	return qdma_fixed_ip_dmap_sel(is_vf, qid, is_c2h ?
+			QDMA_FIXED_IP_C2H_DSC_PIDX :
+			QDMA_FIXED_IP_H2C_DSC_PIDX);
+}
+
+/*****************************************************************************/
+/**
+ * qdma_fixed_ip_cmpt_cidx_reg() - encode a CMPT CIDX update
+ *
+ * @is_vf:	Whether PF or VF
+ * @qid:	Queue id relative to the PF/VF
+ * @reg_info:	data needed for the CIDX register update
+ * @reg_val:	value to be written
+ *
+ * Return:	offset of the register to be written
+ *****************************************************************************/
+static inline uint32_t qdma_fixed_ip_cmpt_cidx_reg(uint8_t is_vf,
+		uint16_t qid, const struct qdma_q_cmpt_cidx_reg_info *reg_info,
+		uint32_t *reg_val)
+{
+	*reg_val =
+		FIELD_SET(QDMA_FIXED_IP_CMPT_WRB_CIDX_MASK,
+				reg_info->wrb_cidx) |
+		FIELD_SET(QDMA_FIXED_IP_CMPT_CNT_THRESH_MASK,
+				reg_info->counter_idx) |
+		FIELD_SET(QDMA_FIXED_IP_CMPT_TMR_CNT_MASK,
+				reg_info->timer_idx) |
+		FIELD_SET(QDMA_FIXED_IP_CMPT_TRG_MODE_MASK,
+				reg_info->trig_mode) |
+		FIELD_SET(QDMA_FIXED_IP_CMPT_STS_DESC_EN_MASK,
+				reg_info->wrb_en) |
+		FIELD_SET(QDMA_FIXED_IP_CMPT_IRQ_EN_MASK, reg_info->irq_en);
+
+	return qdma_fixed_ip_dmap_sel(is_vf, qid, QDMA_FIXED_IP_CMPT_CIDX);
+}
+
+/*****************************************************************************/
+/**
+ * qdma_fixed_ip_intr_cidx_reg() - encode an interrupt ring CIDX update
+ *
+ * @is_vf:	Whether PF or VF
+ * @qid:	Interrupt ring index relative to the PF/VF
+ * @reg_info:	data needed for the CIDX register update
+ * @reg_val:	value to be written
+ *
+ * Return:	offset of the register to be written
+ *****************************************************************************/
+static inline uint32_t qdma_fixed_ip_intr_cidx_reg(uint8_t is_vf,
+		uint16_t qid, const struct qdma_intr_cidx_reg_info *reg_info,
+		uint32_t *reg_val)
+{
+	*reg_val =
+		FIELD_SET(QDMA_FIXED_IP_INT_SW_CIDX_MASK, reg_info->sw_cidx) |
+		FIELD_SET(QDMA_FIXED_IP_INT_RING_IDX_MASK, reg_info->rng_idx);
+
+	return qdma_fixed_ip_dmap_sel(is_vf, qid, QDMA_FIXED_IP_INT_CIDX);
+}
+
+#endif /* QDMA_FIXED_IP_SOFT || QDMA_FIXED_IP_CPM4 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __QDMA_ACCESS_FIXED_IP_H_ */
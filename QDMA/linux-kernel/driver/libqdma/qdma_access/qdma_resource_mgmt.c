@@ -24,19 +24,56 @@
 #include "qdma_resource_mgmt.tmh"
 #endif
 
+/*
+ * Free queue ranges are kept in two AVL trees, one ordered by qbase to
+ * honor a requested qbase and to merge neighbouring ranges on release, one
+ * ordered by size (ties broken by the higher qbase) to find the best fit.
+ * Device entries are hashed on (dma_device_index, func_id). All lookups
+ * and updates are O(log n) in the number of free ranges and O(1) in the
+ * number of functions, as needed for VF bring up storms on devices with
+ * hundreds of VFs.
+ */
+#define QDMA_DEV_HASH_BITS		8
+#define QDMA_DEV_HASH_SIZE		(1 << QDMA_DEV_HASH_BITS)
+
+struct qdma_tree_node {
+	struct qdma_tree_node *left;
+	struct qdma_tree_node *right;
+	int height;
+	void *priv;
+};
+
+struct qdma_resource_entry;
+
+#define QDMA_TREE_GET_DATA(node) ((struct qdma_resource_entry *)(node)->priv)
+
+typedef int (*qdma_tree_cmp_t)(const struct qdma_resource_entry *a,
+		const struct qdma_resource_entry *b);
+
+/** free queue range */
 struct qdma_resource_entry {
 	int qbase;
 	uint32_t total_q;
-	struct qdma_list_head node;
+	struct qdma_tree_node addr_node;
+	struct qdma_tree_node size_node;
 };
 
+struct qdma_resource_master;
+
 /** per function entry */
 struct qdma_dev_entry {
 	uint16_t func_id;
 	uint32_t active_h2c_qcnt;
 	uint32_t active_c2h_qcnt;
 	uint32_t active_cmpt_qcnt;
-	struct qdma_resource_entry entry;
+	/** queue base of the function, -1 if no queues assigned */
+	int qbase;
+	/** number of queues assigned to the function */
+	uint32_t total_q;
+	/** master resource the function belongs to */
+	struct qdma_resource_master *q_resource;
+	/** for attaching to the device entry hash bucket */
+	struct qdma_list_head node;
 };
 
 /** for hodling the qconf_entry structure */
@@ -53,34 +90,292 @@ struct qdma_resource_master {
 	int qbase;
 	/** for attaching to master resource list */
 	struct qdma_list_head node;
-	/** for holding device entries */
-	struct qdma_list_head dev_list;
-	/** for holding free resource list */
-	struct qdma_list_head free_list;
+	/** number of device entries of this resource */
+	uint32_t dev_cnt;
+	/** free ranges ordered by qbase */
+	struct qdma_tree_node *free_addr_root;
+	/** free ranges ordered by size */
+	struct qdma_tree_node *free_size_root;
 	/** active queue count per resource*/
 	uint32_t active_qcnt;
 };
 
 static QDMA_LIST_HEAD(master_resource_list);
+static struct qdma_list_head dev_hash[QDMA_DEV_HASH_SIZE];
+static int dev_hash_init_done;
+
+/*
+ * AVL tree helpers, the caller holds the resource lock
+ */
+static int qdma_tree_height(struct qdma_tree_node *node)
+{
+	return node ? node->height : 0;
+}
+
+static void qdma_tree_update_height(struct qdma_tree_node *node)
+{
+	int lh = qdma_tree_height(node->left);
+	int rh = qdma_tree_height(node->right);
+
+	node->height = ((lh > rh) ? lh : rh) + 1;
+}
+
+static struct qdma_tree_node *qdma_tree_rotate_right(
+		struct qdma_tree_node *node)
+{
+	struct qdma_tree_node *left = node->left;
+
+	node->left = left->right;
+	left->right = node;
+	qdma_tree_update_height(node);
+	qdma_tree_update_height(left);
+
+	return left;
+}
+
+static struct qdma_tree_node *qdma_tree_rotate_left(
+		struct qdma_tree_node *node)
+{
+	struct qdma_tree_node *right = node->right;
+
+	node->right = right->left;
+	right->left = node;
+	qdma_tree_update_height(node);
+	qdma_tree_update_height(right);
+
+	return right;
+}
+
+static struct qdma_tree_node *qdma_tree_balance(struct qdma_tree_node *node)
+{
+	int balance;
+
+	qdma_tree_update_height(node);
+	balance = qdma_tree_height(node->left) -
+			qdma_tree_height(node->right);
+
+	if (balance > 1) {
+		if (qdma_tree_height(node->left->left) <
+				qdma_tree_height(node->left->right))
+			node->left = qdma_tree_rotate_left(node->left);
+		return qdma_tree_rotate_right(node);
+	}
+
+	if (balance < -1) {
+		if (qdma_tree_height(node->right->right) <
+				qdma_tree_height(node->right->left))
+			node->right = qdma_tree_rotate_right(node->right);
+		return qdma_tree_rotate_left(node);
+	}
+
+	return node;
+}
+
+static struct qdma_tree_node *qdma_tree_insert(struct qdma_tree_node *root,
+		struct qdma_tree_node *node, qdma_tree_cmp_t cmp)
+{
+	if (!root) {
+		node->left = NULL;
+		node->right = NULL;
+		node->height = 1;
+		return node;
+	}
+
+	if (cmp(QDMA_TREE_GET_DATA(node), QDMA_TREE_GET_DATA(root)) < 0)
+		root->left = qdma_tree_insert(root->left, node, cmp);
+	else
+		root->right = qdma_tree_insert(root->right, node, cmp);
+
+	return qdma_tree_balance(root);
+}
+
+static struct qdma_tree_node *qdma_tree_remove_min(
+		struct qdma_tree_node *root, struct qdma_tree_node **min)
+{
+	if (!root->left) {
+		*min = root;
+		return root->right;
+	}
+
+	root->left = qdma_tree_remove_min(root->left, min);
+
+	return qdma_tree_balance(root);
+}
+
+static struct qdma_tree_node *qdma_tree_remove(struct qdma_tree_node *root,
+		struct qdma_tree_node *node, qdma_tree_cmp_t cmp)
+{
+	struct qdma_tree_node *min = NULL;
+	int rv;
+
+	if (!root)
+		return NULL;
+
+	rv = cmp(QDMA_TREE_GET_DATA(node), QDMA_TREE_GET_DATA(root));
+	if (rv < 0) {
+		root->left = qdma_tree_remove(root->left, node, cmp);
+	} else if (rv > 0) {
+		root->right = qdma_tree_remove(root->right, node, cmp);
+	} else {
+		if (!root->right)
+			return root->left;
+		root->right = qdma_tree_remove_min(root->right, &min);
+		min->left = root->left;
+		min->right = root->right;
+		root = min;
+	}
+
+	return qdma_tree_balance(root);
+}
+
+static int qdma_free_addr_cmp(const struct qdma_resource_entry *a,
+		const struct qdma_resource_entry *b)
+{
+	if (a->qbase == b->qbase)
+		return 0;
+
+	return (a->qbase < b->qbase) ? -1 : 1;
+}
+
+static int qdma_free_size_cmp(const struct qdma_resource_entry *a,
+		const struct qdma_resource_entry *b)
+{
+	if (a->total_q != b->total_q)
+		return (a->total_q < b->total_q) ? -1 : 1;
+
+	/* on equal size prefer the higher qbase */
+	return qdma_free_addr_cmp(b, a);
+}
+
+static void qdma_free_entry_insert(struct qdma_resource_master *q_resource,
+		struct qdma_resource_entry *entry)
+{
+	q_resource->free_addr_root = qdma_tree_insert(
+			q_resource->free_addr_root, &entry->addr_node,
+			qdma_free_addr_cmp);
+	q_resource->free_size_root = qdma_tree_insert(
+			q_resource->free_size_root, &entry->size_node,
+			qdma_free_size_cmp);
+}
+
+static void qdma_free_entry_remove(struct qdma_resource_master *q_resource,
+		struct qdma_resource_entry *entry)
+{
+	q_resource->free_addr_root = qdma_tree_remove(
+			q_resource->free_addr_root, &entry->addr_node,
+			qdma_free_addr_cmp);
+	q_resource->free_size_root = qdma_tree_remove(
+			q_resource->free_size_root, &entry->size_node,
+			qdma_free_size_cmp);
+}
+
+/* free range with the highest qbase <= @qbase */
+static struct qdma_resource_entry *qdma_free_entry_floor(
+		struct qdma_resource_master *q_resource, int qbase)
+{
+	struct qdma_tree_node *node = q_resource->free_addr_root;
+	struct qdma_resource_entry *found = NULL;
+
+	while (node) {
+		struct qdma_resource_entry *entry = QDMA_TREE_GET_DATA(node);
+
+		if (entry->qbase <= qbase) {
+			found = entry;
+			node = node->right;
+		} else {
+			node = node->left;
+		}
+	}
+
+	return found;
+}
+
+/* free range with the lowest qbase > @qbase */
+static struct qdma_resource_entry *qdma_free_entry_next(
+		struct qdma_resource_master *q_resource, int qbase)
+{
+	struct qdma_tree_node *node = q_resource->free_addr_root;
+	struct qdma_resource_entry *found = NULL;
+
+	while (node) {
+		struct qdma_resource_entry *entry = QDMA_TREE_GET_DATA(node);
+
+		if (entry->qbase > qbase) {
+			found = entry;
+			node = node->left;
+		} else {
+			node = node->right;
+		}
+	}
+
+	return found;
+}
+
+/* smallest free range holding @qmax queues */
+static struct qdma_resource_entry *qdma_free_entry_best_fit(
+		struct qdma_resource_master *q_resource, uint32_t qmax)
+{
+	struct qdma_tree_node *node = q_resource->free_size_root;
+	struct qdma_resource_entry *found = NULL;
+
+	while (node) {
+		struct qdma_resource_entry *entry = QDMA_TREE_GET_DATA(node);
+
+		if (entry->total_q >= qmax) {
+			found = entry;
+			node = node->left;
+		} else {
+			node = node->right;
+		}
+	}
+
+	return found;
+}
+
+static void qdma_free_tree_destroy(struct qdma_tree_node *node)
+{
+	if (!node)
+		return;
+
+	qdma_free_tree_destroy(node->left);
+	qdma_free_tree_destroy(node->right);
+	qdma_memfree(QDMA_TREE_GET_DATA(node));
+}
+
+/*
+ * lookup helpers, the caller holds the resource lock
+ */
+static uint32_t qdma_dev_hash(uint32_t dma_device_index, uint16_t func_id)
+{
+	return (func_id + (dma_device_index * 37)) & (QDMA_DEV_HASH_SIZE - 1);
+}
+
+static void qdma_dev_hash_init(void)
+{
+	int i;
+
+	if (dev_hash_init_done)
+		return;
+
+	for (i = 0; i < QDMA_DEV_HASH_SIZE; i++)
+		qdma_list_init_head(&dev_hash[i]);
+	dev_hash_init_done = 1;
+}
 
 static struct qdma_resource_master *qdma_find_master_resource_entry(
 		uint32_t bus_start, uint32_t bus_end)
 {
 	struct qdma_list_head *entry, *tmp;
 
-	qdma_resource_lock_take();
 	qdma_list_for_each_safe(entry, tmp, &master_resource_list) {
 		struct qdma_resource_master *q_resource =
 			(struct qdma_resource_master *)
 			QDMA_LIST_GET_DATA(entry);
 
 		if (q_resource->pci_bus_start == bus_start &&
-			q_resource->pci_bus_end == bus_end) {
-			qdma_resource_lock_give();
+			q_resource->pci_bus_end == bus_end)
 			return q_resource;
-		}
 	}
-	qdma_resource_lock_give();
 
 	return NULL;
 }
@@ -90,18 +385,14 @@ static struct qdma_resource_master *qdma_get_master_resource_entry(
 {
 	struct qdma_list_head *entry, *tmp;
 
-	qdma_resource_lock_take();
 	qdma_list_for_each_safe(entry, tmp, &master_resource_list) {
 		struct qdma_resource_master *q_resource =
 			(struct qdma_resource_master *)
 				QDMA_LIST_GET_DATA(entry);
 
-		if (q_resource->dma_device_index == dma_device_index) {
-			qdma_resource_lock_give();
+		if (q_resource->dma_device_index == dma_device_index)
 			return q_resource;
-		}
 	}
-	qdma_resource_lock_give();
 
 	return NULL;
 }
@@ -109,24 +400,43 @@ static struct qdma_resource_master *qdma_get_master_resource_entry(
 static struct qdma_dev_entry *qdma_get_dev_entry(uint32_t dma_device_index,
 						uint16_t func_id)
 {
-	struct qdma_list_head *entry, *tmp;
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
+	struct qdma_list_head *entry, *tmp, *head;
 
-	if (!q_resource)
-		return NULL;
+	qdma_dev_hash_init();
+	head = &dev_hash[qdma_dev_hash(dma_device_index, func_id)];
 
-	qdma_resource_lock_take();
-	qdma_list_for_each_safe(entry, tmp, &q_resource->dev_list) {
+	qdma_list_for_each_safe(entry, tmp, head) {
 		struct qdma_dev_entry *dev_entry = (struct qdma_dev_entry *)
 			QDMA_LIST_GET_DATA(entry);
 
-		if (dev_entry->func_id == func_id) {
-			qdma_resource_lock_give();
+		if ((dev_entry->func_id == func_id) &&
+				(dev_entry->q_resource->dma_device_index ==
+				 dma_device_index))
 			return dev_entry;
-		}
 	}
-	qdma_resource_lock_give();
+
+	return NULL;
+}
+
+/*
+ * qdma_dev_entry_lookup() - find the device entry, the error code tells
+ * apart a missing master resource from a missing device entry
+ */
+static struct qdma_dev_entry *qdma_dev_entry_lookup(
+		uint32_t dma_device_index, uint16_t func_id, int *rv)
+{
+	struct qdma_dev_entry *dev_entry =
+			qdma_get_dev_entry(dma_device_index, func_id);
+
+	if (dev_entry) {
+		*rv = QDMA_SUCCESS;
+		return dev_entry;
+	}
+
+	if (!qdma_get_master_resource_entry(dma_device_index))
+		*rv = -QDMA_ERR_RM_RES_NOT_EXISTS;
+	else
+		*rv = -QDMA_ERR_RM_DEV_NOT_EXISTS;
 
 	return NULL;
 }
@@ -135,241 +445,154 @@ static struct qdma_resource_entry *qdma_free_entry_create(int q_base,
 							  uint32_t total_q)
 {
 	struct qdma_resource_entry *entry = (struct qdma_resource_entry *)
-		qdma_calloc(1, sizeof(struct qdma_resource_master));
+		qdma_calloc(1, sizeof(struct qdma_resource_entry));
 	if (entry == NULL)
 		return NULL;
 
 	entry->total_q = total_q;
 	entry->qbase = q_base;
+	entry->addr_node.priv = entry;
+	entry->size_node.priv = entry;
 
 	return entry;
 }
 
 static void qdma_submit_to_free_list(struct qdma_dev_entry *dev_entry,
-				     struct qdma_list_head *head)
+				     struct qdma_resource_master *q_resource)
 {
-	struct qdma_resource_entry *streach_node = NULL;
-	struct qdma_list_head *entry, *tmp;
-	/* create a new node to be added to empty free list */
-	struct qdma_resource_entry *new_node = NULL;
+	struct qdma_resource_entry *prev, *next, *node;
+	int qbase = dev_entry->qbase;
+	uint32_t total_q = dev_entry->total_q;
 
-	if (!dev_entry->entry.total_q)
+	if (!total_q)
 		return;
 
-	if (qdma_list_is_empty(head)) {
-		new_node = qdma_free_entry_create(dev_entry->entry.qbase,
-				dev_entry->entry.total_q);
-		if (new_node == NULL)
-			return;
-		QDMA_LIST_SET_DATA(&new_node->node, new_node);
-		qdma_list_add_tail(&new_node->node, head);
-		/* reset device entry q resource params */
-		dev_entry->entry.qbase = -1;
-		dev_entry->entry.total_q = 0;
+	prev = qdma_free_entry_floor(q_resource, qbase);
+	next = qdma_free_entry_next(q_resource, qbase);
+
+	/* de-fragment (merge contiguous resource chunks) if possible */
+	if (prev && ((prev->qbase + prev->total_q) == (uint32_t)qbase)) {
+		node = prev;
+		qdma_free_entry_remove(q_resource, node);
+		node->total_q += total_q;
 	} else {
-		qdma_list_for_each_safe(entry, tmp, head) {
-			struct qdma_resource_entry *node =
-				(struct qdma_resource_entry *)
-					QDMA_LIST_GET_DATA(entry);
-
-			/* insert the free slot at appropriate place */
-			if ((node->qbase > dev_entry->entry.qbase) ||
-				qdma_list_is_last_entry(entry, head)) {
-				new_node = qdma_free_entry_create(
-						dev_entry->entry.qbase,
-						dev_entry->entry.total_q);
-				if (new_node == NULL)
-					return;
-				QDMA_LIST_SET_DATA(&new_node->node, new_node);
-				if (node->qbase > dev_entry->entry.qbase)
-					qdma_list_insert_before(&new_node->node,
-								&node->node);
-				else
-					qdma_list_add_tail(&new_node->node,
-							   head);
-				/* reset device entry q resource params */
-				dev_entry->entry.qbase = -1;
-				dev_entry->entry.total_q = 0;
-				break;
-			}
-		}
+		node = qdma_free_entry_create(qbase, total_q);
+		if (node == NULL)
+			return;
 	}
 
-	/* de-fragment (merge contiguous resource chunks) if possible */
-	qdma_list_for_each_safe(entry, tmp, head) {
-		struct qdma_resource_entry *node =
-		(struct qdma_resource_entry *)QDMA_LIST_GET_DATA(entry);
-
-		if (!streach_node)
-			streach_node = node;
-		else {
-			if ((streach_node->qbase + streach_node->total_q) ==
-					(uint32_t)node->qbase) {
-				streach_node->total_q += node->total_q;
-				qdma_list_del(&node->node);
-				qdma_memfree(node);
-			} else
-				streach_node = node;
-		}
+	if (next && ((node->qbase + node->total_q) == (uint32_t)next->qbase)) {
+		qdma_free_entry_remove(q_resource, next);
+		node->total_q += next->total_q;
+		qdma_memfree(next);
 	}
+
+	qdma_free_entry_insert(q_resource, node);
+
+	/* reset device entry q resource params */
+	dev_entry->qbase = -1;
+	dev_entry->total_q = 0;
 }
 
 /**
- * qdma_resource_entry() - return the best free list entry node that can
- *                         accommodate the new request
+ * qdma_get_resource_node() - carve @qmax queues out of the free ranges,
+ *                            honoring @qbase if possible
+ *
+ * Return: qbase of the allocated range, < 0 if the request cannot be
+ *         accommodated
  */
-static struct qdma_resource_entry *qdma_get_resource_node(uint32_t qmax,
-							  int qbase,
-				   struct qdma_list_head *free_list_head)
+static int qdma_get_resource_node(uint32_t qmax, int qbase,
+				  struct qdma_resource_master *q_resource)
 {
-	struct qdma_list_head *entry, *tmp;
 	struct qdma_resource_entry *best_fit_node = NULL;
+	struct qdma_resource_entry *tail;
+	uint32_t start, end;
 
 	/* try to honor requested qbase */
 	if (qbase >= 0) {
-		qdma_list_for_each_safe(entry, tmp, free_list_head) {
-			struct qdma_resource_entry *node =
-			(struct qdma_resource_entry *)QDMA_LIST_GET_DATA(entry);
-
-			if ((qbase >= node->qbase) &&
-					(node->qbase + node->total_q) >=
-					(qbase + qmax)) {
-				best_fit_node = node;
-				goto fragment_free_list;
-			}
-		}
+		best_fit_node = qdma_free_entry_floor(q_resource, qbase);
+		if (best_fit_node && ((best_fit_node->qbase +
+				best_fit_node->total_q) < (qbase + qmax)))
+			best_fit_node = NULL;
 	}
-	best_fit_node = NULL;
 
 	/* find a best node to accommodate q resource request */
-	qdma_list_for_each_safe(entry, tmp, free_list_head) {
-		struct qdma_resource_entry *node =
-		(struct qdma_resource_entry *)QDMA_LIST_GET_DATA(entry);
-
-		if (node->total_q >= qmax) {
-			if (!best_fit_node || (best_fit_node->total_q >=
-					node->total_q)) {
-				best_fit_node = node;
-				qbase = best_fit_node->qbase;
-			}
-		}
+	if (!best_fit_node) {
+		best_fit_node = qdma_free_entry_best_fit(q_resource, qmax);
+		if (!best_fit_node)
+			return -QDMA_ERR_RM_NO_QUEUES_LEFT;
+		qbase = best_fit_node->qbase;
 	}
 
-fragment_free_list:
-	if (!best_fit_node)
-		return NULL;
-
-	if ((qbase == best_fit_node->qbase) &&
-			(qmax == best_fit_node->total_q))
-		return best_fit_node;
+	start = best_fit_node->qbase;
+	end = start + best_fit_node->total_q;
 
 	/* split free resource node accordingly */
-	if ((qbase == best_fit_node->qbase) &&
-			(qmax != best_fit_node->total_q)) {
-		/*
-		 * create an extra node to hold the extra queues from this node
-		 */
-		struct qdma_resource_entry *new_entry = NULL;
-		int lqbase = best_fit_node->qbase + qmax;
-		uint32_t lqmax = best_fit_node->total_q - qmax;
-
-		new_entry = qdma_free_entry_create(lqbase, lqmax);
-		if (new_entry == NULL)
-			return NULL;
-		QDMA_LIST_SET_DATA(&new_entry->node, new_entry);
-		qdma_list_insert_after(&new_entry->node,
-				       &best_fit_node->node);
-		best_fit_node->total_q -= lqmax;
-	} else if ((qbase > best_fit_node->qbase) &&
-			((qbase + qmax) == (best_fit_node->qbase +
-					best_fit_node->total_q))) {
-		/*
-		 * create an extra node to hold the extra queues from this node
-		 */
-		struct qdma_resource_entry *new_entry = NULL;
-		int lqbase = best_fit_node->qbase;
-		uint32_t lqmax = qbase - best_fit_node->qbase;
-
-		new_entry = qdma_free_entry_create(lqbase, lqmax);
-		if (new_entry == NULL)
-			return NULL;
-		QDMA_LIST_SET_DATA(&new_entry->node, new_entry);
-		qdma_list_insert_before(&new_entry->node,
-					&best_fit_node->node);
-		best_fit_node->total_q = qmax;
-		best_fit_node->qbase = qbase;
+	if (((uint32_t)qbase > start) && ((qbase + qmax) < end)) {
+		/* the node keeps the head, a new node holds the tail */
+		tail = qdma_free_entry_create(qbase + qmax,
+				end - (qbase + qmax));
+		if (tail == NULL)
+			return -QDMA_ERR_NO_MEM;
+		qdma_free_entry_remove(q_resource, best_fit_node);
+		best_fit_node->total_q = qbase - start;
+		qdma_free_entry_insert(q_resource, best_fit_node);
+		qdma_free_entry_insert(q_resource, tail);
+	} else if ((uint32_t)qbase > start) {
+		qdma_free_entry_remove(q_resource, best_fit_node);
+		best_fit_node->total_q = qbase - start;
+		qdma_free_entry_insert(q_resource, best_fit_node);
+	} else if ((qbase + qmax) < end) {
+		qdma_free_entry_remove(q_resource, best_fit_node);
+		best_fit_node->qbase = qbase + qmax;
+		best_fit_node->total_q = end - (qbase + qmax);
+		qdma_free_entry_insert(q_resource, best_fit_node);
 	} else {
-		/*
-		 * create two extra node to hold the extra queues from this node
-		 */
-		struct qdma_resource_entry *new_entry = NULL;
-		int lqbase = best_fit_node->qbase;
-		uint32_t lqmax = qbase - best_fit_node->qbase;
-
-		new_entry = qdma_free_entry_create(lqbase, lqmax);
-		if (new_entry == NULL)
-			return NULL;
-		QDMA_LIST_SET_DATA(&new_entry->node, new_entry);
-		qdma_list_insert_before(&new_entry->node,
-					&best_fit_node->node);
-
-		best_fit_node->qbase = qbase;
-		best_fit_node->total_q -= lqmax;
-
-		lqbase = best_fit_node->qbase + qmax;
-		lqmax = best_fit_node->total_q - qmax;
-
-		new_entry = qdma_free_entry_create(lqbase, lqmax);
-		if (new_entry == NULL)
-			return NULL;
-		QDMA_LIST_SET_DATA(&new_entry->node, new_entry);
-		qdma_list_insert_after(&new_entry->node,
-				       &best_fit_node->node);
-		best_fit_node->total_q = qmax;
+		qdma_free_entry_remove(q_resource, best_fit_node);
+		qdma_memfree(best_fit_node);
 	}
 
-	return best_fit_node;
+	return qbase;
 }
 
 static int qdma_request_q_resource(struct qdma_dev_entry *dev_entry,
 				    uint32_t new_qmax, int new_qbase,
-				    struct qdma_list_head *free_list_head)
+				    struct qdma_resource_master *q_resource)
 {
-	uint32_t qmax = dev_entry->entry.total_q;
-	int qbase = dev_entry->entry.qbase;
-	struct qdma_resource_entry *free_entry_node = NULL;
+	uint32_t qmax = dev_entry->total_q;
+	int qbase = dev_entry->qbase;
 	int rv = QDMA_SUCCESS;
+	int alloc_qbase;
 
 	/* submit already allocated queues back to free list before requesting
 	 * new resource
 	 */
-	qdma_submit_to_free_list(dev_entry, free_list_head);
+	qdma_submit_to_free_list(dev_entry, q_resource);
 
 	if (!new_qmax)
 		return 0;
 	/* check if the request can be accomodated */
-	free_entry_node = qdma_get_resource_node(new_qmax, new_qbase,
-						 free_list_head);
-	if (free_entry_node == NULL) {
+	alloc_qbase = qdma_get_resource_node(new_qmax, new_qbase, q_resource);
+	if (alloc_qbase < 0) {
 		/* request cannot be accommodated. Restore the dev_entry */
-		free_entry_node = qdma_get_resource_node(qmax, qbase,
-							 free_list_head);
 		rv = -QDMA_ERR_RM_NO_QUEUES_LEFT;
 		qdma_log_error("%s: Not enough queues, err:%d\n", __func__,
 					   -QDMA_ERR_RM_NO_QUEUES_LEFT);
-		if (free_entry_node == NULL) {
-			dev_entry->entry.qbase = -1;
-			dev_entry->entry.total_q = 0;
+		new_qmax = qmax;
+		alloc_qbase = -1;
+		if (qmax)
+			alloc_qbase = qdma_get_resource_node(qmax, qbase,
+							     q_resource);
+		if (alloc_qbase < 0) {
+			dev_entry->qbase = -1;
+			dev_entry->total_q = 0;
 
 			return rv;
 		}
 	}
 
-	dev_entry->entry.qbase = free_entry_node->qbase;
-	dev_entry->entry.total_q = free_entry_node->total_q;
-
-	qdma_list_del(&free_entry_node->node);
-	qdma_memfree(free_entry_node);
+	dev_entry->qbase = alloc_qbase;
+	dev_entry->total_q = new_qmax;
 
 	return rv;
 }
@@ -381,14 +604,17 @@ int qdma_master_resource_create(uint32_t bus_start, uint32_t bus_end,
 	struct qdma_resource_entry *free_entry;
 	static int index;
 
+	qdma_resource_lock_take();
 	q_resource = qdma_find_master_resource_entry(bus_start, bus_end);
 	if (q_resource) {
 		*dma_device_index = q_resource->dma_device_index;
+		qdma_resource_lock_give();
 		qdma_log_debug("%s: Resource already created", __func__);
 		qdma_log_debug("for this device(%d)\n",
 				q_resource->dma_device_index);
 		return -QDMA_ERR_RM_RES_EXISTS;
 	}
+	qdma_resource_lock_give();
 
 	*dma_device_index = index;
 
@@ -401,8 +627,7 @@ int qdma_master_resource_create(uint32_t bus_start, uint32_t bus_end,
 		return -QDMA_ERR_NO_MEM;
 	}
 
-	free_entry = (struct qdma_resource_entry *)
-		qdma_calloc(1, sizeof(struct qdma_resource_entry));
+	free_entry = qdma_free_entry_create(q_base, total_q);
 	if (!free_entry) {
 		qdma_memfree(q_resource);
 		qdma_log_error("%s: no memory for free_entry, err:%d\n",
@@ -417,17 +642,13 @@ int qdma_master_resource_create(uint32_t bus_start, uint32_t bus_end,
 	q_resource->pci_bus_end = bus_end;
 	q_resource->total_q = total_q;
 	q_resource->qbase = q_base;
-	qdma_list_init_head(&q_resource->dev_list);
-	qdma_list_init_head(&q_resource->free_list);
 	QDMA_LIST_SET_DATA(&q_resource->node, q_resource);
-	QDMA_LIST_SET_DATA(&q_resource->free_list, q_resource);
 	qdma_list_add_tail(&q_resource->node, &master_resource_list);
 
-
-	free_entry->total_q = total_q;
-	free_entry->qbase = q_base;
-	QDMA_LIST_SET_DATA(&free_entry->node, free_entry);
-	qdma_list_add_tail(&free_entry->node, &q_resource->free_list);
+	if (total_q)
+		qdma_free_entry_insert(q_resource, free_entry);
+	else
+		qdma_memfree(free_entry);
 	qdma_resource_lock_give();
 
 	qdma_log_debug("%s: New master resource created at %d",
@@ -439,25 +660,15 @@ int qdma_master_resource_create(uint32_t bus_start, uint32_t bus_end,
 
 void qdma_master_resource_destroy(uint32_t dma_device_index)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
-	struct qdma_list_head *entry, *tmp;
+	struct qdma_resource_master *q_resource;
 
-	if (!q_resource)
-		return;
 	qdma_resource_lock_take();
-	if (!qdma_list_is_empty(&q_resource->dev_list)) {
+	q_resource = qdma_get_master_resource_entry(dma_device_index);
+	if (!q_resource || q_resource->dev_cnt) {
 		qdma_resource_lock_give();
 		return;
 	}
-	qdma_list_for_each_safe(entry, tmp, &q_resource->free_list) {
-		struct qdma_resource_entry *free_entry =
-			(struct qdma_resource_entry *)
-				QDMA_LIST_GET_DATA(entry);
-
-		qdma_list_del(&free_entry->node);
-		qdma_memfree(free_entry);
-	}
+	qdma_free_tree_destroy(q_resource->free_addr_root);
 	qdma_list_del(&q_resource->node);
 	qdma_memfree(q_resource);
 	qdma_resource_lock_give();
@@ -466,11 +677,13 @@ void qdma_master_resource_destroy(uint32_t dma_device_index)
 
 int qdma_dev_entry_create(uint32_t dma_device_index, uint16_t func_id)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
+	struct qdma_resource_master *q_resource;
 	struct qdma_dev_entry *dev_entry;
 
+	qdma_resource_lock_take();
+	q_resource = qdma_get_master_resource_entry(dma_device_index);
 	if (!q_resource) {
+		qdma_resource_lock_give();
 		qdma_log_error("%s: Queue resource not found, err: %d\n",
 					__func__,
 					-QDMA_ERR_RM_RES_NOT_EXISTS);
@@ -479,7 +692,6 @@ int qdma_dev_entry_create(uint32_t dma_device_index, uint16_t func_id)
 
 	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
 	if (!dev_entry) {
-		qdma_resource_lock_take();
 		dev_entry = (struct qdma_dev_entry *)
 			qdma_calloc(1, sizeof(struct qdma_dev_entry));
 		if (dev_entry == NULL) {
@@ -490,15 +702,18 @@ int qdma_dev_entry_create(uint32_t dma_device_index, uint16_t func_id)
 			return -QDMA_ERR_NO_MEM;
 		}
 		dev_entry->func_id = func_id;
-		dev_entry->entry.qbase = -1;
-		dev_entry->entry.total_q = 0;
-		QDMA_LIST_SET_DATA(&dev_entry->entry.node, dev_entry);
-		qdma_list_add_tail(&dev_entry->entry.node,
-				   &q_resource->dev_list);
+		dev_entry->qbase = -1;
+		dev_entry->total_q = 0;
+		dev_entry->q_resource = q_resource;
+		QDMA_LIST_SET_DATA(&dev_entry->node, dev_entry);
+		qdma_list_add_tail(&dev_entry->node,
+			&dev_hash[qdma_dev_hash(dma_device_index, func_id)]);
+		q_resource->dev_cnt++;
 		qdma_resource_lock_give();
 		qdma_log_info("%s: Created the dev entry successfully\n",
 						__func__);
 	} else {
+		qdma_resource_lock_give();
 		qdma_log_error("%s: Dev entry already created, err = %d\n",
 						__func__,
 						-QDMA_ERR_RM_DEV_EXISTS);
@@ -510,24 +725,24 @@ int qdma_dev_entry_create(uint32_t dma_device_index, uint16_t func_id)
 
 void qdma_dev_entry_destroy(uint32_t dma_device_index, uint16_t func_id)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
 	struct qdma_dev_entry *dev_entry;
+	int rv;
 
-	if (!q_resource) {
-		qdma_log_error("%s: Queue resource not found.\n", __func__);
-		return;
-	}
-
-	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
+	qdma_resource_lock_take();
+	dev_entry = qdma_dev_entry_lookup(dma_device_index, func_id, &rv);
 	if (!dev_entry) {
-		qdma_log_error("%s: Dev entry not found\n", __func__);
+		qdma_resource_lock_give();
+		if (rv == -QDMA_ERR_RM_RES_NOT_EXISTS)
+			qdma_log_error("%s: Queue resource not found.\n",
+					__func__);
+		else
+			qdma_log_error("%s: Dev entry not found\n", __func__);
 		return;
 	}
-	qdma_resource_lock_take();
-	qdma_submit_to_free_list(dev_entry, &q_resource->free_list);
+	qdma_submit_to_free_list(dev_entry, dev_entry->q_resource);
 
-	qdma_list_del(&dev_entry->entry.node);
+	qdma_list_del(&dev_entry->node);
+	dev_entry->q_resource->dev_cnt--;
 	qdma_memfree(dev_entry);
 	qdma_resource_lock_give();
 }
@@ -535,28 +750,22 @@ void qdma_dev_entry_destroy(uint32_t dma_device_index, uint16_t func_id)
 int qdma_dev_update(uint32_t dma_device_index, uint16_t func_id,
 		    uint32_t qmax, int *qbase)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
 	struct qdma_dev_entry *dev_entry;
 	int rv;
 
-	if (!q_resource) {
-		qdma_log_error("%s: Queue resource not found, err: %d\n",
-				__func__, -QDMA_ERR_RM_RES_NOT_EXISTS);
-		return -QDMA_ERR_RM_RES_NOT_EXISTS;
-	}
-
-	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
-
+	qdma_resource_lock_take();
+	dev_entry = qdma_dev_entry_lookup(dma_device_index, func_id, &rv);
 	if (!dev_entry) {
-		qdma_log_error("%s: Dev Entry not found, err: %d\n",
-					__func__,
-					-QDMA_ERR_RM_DEV_NOT_EXISTS);
-		return -QDMA_ERR_RM_DEV_NOT_EXISTS;
+		qdma_resource_lock_give();
+		if (rv == -QDMA_ERR_RM_RES_NOT_EXISTS)
+			qdma_log_error("%s: Queue resource not found, err: %d\n",
+					__func__, rv);
+		else
+			qdma_log_error("%s: Dev Entry not found, err: %d\n",
+					__func__, rv);
+		return rv;
 	}
 
-	qdma_resource_lock_take();
-
 	/* if any active queue on device, no more new qmax
 	 * configuration allowed
 	 */
@@ -570,9 +779,9 @@ int qdma_dev_update(uint32_t dma_device_index, uint16_t func_id,
 	}
 
 	rv = qdma_request_q_resource(dev_entry, qmax, *qbase,
-				&q_resource->free_list);
+				dev_entry->q_resource);
 
-	*qbase = dev_entry->entry.qbase;
+	*qbase = dev_entry->qbase;
 	qdma_resource_lock_give();
 
 
@@ -582,26 +791,24 @@ int qdma_dev_update(uint32_t dma_device_index, uint16_t func_id,
 int qdma_dev_qinfo_get(uint32_t dma_device_index, uint16_t func_id,
 		       int *qbase, uint32_t *qmax)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
 	struct qdma_dev_entry *dev_entry;
+	int rv;
 
-	if (!q_resource) {
-		qdma_log_error("%s: Queue resource not found, err: %d\n",
-				__func__, -QDMA_ERR_RM_RES_NOT_EXISTS);
-		return -QDMA_ERR_RM_RES_NOT_EXISTS;
-	}
-
-	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
-
+	qdma_resource_lock_take();
+	dev_entry = qdma_dev_entry_lookup(dma_device_index, func_id, &rv);
 	if (!dev_entry) {
-		qdma_log_debug("%s: Dev Entry not created yet\n", __func__);
-		return -QDMA_ERR_RM_DEV_NOT_EXISTS;
+		qdma_resource_lock_give();
+		if (rv == -QDMA_ERR_RM_RES_NOT_EXISTS)
+			qdma_log_error("%s: Queue resource not found, err: %d\n",
+					__func__, rv);
+		else
+			qdma_log_debug("%s: Dev Entry not created yet\n",
+					__func__);
+		return rv;
 	}
 
-	qdma_resource_lock_take();
-	*qbase = dev_entry->entry.qbase;
-	*qmax = dev_entry->entry.total_q;
+	*qbase = dev_entry->qbase;
+	*qmax = dev_entry->total_q;
 	qdma_resource_lock_give();
 
 	return QDMA_SUCCESS;
@@ -611,29 +818,26 @@ enum qdma_dev_q_range qdma_dev_is_queue_in_range(uint32_t dma_device_index,
 						 uint16_t func_id,
 						 uint32_t qid_hw)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
 	struct qdma_dev_entry *dev_entry;
 	uint32_t qmax;
+	int rv;
 
-	if (!q_resource) {
-		qdma_log_error("%s: Queue resource not found, err: %d\n",
-				__func__, -QDMA_ERR_RM_RES_NOT_EXISTS);
-		return QDMA_DEV_Q_OUT_OF_RANGE;
-	}
-
-	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
-
+	qdma_resource_lock_take();
+	dev_entry = qdma_dev_entry_lookup(dma_device_index, func_id, &rv);
 	if (!dev_entry) {
-		qdma_log_error("%s: Dev entry not found, err: %d\n",
-				__func__, -QDMA_ERR_RM_DEV_NOT_EXISTS);
+		qdma_resource_lock_give();
+		if (rv == -QDMA_ERR_RM_RES_NOT_EXISTS)
+			qdma_log_error("%s: Queue resource not found, err: %d\n",
+					__func__, rv);
+		else
+			qdma_log_error("%s: Dev entry not found, err: %d\n",
+					__func__, rv);
 		return QDMA_DEV_Q_OUT_OF_RANGE;
 	}
 
-	qdma_resource_lock_take();
-	qmax = dev_entry->entry.qbase + dev_entry->entry.total_q;
-	if (dev_entry->entry.total_q && (qid_hw < qmax) &&
-			((int)qid_hw >= dev_entry->entry.qbase)) {
+	qmax = dev_entry->qbase + dev_entry->total_q;
+	if (dev_entry->total_q && (qid_hw < qmax) &&
+			((int)qid_hw >= dev_entry->qbase)) {
 		qdma_resource_lock_give();
 		return QDMA_DEV_Q_IN_RANGE;
 	}
@@ -642,53 +846,53 @@ enum qdma_dev_q_range qdma_dev_is_queue_in_range(uint32_t dma_device_index,
 	return QDMA_DEV_Q_OUT_OF_RANGE;
 }
 
+static uint32_t *qdma_dev_active_qcnt(struct qdma_dev_entry *dev_entry,
+				      enum qdma_dev_q_type q_type)
+{
+	switch (q_type) {
+	case QDMA_DEV_Q_TYPE_H2C:
+		return &dev_entry->active_h2c_qcnt;
+	case QDMA_DEV_Q_TYPE_C2H:
+		return &dev_entry->active_c2h_qcnt;
+	case QDMA_DEV_Q_TYPE_CMPT:
+		return &dev_entry->active_cmpt_qcnt;
+	default:
+		return NULL;
+	}
+}
+
 int qdma_dev_increment_active_queue(uint32_t dma_device_index, uint16_t func_id,
 				    enum qdma_dev_q_type q_type)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
 	struct qdma_dev_entry *dev_entry;
 	int rv = QDMA_SUCCESS;
 	uint32_t *active_qcnt = NULL;
 
-	if (!q_resource) {
-		qdma_log_error("%s: Queue resource not found, err: %d\n",
-				__func__, -QDMA_ERR_RM_RES_NOT_EXISTS);
-		return -QDMA_ERR_RM_RES_NOT_EXISTS;
-	}
-
-	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
-
+	qdma_resource_lock_take();
+	dev_entry = qdma_dev_entry_lookup(dma_device_index, func_id, &rv);
 	if (!dev_entry) {
-		qdma_log_error("%s: Dev Entry not found, err: %d\n",
-					__func__,
-					-QDMA_ERR_RM_DEV_NOT_EXISTS);
-		return -QDMA_ERR_RM_DEV_NOT_EXISTS;
+		qdma_resource_lock_give();
+		if (rv == -QDMA_ERR_RM_RES_NOT_EXISTS)
+			qdma_log_error("%s: Queue resource not found, err: %d\n",
+					__func__, rv);
+		else
+			qdma_log_error("%s: Dev Entry not found, err: %d\n",
+					__func__, rv);
+		return rv;
 	}
 
-	qdma_resource_lock_take();
-	switch (q_type) {
-	case QDMA_DEV_Q_TYPE_H2C:
-		active_qcnt = &dev_entry->active_h2c_qcnt;
-		break;
-	case QDMA_DEV_Q_TYPE_C2H:
-		active_qcnt = &dev_entry->active_c2h_qcnt;
-		break;
-	case QDMA_DEV_Q_TYPE_CMPT:
-		active_qcnt = &dev_entry->active_cmpt_qcnt;
-		break;
-	default:
+	active_qcnt = qdma_dev_active_qcnt(dev_entry, q_type);
+	if (!active_qcnt)
 		rv = -QDMA_ERR_RM_DEV_NOT_EXISTS;
-	}
 
-	if (active_qcnt && (dev_entry->entry.total_q < ((*active_qcnt) + 1))) {
+	if (active_qcnt && (dev_entry->total_q < ((*active_qcnt) + 1))) {
 		qdma_resource_lock_give();
 		return -QDMA_ERR_RM_NO_QUEUES_LEFT;
 	}
 
 	if (active_qcnt) {
 		*active_qcnt = (*active_qcnt) + 1;
-		q_resource->active_qcnt++;
+		dev_entry->q_resource->active_qcnt++;
 	}
 	qdma_resource_lock_give();
 
@@ -699,44 +903,29 @@ int qdma_dev_increment_active_queue(uint32_t dma_device_index, uint16_t func_id,
 int qdma_dev_decrement_active_queue(uint32_t dma_device_index, uint16_t func_id,
 				    enum qdma_dev_q_type q_type)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
 	struct qdma_dev_entry *dev_entry;
 	int rv = QDMA_SUCCESS;
+	uint32_t *active_qcnt;
 
-	if (!q_resource) {
-		qdma_log_error("%s: Queue resource not found, err: %d\n",
-				__func__,
-			   -QDMA_ERR_RM_RES_NOT_EXISTS);
-		return -QDMA_ERR_RM_RES_NOT_EXISTS;
-	}
-
-	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
-
+	qdma_resource_lock_take();
+	dev_entry = qdma_dev_entry_lookup(dma_device_index, func_id, &rv);
 	if (!dev_entry) {
-		qdma_log_error("%s: Dev entry not found, err: %d\n",
-				__func__, -QDMA_ERR_RM_DEV_NOT_EXISTS);
-		return -QDMA_ERR_RM_DEV_NOT_EXISTS;
+		qdma_resource_lock_give();
+		if (rv == -QDMA_ERR_RM_RES_NOT_EXISTS)
+			qdma_log_error("%s: Queue resource not found, err: %d\n",
+					__func__, rv);
+		else
+			qdma_log_error("%s: Dev entry not found, err: %d\n",
+					__func__, rv);
+		return rv;
 	}
 
-	qdma_resource_lock_take();
-	switch (q_type) {
-	case QDMA_DEV_Q_TYPE_H2C:
-		if (dev_entry->active_h2c_qcnt)
-			dev_entry->active_h2c_qcnt--;
-		break;
-	case QDMA_DEV_Q_TYPE_C2H:
-		if (dev_entry->active_c2h_qcnt)
-			dev_entry->active_c2h_qcnt--;
-		break;
-	case QDMA_DEV_Q_TYPE_CMPT:
-		if (dev_entry->active_cmpt_qcnt)
-			dev_entry->active_cmpt_qcnt--;
-		break;
-	default:
+	active_qcnt = qdma_dev_active_qcnt(dev_entry, q_type);
+	if (!active_qcnt)
 		rv = -QDMA_ERR_RM_DEV_NOT_EXISTS;
-	}
-	q_resource->active_qcnt--;
+	else if (*active_qcnt)
+		(*active_qcnt)--;
+	dev_entry->q_resource->active_qcnt--;
 	qdma_resource_lock_give();
 
 	return rv;
@@ -744,15 +933,13 @@ int qdma_dev_decrement_active_queue(uint32_t dma_device_index, uint16_t func_id,
 
 uint32_t qdma_get_active_queue_count(uint32_t dma_device_index)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
-	uint32_t q_cnt;
-
-	if (!q_resource)
-		return QDMA_SUCCESS;
+	struct qdma_resource_master *q_resource;
+	uint32_t q_cnt = 0;
 
 	qdma_resource_lock_take();
-	q_cnt = q_resource->active_qcnt;
+	q_resource = qdma_get_master_resource_entry(dma_device_index);
+	if (q_resource)
+		q_cnt = q_resource->active_qcnt;
 	qdma_resource_lock_give();
 
 	return q_cnt;
@@ -762,33 +949,21 @@ int qdma_get_device_active_queue_count(uint32_t dma_device_index,
 					uint16_t func_id,
 					enum qdma_dev_q_type q_type)
 {
-	struct qdma_resource_master *q_resource =
-			qdma_get_master_resource_entry(dma_device_index);
 	struct qdma_dev_entry *dev_entry;
+	uint32_t *active_qcnt;
 	uint32_t dev_active_qcnt = 0;
-
-	if (!q_resource)
-		return -QDMA_ERR_RM_RES_NOT_EXISTS;
-
-	dev_entry = qdma_get_dev_entry(dma_device_index, func_id);
-
-	if (!dev_entry)
-		return -QDMA_ERR_RM_DEV_NOT_EXISTS;
+	int rv;
 
 	qdma_resource_lock_take();
-	switch (q_type) {
-	case QDMA_DEV_Q_TYPE_H2C:
-		dev_active_qcnt = dev_entry->active_h2c_qcnt;
-		break;
-	case QDMA_DEV_Q_TYPE_C2H:
-		dev_active_qcnt = dev_entry->active_c2h_qcnt;
-		break;
-	case QDMA_DEV_Q_TYPE_CMPT:
-		dev_active_qcnt = dev_entry->active_cmpt_qcnt;
-		break;
-	default:
-		dev_active_qcnt = 0;
+	dev_entry = qdma_dev_entry_lookup(dma_device_index, func_id, &rv);
+	if (!dev_entry) {
+		qdma_resource_lock_give();
+		return rv;
 	}
+
+	active_qcnt = qdma_dev_active_qcnt(dev_entry, q_type);
+	if (active_qcnt)
+		dev_active_qcnt = *active_qcnt;
 	qdma_resource_lock_give();
 
 	return dev_active_qcnt;
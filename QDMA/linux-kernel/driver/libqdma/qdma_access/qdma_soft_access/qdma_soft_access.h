@@ -250,6 +250,19 @@ int qdma_soft_read_dump_queue_context(void *dev_hndl,
 				enum qdma_dev_q_type q_type,
 				char *buf, uint32_t buflen);
 
+int qdma_soft_read_queue_context_raw(void *dev_hndl,
+		uint16_t func_id,
+		uint16_t qid_hw,
+		uint8_t st,
+		enum qdma_dev_q_type q_type,
+		struct qdma_descq_ctxt_raw *raw);
+
+int qdma_soft_decode_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		struct qdma_descq_context *ctxt);
+
+int qdma_soft_dump_queue_context_raw(const struct qdma_descq_ctxt_raw *raw,
+		char *buf, uint32_t buflen);
+
 int qdma_hw_error_process(void *dev_hndl);
 
 const char *qdma_hw_get_error_name(uint32_t err_idx);
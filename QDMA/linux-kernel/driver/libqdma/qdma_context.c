@@ -838,8 +838,9 @@ int qdma_intr_context_read(struct xlnx_dma_dev *xdev,
 	return 0;
 }
 
-int qdma_descq_context_program(struct xlnx_dma_dev *xdev, unsigned int qid_hw,
-			bool st, u8 type, struct qdma_descq_context *context)
+static int descq_context_program(struct xlnx_dma_dev *xdev,
+			unsigned int qid_hw, bool st, u8 type,
+			struct qdma_descq_context *context)
 {
 	int rv;
 
@@ -892,6 +893,27 @@ int qdma_descq_context_program(struct xlnx_dma_dev *xdev, unsigned int qid_hw,
 	return 0;
 }
 
+int qdma_descq_context_program(struct xlnx_dma_dev *xdev, unsigned int qid_hw,
+			bool st, u8 type, struct qdma_descq_context *context)
+{
+	int rv, batch_rv;
+
+	/* issue the clear and program commands back to back */
+	rv = xdev->hw.qdma_ctxt_batch_start(xdev);
+	if (rv < 0)
+		return xdev->hw.qdma_get_error_code(rv);
+
+	rv = descq_context_program(xdev, qid_hw, st, type, context);
+
+	batch_rv = xdev->hw.qdma_ctxt_batch_end(xdev);
+	if (!rv && (batch_rv < 0)) {
+		pr_err("failed to program the context, rv= %d", batch_rv);
+		return xdev->hw.qdma_get_error_code(batch_rv);
+	}
+
+	return rv;
+}
+
 int qdma_descq_context_dump(struct qdma_descq *descq, char *buf, int buflen)
 {
 	int rv = 0;
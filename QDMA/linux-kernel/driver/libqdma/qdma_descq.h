@@ -29,6 +29,7 @@
 #include "qdma_compat.h"
 #include "libqdma_export.h"
 #include "qdma_regs.h"
+#include "qdma_access_fixed_ip.h"
 #ifdef ERR_DEBUG
 #include "qdma_nl.h"
 #endif
@@ -499,6 +500,47 @@ int parse_cmpl_entry(struct qdma_descq *descq, struct qdma_ul_cmpt_info *cmpl);
 void cmpt_next(struct qdma_descq *descq);
 
 /* CIDX/PIDX update macros */
+#ifdef QDMA_FIXED_IP
+/* single IP variant build, the doorbells are written directly */
+#ifndef __QDMA_VF__
+#define QDMA_DESCQ_IS_VF	0
+#else
+#define QDMA_DESCQ_IS_VF	1
+#endif
+
+static inline int queue_pidx_update(struct xlnx_dma_dev *xdev, u16 qid,
+		u8 is_c2h, const struct qdma_q_pidx_reg_info *pidx_info)
+{
+	u32 val;
+	u32 reg = qdma_fixed_ip_pidx_reg(QDMA_DESCQ_IS_VF, qid, is_c2h,
+			pidx_info, &val);
+
+	writel(val, xdev->regs + reg);
+	return 0;
+}
+
+static inline int queue_cmpt_cidx_update(struct xlnx_dma_dev *xdev, u16 qid,
+		const struct qdma_q_cmpt_cidx_reg_info *cmpt_cidx_info)
+{
+	u32 val;
+	u32 reg = qdma_fixed_ip_cmpt_cidx_reg(QDMA_DESCQ_IS_VF, qid,
+			cmpt_cidx_info, &val);
+
+	writel(val, xdev->regs + reg);
+	return 0;
+}
+
+static inline int queue_intr_cidx_update(struct xlnx_dma_dev *xdev, u16 qid,
+		const struct qdma_intr_cidx_reg_info *intr_cidx_info)
+{
+	u32 val;
+	u32 reg = qdma_fixed_ip_intr_cidx_reg(QDMA_DESCQ_IS_VF, qid,
+			intr_cidx_info, &val);
+
+	writel(val, xdev->regs + reg);
+	return 0;
+}
+#else
 #ifndef __QDMA_VF__
 #define queue_pidx_update(xdev, qid, is_c2h, pidx_info) \
 	(xdev->hw.qdma_queue_pidx_update(xdev, QDMA_DEV_PF, qid, is_c2h,\
@@ -519,16 +561,6 @@ void cmpt_next(struct qdma_descq *descq);
 					     cmpt_cidx_info))
 #endif
 
-#ifndef __QDMA_VF__
-#define queue_cmpt_cidx_read(xdev, qid, cmpt_cidx_info) \
-	(xdev->hw.qdma_queue_cmpt_cidx_read(xdev, QDMA_DEV_PF, qid, \
-					   cmpt_cidx_info))
-#else
-#define queue_cmpt_cidx_read(xdev, qid, cmpt_cidx_info) \
-	(xdev->hw.qdma_queue_cmpt_cidx_read(xdev, QDMA_DEV_VF, qid, \
-					   cmpt_cidx_info))
-#endif
-
 #ifndef __QDMA_VF__
 #define queue_intr_cidx_update(xdev, qid, intr_cidx_info) \
 	(xdev->hw.qdma_queue_intr_cidx_update(xdev, QDMA_DEV_PF, qid, \
@@ -538,6 +570,17 @@ void cmpt_next(struct qdma_descq *descq);
 	(xdev->hw.qdma_queue_intr_cidx_update(xdev, QDMA_DEV_VF, qid, \
 						intr_cidx_info))
 #endif
+#endif /* QDMA_FIXED_IP */
+
+#ifndef __QDMA_VF__
+#define queue_cmpt_cidx_read(xdev, qid, cmpt_cidx_info) \
+	(xdev->hw.qdma_queue_cmpt_cidx_read(xdev, QDMA_DEV_PF, qid, \
+					   cmpt_cidx_info))
+#else
+#define queue_cmpt_cidx_read(xdev, qid, cmpt_cidx_info) \
+	(xdev->hw.qdma_queue_cmpt_cidx_read(xdev, QDMA_DEV_VF, qid, \
+					   cmpt_cidx_info))
+#endif
 
 u64 rdtsc_gettime(void);
 static inline unsigned int get_next_powof2(unsigned int value)
@@ -21,6 +21,7 @@
 #include "qdma_access_errors.h"
 #include <linux/errno.h>
 #include <linux/delay.h>
+#include <linux/sched.h>
 
 static struct err_code_map error_code_map_list[] = {
 	{QDMA_SUCCESS,				0},
@@ -71,6 +72,11 @@ void qdma_udelay(u32 delay_us)
 	udelay(delay_us);
 }
 
+u64 qdma_get_thread_id(void)
+{
+	return (u64)(uintptr_t)current;
+}
+
 int qdma_reg_access_lock(void *dev_hndl)
 {
 	struct xlnx_dma_dev *xdev = (struct xlnx_dma_dev *)dev_hndl;
@@ -0,0 +1,36 @@
+#!/bin/bash
+#
+# Sweep multi-MB transfer sizes on one H2C and one C2H channel and report the
+# average bandwidth of each size. A single request of several MB spans more
+# descriptors than the 0x800 ring holds: the driver runs it as a chain of
+# transfers and the bandwidth should stay flat as the size grows.
+#
+tool_path=../tools
+
+if [ "$#" -lt 2 ]; then
+  echo "usage $0 <h2c channel> <c2h channel> [io min] [io max] [iterations]"
+  echo -e "\tio min, io max: dma size in byte, doubles each time,"
+  echo -e "\t\tdefault 1MB ~ 64MB"
+  exit -1
+fi
+
+h2c=/dev/xdma0_h2c_$1
+c2h=/dev/xdma0_c2h_$2
+io_min=${3:-1048576}
+io_max=${4:-67108864}
+iter=${5:-16}
+
+out=pipeline_log.txt
+rm -f $out
+
+printf "%12s %16s %16s\n" "bytes" "H2C BW (MB/s)" "C2H BW (MB/s)" | tee -a $out
+size=$io_min
+while [ $size -le $io_max ]; do
+	h2c_bw=$($tool_path/dma_to_device -d $h2c -s $size -c $iter | \
+		grep "Average BW" | awk -F', ' '{print $2}')
+	c2h_bw=$($tool_path/dma_from_device -d $c2h -s $size -c $iter | \
+		grep "Average BW" | awk -F', ' '{print $2}')
+	printf "%12u %16s %16s\n" $size "${h2c_bw:-error}" "${c2h_bw:-error}" \
+		| tee -a $out
+	size=$(($size * 2))
+done
@@ -26,6 +26,7 @@
 #include "../xdma/cdev_sgdma.h"
 
 #include "dma_utils.c"
+#include "dma_uring.c"
 
 #define DEVICE_NAME_DEFAULT "/dev/xdma0_c2h_0"
 #define SIZE_DEFAULT (32)
@@ -40,6 +41,8 @@ static struct option const long_opts[] = {
 	{"count", required_argument, NULL, 'c'},
 	{"file", required_argument, NULL, 'f'},
 	{"eop_flush", no_argument, NULL, 'e'},
+	{"registered", no_argument, NULL, 'r'},
+	{"uring", no_argument, NULL, 'u'},
 	{"help", no_argument, NULL, 'h'},
 	{"verbose", no_argument, NULL, 'v'},
 	{0, 0, 0, 0}
@@ -49,6 +52,8 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 		uint64_t size, uint64_t offset, uint64_t count,
 		char *ofname);
 static int eop_flush = 0;
+static int registered;
+static int uring;
 
 static void usage(const char *name)
 {
@@ -88,6 +93,16 @@ static void usage(const char *name)
 	fprintf(stdout,
 		 "\t\t* acutal # of bytes dma'ed could be smaller than specified\n");
 	i++;
+	fprintf(stdout,
+		"  -%c (--%s) register the buffer with the driver once, no "
+		"per transfer pinning\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) submit through io_uring against the registered "
+		"buffer\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
 	fprintf(stdout, "  -%c (--%s) print usage help and exit\n",
 		long_opts[i].val, long_opts[i].name);
 	i++;
@@ -112,7 +127,7 @@ int main(int argc, char *argv[])
 	uint64_t count = COUNT_DEFAULT;
 	char *ofname = NULL;
 
-	while ((cmd_opt = getopt_long(argc, argv, "vhec:f:d:a:k:s:o:", long_opts,
+	while ((cmd_opt = getopt_long(argc, argv, "vheruc:f:d:a:k:s:o:", long_opts,
 			    NULL)) != -1) {
 		switch (cmd_opt) {
 		case 0:
@@ -145,6 +160,12 @@ int main(int argc, char *argv[])
 		case 'f':
 			ofname = strdup(optarg);
 			break;
+		case 'r':
+			registered = 1;
+			break;
+		case 'u':
+			uring = 1;
+			break;
 			/* print usage help and exit */
 		case 'v':
 			verbose = 1;
@@ -159,6 +180,12 @@ int main(int argc, char *argv[])
 			break;
 		}
 	}
+	if (aperture && (registered || uring)) {
+		fprintf(stderr, "aperture and registered buffers exclude each "
+			"other.\n");
+		exit(1);
+	}
+
 	if (verbose)
 	fprintf(stdout,
 		"dev %s, addr 0x%lx, aperture 0x%lx, size 0x%lx, offset 0x%lx, "
@@ -179,6 +206,8 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 	char *buffer = NULL;
 	char *allocated = NULL;
 	struct timespec ts_start, ts_end;
+	struct dma_uring ring = { .fd = -1 };
+	uint32_t handle = 0;
 	int out_fd = -1;
 	int fpga_fd;
 	long total_time = 0;
@@ -226,6 +255,18 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 	if (verbose)
 	fprintf(stdout, "host buffer 0x%lx, %p.\n", size + 4096, buffer);
 
+	/* pinned and mapped once, the transfers below only reference it */
+	if (registered || uring) {
+		rc = dma_register_buf(fpga_fd, buffer, size, &handle);
+		if (rc < 0)
+			goto out;
+	}
+	if (uring) {
+		rc = dma_uring_init(&ring, 4);
+		if (rc < 0)
+			goto out;
+	}
+
 	for (i = 0; i < count; i++) {
 		rc = clock_gettime(CLOCK_MONOTONIC, &ts_start);
 		if (aperture) {
@@ -246,6 +287,16 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 			}
 
 			bytes_done = io.done;
+		} else if (uring) {
+			rc = dma_uring_xfer(&ring, fpga_fd, handle, 0, size,
+					    addr);
+			if (rc < 0) {
+				fprintf(stderr, "#%lu: uring read failed %ld.\n",
+					i, rc);
+				goto out;
+			}
+
+			bytes_done = rc;
 		} else {
 			rc = read_to_buffer(devname, fpga_fd, buffer, size, addr);
 			if (rc < 0)
@@ -263,7 +314,7 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 
 		/* subtract the start time from the end time */
 		timespec_sub(&ts_end, &ts_start);
-		total_time += ts_end.tv_nsec;
+		total_time += ts_end.tv_sec * 1000000000L + ts_end.tv_nsec;
 		/* a bit less accurate but side-effects are accounted for */
 		if (verbose)
 		fprintf(stdout,
@@ -295,6 +346,10 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 		rc = -EIO;
 
 out:
+	if (uring)
+		dma_uring_exit(&ring);
+	if (handle)
+		dma_unregister_buf(fpga_fd, handle);
 	close(fpga_fd);
 	if (out_fd >= 0)
 		close(out_fd);
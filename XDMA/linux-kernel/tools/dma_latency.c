@@ -0,0 +1,119 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver tools for Linux
+ *
+ * Copyright (c) 2016-present,  Xilinx, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "../xdma/cdev_sgdma.h"
+
+static struct option const long_opts[] = {
+	{"device", required_argument, NULL, 'd'},
+	{"reset", no_argument, NULL, 'r'},
+	{"help", no_argument, NULL, 'h'},
+	{0, 0, 0, 0}
+};
+
+#define DEVICE_NAME_DEFAULT "/dev/xdma0_h2c_0"
+
+static const char *mode_name[XDMA_LAT_MODES] = {
+	[XDMA_LAT_MODE_IRQ] = "irq",
+	[XDMA_LAT_MODE_THREAD] = "thread",
+	[XDMA_LAT_MODE_INLINE] = "inline",
+};
+
+static void usage(const char *name)
+{
+	int i = 0;
+
+	fprintf(stdout, "%s\n\n", name);
+	fprintf(stdout, "usage: %s [OPTIONS]\n\n", name);
+	fprintf(stdout,
+		"Print the completion latency percentiles of the engine "
+		"behind a device node,\nper completion mode.\n\n");
+
+	fprintf(stdout, "  -%c (--%s) device (defaults to %s)\n",
+		long_opts[i].val, long_opts[i].name, DEVICE_NAME_DEFAULT);
+	i++;
+	fprintf(stdout, "  -%c (--%s) clear the counts once read\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout, "  -%c (--%s) print usage help and exit\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+
+	fprintf(stdout, "\nReturn code:\n");
+	fprintf(stdout, "  0: success\n");
+	fprintf(stdout, "  < 0: error\n\n");
+}
+
+int main(int argc, char *argv[])
+{
+	struct xdma_latency_ioctl lat;
+	char *device = DEVICE_NAME_DEFAULT;
+	int reset = 0;
+	int cmd_opt;
+	int fd, i, rc;
+
+	while ((cmd_opt = getopt_long(argc, argv, "hrd:", long_opts,
+				      NULL)) != -1) {
+		switch (cmd_opt) {
+		case 0:
+			/* long option */
+			break;
+		case 'd':
+			/* device node name */
+			device = strdup(optarg);
+			break;
+		case 'r':
+			reset = 1;
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(0);
+			break;
+		}
+	}
+
+	fd = open(device, O_RDWR);
+	if (fd < 0) {
+		fprintf(stderr, "unable to open device %s, %d.\n", device, fd);
+		perror("open device");
+		return -EINVAL;
+	}
+
+	memset(&lat, 0, sizeof(lat));
+	lat.version = IOCTL_XDMA_PERF_V1;
+	lat.reset = reset;
+	rc = ioctl(fd, IOCTL_XDMA_PERF_LATENCY, &lat);
+	close(fd);
+	if (rc < 0) {
+		perror("IOCTL_XDMA_PERF_LATENCY");
+		return -errno;
+	}
+
+	printf("%s ** mode, count, p50 ns, p99 ns\n", device);
+	for (i = 0; i < XDMA_LAT_MODES; i++)
+		printf("%s ** %s, %lu, %lu, %lu\n", device, mode_name[i],
+		       lat.mode[i].count, lat.mode[i].p50_ns,
+		       lat.mode[i].p99_ns);
+
+	return 0;
+}
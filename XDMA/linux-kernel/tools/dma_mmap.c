@@ -0,0 +1,232 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver tools for Linux
+ *
+ * Copyright (c) 2016-present,  Xilinx, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree)
+ */
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "dma_utils.c"
+
+static struct option const long_opts[] = {
+	{"device", required_argument, NULL, 'd'},
+	{"address", required_argument, NULL, 'a'},
+	{"min", required_argument, NULL, 's'},
+	{"max", required_argument, NULL, 'm'},
+	{"count", required_argument, NULL, 'c'},
+	{"help", no_argument, NULL, 'h'},
+	{"verbose", no_argument, NULL, 'v'},
+	{0, 0, 0, 0}
+};
+
+#define DEVICE_NAME_DEFAULT "/dev/xdma0_h2c_0"
+#define SIZE_MIN_DEFAULT (4 * 1024)
+#define SIZE_MAX_DEFAULT (64 * 1024 * 1024)
+#define COUNT_DEFAULT (16)
+
+static void usage(const char *name)
+{
+	int i = 0;
+
+	fprintf(stdout, "%s\n\n", name);
+	fprintf(stdout, "usage: %s [OPTIONS]\n\n", name);
+	fprintf(stdout,
+		"Compare the bandwidth of a buffer mmap'ed from the device "
+		"node with a\nmalloc'ed one pinned on every call, doubling the "
+		"transfer size from min to max.\nThe direction follows the "
+		"device name (h2c: write).\n\n");
+
+	fprintf(stdout, "  -%c (--%s) device (defaults to %s)\n",
+		long_opts[i].val, long_opts[i].name, DEVICE_NAME_DEFAULT);
+	i++;
+	fprintf(stdout, "  -%c (--%s) the start address on the AXI bus\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) smallest transfer size in bytes, default %d\n",
+		long_opts[i].val, long_opts[i].name, SIZE_MIN_DEFAULT);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) largest transfer size in bytes, default %d\n",
+		long_opts[i].val, long_opts[i].name, SIZE_MAX_DEFAULT);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) number of transfers per size, default %d\n",
+		long_opts[i].val, long_opts[i].name, COUNT_DEFAULT);
+	i++;
+	fprintf(stdout, "  -%c (--%s) print usage help and exit\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout, "  -%c (--%s) verbose output\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+
+	fprintf(stdout, "\nReturn code:\n");
+	fprintf(stdout, "  0: all bytes were dma'ed successfully\n");
+	fprintf(stdout, "  < 0: error\n\n");
+}
+
+/* bandwidth in GB/s of count transfers of size bytes, < 0 on error */
+static double run_size(int fd, int write, char *buffer, uint64_t addr,
+		       uint64_t size, uint64_t count)
+{
+	struct timespec ts_start, ts_end;
+	uint64_t bytes = 0;
+	uint64_t i;
+	ssize_t rc;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts_start);
+	for (i = 0; i < count; i++) {
+		if (write)
+			rc = pwrite(fd, buffer, size, addr);
+		else
+			rc = pread(fd, buffer, size, addr);
+		if (rc < 0) {
+			fprintf(stderr, "#%lu: %s 0x%lx @ 0x%lx failed %ld.\n",
+				i, write ? "write" : "read", size, addr, rc);
+			perror(write ? "write" : "read");
+			return -EIO;
+		}
+		bytes += rc;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &ts_end);
+
+	timespec_sub(&ts_end, &ts_start);
+	return bytes / (ts_end.tv_sec * 1000000000.0 + ts_end.tv_nsec);
+}
+
+static int test_dma(char *devname, uint64_t addr, uint64_t size_min,
+		    uint64_t size_max, uint64_t count)
+{
+	int write = strstr(devname, "h2c") != NULL;
+	char *pinned = NULL;
+	char *mapped = MAP_FAILED;
+	uint64_t size;
+	double bw_pinned, bw_mapped;
+	int fd;
+	int rc = 0;
+
+	fd = open(devname, O_RDWR);
+	if (fd < 0) {
+		fprintf(stderr, "unable to open device %s, %d.\n",
+			devname, fd);
+		perror("open device");
+		return -EINVAL;
+	}
+
+	posix_memalign((void **)&pinned, 4096 /*alignment */ , size_max);
+	if (!pinned) {
+		fprintf(stderr, "OOM %lu.\n", size_max);
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	mapped = mmap(NULL, size_max, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+		      0);
+	if (mapped == MAP_FAILED) {
+		fprintf(stderr, "unable to mmap 0x%lx from %s.\n", size_max,
+			devname);
+		perror("mmap device");
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	if (write) {
+		memset(pinned, 0xa5, size_max);
+		memset(mapped, 0xa5, size_max);
+	}
+
+	printf("%s ** size, pinned GB/s, mmap GB/s\n", devname);
+	for (size = size_min; size <= size_max; size <<= 1) {
+		bw_pinned = run_size(fd, write, pinned, addr, size, count);
+		bw_mapped = run_size(fd, write, mapped, addr, size, count);
+		if (bw_pinned < 0 || bw_mapped < 0) {
+			rc = -EIO;
+			break;
+		}
+		printf("%s ** %lu, %f, %f\n", devname, size, bw_pinned,
+		       bw_mapped);
+	}
+
+out:
+	if (mapped != MAP_FAILED)
+		munmap(mapped, size_max);
+	free(pinned);
+	close(fd);
+
+	return rc;
+}
+
+int main(int argc, char *argv[])
+{
+	int cmd_opt;
+	char *device = DEVICE_NAME_DEFAULT;
+	uint64_t address = 0;
+	uint64_t size_min = SIZE_MIN_DEFAULT;
+	uint64_t size_max = SIZE_MAX_DEFAULT;
+	uint64_t count = COUNT_DEFAULT;
+
+	while ((cmd_opt =
+		getopt_long(argc, argv, "vhc:d:a:s:m:", long_opts,
+			    NULL)) != -1) {
+		switch (cmd_opt) {
+		case 0:
+			/* long option */
+			break;
+		case 'd':
+			/* device node name */
+			device = strdup(optarg);
+			break;
+		case 'a':
+			/* RAM address on the AXI bus in bytes */
+			address = getopt_integer(optarg);
+			break;
+		case 's':
+			size_min = getopt_integer(optarg);
+			break;
+		case 'm':
+			size_max = getopt_integer(optarg);
+			break;
+		case 'c':
+			count = getopt_integer(optarg);
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(0);
+			break;
+		}
+	}
+
+	if (!size_min || size_min > size_max || !count) {
+		fprintf(stderr, "size 0x%lx ~ 0x%lx, count %lu invalid.\n",
+			size_min, size_max, count);
+		exit(1);
+	}
+
+	if (verbose)
+		fprintf(stdout,
+			"dev %s, addr 0x%lx, size 0x%lx ~ 0x%lx, count %lu\n",
+			device, address, size_min, size_max, count);
+
+	return test_dma(device, address, size_min, size_max, count);
+}
@@ -0,0 +1,281 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver tools for Linux
+ *
+ * Copyright (c) 2016-present,  Xilinx, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree)
+ */
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "dma_utils.c"
+
+static struct option const long_opts[] = {
+	{"device", required_argument, NULL, 'd'},
+	{"address", required_argument, NULL, 'a'},
+	{"size", required_argument, NULL, 's'},
+	{"count", required_argument, NULL, 'c'},
+	{"threads", required_argument, NULL, 't'},
+	{"serialize", no_argument, NULL, 'x'},
+	{"help", no_argument, NULL, 'h'},
+	{"verbose", no_argument, NULL, 'v'},
+	{0, 0, 0, 0}
+};
+
+#define DEVICE_NAME_DEFAULT "/dev/xdma0_h2c_0"
+#define SIZE_DEFAULT (1024 * 1024)
+#define COUNT_DEFAULT (64)
+#define THREADS_DEFAULT (8)
+#define THREADS_MAX (64)
+
+struct thread_ctx {
+	pthread_t tid;
+	int idx;
+	int fd;
+	int write;
+	uint64_t addr;
+	uint64_t size;
+	uint64_t count;
+	uint64_t bytes;
+	int error;
+};
+
+static pthread_barrier_t start_barrier;
+/* emulates the driver running one request per engine at a time */
+static pthread_mutex_t serial_lock = PTHREAD_MUTEX_INITIALIZER;
+static int serialize;
+
+static void usage(const char *name)
+{
+	int i = 0;
+
+	fprintf(stdout, "%s\n\n", name);
+	fprintf(stdout, "usage: %s [OPTIONS]\n\n", name);
+	fprintf(stdout,
+		"Read or write one device node from several threads at once "
+		"and report the\naggregate bandwidth. The direction follows "
+		"the device name (h2c: write).\n\n");
+
+	fprintf(stdout, "  -%c (--%s) device (defaults to %s)\n",
+		long_opts[i].val, long_opts[i].name, DEVICE_NAME_DEFAULT);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) the start address on the AXI bus, thread n "
+		"uses address + n * size\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) size of a single transfer in bytes, default %d\n",
+		long_opts[i].val, long_opts[i].name, SIZE_DEFAULT);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) number of transfers per thread, default %d\n",
+		long_opts[i].val, long_opts[i].name, COUNT_DEFAULT);
+	i++;
+	fprintf(stdout, "  -%c (--%s) number of threads, default %d, max %d\n",
+		long_opts[i].val, long_opts[i].name, THREADS_DEFAULT,
+		THREADS_MAX);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) one transfer at a time across all threads\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout, "  -%c (--%s) print usage help and exit\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout, "  -%c (--%s) verbose output\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+
+	fprintf(stdout, "\nReturn code:\n");
+	fprintf(stdout, "  0: all bytes were dma'ed successfully\n");
+	fprintf(stdout, "  < 0: error\n\n");
+}
+
+static void *dma_thread(void *arg)
+{
+	struct thread_ctx *ctx = arg;
+	char *buffer = NULL;
+	uint64_t i;
+	ssize_t rc;
+
+	posix_memalign((void **)&buffer, 4096 /*alignment */ , ctx->size);
+	if (!buffer) {
+		fprintf(stderr, "#%d: OOM %lu.\n", ctx->idx, ctx->size);
+		ctx->error = -ENOMEM;
+	} else if (ctx->write) {
+		memset(buffer, ctx->idx, ctx->size);
+	}
+
+	pthread_barrier_wait(&start_barrier);
+	if (ctx->error)
+		return NULL;
+
+	for (i = 0; i < ctx->count; i++) {
+		if (serialize)
+			pthread_mutex_lock(&serial_lock);
+		if (ctx->write)
+			rc = pwrite(ctx->fd, buffer, ctx->size, ctx->addr);
+		else
+			rc = pread(ctx->fd, buffer, ctx->size, ctx->addr);
+		if (serialize)
+			pthread_mutex_unlock(&serial_lock);
+
+		if (rc < 0) {
+			fprintf(stderr, "#%d: %s 0x%lx @ 0x%lx failed %ld.\n",
+				ctx->idx, ctx->write ? "write" : "read",
+				ctx->size, ctx->addr, rc);
+			perror(ctx->write ? "write" : "read");
+			ctx->error = -EIO;
+			break;
+		}
+		if (rc != ctx->size)
+			fprintf(stderr, "#%d: underflow %ld/%lu.\n",
+				ctx->idx, rc, ctx->size);
+		ctx->bytes += rc;
+	}
+
+	free(buffer);
+	return NULL;
+}
+
+static int test_dma(char *devname, uint64_t addr, uint64_t size,
+		    uint64_t count, int threads)
+{
+	struct thread_ctx ctx[THREADS_MAX];
+	struct timespec ts_start, ts_end;
+	int write = strstr(devname, "h2c") != NULL;
+	uint64_t bytes = 0;
+	double total_time;
+	int fd, i, rc = 0;
+
+	fd = open(devname, O_RDWR);
+	if (fd < 0) {
+		fprintf(stderr, "unable to open device %s, %d.\n",
+			devname, fd);
+		perror("open device");
+		return -EINVAL;
+	}
+
+	/* all threads plus this one */
+	pthread_barrier_init(&start_barrier, NULL, threads + 1);
+
+	memset(ctx, 0, sizeof(ctx));
+	for (i = 0; i < threads; i++) {
+		ctx[i].idx = i;
+		ctx[i].fd = fd;
+		ctx[i].write = write;
+		ctx[i].addr = addr + i * size;
+		ctx[i].size = size;
+		ctx[i].count = count;
+		if (pthread_create(&ctx[i].tid, NULL, dma_thread, &ctx[i])) {
+			fprintf(stderr, "unable to start thread %d.\n", i);
+			exit(1);
+		}
+	}
+
+	pthread_barrier_wait(&start_barrier);
+	clock_gettime(CLOCK_MONOTONIC, &ts_start);
+
+	for (i = 0; i < threads; i++) {
+		pthread_join(ctx[i].tid, NULL);
+		bytes += ctx[i].bytes;
+		if (ctx[i].error)
+			rc = ctx[i].error;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts_end);
+	timespec_sub(&ts_end, &ts_start);
+	total_time = ts_end.tv_sec * 1000000000.0 + ts_end.tv_nsec;
+
+	pthread_barrier_destroy(&start_barrier);
+	close(fd);
+
+	if (verbose)
+		printf("** %s %d threads%s, %lu x %lu bytes each, total %lu "
+		       "bytes in %.0f nsec\n",
+		       devname, threads, serialize ? " serialized" : "",
+		       count, size, bytes, total_time);
+	printf("%s ** Aggregate BW = %d, %lu, %f GB/s\n", devname, threads,
+	       size, bytes / total_time);
+
+	return rc;
+}
+
+int main(int argc, char *argv[])
+{
+	int cmd_opt;
+	char *device = DEVICE_NAME_DEFAULT;
+	uint64_t address = 0;
+	uint64_t size = SIZE_DEFAULT;
+	uint64_t count = COUNT_DEFAULT;
+	int threads = THREADS_DEFAULT;
+
+	while ((cmd_opt =
+		getopt_long(argc, argv, "vhxc:d:a:s:t:", long_opts,
+			    NULL)) != -1) {
+		switch (cmd_opt) {
+		case 0:
+			/* long option */
+			break;
+		case 'd':
+			/* device node name */
+			device = strdup(optarg);
+			break;
+		case 'a':
+			/* RAM address on the AXI bus in bytes */
+			address = getopt_integer(optarg);
+			break;
+		case 's':
+			/* size in bytes */
+			size = getopt_integer(optarg);
+			break;
+		case 'c':
+			/* count */
+			count = getopt_integer(optarg);
+			break;
+		case 't':
+			threads = getopt_integer(optarg);
+			break;
+		case 'x':
+			serialize = 1;
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(0);
+			break;
+		}
+	}
+
+	if (threads < 1 || threads > THREADS_MAX) {
+		fprintf(stderr, "threads %d, expect 1 ~ %d.\n", threads,
+			THREADS_MAX);
+		exit(1);
+	}
+
+	if (verbose)
+		fprintf(stdout,
+		"dev %s, addr 0x%lx, size 0x%lx, count %lu, threads %d%s\n",
+		device, address, size, count, threads,
+		serialize ? ", serialized" : "");
+
+	return test_dma(device, address, size, count, threads);
+}
@@ -27,6 +27,7 @@
 #include "../xdma/cdev_sgdma.h"
 
 #include "dma_utils.c"
+#include "dma_uring.c"
 
 static struct option const long_opts[] = {
 	{"device", required_argument, NULL, 'd'},
@@ -37,6 +38,8 @@ static struct option const long_opts[] = {
 	{"count", required_argument, NULL, 'c'},
 	{"data infile", required_argument, NULL, 'f'},
 	{"data outfile", required_argument, NULL, 'w'},
+	{"registered", no_argument, NULL, 'r'},
+	{"uring", no_argument, NULL, 'u'},
 	{"help", no_argument, NULL, 'h'},
 	{"verbose", no_argument, NULL, 'v'},
 	{0, 0, 0, 0}
@@ -50,6 +53,8 @@ static struct option const long_opts[] = {
 static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 		    uint64_t size, uint64_t offset, uint64_t count,
 		    char *filename, char *);
+static int registered;
+static int uring;
 
 static void usage(const char *name)
 {
@@ -86,6 +91,16 @@ static void usage(const char *name)
 		"  -%c (--%s) filename to write the data of the transfers\n",
 		long_opts[i].val, long_opts[i].name);
 	i++;
+	fprintf(stdout,
+		"  -%c (--%s) register the buffer with the driver once, no "
+		"per transfer pinning\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
+	fprintf(stdout,
+		"  -%c (--%s) submit through io_uring against the registered "
+		"buffer\n",
+		long_opts[i].val, long_opts[i].name);
+	i++;
 	fprintf(stdout, "  -%c (--%s) print usage help and exit\n",
 		long_opts[i].val, long_opts[i].name);
 	i++;
@@ -111,7 +126,7 @@ int main(int argc, char *argv[])
 	char *ofname = NULL;
 
 	while ((cmd_opt =
-		getopt_long(argc, argv, "vhc:f:d:a:k:s:o:w:", long_opts,
+		getopt_long(argc, argv, "vhruc:f:d:a:k:s:o:w:", long_opts,
 			    NULL)) != -1) {
 		switch (cmd_opt) {
 		case 0:
@@ -148,6 +163,12 @@ int main(int argc, char *argv[])
 		case 'w':
 			ofname = strdup(optarg);
 			break;
+		case 'r':
+			registered = 1;
+			break;
+		case 'u':
+			uring = 1;
+			break;
 			/* print usage help and exit */
 		case 'v':
 			verbose = 1;
@@ -160,6 +181,12 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	if (aperture && (registered || uring)) {
+		fprintf(stderr, "aperture and registered buffers exclude each "
+			"other.\n");
+		exit(1);
+	}
+
 	if (verbose)
 		fprintf(stdout, 
 		"dev %s, addr 0x%lx, aperture 0x%lx, size 0x%lx, offset 0x%lx, "
@@ -181,6 +208,8 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 	char *buffer = NULL;
 	char *allocated = NULL;
 	struct timespec ts_start, ts_end;
+	struct dma_uring ring = { .fd = -1 };
+	uint32_t handle = 0;
 	int infile_fd = -1;
 	int outfile_fd = -1;
 	int fpga_fd = open(devname, O_RDWR);
@@ -237,6 +266,18 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 			goto out;
 	}
 
+	/* pinned and mapped once, the transfers below only reference it */
+	if (registered || uring) {
+		rc = dma_register_buf(fpga_fd, buffer, size, &handle);
+		if (rc < 0)
+			goto out;
+	}
+	if (uring) {
+		rc = dma_uring_init(&ring, 4);
+		if (rc < 0)
+			goto out;
+	}
+
 	for (i = 0; i < count; i++) {
 		/* write buffer to AXI MM address using SGDMA */
 		rc = clock_gettime(CLOCK_MONOTONIC, &ts_start);
@@ -259,6 +300,16 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 			}
 
 			bytes_done = io.done;
+		} else if (uring) {
+			rc = dma_uring_xfer(&ring, fpga_fd, handle, 0, size,
+					    addr);
+			if (rc < 0) {
+				fprintf(stderr, "#%lu: uring write failed %ld.\n",
+					i, rc);
+				goto out;
+			}
+
+			bytes_done = rc;
 		} else {
 			rc = write_from_buffer(devname, fpga_fd, buffer, size,
 				      	 	addr);
@@ -278,7 +329,7 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 
 		/* subtract the start time from the end time */
 		timespec_sub(&ts_end, &ts_start);
-		total_time += ts_end.tv_nsec;
+		total_time += ts_end.tv_sec * 1000000000L + ts_end.tv_nsec;
 		/* a bit less accurate but side-effects are accounted for */
 		if (verbose)
 		fprintf(stdout,
@@ -304,6 +355,10 @@ static int test_dma(char *devname, uint64_t addr, uint64_t aperture,
 	}
 
 out:
+	if (uring)
+		dma_uring_exit(&ring);
+	if (handle)
+		dma_unregister_buf(fpga_fd, handle);
 	close(fpga_fd);
 	if (infile_fd >= 0)
 		close(infile_fd);
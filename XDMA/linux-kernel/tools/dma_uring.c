@@ -0,0 +1,172 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver tools for Linux
+ *
+ * Copyright (c) 2016-present,  Xilinx, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under BSD-style license (found in the
+ * LICENSE file in the root directory of this source tree)
+ */
+
+/*
+ * Registered buffers (IOCTL_XDMA_REGISTER_BUF) and just enough of an io_uring
+ * to issue XDMA_URING_CMD_XFER through raw syscalls, without liburing.
+ */
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/* the command payload needs the 128 byte SQEs */
+#define DMA_URING_SQE_SIZE (2 * sizeof(struct io_uring_sqe))
+
+struct dma_uring {
+	int fd;
+	unsigned int *sq_tail;
+	unsigned int *sq_mask;
+	unsigned int *sq_array;
+	unsigned int *cq_head;
+	unsigned int *cq_tail;
+	unsigned int *cq_mask;
+	struct io_uring_cqe *cqes;
+	char *sqes;
+	char *sq_ring;
+	char *cq_ring;
+	size_t sq_ring_sz;
+	size_t cq_ring_sz;
+	size_t sqes_sz;
+};
+
+static int dma_register_buf(int fd, char *buffer, uint64_t size,
+			    uint32_t *handle)
+{
+	struct xdma_buf_ioctl io;
+	int rc;
+
+	io.buffer = (unsigned long)buffer;
+	io.len = size;
+	io.handle = 0;
+
+	rc = ioctl(fd, IOCTL_XDMA_REGISTER_BUF, &io);
+	if (rc < 0) {
+		fprintf(stderr, "register buffer %p,0x%lx failed %d.\n",
+			buffer, size, rc);
+		perror("register buffer");
+		return -errno;
+	}
+
+	*handle = io.handle;
+	return 0;
+}
+
+static void dma_unregister_buf(int fd, uint32_t handle)
+{
+	ioctl(fd, IOCTL_XDMA_UNREGISTER_BUF, handle);
+}
+
+static void dma_uring_exit(struct dma_uring *ring)
+{
+	if (ring->sqes && ring->sqes != MAP_FAILED)
+		munmap(ring->sqes, ring->sqes_sz);
+	if (ring->cq_ring && ring->cq_ring != MAP_FAILED)
+		munmap(ring->cq_ring, ring->cq_ring_sz);
+	if (ring->sq_ring && ring->sq_ring != MAP_FAILED)
+		munmap(ring->sq_ring, ring->sq_ring_sz);
+	if (ring->fd >= 0)
+		close(ring->fd);
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+}
+
+static int dma_uring_init(struct dma_uring *ring, unsigned int entries)
+{
+	struct io_uring_params p;
+
+	memset(ring, 0, sizeof(*ring));
+	memset(&p, 0, sizeof(p));
+	p.flags = IORING_SETUP_SQE128;
+
+	ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (ring->fd < 0) {
+		perror("io_uring_setup");
+		return -errno;
+	}
+
+	ring->sq_ring_sz = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+	ring->cq_ring_sz = p.cq_off.cqes +
+			   p.cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqes_sz = p.sq_entries * DMA_URING_SQE_SIZE;
+
+	ring->sq_ring = mmap(NULL, ring->sq_ring_sz, PROT_READ | PROT_WRITE,
+			     MAP_SHARED | MAP_POPULATE, ring->fd,
+			     IORING_OFF_SQ_RING);
+	ring->cq_ring = mmap(NULL, ring->cq_ring_sz, PROT_READ | PROT_WRITE,
+			     MAP_SHARED | MAP_POPULATE, ring->fd,
+			     IORING_OFF_CQ_RING);
+	ring->sqes = mmap(NULL, ring->sqes_sz, PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE, ring->fd,
+			  IORING_OFF_SQES);
+	if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED ||
+	    ring->sqes == MAP_FAILED) {
+		perror("io_uring mmap");
+		dma_uring_exit(ring);
+		return -ENOMEM;
+	}
+
+	ring->sq_tail = (unsigned int *)(ring->sq_ring + p.sq_off.tail);
+	ring->sq_mask = (unsigned int *)(ring->sq_ring + p.sq_off.ring_mask);
+	ring->sq_array = (unsigned int *)(ring->sq_ring + p.sq_off.array);
+	ring->cq_head = (unsigned int *)(ring->cq_ring + p.cq_off.head);
+	ring->cq_tail = (unsigned int *)(ring->cq_ring + p.cq_off.tail);
+	ring->cq_mask = (unsigned int *)(ring->cq_ring + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(ring->cq_ring + p.cq_off.cqes);
+
+	return 0;
+}
+
+/*
+ * transfer size bytes at offset of the registered buffer to/from the AXI
+ * address, returns the bytes dma'ed or -errno
+ */
+static ssize_t dma_uring_xfer(struct dma_uring *ring, int fd, uint32_t handle,
+			      uint64_t offset, uint64_t size, uint64_t addr)
+{
+	unsigned int tail = *ring->sq_tail;
+	unsigned int idx = tail & *ring->sq_mask;
+	unsigned int head;
+	struct io_uring_sqe *sqe;
+	struct xdma_uring_cmd *cmd;
+	int rc;
+
+	sqe = (struct io_uring_sqe *)(ring->sqes + idx * DMA_URING_SQE_SIZE);
+	memset(sqe, 0, DMA_URING_SQE_SIZE);
+	sqe->opcode = IORING_OP_URING_CMD;
+	sqe->fd = fd;
+	sqe->cmd_op = XDMA_URING_CMD_XFER;
+
+	cmd = (struct xdma_uring_cmd *)sqe->cmd;
+	cmd->ep_addr = addr;
+	cmd->offset = offset;
+	cmd->len = size;
+	cmd->handle = handle;
+
+	ring->sq_array[idx] = idx;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	rc = syscall(__NR_io_uring_enter, ring->fd, 1, 1,
+		     IORING_ENTER_GETEVENTS, NULL, 0);
+	if (rc < 0) {
+		perror("io_uring_enter");
+		return -errno;
+	}
+
+	head = *ring->cq_head;
+	if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+		fprintf(stderr, "io_uring, no completion.\n");
+		return -EIO;
+	}
+	rc = ring->cqes[head & *ring->cq_mask].res;
+	__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+
+	return rc;
+}
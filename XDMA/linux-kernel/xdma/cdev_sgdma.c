@@ -26,10 +26,19 @@
 #include <linux/sched.h>
 #include <linux/wait.h>
 #include <linux/kthread.h>
+#include <linux/kref.h>
 #include <linux/version.h>
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 16, 0)
 #include <linux/uio.h>
 #endif
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0)
+#include <linux/sched/mm.h>
+#endif
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 7, 0)
+#include <linux/io_uring/cmd.h>
+#elif LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0)
+#include <linux/io_uring.h>
+#endif
 #include "libxdma_api.h"
 #include "xdma_cdev.h"
 #include "cdev_sgdma.h"
@@ -85,12 +94,18 @@ static void async_io_handler(unsigned long  cb_hndl, int err)
 	engine = xcdev->engine;
 	xdev = xcdev->xdev;
 
-	if (!err)
+	/* a failed shared ring request still holds its mapping */
+	if (!err || engine->ring) {
 		numbytes = xdma_xfer_completion((void *)cb, xdev,
 				engine->channel, cb->write, cb->ep_addr,
 				&cb->sgt, 0, 
 				cb->write ? h2c_timeout * 1000 :
 					    c2h_timeout * 1000);
+		if (numbytes < 0) {
+			err = numbytes;
+			numbytes = 0;
+		}
+	}
 
 	char_sgdma_unmap_user_buf(cb, cb->write);
 
@@ -104,7 +119,9 @@ static void async_io_handler(unsigned long  cb_hndl, int err)
 	if (caio->cmpl_cnt == caio->req_cnt) {
 		res = caio->res;
 		res2 = caio->res2;
-#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 1, 0)
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 16, 0)
+		caio->iocb->ki_complete(caio->iocb, res2 ? res2 : res);
+#elif LINUX_VERSION_CODE >= KERNEL_VERSION(4, 1, 0)
 		caio->iocb->ki_complete(caio->iocb, res, res2);
 #else
 		aio_complete(caio->iocb, res, res2);
@@ -119,7 +136,9 @@ skip_tran:
 	return;
 
 skip_dev_lock:
-#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 1, 0)
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 16, 0)
+	caio->iocb->ki_complete(caio->iocb, -EBUSY);
+#elif LINUX_VERSION_CODE >= KERNEL_VERSION(4, 1, 0)
 	caio->iocb->ki_complete(caio->iocb, numbytes, -EBUSY);
 #else
 	aio_complete(caio->iocb, numbytes, -EBUSY);
@@ -349,6 +368,302 @@ err_out:
 	return rv;
 }
 
+/*
+ * Registered user buffers: pinned and dma mapped once by
+ * IOCTL_XDMA_REGISTER_BUF, or allocated by the driver and mapped into the
+ * process by mmap(), so a transfer against them only has to build a sgl of
+ * the already mapped segments. They belong to the file that registered them
+ * and are released on its close, or on munmap.
+ */
+struct xdma_reg_buf {
+	struct list_head entry;
+	struct kref ref;
+	struct file *file;
+	struct mm_struct *mm;
+	struct xdma_dev *xdev;
+	enum dma_data_direction dir;
+	u32 handle;
+	unsigned long buf;
+	unsigned long len;
+	unsigned int pages_nr;
+	struct page **pages;
+	struct sg_table sgt;
+	/* pages allocated by the driver for mmap, not pinned user memory */
+	bool alloc;
+};
+
+static int reg_buf_pin(unsigned long buf, unsigned int pages_nr,
+			struct page **pages)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
+	return pin_user_pages_fast(buf, pages_nr, FOLL_WRITE | FOLL_LONGTERM,
+				pages);
+#else
+	return get_user_pages_fast(buf, pages_nr, 1/* write */, pages);
+#endif
+}
+
+static void reg_buf_unpin(struct page **pages, unsigned int pages_nr,
+			bool dirty)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
+	unpin_user_pages_dirty_lock(pages, pages_nr, dirty);
+#else
+	int i;
+
+	for (i = 0; i < pages_nr; i++) {
+		if (dirty)
+			set_page_dirty_lock(pages[i]);
+		put_page(pages[i]);
+	}
+#endif
+}
+
+static void reg_buf_release(struct kref *ref)
+{
+	struct xdma_reg_buf *rb = container_of(ref, struct xdma_reg_buf, ref);
+
+	dbg_tfr("release buf %u, 0x%lx,%lu.\n", rb->handle, rb->buf, rb->len);
+
+	pci_unmap_sg(rb->xdev->pdev, rb->sgt.sgl, rb->sgt.orig_nents, rb->dir);
+	if (rb->alloc) {
+		struct scatterlist *sg;
+		int i;
+
+		/* one sg entry per contiguous chunk */
+		for_each_sg(rb->sgt.sgl, sg, rb->sgt.orig_nents, i)
+			__free_pages(sg_page(sg), get_order(sg->length));
+	} else {
+		reg_buf_unpin(rb->pages, rb->pages_nr,
+				rb->dir == DMA_FROM_DEVICE);
+	}
+	sg_free_table(&rb->sgt);
+	mmdrop(rb->mm);
+	kfree(rb->pages);
+	kfree(rb);
+}
+
+static inline void reg_buf_put(struct xdma_reg_buf *rb)
+{
+	kref_put(&rb->ref, reg_buf_release);
+}
+
+/*
+ * look up a buffer of the file either by handle, or, with handle 0, by the
+ * user address range [buf, buf + len) in the caller's address space
+ */
+static struct xdma_reg_buf *reg_buf_get(struct xdma_cdev *xcdev,
+			struct file *file, u32 handle, unsigned long buf,
+			size_t len)
+{
+	struct xdma_reg_buf *rb;
+
+	spin_lock(&xcdev->lock);
+	list_for_each_entry(rb, &xcdev->buf_list, entry) {
+		if (rb->file != file)
+			continue;
+		if (handle) {
+			if (rb->handle != handle)
+				continue;
+		} else if (rb->mm != current->mm || buf < rb->buf ||
+			   len > rb->len || buf - rb->buf > rb->len - len) {
+			continue;
+		}
+		kref_get(&rb->ref);
+		spin_unlock(&xcdev->lock);
+		return rb;
+	}
+	spin_unlock(&xcdev->lock);
+
+	return NULL;
+}
+
+/* hand the list reference of a new buffer over to the cdev */
+static void reg_buf_add(struct xdma_cdev *xcdev, struct xdma_reg_buf *rb,
+			struct file *file, struct mm_struct *mm)
+{
+	rb->file = file;
+	rb->mm = mm;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0)
+	mmgrab(mm);
+#else
+	atomic_inc(&mm->mm_count);
+#endif
+
+	spin_lock(&xcdev->lock);
+	/* handle 0 means "look up by address" */
+	if (!++xcdev->buf_handle)
+		++xcdev->buf_handle;
+	rb->handle = xcdev->buf_handle;
+	list_add_tail(&rb->entry, &xcdev->buf_list);
+	spin_unlock(&xcdev->lock);
+}
+
+/* take the buffer off the list, if still on it, and drop the list reference */
+static void reg_buf_del(struct xdma_cdev *xcdev, struct xdma_reg_buf *rb)
+{
+	bool listed;
+
+	spin_lock(&xcdev->lock);
+	listed = !list_empty(&rb->entry);
+	list_del_init(&rb->entry);
+	spin_unlock(&xcdev->lock);
+
+	if (listed)
+		reg_buf_put(rb);
+}
+
+/* drop all the buffers registered through the file */
+static void reg_buf_release_file(struct xdma_cdev *xcdev, struct file *file)
+{
+	struct xdma_reg_buf *rb, *tmp;
+	LIST_HEAD(release);
+
+	spin_lock(&xcdev->lock);
+	list_for_each_entry_safe(rb, tmp, &xcdev->buf_list, entry) {
+		if (rb->file == file)
+			list_move_tail(&rb->entry, &release);
+	}
+	spin_unlock(&xcdev->lock);
+
+	list_for_each_entry_safe(rb, tmp, &release, entry) {
+		list_del_init(&rb->entry);
+		reg_buf_put(rb);
+	}
+}
+
+/*
+ * Build a sgl for [offset, offset + len) of the buffer out of its dma
+ * mapped segments, for xdma_xfer_submit() with dma_mapped set.
+ */
+static int reg_buf_map_range(struct xdma_reg_buf *rb, unsigned long offset,
+			size_t len, struct sg_table *sgt)
+{
+	struct scatterlist *sg, *dst = NULL;
+	unsigned long skip = offset;
+	size_t left = len;
+	unsigned int nents = 0;
+	int i;
+
+	for_each_sg(rb->sgt.sgl, sg, rb->sgt.nents, i) {
+		unsigned int slen = sg_dma_len(sg);
+
+		if (skip >= slen) {
+			skip -= slen;
+			continue;
+		}
+		nents++;
+		if (slen - skip >= left)
+			break;
+		left -= slen - skip;
+		skip = 0;
+	}
+
+	if (sg_alloc_table(sgt, nents, GFP_KERNEL)) {
+		pr_err("sgl OOM.\n");
+		return -ENOMEM;
+	}
+
+	skip = offset;
+	left = len;
+	for_each_sg(rb->sgt.sgl, sg, rb->sgt.nents, i) {
+		unsigned int slen = sg_dma_len(sg);
+		unsigned int nbytes;
+
+		if (skip >= slen) {
+			skip -= slen;
+			continue;
+		}
+		dst = dst ? sg_next(dst) : sgt->sgl;
+		nbytes = min_t(size_t, slen - skip, left);
+		sg_dma_address(dst) = sg_dma_address(sg) + skip;
+		sg_dma_len(dst) = nbytes;
+		dst->length = nbytes;
+
+		left -= nbytes;
+		if (!left)
+			break;
+		skip = 0;
+	}
+	sgt->nents = nents;
+
+	return 0;
+}
+
+/* long lived mapping, hand the range to the device and back */
+static void reg_buf_sync(struct xdma_reg_buf *rb, struct sg_table *sgt,
+			bool for_device)
+{
+	struct device *dev = &rb->xdev->pdev->dev;
+	struct scatterlist *sg;
+	int i;
+
+	for_each_sg(sgt->sgl, sg, sgt->nents, i) {
+		if (for_device)
+			dma_sync_single_for_device(dev, sg_dma_address(sg),
+					sg_dma_len(sg), rb->dir);
+		else
+			dma_sync_single_for_cpu(dev, sg_dma_address(sg),
+					sg_dma_len(sg), rb->dir);
+	}
+}
+
+/* [offset, offset + len) of the buffer to/from ep_addr is a valid transfer */
+static int reg_buf_check(struct xdma_engine *engine, struct xdma_reg_buf *rb,
+			unsigned long offset, size_t len, u64 ep_addr,
+			bool write)
+{
+	int rv;
+
+	if ((write && engine->dir != DMA_TO_DEVICE) ||
+	    (!write && engine->dir != DMA_FROM_DEVICE)) {
+		pr_err("r/w mismatch. W %d, dir %d.\n", write, engine->dir);
+		return -EINVAL;
+	}
+
+	if (!len || offset > rb->len || len > rb->len - offset)
+		return -EINVAL;
+
+	rv = check_transfer_align(engine,
+				(const char __user *)(rb->buf + offset), len,
+				ep_addr, 1);
+	if (rv) {
+		pr_info("Invalid transfer alignment detected\n");
+		return rv;
+	}
+
+	return 0;
+}
+
+static ssize_t reg_buf_xfer(struct xdma_cdev *xcdev, struct xdma_reg_buf *rb,
+			unsigned long offset, size_t len, u64 ep_addr,
+			bool write)
+{
+	struct xdma_engine *engine = xcdev->engine;
+	struct sg_table sgt;
+	ssize_t res;
+	int rv;
+
+	rv = reg_buf_check(engine, rb, offset, len, ep_addr, write);
+	if (rv < 0)
+		return rv;
+
+	rv = reg_buf_map_range(rb, offset, len, &sgt);
+	if (rv < 0)
+		return rv;
+
+	reg_buf_sync(rb, &sgt, true);
+	res = xdma_xfer_submit(xcdev->xdev, engine->channel, write, ep_addr,
+				&sgt, 1, write ? h2c_timeout * 1000 :
+						c2h_timeout * 1000);
+	if (!write)
+		reg_buf_sync(rb, &sgt, false);
+
+	sg_free_table(&sgt);
+
+	return res;
+}
+
 static ssize_t char_sgdma_read_write(struct file *file, const char __user *buf,
 		size_t count, loff_t *pos, bool write)
 {
@@ -357,6 +672,7 @@ static ssize_t char_sgdma_read_write(struct file *file, const char __user *buf,
 	struct xdma_cdev *xcdev = (struct xdma_cdev *)file->private_data;
 	struct xdma_dev *xdev;
 	struct xdma_engine *engine;
+	struct xdma_reg_buf *rb;
 	struct xdma_io_cb cb;
 
 	rv = xcdev_check(__func__, xcdev, 1);
@@ -382,6 +698,15 @@ static ssize_t char_sgdma_read_write(struct file *file, const char __user *buf,
 		return rv;
 	}
 
+	/* registered buffer, already pinned and mapped */
+	rb = reg_buf_get(xcdev, file, 0, (unsigned long)buf, count);
+	if (rb) {
+		res = reg_buf_xfer(xcdev, rb, (unsigned long)buf - rb->buf,
+				count, *pos, write);
+		reg_buf_put(rb);
+		return res;
+	}
+
 	memset(&cb, 0, sizeof(struct xdma_io_cb));
 	cb.buf = (char __user *)buf;
 	cb.len = count;
@@ -560,13 +885,85 @@ static ssize_t cdev_aio_read(struct kiocb *iocb, const struct iovec *io,
 }
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 16, 0)
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 13, 0)
+/* user address of a single segment iov_iter, 0 for anything else */
+static unsigned long cdev_iter_user_addr(struct iov_iter *io)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0)
+	if (iter_is_ubuf(io))
+		return (unsigned long)io->ubuf + io->iov_offset;
+#endif
+	if (!iter_is_iovec(io) || io->nr_segs != 1)
+		return 0;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 4, 0)
+	return (unsigned long)iter_iov(io)->iov_base + io->iov_offset;
+#else
+	return (unsigned long)io->iov->iov_base + io->iov_offset;
+#endif
+}
+
+/*
+ * Transfer straight out of a registered buffer, -ENOENT if the range is not
+ * part of one.
+ */
+static ssize_t cdev_reg_buf_iter(struct kiocb *iocb, struct iov_iter *io,
+				bool write)
+{
+	struct file *file = iocb->ki_filp;
+	struct xdma_cdev *xcdev = (struct xdma_cdev *)file->private_data;
+	unsigned long buf;
+	size_t len = iov_iter_count(io);
+	struct xdma_reg_buf *rb;
+	ssize_t res;
+
+	if (!xcdev)
+		return -ENOENT;
+
+	buf = cdev_iter_user_addr(io);
+	if (!buf || !len)
+		return -ENOENT;
+
+	rb = reg_buf_get(xcdev, file, 0, buf, len);
+	if (!rb)
+		return -ENOENT;
+
+	/* the transfer sleeps, let io_uring retry it from a worker */
+	if (iocb->ki_flags & IOCB_NOWAIT) {
+		reg_buf_put(rb);
+		return -EAGAIN;
+	}
+
+	res = reg_buf_xfer(xcdev, rb, buf - rb->buf, len, iocb->ki_pos, write);
+	reg_buf_put(rb);
+
+	if (res > 0) {
+		iocb->ki_pos += res;
+		iov_iter_advance(io, res);
+	}
+
+	return res;
+}
+#endif
+
 static ssize_t cdev_write_iter(struct kiocb *iocb, struct iov_iter *io)
 {
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 13, 0)
+	ssize_t res = cdev_reg_buf_iter(iocb, io, 1);
+
+	if (res != -ENOENT)
+		return res;
+#endif
 	return cdev_aio_write(iocb, io->iov, io->nr_segs, io->iov_offset);
 }
 
 static ssize_t cdev_read_iter(struct kiocb *iocb, struct iov_iter *io)
 {
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 13, 0)
+	ssize_t res = cdev_reg_buf_iter(iocb, io, 0);
+
+	if (res != -ENOENT)
+		return res;
+#endif
 	return cdev_aio_read(iocb, io->iov, io->nr_segs, io->iov_offset);
 }
 #endif
@@ -698,6 +1095,33 @@ static int ioctl_do_perf_get(struct xdma_engine *engine, unsigned long arg)
 	return 0;
 }
 
+static int ioctl_do_perf_latency(struct xdma_engine *engine,
+				 unsigned long arg)
+{
+	struct xdma_latency_ioctl lat;
+
+	if (!engine) {
+		pr_err("Invalid DMA engine\n");
+		return -EINVAL;
+	}
+
+	dbg_perf("IOCTL_XDMA_PERF_LATENCY\n");
+
+	if (copy_from_user(&lat, (void __user *)arg, sizeof(lat)))
+		return -EFAULT;
+	if (lat.version != IOCTL_XDMA_PERF_V1) {
+		pr_err("%s, latency ioctl version %u.\n", engine->name,
+			lat.version);
+		return -EINVAL;
+	}
+
+	engine_latency_get(engine, lat.mode, lat.reset);
+
+	if (copy_to_user((void __user *)arg, &lat, sizeof(lat)))
+		return -EFAULT;
+	return 0;
+}
+
 static int ioctl_do_addrmode_set(struct xdma_engine *engine, unsigned long arg)
 {
 	return engine_addrmode_set(engine, arg);
@@ -795,12 +1219,292 @@ static int ioctl_do_aperture_dma(struct xdma_engine *engine, unsigned long arg,
 
 	return io.error;
 }
+
+static int ioctl_do_register_buf(struct xdma_cdev *xcdev, struct file *file,
+				unsigned long arg)
+{
+	struct xdma_engine *engine = xcdev->engine;
+	struct xdma_dev *xdev = xcdev->xdev;
+	struct xdma_buf_ioctl io;
+	struct xdma_reg_buf *rb;
+	unsigned int pages_nr;
+	int nents;
+	int rv;
+
+	if (copy_from_user(&io, (struct xdma_buf_ioctl __user *)arg,
+			sizeof(struct xdma_buf_ioctl))) {
+		dbg_tfr("%s failed to copy from user space 0x%lx\n",
+			engine->name, arg);
+		return -EFAULT;
+	}
+
+	if (!io.len || io.buffer + io.len < io.buffer)
+		return -EINVAL;
+
+	pages_nr = (PAGE_ALIGN(io.buffer + io.len) - (io.buffer & PAGE_MASK))
+			>> PAGE_SHIFT;
+
+	rb = kzalloc(sizeof(struct xdma_reg_buf), GFP_KERNEL);
+	if (!rb)
+		return -ENOMEM;
+
+	rb->pages = kcalloc(pages_nr, sizeof(struct page *), GFP_KERNEL);
+	if (!rb->pages) {
+		pr_err("pages OOM.\n");
+		rv = -ENOMEM;
+		goto free_rb;
+	}
+
+	rv = reg_buf_pin(io.buffer & PAGE_MASK, pages_nr, rb->pages);
+	if (rv != pages_nr) {
+		pr_err("unable to pin down all %u user pages, %d.\n",
+			pages_nr, rv);
+		if (rv > 0)
+			reg_buf_unpin(rb->pages, rv, false);
+		rv = rv < 0 ? rv : -EFAULT;
+		goto free_pages;
+	}
+
+	rv = sg_alloc_table_from_pages(&rb->sgt, rb->pages, pages_nr,
+				offset_in_page(io.buffer), io.len, GFP_KERNEL);
+	if (rv < 0) {
+		pr_err("sgl OOM.\n");
+		goto unpin;
+	}
+
+	nents = pci_map_sg(xdev->pdev, rb->sgt.sgl, rb->sgt.orig_nents,
+				engine->dir);
+	if (!nents) {
+		pr_info("map sgl failed, sgt 0x%p.\n", &rb->sgt);
+		rv = -EIO;
+		goto free_sgt;
+	}
+	rb->sgt.nents = nents;
+
+	kref_init(&rb->ref);
+	rb->xdev = xdev;
+	rb->dir = engine->dir;
+	rb->buf = io.buffer;
+	rb->len = io.len;
+	rb->pages_nr = pages_nr;
+	reg_buf_add(xcdev, rb, file, current->mm);
+
+	dbg_tfr("%s, buf %u, 0x%lx,%lu, %u pages, %d segments.\n",
+		engine->name, rb->handle, rb->buf, rb->len, pages_nr, nents);
+
+	io.handle = rb->handle;
+	if (copy_to_user((struct xdma_buf_ioctl __user *)arg, &io,
+			sizeof(struct xdma_buf_ioctl))) {
+		dbg_tfr("%s failed to copy to user space 0x%lx\n",
+			engine->name, arg);
+		reg_buf_del(xcdev, rb);
+		return -EFAULT;
+	}
+
+	return 0;
+
+free_sgt:
+	sg_free_table(&rb->sgt);
+unpin:
+	reg_buf_unpin(rb->pages, pages_nr, false);
+free_pages:
+	kfree(rb->pages);
+free_rb:
+	kfree(rb);
+	return rv;
+}
+
+static int ioctl_do_unregister_buf(struct xdma_cdev *xcdev, struct file *file,
+				unsigned long arg)
+{
+	struct xdma_reg_buf *rb;
+
+	spin_lock(&xcdev->lock);
+	list_for_each_entry(rb, &xcdev->buf_list, entry) {
+		if (rb->file == file && rb->handle == (u32)arg) {
+			list_del_init(&rb->entry);
+			spin_unlock(&xcdev->lock);
+			/* transfers still using it hold their own reference */
+			reg_buf_put(rb);
+			return 0;
+		}
+	}
+	spin_unlock(&xcdev->lock);
+
+	return -ENOENT;
+}
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0)
+/* an XDMA_URING_CMD_XFER queued on the shared descriptor ring */
+struct xdma_uring_io {
+	struct xdma_io_cb cb;
+	struct io_uring_cmd *ioucmd;
+	struct xdma_reg_buf *rb;
+	ssize_t res;
+};
+
+static inline struct xdma_uring_io **cdev_uring_pdu(struct io_uring_cmd *ioucmd)
+{
+	return (struct xdma_uring_io **)ioucmd->pdu;
+}
+
+/* in the submitter's task: release what the transfer used and post the cqe */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0)
+static void cdev_uring_cmd_end(struct io_uring_cmd *ioucmd,
+			unsigned int issue_flags)
+#else
+static void cdev_uring_cmd_end(struct io_uring_cmd *ioucmd)
+#endif
+{
+	struct xdma_uring_io *io = *cdev_uring_pdu(ioucmd);
+	ssize_t res = io->res;
+
+	if (!io->cb.write)
+		reg_buf_sync(io->rb, &io->cb.sgt, false);
+	sg_free_table(&io->cb.sgt);
+	reg_buf_put(io->rb);
+	kfree(io);
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0)
+	io_uring_cmd_done(ioucmd, res, 0, issue_flags);
+#else
+	io_uring_cmd_done(ioucmd, res, 0);
+#endif
+}
+
+/*
+ * io_done of the request, called with the engine lock held, possibly from
+ * the interrupt: account it, the rest is done in task context
+ */
+static void cdev_uring_io_done(unsigned long cb_hndl, int err)
+{
+	struct xdma_io_cb *cb = (struct xdma_io_cb *)cb_hndl;
+	struct xdma_uring_io *io = container_of(cb, struct xdma_uring_io, cb);
+	struct xdma_cdev *xcdev = (struct xdma_cdev *)
+					io->ioucmd->file->private_data;
+
+	/* a failed request reports its error instead of the byte count */
+	io->res = xdma_xfer_completion(cb, xcdev->xdev,
+				xcdev->engine->channel, cb->write, cb->ep_addr,
+				&cb->sgt, 1, 0);
+	if (!io->res)
+		io->res = err;
+
+	io_uring_cmd_complete_in_task(io->ioucmd, cdev_uring_cmd_end);
+}
+
+/*
+ * queue the transfer on the shared ring without waiting for it, the buffer
+ * reference is handed over to the command on success (-EIOCBQUEUED)
+ */
+static int cdev_uring_cmd_submit(struct xdma_cdev *xcdev,
+			struct io_uring_cmd *ioucmd, struct xdma_reg_buf *rb,
+			unsigned long offset, size_t len, u64 ep_addr)
+{
+	struct xdma_engine *engine = xcdev->engine;
+	bool write = engine->dir == DMA_TO_DEVICE;
+	struct xdma_uring_io *io;
+	int rv;
+
+	rv = reg_buf_check(engine, rb, offset, len, ep_addr, write);
+	if (rv < 0)
+		return rv;
+
+	io = kzalloc(sizeof(*io), GFP_KERNEL);
+	if (!io)
+		return -ENOMEM;
+
+	rv = reg_buf_map_range(rb, offset, len, &io->cb.sgt);
+	if (rv < 0) {
+		kfree(io);
+		return rv;
+	}
+
+	io->ioucmd = ioucmd;
+	io->rb = rb;
+	io->cb.len = len;
+	io->cb.ep_addr = ep_addr;
+	io->cb.write = write;
+	io->cb.io_done = cdev_uring_io_done;
+	*cdev_uring_pdu(ioucmd) = io;
+
+	reg_buf_sync(rb, &io->cb.sgt, true);
+	rv = xdma_xfer_submit_nowait(&io->cb, xcdev->xdev, engine->channel,
+				write, ep_addr, &io->cb.sgt, 1, 0);
+	if (rv == -EIOCBQUEUED)
+		return rv;
+
+	sg_free_table(&io->cb.sgt);
+	kfree(io);
+	return rv;
+}
+
+/*
+ * io_uring passthrough: XDMA_URING_CMD_XFER against a registered buffer,
+ * no pinning or mapping per I/O. MM engines complete it asynchronously off
+ * the shared ring; ST engines have no per request completion, there the
+ * transfer is run synchronously from an io_uring worker.
+ */
+static int cdev_uring_cmd(struct io_uring_cmd *ioucmd, unsigned int issue_flags)
+{
+	struct file *file = ioucmd->file;
+	struct xdma_cdev *xcdev = (struct xdma_cdev *)file->private_data;
+	const struct xdma_uring_cmd *cmd;
+	struct xdma_reg_buf *rb;
+	u64 ep_addr, offset;
+	u32 len, handle;
+	ssize_t res;
+	int rv;
+
+	rv = xcdev_check(__func__, xcdev, 1);
+	if (rv < 0)
+		return rv;
+
+	if (ioucmd->cmd_op != XDMA_URING_CMD_XFER)
+		return -EINVAL;
+	if (!(issue_flags & IO_URING_F_SQE128))
+		return -EINVAL;
+	/* the synchronous transfer sleeps, have io_uring reissue it */
+	if (!xcdev->engine->ring && (issue_flags & IO_URING_F_NONBLOCK))
+		return -EAGAIN;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 6, 0)
+	cmd = io_uring_sqe_cmd(ioucmd->sqe);
+#else
+	cmd = ioucmd->cmd;
+#endif
+	ep_addr = READ_ONCE(cmd->ep_addr);
+	offset = READ_ONCE(cmd->offset);
+	len = READ_ONCE(cmd->len);
+	handle = READ_ONCE(cmd->handle);
+
+	if (!handle || len > INT_MAX)
+		return -EINVAL;
+
+	rb = reg_buf_get(xcdev, file, handle, 0, 0);
+	if (!rb)
+		return -ENOENT;
+
+	if (xcdev->engine->ring) {
+		rv = cdev_uring_cmd_submit(xcdev, ioucmd, rb, offset, len,
+					ep_addr);
+		if (rv != -EIOCBQUEUED)
+			reg_buf_put(rb);
+		return rv;
+	}
+
+	res = reg_buf_xfer(xcdev, rb, offset, len, ep_addr,
+			xcdev->engine->dir == DMA_TO_DEVICE);
+	reg_buf_put(rb);
+
+	return res;
+}
+#endif
 	
 static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 		unsigned long arg)
 {
 	struct xdma_cdev *xcdev = (struct xdma_cdev *)file->private_data;
-	struct xdma_dev *xdev;
 	struct xdma_engine *engine;
 
 	int rv = 0;
@@ -809,7 +1513,6 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 	if (rv < 0)
 		return rv;
 
-	xdev = xcdev->xdev;
 	engine = xcdev->engine;
 
 	switch (cmd) {
@@ -822,6 +1525,9 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 	case IOCTL_XDMA_PERF_GET:
 		rv = ioctl_do_perf_get(engine, arg);
 		break;
+	case IOCTL_XDMA_PERF_LATENCY:
+		rv = ioctl_do_perf_latency(engine, arg);
+		break;
 	case IOCTL_XDMA_ADDRMODE_SET:
 		rv = ioctl_do_addrmode_set(engine, arg);
 		break;
@@ -837,6 +1543,12 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 	case IOCTL_XDMA_APERTURE_W:
 		rv = ioctl_do_aperture_dma(engine, arg, 1);
 		break;
+	case IOCTL_XDMA_REGISTER_BUF:
+		rv = ioctl_do_register_buf(xcdev, file, arg);
+		break;
+	case IOCTL_XDMA_UNREGISTER_BUF:
+		rv = ioctl_do_unregister_buf(xcdev, file, arg);
+		break;
 	default:
 		dbg_perf("Unsupported operation\n");
 		rv = -EINVAL;
@@ -846,6 +1558,191 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 	return rv;
 }
 
+/*
+ * mmap() hands out DMA buffers allocated by the driver in physically
+ * contiguous chunks of up to 2MB, falling back to smaller ones under
+ * fragmentation. They are mapped for the engine at mmap time and every chunk
+ * takes a single descriptor, read/write on the file pointing into the
+ * mapping go through the registered buffer path.
+ */
+#define XDMA_MMAP_CHUNK_ORDER	(PAGE_SHIFT < 21 ? 21 - PAGE_SHIFT : 0)
+
+struct sgdma_mmap_chunk {
+	struct page *page;
+	unsigned int order;
+};
+
+static int sgdma_mmap_alloc(struct xdma_reg_buf *rb, unsigned long len)
+{
+	unsigned long left = len >> PAGE_SHIFT;
+	unsigned int order = XDMA_MMAP_CHUNK_ORDER;
+	struct sgdma_mmap_chunk *chunk;
+	struct scatterlist *sg;
+	unsigned int nr = 0;
+	int i;
+	int rv = 0;
+
+	chunk = kcalloc(left, sizeof(struct sgdma_mmap_chunk), GFP_KERNEL);
+	if (!chunk)
+		return -ENOMEM;
+
+	while (left) {
+		unsigned int o = min_t(unsigned int, order, ilog2(left));
+		gfp_t gfp = GFP_KERNEL | __GFP_ZERO;
+		struct page *page;
+
+		if (o)
+			gfp |= __GFP_NOWARN | __GFP_NORETRY;
+		page = alloc_pages(gfp, o);
+		if (!page) {
+			if (!o) {
+				pr_err("buffer OOM, %lu pages left.\n", left);
+				rv = -ENOMEM;
+				goto free_chunks;
+			}
+			order = o - 1;
+			continue;
+		}
+
+		chunk[nr].page = page;
+		chunk[nr].order = o;
+		nr++;
+		left -= 1UL << o;
+	}
+
+	if (sg_alloc_table(&rb->sgt, nr, GFP_KERNEL)) {
+		pr_err("sgl OOM.\n");
+		rv = -ENOMEM;
+		goto free_chunks;
+	}
+
+	for_each_sg(rb->sgt.sgl, sg, nr, i)
+		sg_set_page(sg, chunk[i].page, PAGE_SIZE << chunk[i].order, 0);
+
+	kfree(chunk);
+	return 0;
+
+free_chunks:
+	while (nr--)
+		__free_pages(chunk[nr].page, chunk[nr].order);
+	kfree(chunk);
+	return rv;
+}
+
+static void sgdma_vma_open(struct vm_area_struct *vma)
+{
+	struct xdma_reg_buf *rb = vma->vm_private_data;
+
+	kref_get(&rb->ref);
+}
+
+/*
+ * Unmapping any part of the buffer retires it from the transfer path, the
+ * pages go once the last piece of the mapping is gone.
+ */
+static void sgdma_vma_close(struct vm_area_struct *vma)
+{
+	struct xdma_cdev *xcdev = (struct xdma_cdev *)
+					vma->vm_file->private_data;
+	struct xdma_reg_buf *rb = vma->vm_private_data;
+
+	reg_buf_del(xcdev, rb);
+	reg_buf_put(rb);
+}
+
+static const struct vm_operations_struct sgdma_vm_ops = {
+	.open = sgdma_vma_open,
+	.close = sgdma_vma_close,
+};
+
+static int char_sgdma_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct xdma_cdev *xcdev = (struct xdma_cdev *)file->private_data;
+	unsigned long len = vma->vm_end - vma->vm_start;
+	unsigned long addr = vma->vm_start;
+	struct xdma_engine *engine;
+	struct xdma_reg_buf *rb;
+	struct scatterlist *sg;
+	int nents;
+	int rv;
+	int i;
+
+	rv = xcdev_check(__func__, xcdev, 1);
+	if (rv < 0)
+		return rv;
+	engine = xcdev->engine;
+
+	/* one buffer per mapping, shared with the device */
+	if (vma->vm_pgoff || !(vma->vm_flags & VM_SHARED))
+		return -EINVAL;
+
+	rb = kzalloc(sizeof(struct xdma_reg_buf), GFP_KERNEL);
+	if (!rb)
+		return -ENOMEM;
+
+	rv = sgdma_mmap_alloc(rb, len);
+	if (rv < 0)
+		goto free_rb;
+
+	nents = pci_map_sg(xcdev->xdev->pdev, rb->sgt.sgl, rb->sgt.orig_nents,
+				engine->dir);
+	if (!nents) {
+		pr_info("map sgl failed, sgt 0x%p.\n", &rb->sgt);
+		rv = -EIO;
+		goto free_pages;
+	}
+	rb->sgt.nents = nents;
+
+	for_each_sg(rb->sgt.sgl, sg, rb->sgt.orig_nents, i) {
+		rv = remap_pfn_range(vma, addr, page_to_pfn(sg_page(sg)),
+				sg->length, vma->vm_page_prot);
+		if (rv < 0) {
+			pr_err("remap 0x%lx,%u failed %d.\n", addr,
+				sg->length, rv);
+			goto unmap;
+		}
+		addr += sg->length;
+	}
+
+	/* a child would retire the buffer with its copy of the mapping */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0)
+	vm_flags_set(vma, VM_DONTCOPY);
+#else
+	vma->vm_flags |= VM_DONTCOPY;
+#endif
+
+	kref_init(&rb->ref);
+	rb->xdev = xcdev->xdev;
+	rb->dir = engine->dir;
+	rb->buf = vma->vm_start;
+	rb->len = len;
+	rb->pages_nr = len >> PAGE_SHIFT;
+	rb->alloc = true;
+	reg_buf_add(xcdev, rb, file, vma->vm_mm);
+
+	/* the mapping holds its own reference next to the list's */
+	kref_get(&rb->ref);
+	vma->vm_private_data = rb;
+	vma->vm_ops = &sgdma_vm_ops;
+
+	dbg_tfr("%s, mmap buf %u, 0x%lx,%lu, %u chunks, %d segments.\n",
+		engine->name, rb->handle, rb->buf, rb->len,
+		rb->sgt.orig_nents, nents);
+
+	return 0;
+
+unmap:
+	pci_unmap_sg(xcdev->xdev->pdev, rb->sgt.sgl, rb->sgt.orig_nents,
+			engine->dir);
+free_pages:
+	for_each_sg(rb->sgt.sgl, sg, rb->sgt.orig_nents, i)
+		__free_pages(sg_page(sg), get_order(sg->length));
+	sg_free_table(&rb->sgt);
+free_rb:
+	kfree(rb);
+	return rv;
+}
+
 static int char_sgdma_open(struct inode *inode, struct file *file)
 {
 	struct xdma_cdev *xcdev;
@@ -879,6 +1776,8 @@ static int char_sgdma_close(struct inode *inode, struct file *file)
 
 	engine = xcdev->engine;
 
+	reg_buf_release_file(xcdev, file);
+
 	if (engine->streaming && engine->dir == DMA_FROM_DEVICE)
 		engine->device_open = 0;
 
@@ -901,6 +1800,10 @@ static const struct file_operations sgdma_fops = {
 	.aio_read = cdev_aio_read,
 #endif
 	.unlocked_ioctl = char_sgdma_ioctl,
+	.mmap = char_sgdma_mmap,
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0)
+	.uring_cmd = cdev_uring_cmd,
+#endif
 	.llseek = char_sgdma_llseek,
 };
 
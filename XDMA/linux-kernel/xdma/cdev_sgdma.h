@@ -21,6 +21,7 @@
 #define _XDMA_IOCALLS_POSIX_H_
 
 #include <linux/ioctl.h>
+#include "xdma_latency.h"
 
 
 #define IOCTL_XDMA_PERF_V1 (1)
@@ -67,6 +68,39 @@ struct xdma_aperture_ioctl {
 	unsigned long done;
 };
 
+/*
+ * user buffer pinned and dma mapped once, then referenced by its handle or
+ * by address from read/write on the same file
+ */
+struct xdma_buf_ioctl {
+	unsigned long buffer;
+	unsigned long len;
+	/* returned by IOCTL_XDMA_REGISTER_BUF */
+	uint32_t handle;
+};
+
+/*
+ * io_uring passthrough (IORING_OP_URING_CMD, needs IORING_SETUP_SQE128):
+ * transfer len bytes at offset into a registered buffer, the direction
+ * follows the device node.
+ */
+#define XDMA_URING_CMD_XFER	(1)
+
+struct xdma_uring_cmd {
+	uint64_t ep_addr;
+	uint64_t offset;
+	uint32_t len;
+	uint32_t handle;
+};
+
+/* request completion latency of the engine, submit to wake up */
+struct xdma_latency_ioctl {
+	/* IOCTL_XDMA_IOCTL_Vx */
+	uint32_t version;
+	/* clear the counts once read */
+	uint32_t reset;
+	struct xdma_latency_stat mode[XDMA_LAT_MODES];
+};
 
 /* IOCTL codes */
 
@@ -78,5 +112,8 @@ struct xdma_aperture_ioctl {
 #define IOCTL_XDMA_ALIGN_GET    _IOR('q', 6, int)
 #define IOCTL_XDMA_APERTURE_R   _IOW('q', 7, struct xdma_aperture_ioctl *)
 #define IOCTL_XDMA_APERTURE_W   _IOW('q', 8, struct xdma_aperture_ioctl *)
+#define IOCTL_XDMA_REGISTER_BUF _IOWR('q', 9, struct xdma_buf_ioctl *)
+#define IOCTL_XDMA_UNREGISTER_BUF _IO('q', 10)
+#define IOCTL_XDMA_PERF_LATENCY _IOWR('q', 11, struct xdma_latency_ioctl *)
 
 #endif /* _XDMA_IOCALLS_POSIX_H_ */
@@ -26,6 +26,9 @@
 #include <linux/errno.h>
 #include <linux/sched.h>
 #include <linux/vmalloc.h>
+#include <linux/delay.h>
+#include <linux/ktime.h>
+#include <linux/log2.h>
 
 #include "libxdma.h"
 #include "libxdma_api.h"
@@ -52,6 +55,21 @@ module_param(desc_blen_max, uint, 0644);
 MODULE_PARM_DESC(desc_blen_max,
 		 "per descriptor max. buffer length, default is (1 << 28) - 1");
 
+static unsigned int poll_spin_us = 20;
+module_param(poll_spin_us, uint, 0644);
+MODULE_PARM_DESC(poll_spin_us,
+	"poll mode, usecs to busy spin on the writeback before sleeping, default 20");
+
+static unsigned int poll_sleep_us = 1000;
+module_param(poll_sleep_us, uint, 0644);
+MODULE_PARM_DESC(poll_sleep_us,
+	"poll mode, usecs of short sleeps after spinning before sleeping a jiffy at a time, default 1000");
+
+static unsigned int poll_inline_max = 4096;
+module_param(poll_inline_max, uint, 0644);
+MODULE_PARM_DESC(poll_inline_max,
+	"poll mode, requests up to this many bytes are polled by the submitter, 0 to always use the thread, default 4096");
+
 #define XDMA_PERF_NUM_DESC 128
 
 /* Kernel version adaptative code */
@@ -110,8 +128,7 @@ static inline int xdev_list_add(struct xdma_dev *xdev)
 	if (list_empty(&xdev_list)) {
 		xdev->idx = 0;
 		if (poll_mode) {
-			int rv = xdma_threads_create(xdev->h2c_channel_max +
-					xdev->c2h_channel_max);
+			int rv = xdma_threads_create();
 			if (rv < 0) {
 				mutex_unlock(&xdev_mutex);
 				return rv;
@@ -799,6 +816,10 @@ static int engine_service_shutdown(struct xdma_engine *engine)
 	return 0;
 }
 
+static void engine_ring_retire(struct xdma_engine *engine,
+			       struct xdma_transfer *xfer);
+static void engine_ring_fill(struct xdma_engine *engine);
+
 static struct xdma_transfer *engine_transfer_completion(
 		struct xdma_engine *engine,
 		struct xdma_transfer *transfer)
@@ -813,6 +834,12 @@ static struct xdma_transfer *engine_transfer_completion(
 		return NULL;
 	}
 
+	/* shared ring: completion is accounted to the request */
+	if (transfer->flags & XFER_FLAG_RING) {
+		engine_ring_retire(engine, transfer);
+		return transfer;
+	}
+
 	/* synchronous I/O? */
 	/* awake task on transfer's wait queue */
 	xlx_wake_up(&transfer->wq);
@@ -862,6 +889,7 @@ engine_service_transfer_list(struct xdma_engine *engine,
 		engine->desc_dequeued += transfer->desc_num;
 		/* mark transfer as succesfully completed */
 		transfer->state = TRANSFER_STATE_COMPLETED;
+		transfer->desc_cmpl = transfer->desc_num;
 
 		/*
 		 * Complete transfer - sets transfer to NULL if an async
@@ -1087,6 +1115,68 @@ static int engine_service_resume(struct xdma_engine *engine)
 	return 0;
 }
 
+/*
+ * engine_chain_pending() - check if the engine may still be running a chain
+ *
+ * In polled mode the writeback of a transfer in the middle of a chain is
+ * not the end of the engine run: the status has to be read to tell.
+ */
+static bool engine_chain_pending(struct xdma_engine *engine, u32 desc_count)
+{
+	struct xdma_transfer *transfer;
+	u32 desc_queued = 0;
+
+	if (engine->eop_flush || !desc_count)
+		return false;
+
+	list_for_each_entry(transfer, &engine->transfer_list, entry)
+		desc_queued += transfer->desc_num;
+
+	return (desc_count - engine->desc_dequeued) < desc_queued;
+}
+
+static bool engine_chain_running(struct xdma_engine *engine)
+{
+	u32 err_mask = (engine->dir == DMA_TO_DEVICE) ?
+			XDMA_STAT_H2C_ERR_MASK : XDMA_STAT_C2H_ERR_MASK;
+
+	return !engine->eop_flush && (engine->status & XDMA_STAT_BUSY) &&
+	       !(engine->status & (XDMA_STAT_DESC_STOPPED | err_mask));
+}
+
+/*
+ * engine_service_chain() - dequeue the transfers completed by an engine
+ * that moved on to the next transfer of a chain, see transfer_queue()
+ *
+ * The last transfer on the queue is left to the engine stop handling.
+ *
+ * must be called with engine->lock already acquired
+ */
+static void engine_service_chain(struct xdma_engine *engine, u32 desc_count)
+{
+	struct xdma_transfer *transfer;
+
+	desc_count -= engine->desc_dequeued;
+
+	while (!list_empty(&engine->transfer_list)) {
+		transfer = list_entry(engine->transfer_list.next,
+				      struct xdma_transfer, entry);
+		if (transfer->cyclic || (desc_count < transfer->desc_num) ||
+		    list_is_last(&transfer->entry, &engine->transfer_list))
+			break;
+
+		dbg_tfr("%s engine completed chained xfer 0x%p (%d desc)\n",
+			engine->name, transfer, transfer->desc_num);
+
+		desc_count -= transfer->desc_num;
+		list_del(engine->transfer_list.next);
+		engine->desc_dequeued += transfer->desc_num;
+		transfer->state = TRANSFER_STATE_COMPLETED;
+		transfer->desc_cmpl = transfer->desc_num;
+		engine_transfer_completion(engine, transfer);
+	}
+}
+
 /**
  * engine_service() - service an SG DMA engine
  *
@@ -1121,14 +1211,27 @@ static int engine_service(struct xdma_engine *engine, int desc_writeback)
 	/*
 	 * If called by the ISR or polling detected an error, read and clear
 	 * engine status. For polled mode descriptor completion, this read is
-	 * unnecessary and is skipped to reduce latency
+	 * unnecessary and is skipped to reduce latency, unless the engine may
+	 * still be running further chained transfers
 	 */
-	if ((desc_count == 0) || (err_flag != 0)) {
+	if ((desc_count == 0) || (err_flag != 0) ||
+	    engine_chain_pending(engine, desc_count)) {
 		rv = engine_status_read(engine, 1, 0);
 		if (rv < 0) {
 			pr_err("Failed to read engine status\n");
 			return rv;
 		}
+
+		/* completed transfers of a chain, the engine carries on */
+		if (!err_flag && engine_chain_running(engine)) {
+			if (!desc_count)
+				desc_count = read_register(
+					&engine->regs->completed_desc_count);
+			engine_service_chain(engine, desc_count);
+			if (engine->ring)
+				engine_ring_fill(engine);
+			return 0;
+		}
 	}
 
 	/*
@@ -1198,6 +1301,10 @@ static int engine_service(struct xdma_engine *engine, int desc_writeback)
 			pr_err("Failed to resume engine\n");
 	}
 
+	/* build more requests into the descriptors just freed */
+	if (engine->ring)
+		engine_ring_fill(engine);
+
 done:
 	/* If polling detected an error, signal to the caller */
 	return err_flag ? -1 : 0;
@@ -1243,13 +1350,21 @@ unlock:
 	spin_unlock_irqrestore(&engine->lock, flags);
 }
 
+/*
+ * engine_service_wb_monitor() - wait for the expected writeback count
+ *
+ * @budget_us give up after this many usecs, returning 0, or 0 to wait up to
+ * POLL_TIMEOUT_SECONDS
+ */
 static u32 engine_service_wb_monitor(struct xdma_engine *engine,
-				     u32 expected_wb)
+				     u32 expected_wb, unsigned int budget_us)
 {
 	struct xdma_poll_wb *wb_data;
 	u32 desc_wb = 0;
-	u32 sched_limit = 0;
+	unsigned int sleep_us = XDMA_POLL_USLEEP_MIN;
 	unsigned long timeout;
+	ktime_t start;
+	s64 elapsed;
 
 	if (!engine) {
 		pr_err("dma engine NULL\n");
@@ -1264,20 +1379,23 @@ static u32 engine_service_wb_monitor(struct xdma_engine *engine,
 	 * determined before the function is called
 	 */
 
+	start = ktime_get();
 	timeout = jiffies + (POLL_TIMEOUT_SECONDS * HZ);
 	while (expected_wb != 0) {
-		desc_wb = wb_data->completed_desc_count;
+		desc_wb = READ_ONCE(wb_data->completed_desc_count);
 
-		if (desc_wb)
-			wb_data->completed_desc_count = 0;
-
-		if (desc_wb & WB_ERR_MASK)
-			break;
-		else if (desc_wb >= expected_wb)
+		/*
+		 * Consume the writeback atomically: with chained transfers
+		 * the next one may write back between a read and a clear.
+		 */
+		if ((desc_wb & WB_ERR_MASK) || desc_wb >= expected_wb) {
+			desc_wb = xchg(&wb_data->completed_desc_count, 0);
 			break;
+		}
 
 		/* prevent system from hanging in polled mode */
 		if (time_after(jiffies, timeout)) {
+			desc_wb = xchg(&wb_data->completed_desc_count, 0);
 			dbg_tfr("Polling timeout occurred");
 			dbg_tfr("desc_wb = 0x%08x, expected 0x%08x\n", desc_wb,
 				expected_wb);
@@ -1288,27 +1406,59 @@ static u32 engine_service_wb_monitor(struct xdma_engine *engine,
 		}
 
 		/*
-		 * Define NUM_POLLS_PER_SCHED to limit how much time is spent
-		 * in the scheduler
+		 * Back off the longer the writeback takes: busy spin first,
+		 * then short sleeps with a growing interval, then a jiffy at
+		 * a time.
 		 */
-
-		if (sched_limit != 0) {
-			if ((sched_limit % NUM_POLLS_PER_SCHED) == 0)
-				schedule();
+		elapsed = ktime_us_delta(ktime_get(), start);
+		if (budget_us && elapsed >= budget_us)
+			return 0;
+		if (elapsed < poll_spin_us) {
+			cpu_relax();
+		} else if (elapsed < (s64)poll_spin_us + poll_sleep_us) {
+			usleep_range(sleep_us, sleep_us * 2);
+			sleep_us = min_t(unsigned int, sleep_us * 2,
+					XDMA_POLL_USLEEP_MAX);
+		} else {
+			schedule_timeout_interruptible(1);
 		}
-		sched_limit++;
 	}
 
 	return desc_wb;
 }
 
-int engine_service_poll(struct xdma_engine *engine,
-			       u32 expected_desc_count)
+/* caller holds engine->poll_lock, see engine_service_wb_monitor() */
+static int __engine_service_poll(struct xdma_engine *engine,
+				 u32 expected_desc_count,
+				 unsigned int budget_us)
 {
 	u32 desc_wb = 0;
 	unsigned long flags;
 	int rv = 0;
 
+	desc_wb = engine_service_wb_monitor(engine, expected_desc_count,
+					    budget_us);
+	if (!desc_wb)
+		return 0;
+
+	spin_lock_irqsave(&engine->lock, flags);
+	dbg_tfr("%s service.\n", engine->name);
+	rv = engine_service(engine, desc_wb);
+	spin_unlock_irqrestore(&engine->lock, flags);
+
+	return rv;
+}
+
+/*
+ * engine_service_poll() - poll the writeback and service the engine. A
+ * submitter polling inline holds the engine for at most poll_spin_us, see
+ * engine_poll_kick(): sleep until it is done rather than spin.
+ */
+int engine_service_poll(struct xdma_engine *engine,
+			       u32 expected_desc_count)
+{
+	int rv;
+
 	if (!engine) {
 		pr_err("dma engine NULL\n");
 		return -EINVAL;
@@ -1320,23 +1470,151 @@ int engine_service_poll(struct xdma_engine *engine,
 		return -EINVAL;
 	}
 
-	/*
-	 * Poll the writeback location for the expected number of
-	 * descriptors / error events This loop is skipped for cyclic mode,
-	 * where the expected_desc_count passed in is zero, since it cannot be
-	 * determined before the function is called
-	 */
+	mutex_lock(&engine->poll_lock);
+	rv = __engine_service_poll(engine, expected_desc_count, 0);
+	mutex_unlock(&engine->poll_lock);
 
-	desc_wb = engine_service_wb_monitor(engine, expected_desc_count);
-	if (!desc_wb)
-		return 0;
+	return rv;
+}
 
-	spin_lock_irqsave(&engine->lock, flags);
-	dbg_tfr("%s service.\n", engine->name);
-	rv = engine_service(engine, desc_wb);
-	spin_unlock_irqrestore(&engine->lock, flags);
+/*
+ * engine_poll_kick() - poll mode: get a just queued request noticed when it
+ * completes. Small requests are polled for by the submitter itself for up to
+ * poll_spin_us, or timeout_ms if shorter, sparing the thread wake up, as long
+ * as no one else polls the engine already; the rest is left to the
+ * completion thread.
+ *
+ * @state state of the request or transfer waited for
+ *
+ * Returns the XDMA_LAT_MODE_* the completion is noticed in.
+ */
+static int engine_poll_kick(struct xdma_engine *engine, unsigned int len,
+			    enum transfer_state *state, int timeout_ms)
+{
+	unsigned int budget_us = poll_spin_us;
 
-	return rv;
+	if (!engine->cmplthp)
+		return XDMA_LAT_MODE_IRQ;
+
+	if (timeout_ms > 0)
+		budget_us = min_t(u64, budget_us, (u64)timeout_ms * 1000);
+
+	if (budget_us && len <= poll_inline_max &&
+	    mutex_trylock(&engine->poll_lock)) {
+		ktime_t start = ktime_get();
+		s64 left;
+
+		while (READ_ONCE(*state) == TRANSFER_STATE_SUBMITTED &&
+		       !signal_pending(current)) {
+			struct xdma_transfer *xfer;
+			unsigned long flags;
+			u32 expected = 0;
+
+			left = budget_us - ktime_us_delta(ktime_get(), start);
+			if (left <= 0)
+				break;
+
+			spin_lock_irqsave(&engine->lock, flags);
+			xfer = list_first_entry_or_null(&engine->transfer_list,
+						struct xdma_transfer, entry);
+			if (xfer)
+				expected = xfer->desc_cmpl_th;
+			spin_unlock_irqrestore(&engine->lock, flags);
+
+			if (expected)
+				__engine_service_poll(engine, expected, left);
+			else
+				cpu_relax();
+			cond_resched();
+		}
+		mutex_unlock(&engine->poll_lock);
+
+		if (READ_ONCE(*state) != TRANSFER_STATE_SUBMITTED)
+			return XDMA_LAT_MODE_INLINE;
+	}
+
+	xdma_kthread_wakeup(engine->cmplthp);
+	return XDMA_LAT_MODE_THREAD;
+}
+
+/* histogram bucket of a latency, see XDMA_LAT_SUB_BITS */
+static unsigned int latency_bucket(u64 ns)
+{
+	unsigned int msb;
+	unsigned int idx;
+
+	if (ns < (1 << XDMA_LAT_SUB_BITS))
+		return ns;
+
+	msb = ilog2(ns);
+	idx = ((msb - XDMA_LAT_SUB_BITS + 1) << XDMA_LAT_SUB_BITS) |
+	      ((ns >> (msb - XDMA_LAT_SUB_BITS)) &
+	       ((1 << XDMA_LAT_SUB_BITS) - 1));
+
+	return min_t(unsigned int, idx, XDMA_LAT_BUCKETS - 1);
+}
+
+/* middle of the latency range covered by a bucket */
+static u64 latency_bucket_ns(unsigned int idx)
+{
+	unsigned int grp = idx >> XDMA_LAT_SUB_BITS;
+	u64 sub = idx & ((1 << XDMA_LAT_SUB_BITS) - 1);
+
+	if (!grp)
+		return idx;
+
+	return (((1ULL << XDMA_LAT_SUB_BITS) | sub) << (grp - 1)) +
+		((1ULL << (grp - 1)) >> 1);
+}
+
+static void engine_latency_record(struct xdma_engine *engine, int mode,
+				  ktime_t start)
+{
+	u64 ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	atomic_inc(&engine->lat_hist[mode][latency_bucket(ns)]);
+}
+
+static u64 latency_percentile(u32 *hist, u64 total, unsigned int pct)
+{
+	u64 target = div_u64(total * pct + 99, 100);
+	u64 seen = 0;
+	int i;
+
+	for (i = 0; i < XDMA_LAT_BUCKETS; i++) {
+		seen += hist[i];
+		if (seen && seen >= target)
+			return latency_bucket_ns(i);
+	}
+
+	return 0;
+}
+
+/*
+ * engine_latency_get() - p50/p99 of the request completion latency, from
+ * submission to the submitter waking up, into stat[XDMA_LAT_MODE_*]
+ */
+void engine_latency_get(struct xdma_engine *engine,
+			struct xdma_latency_stat *stat, bool reset)
+{
+	u32 hist[XDMA_LAT_BUCKETS];
+	int mode;
+	int i;
+
+	for (mode = 0; mode < XDMA_LAT_MODES; mode++) {
+		u64 total = 0;
+
+		for (i = 0; i < XDMA_LAT_BUCKETS; i++) {
+			atomic_t *cnt = &engine->lat_hist[mode][i];
+
+			hist[i] = reset ? atomic_xchg(cnt, 0) : atomic_read(cnt);
+			total += hist[i];
+		}
+
+		stat[mode].count = total;
+		stat[mode].p50_ns = latency_percentile(hist, total, 50);
+		stat[mode].p99_ns = latency_percentile(hist, total, 99);
+	}
 }
 
 static irqreturn_t user_irq_service(int irq, struct xdma_user_irq *user_irq)
@@ -2437,6 +2715,80 @@ static int transfer_abort(struct xdma_engine *engine,
 	return 0;
 }
 
+/*
+ * transfer_link() - let the engine run on from prev into transfer
+ *
+ * The last descriptor of prev is linked to the first one of transfer before
+ * its STOPPED bit is cleared. An engine that has fetched the descriptor
+ * already stops there and is restarted by engine_service_resume().
+ */
+static void transfer_link(struct xdma_transfer *prev,
+			  struct xdma_transfer *transfer)
+{
+	struct xdma_desc *last = prev->desc_virt + prev->desc_num - 1;
+
+	xdma_desc_link(last, transfer->desc_virt, transfer->desc_bus);
+	/* make the link visible before the engine may follow it */
+	wmb();
+	xdma_desc_control_set(last, XDMA_DESC_COMPLETED);
+}
+
+/*
+ * __transfer_queue() - queue a DMA transfer on the engine, chained behind
+ * the transfer list tail if both allow it, see transfer_link()
+ *
+ * must be called with engine->lock already acquired
+ */
+static int __transfer_queue(struct xdma_engine *engine,
+			    struct xdma_transfer *transfer)
+{
+	struct xdma_transfer *transfer_started;
+
+	engine->prev_cpu = get_cpu();
+	put_cpu();
+
+	/* engine is being shutdown; do not accept new transfers */
+	if (engine->shutdown & ENGINE_SHUTDOWN_REQUEST) {
+		pr_info("engine %s offline, transfer 0x%p not queued.\n",
+			engine->name, transfer);
+		return -EBUSY;
+	}
+
+	/* chain behind the previous transfer, if running */
+	if (engine->running && (transfer->flags & XFER_FLAG_CHAIN) &&
+	    !list_empty(&engine->transfer_list)) {
+		struct xdma_transfer *prev = list_entry(
+				engine->transfer_list.prev,
+				struct xdma_transfer, entry);
+
+		if (prev->flags & XFER_FLAG_CHAIN)
+			transfer_link(prev, transfer);
+	}
+
+	/* mark the transfer as submitted */
+	transfer->state = TRANSFER_STATE_SUBMITTED;
+	/* add transfer to the tail of the engine transfer queue */
+	list_add_tail(&transfer->entry, &engine->transfer_list);
+
+	/* engine is idle? */
+	if (!engine->running) {
+		/* start engine */
+		dbg_tfr("%s(): starting %s engine.\n", __func__, engine->name);
+		transfer_started = engine_start(engine);
+		if (!transfer_started) {
+			pr_err("Failed to start dma engine\n");
+			return 0;
+		}
+		dbg_tfr("transfer=0x%p started %s engine with transfer 0x%p.\n",
+			transfer, engine->name, transfer_started);
+	} else {
+		dbg_tfr("transfer=0x%p queued, with %s engine running.\n",
+			transfer, engine->name);
+	}
+
+	return 0;
+}
+
 /* transfer_queue() - Queue a DMA transfer on the engine
  *
  * @engine DMA engine doing the transfer
@@ -2448,7 +2800,6 @@ static int transfer_queue(struct xdma_engine *engine,
 			  struct xdma_transfer *transfer)
 {
 	int rv = 0;
-	struct xdma_transfer *transfer_started;
 	struct xdma_dev *xdev;
 	unsigned long flags;
 
@@ -2484,39 +2835,8 @@ static int transfer_queue(struct xdma_engine *engine,
 	/* lock the engine state */
 	spin_lock_irqsave(&engine->lock, flags);
 
-	engine->prev_cpu = get_cpu();
-	put_cpu();
-
-	/* engine is being shutdown; do not accept new transfers */
-	if (engine->shutdown & ENGINE_SHUTDOWN_REQUEST) {
-		pr_info("engine %s offline, transfer 0x%p not queued.\n",
-			engine->name, transfer);
-		rv = -EBUSY;
-		goto shutdown;
-	}
-
-	/* mark the transfer as submitted */
-	transfer->state = TRANSFER_STATE_SUBMITTED;
-	/* add transfer to the tail of the engine transfer queue */
-	list_add_tail(&transfer->entry, &engine->transfer_list);
-
-	/* engine is idle? */
-	if (!engine->running) {
-		/* start engine */
-		dbg_tfr("%s(): starting %s engine.\n", __func__, engine->name);
-		transfer_started = engine_start(engine);
-		if (!transfer_started) {
-			pr_err("Failed to start dma engine\n");
-			goto shutdown;
-		}
-		dbg_tfr("transfer=0x%p started %s engine with transfer 0x%p.\n",
-			transfer, engine->name, transfer_started);
-	} else {
-		dbg_tfr("transfer=0x%p queued, with %s engine running.\n",
-			transfer, engine->name);
-	}
+	rv = __transfer_queue(engine, transfer);
 
-shutdown:
 	/* unlock the engine state */
 	dbg_tfr("engine->running = %d\n", engine->running);
 	spin_unlock_irqrestore(&engine->lock, flags);
@@ -2859,6 +3179,8 @@ static int engine_init(struct xdma_engine *engine, struct xdma_dev *xdev,
 	val = read_register(&engine->regs->identifier);
 	if (val & 0x8000U)
 		engine->streaming = 1;
+	/* MM requests of any number of callers can share the ring */
+	engine->ring = !engine->streaming;
 
 	/* remember SG DMA direction */
 	engine->dir = dir;
@@ -2893,7 +3215,7 @@ static int engine_init(struct xdma_engine *engine, struct xdma_dev *xdev,
 		return rv;
 
 	if (poll_mode)
-		xdma_thread_add_work(engine);
+		return xdma_thread_add_work(engine);
 
 	return 0;
 }
@@ -2954,21 +3276,30 @@ static int transfer_build(struct xdma_engine *engine,
 }
 
 
-static int transfer_init(struct xdma_engine *engine,
-			struct xdma_request_cb *req, struct xdma_transfer *xfer)
+/*
+ * __transfer_init() - build the next transfer of a request into the free part
+ * of the descriptor ring, at most desc_cap descriptors
+ *
+ * must be called with engine->lock already acquired
+ */
+static int __transfer_init(struct xdma_engine *engine,
+			   struct xdma_request_cb *req,
+			   struct xdma_transfer *xfer, unsigned int desc_cap)
 {
-	unsigned int desc_max = min_t(unsigned int,
-				req->sw_desc_cnt - req->sw_desc_idx,
-				engine->desc_max);
+	unsigned int desc_max = min3(req->sw_desc_cnt - req->sw_desc_idx,
+				     desc_cap, (unsigned int)engine->desc_max);
 	int i = 0;
 	int last = 0;
 	u32 control;
-	unsigned long flags;
 
 	memset(xfer, 0, sizeof(*xfer));
 
-	/* lock the engine state */
-	spin_lock_irqsave(&engine->lock, flags);
+	/* never overwrite descriptors still owned by queued transfers */
+	if (engine->desc_used >= engine->desc_max)
+		return -EBUSY;
+	desc_max = min_t(unsigned int, desc_max,
+			 engine->desc_max - engine->desc_used);
+
 	/* initialize wait queue */
 #if HAS_SWAKE_UP
 	init_swait_queue_head(&xfer->wq);
@@ -2986,8 +3317,6 @@ static int transfer_init(struct xdma_engine *engine,
 			(sizeof(struct xdma_result) * engine->desc_idx);
 	xfer->desc_index = engine->desc_idx;
 
-	/* Need to handle desc_used >= engine->desc_max */
-
 	if ((engine->desc_idx + desc_max) >= engine->desc_max)
 		desc_max = engine->desc_max - engine->desc_idx;
 
@@ -3001,10 +3330,14 @@ static int transfer_init(struct xdma_engine *engine,
 
 	/* terminate last descriptor */
 	last = desc_max - 1;
-	/* stop engine, EOP for AXI ST, req IRQ on last descriptor */
+	/*
+	 * stop engine, req IRQ on last descriptor, EOP for AXI ST at the end
+	 * of the request only
+	 */
 	control = XDMA_DESC_STOPPED;
-	control |= XDMA_DESC_EOP;
 	control |= XDMA_DESC_COMPLETED;
+	if (req->sw_desc_idx == req->sw_desc_cnt)
+		control |= XDMA_DESC_EOP;
 	xdma_desc_control_set(xfer->desc_virt + last, control);
 
 	if (engine->eop_flush) {
@@ -3028,10 +3361,272 @@ static int transfer_init(struct xdma_engine *engine,
 		xdma_desc_adjacent(xfer->desc_virt + i, next_adj);
 	}
 
-	spin_unlock_irqrestore(&engine->lock, flags);
 	return 0;
 }
 
+static int transfer_init(struct xdma_engine *engine,
+			struct xdma_request_cb *req, struct xdma_transfer *xfer,
+			unsigned int desc_cap)
+{
+	unsigned long flags;
+	int rv;
+
+	/* lock the engine state */
+	spin_lock_irqsave(&engine->lock, flags);
+	rv = __transfer_init(engine, req, xfer, desc_cap);
+	spin_unlock_irqrestore(&engine->lock, flags);
+
+	return rv;
+}
+
+/*
+ * Shared descriptor ring (MM engines)
+ *
+ * Submitters add their request to the lockless engine->req_llist and do
+ * not wait for each other. engine_ring_fill() builds the requests, in
+ * submission order, into the free part of the descriptor ring, each
+ * transfer chained behind the tail of the running engine. Transfers are
+ * retired by engine_service() in ring order from the completed descriptor
+ * count, which frees their descriptors for the next fill.
+ */
+
+static void engine_request_done(struct xdma_engine *engine,
+				struct xdma_request_cb *req)
+{
+	if (!list_empty(&req->entry))
+		list_del_init(&req->entry);
+
+	/* the request may be gone once signalled */
+	req->state = req->error ? TRANSFER_STATE_FAILED :
+				  TRANSFER_STATE_COMPLETED;
+	if (req->cb)
+		req->cb->io_done((unsigned long)req->cb, req->error);
+	else
+		xlx_wake_up(&req->wq);
+}
+
+/*
+ * engine_ring_retire() - release the descriptors of a finished transfer
+ * and account it to its request
+ *
+ * must be called with engine->lock already acquired
+ */
+static void engine_ring_retire(struct xdma_engine *engine,
+			       struct xdma_transfer *xfer)
+{
+	struct xdma_request_cb *req = xfer->req;
+
+	engine->desc_used -= xfer->desc_num;
+
+	if (xfer->state == TRANSFER_STATE_COMPLETED) {
+		req->done += xfer->len;
+	} else if (!req->error) {
+		pr_info("%s, req 0x%p, xfer 0x%p,%u, s 0x%x failed.\n",
+			engine->name, req, xfer, xfer->len, xfer->state);
+		req->error = -EIO;
+	}
+
+	req->xfer_head = (req->xfer_head + 1) % XDMA_REQ_XFER_MAX;
+	req->xfer_inflight--;
+
+	if (!req->xfer_inflight &&
+	    (req->error || (req->sw_desc_idx == req->sw_desc_cnt)))
+		engine_request_done(engine, req);
+}
+
+/* move newly submitted requests to engine->req_list, oldest first */
+static void engine_ring_pull(struct xdma_engine *engine)
+{
+	struct llist_node *first;
+	struct xdma_request_cb *req, *tmp;
+
+	first = llist_reverse_order(llist_del_all(&engine->req_llist));
+	llist_for_each_entry_safe(req, tmp, first, llnode)
+		list_add_tail(&req->entry, &engine->req_list);
+}
+
+/*
+ * engine_ring_fill() - build submitted requests into the free descriptors
+ *
+ * must be called with engine->lock already acquired
+ */
+static void engine_ring_fill(struct xdma_engine *engine)
+{
+	struct xdma_request_cb *req, *tmp;
+	struct xdma_transfer *xfer;
+	int rv;
+
+	engine_ring_pull(engine);
+
+	/* ring drained for exclusive use, see xdma_xfer_aperture() */
+	if (engine->ring_hold) {
+		if (list_empty(&engine->transfer_list))
+			xlx_wake_up(&engine->shutdown_wq);
+		return;
+	}
+
+	list_for_each_entry_safe(req, tmp, &engine->req_list, entry) {
+		while (!req->error &&
+		       (req->sw_desc_idx < req->sw_desc_cnt) &&
+		       (req->xfer_inflight < XDMA_REQ_XFER_MAX)) {
+			xfer = &req->tfer[(req->xfer_head + req->xfer_inflight) %
+					  XDMA_REQ_XFER_MAX];
+
+			rv = __transfer_init(engine, req, xfer,
+				engine->desc_max / XDMA_REQ_XFER_MAX);
+			if (rv < 0)
+				return;	/* ring full */
+
+			xfer->flags = XFER_FLAG_RING | XFER_FLAG_CHAIN;
+			xfer->req = req;
+
+			rv = __transfer_queue(engine, xfer);
+			if (rv < 0) {
+				/* nothing was built after it, take it back */
+				engine->desc_idx = xfer->desc_index;
+				engine->desc_used -= xfer->desc_num;
+				req->error = rv;
+				break;
+			}
+			req->xfer_inflight++;
+		}
+
+		/* out of transfer slots: keep the submission order */
+		if (!req->error && (req->sw_desc_idx < req->sw_desc_cnt))
+			return;
+
+		list_del_init(&req->entry);
+		if (!req->xfer_inflight)
+			engine_request_done(engine, req);
+	}
+}
+
+/*
+ * engine_ring_detach() - give up on a request its caller stopped waiting for
+ *
+ * Nothing more of it is built, the other requests are not affected.
+ * Returns false if some of its transfers are still on the engine: its
+ * buffers must stay mapped until they are off, see engine_ring_restart().
+ *
+ * must be called with engine->lock already acquired
+ */
+static bool engine_ring_detach(struct xdma_engine *engine,
+			       struct xdma_request_cb *req, int err)
+{
+	engine_ring_pull(engine);
+
+	if (!req->error)
+		req->error = err;
+	if (!list_empty(&req->entry))
+		list_del_init(&req->entry);
+
+	if (req->state != TRANSFER_STATE_SUBMITTED)
+		return true;
+	if (!req->xfer_inflight) {
+		engine_request_done(engine, req);
+		/* it may have held back the ones behind it */
+		engine_ring_fill(engine);
+		return true;
+	}
+	return false;
+}
+
+/*
+ * engine_ring_restart() - the engine is stuck with transfers of a detached
+ * request: stop it, retire them, and rebuild the transfers of the other
+ * requests from the first unfinished one, which restarts the engine. MM
+ * transfers can safely be run again.
+ *
+ * must be called with engine->lock already acquired
+ */
+static void engine_ring_restart(struct xdma_engine *engine,
+				struct xdma_request_cb *req)
+{
+	struct xdma_transfer *xfer, *tmp;
+	struct xdma_request_cb *r;
+	LIST_HEAD(requeue);
+
+	if (engine->running && xdma_engine_stop(engine) < 0)
+		pr_err("Failed to stop engine\n");
+
+	list_for_each_entry_safe(xfer, tmp, &engine->transfer_list, entry) {
+		if (!(xfer->flags & XFER_FLAG_RING))
+			continue;
+		list_del(&xfer->entry);
+
+		r = xfer->req;
+		if (r == req) {
+			xfer->state = TRANSFER_STATE_ABORTED;
+			engine_ring_retire(engine, xfer);
+			continue;
+		}
+
+		/* rewind the request to the start of the transfer */
+		engine->desc_used -= xfer->desc_num;
+		r->sw_desc_idx -= xfer->desc_num;
+		if (!engine->non_incr_addr)
+			r->ep_addr -= xfer->len;
+		r->xfer_inflight--;
+		if (list_empty(&r->entry))
+			list_add_tail(&r->entry, &requeue);
+	}
+
+	/* ahead of those not built yet, in the original order */
+	list_splice(&requeue, &engine->req_list);
+	engine_ring_fill(engine);
+}
+
+/*
+ * engine_ring_submit() - queue a request on the shared descriptor ring
+ *
+ * Completion is signalled on req->wq, or through req->cb->io_done(). In
+ * poll mode the caller still has to get it noticed, see engine_poll_kick().
+ */
+static void engine_ring_submit(struct xdma_engine *engine,
+			       struct xdma_request_cb *req)
+{
+	unsigned long flags;
+
+	req->state = TRANSFER_STATE_SUBMITTED;
+	INIT_LIST_HEAD(&req->entry);
+#if HAS_SWAKE_UP
+	init_swait_queue_head(&req->wq);
+#else
+	init_waitqueue_head(&req->wq);
+#endif
+
+	/* the first one on an empty queue kicks the filling */
+	if (llist_add(&req->llnode, &engine->req_llist)) {
+		spin_lock_irqsave(&engine->lock, flags);
+		engine_ring_fill(engine);
+		spin_unlock_irqrestore(&engine->lock, flags);
+	}
+}
+
+/* engine_ring_hold() - drain the shared ring for exclusive use, or release */
+static int engine_ring_hold(struct xdma_engine *engine, bool hold)
+{
+	unsigned long flags;
+	int rv = 0;
+
+	if (!engine->ring)
+		return 0;
+
+	spin_lock_irqsave(&engine->lock, flags);
+	engine->ring_hold = hold;
+	if (!hold)
+		engine_ring_fill(engine);
+	spin_unlock_irqrestore(&engine->lock, flags);
+
+	if (hold) {
+		rv = xlx_wait_event_interruptible(engine->shutdown_wq,
+				list_empty(&engine->transfer_list));
+		if (rv < 0)
+			engine_ring_hold(engine, 0);
+	}
+	return rv;
+}
+
 #ifdef __LIBXDMA_DEBUG__
 static void sgt_dump(struct sg_table *sgt)
 {
@@ -3159,6 +3754,8 @@ ssize_t xdma_xfer_aperture(struct xdma_engine *engine, bool write, u64 ep_addr,
 	unsigned int sg_max;
 	unsigned int tlen = 0;
 	u64 ep_addr_max = ep_addr + aperture - 1;
+	int lat_mode = XDMA_LAT_MODE_IRQ;
+	ktime_t start = ktime_get();
 	ssize_t done = 0;
 	int i, rv = 0;
 
@@ -3223,6 +3820,13 @@ ssize_t xdma_xfer_aperture(struct xdma_engine *engine, bool write, u64 ep_addr,
 
 	mutex_lock(&engine->desc_lock);
 
+	/* aperture transfers do not share the descriptor ring */
+	rv = engine_ring_hold(engine, 1);
+	if (rv < 0) {
+		mutex_unlock(&engine->desc_lock);
+		goto unmap_sgl;
+	}
+
 	while (req->offset < req->total_len) {
 		unsigned long flags;
 		struct xdma_transfer *xfer = &req->tfer[0];
@@ -3353,13 +3957,14 @@ ssize_t xdma_xfer_aperture(struct xdma_engine *engine, bool write, u64 ep_addr,
 
 		rv = transfer_queue(engine, xfer);
 		if (rv < 0) {
+			engine_ring_hold(engine, 0);
 			mutex_unlock(&engine->desc_lock);
 			pr_info("unable to submit %s, %d.\n", engine->name, rv);
 			goto unmap_sgl;
 		}
 
-		if (engine->cmplthp)
-			xdma_kthread_wakeup(engine->cmplthp);
+		lat_mode = engine_poll_kick(engine, xfer->len, &xfer->state,
+					    timeout_ms);
 
 		if (timeout_ms > 0)
 			xlx_wait_event_interruptible_timeout(xfer->wq,
@@ -3426,11 +4031,14 @@ ssize_t xdma_xfer_aperture(struct xdma_engine *engine, bool write, u64 ep_addr,
 		transfer_destroy(xdev, xfer);
 
 		if (rv < 0) {
+			engine_ring_hold(engine, 0);
 			mutex_unlock(&engine->desc_lock);
 			goto unmap_sgl;
 		}
 	} /* while (sg) */
+	engine_ring_hold(engine, 0);
 	mutex_unlock(&engine->desc_lock);
+	engine_latency_record(engine, lat_mode, start);
 
 unmap_sgl:
 	if (!dma_mapped && sgt->nents) {
@@ -3445,17 +4053,59 @@ unmap_sgl:
 	return done ? done : rv;
 }
 
+/*
+ * xdma_request_abort() - take in-flight transfers of a failed request off
+ * the engine and release their descriptors
+ *
+ * @head slot of the oldest in-flight transfer
+ * @inflight number of in-flight transfers
+ */
+static void xdma_request_abort(struct xdma_engine *engine,
+			       struct xdma_request_cb *req, unsigned int head,
+			       unsigned int inflight)
+{
+	struct xdma_transfer *xfer;
+	unsigned long flags;
+	unsigned int i;
+	int rv;
+
+	spin_lock_irqsave(&engine->lock, flags);
+	for (i = 0; i < inflight; i++) {
+		xfer = &req->tfer[(head + i) % XDMA_REQ_XFER_MAX];
+		if (xfer->state == TRANSFER_STATE_SUBMITTED) {
+			list_del(&xfer->entry);
+			xfer->state = TRANSFER_STATE_ABORTED;
+		}
+	}
+	if (engine->running) {
+		rv = xdma_engine_stop(engine);
+		if (rv < 0)
+			pr_err("Failed to stop engine\n");
+	}
+	spin_unlock_irqrestore(&engine->lock, flags);
+
+	for (i = 0; i < inflight; i++) {
+		xfer = &req->tfer[(head + i) % XDMA_REQ_XFER_MAX];
+		engine->desc_used -= xfer->desc_num;
+		transfer_destroy(engine->xdev, xfer);
+	}
+}
+
 ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 			 struct sg_table *sgt, bool dma_mapped, int timeout_ms)
 {
 	struct xdma_dev *xdev = (struct xdma_dev *)dev_hndl;
 	struct xdma_engine *engine;
-	int rv = 0, tfer_idx = 0, i;
+	unsigned int head = 0, inflight = 0, xfer_max, desc_cap;
+	bool chain;
+	int rv = 0, i;
 	ssize_t done = 0;
 	struct scatterlist *sg = sgt->sgl;
 	int nents;
 	enum dma_data_direction dir = write ? DMA_TO_DEVICE : DMA_FROM_DEVICE;
 	struct xdma_request_cb *req = NULL;
+	int lat_mode = XDMA_LAT_MODE_IRQ;
+	ktime_t start;
 
 	if (!dev_hndl)
 		return -EINVAL;
@@ -3526,50 +4176,133 @@ ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 
 	dbg_tfr("%s, len %u sg cnt %u.\n", engine->name, req->total_len,
 		req->sw_desc_cnt);
+	start = ktime_get();
+
+	/* MM: share the descriptor ring with the other callers */
+	if (engine->ring) {
+		unsigned long flags;
+
+		engine_ring_submit(engine, req);
+		lat_mode = engine_poll_kick(engine, req->total_len,
+					    &req->state, timeout_ms);
+
+		if (timeout_ms > 0)
+			xlx_wait_event_interruptible_timeout(req->wq,
+				(req->state != TRANSFER_STATE_SUBMITTED),
+				msecs_to_jiffies(timeout_ms));
+		else
+			xlx_wait_event_interruptible(req->wq,
+				(req->state != TRANSFER_STATE_SUBMITTED));
+
+		spin_lock_irqsave(&engine->lock, flags);
+		if (req->state == TRANSFER_STATE_SUBMITTED) {
+			int err = signal_pending(current) ? -ERESTARTSYS :
+							    -ETIMEDOUT;
+			unsigned long drain = jiffies +
+				msecs_to_jiffies(XDMA_RING_DRAIN_MS);
+
+			pr_info("%s, req 0x%p,%u %s, ep 0x%llx.\n",
+				engine->name, req, req->total_len,
+				err == -ETIMEDOUT ? "timed out" : "interrupted",
+				ep_addr);
+
+			if (!engine_ring_detach(engine, req, err)) {
+				while (req->state == TRANSFER_STATE_SUBMITTED &&
+				       time_before(jiffies, drain)) {
+					spin_unlock_irqrestore(&engine->lock,
+							       flags);
+					msleep(1);
+					spin_lock_irqsave(&engine->lock, flags);
+				}
+				if (req->state == TRANSFER_STATE_SUBMITTED) {
+					engine_status_read(engine, 0, 1);
+					engine_ring_restart(engine, req);
+				}
+			}
+		}
+		spin_unlock_irqrestore(&engine->lock, flags);
+
+		if (req->state == TRANSFER_STATE_COMPLETED)
+			engine_latency_record(engine, lat_mode, start);
+
+		done = req->done;
+		rv = req->error;
+		goto unmap_sgl;
+	}
+
+	/*
+	 * Keep up to XDMA_REQ_XFER_MAX transfers of the request queued, each
+	 * chained behind the previous one, so the engine runs through the
+	 * request without stopping. The descriptors of the oldest transfer
+	 * are recycled as soon as it completes. EOP flush and C2H credit
+	 * mode need the engine to stop on each transfer: one at a time.
+	 */
+	chain = !engine->eop_flush &&
+		!(enable_st_c2h_credit && engine->streaming &&
+		  engine->dir == DMA_FROM_DEVICE);
+	if (chain) {
+		xfer_max = XDMA_REQ_XFER_MAX;
+		desc_cap = engine->desc_max / XDMA_REQ_XFER_MAX;
+	} else {
+		xfer_max = 1;
+		desc_cap = engine->desc_max;
+	}
 
-	sg = sgt->sgl;
-	nents = req->sw_desc_cnt;
 	mutex_lock(&engine->desc_lock);
 
-	while (nents) {
+	while ((req->sw_desc_idx < req->sw_desc_cnt) || inflight) {
 		unsigned long flags;
 		struct xdma_transfer *xfer;
 
-		/* build transfer */
-		rv = transfer_init(engine, req, &req->tfer[0]);
-		if (rv < 0) {
-			mutex_unlock(&engine->desc_lock);
-			goto unmap_sgl;
-		}
-		xfer = &req->tfer[0];
+		/* build and queue transfers while ring and slots allow */
+		while ((req->sw_desc_idx < req->sw_desc_cnt) &&
+		       (inflight < xfer_max)) {
+			xfer = &req->tfer[(head + inflight) % XDMA_REQ_XFER_MAX];
 
-		if (!dma_mapped)
-			xfer->flags = XFER_FLAG_NEED_UNMAP;
+			rv = transfer_init(engine, req, xfer, desc_cap);
+			if (rv == -EBUSY && inflight) {
+				/* ring full, wait for the oldest transfer */
+				rv = 0;
+				break;
+			}
+			if (rv < 0)
+				goto abort;
 
-		/* last transfer for the given request? */
-		nents -= xfer->desc_num;
-		if (!nents) {
-			xfer->last_in_request = 1;
-			xfer->sgt = sgt;
-		}
+			if (!dma_mapped)
+				xfer->flags = XFER_FLAG_NEED_UNMAP;
+			if (chain)
+				xfer->flags |= XFER_FLAG_CHAIN;
+
+			/* last transfer for the given request? */
+			if (req->sw_desc_idx == req->sw_desc_cnt) {
+				xfer->last_in_request = 1;
+				xfer->sgt = sgt;
+			}
 
-		dbg_tfr("xfer, %u, ep 0x%llx, done %lu, sg %u/%u.\n", xfer->len,
-			req->ep_addr, done, req->sw_desc_idx, req->sw_desc_cnt);
+			dbg_tfr("xfer, %u, ep 0x%llx, done %lu, sg %u/%u.\n",
+				xfer->len, req->ep_addr, done,
+				req->sw_desc_idx, req->sw_desc_cnt);
 
 #ifdef __LIBXDMA_DEBUG__
-		transfer_dump(xfer);
+			transfer_dump(xfer);
 #endif
 
-		rv = transfer_queue(engine, xfer);
-		if (rv < 0) {
-			mutex_unlock(&engine->desc_lock);
-			pr_info("unable to submit %s, %d.\n", engine->name, rv);
-			goto unmap_sgl;
+			rv = transfer_queue(engine, xfer);
+			if (rv < 0) {
+				pr_info("unable to submit %s, %d.\n",
+					engine->name, rv);
+				engine->desc_used -= xfer->desc_num;
+				transfer_destroy(xdev, xfer);
+				goto abort;
+			}
+			inflight++;
 		}
 
-		if (engine->cmplthp)
-			xdma_kthread_wakeup(engine->cmplthp);
+		lat_mode = engine_poll_kick(engine, req->total_len,
+					    &req->tfer[head].state, timeout_ms);
 
+		/* wait for the oldest transfer of the request */
+		xfer = &req->tfer[head];
 		if (timeout_ms > 0)
 			xlx_wait_event_interruptible_timeout(xfer->wq,
 				(xfer->state != TRANSFER_STATE_SUBMITTED),
@@ -3585,9 +4318,8 @@ ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 			spin_unlock_irqrestore(&engine->lock, flags);
 
 			rv = 0;
-			dbg_tfr("transfer %p, %u, ep 0x%llx compl, +%lu.\n",
-				xfer, xfer->len, req->ep_addr - xfer->len,
-				done);
+			dbg_tfr("transfer %p, %u compl, +%lu.\n",
+				xfer, xfer->len, done);
 
 			/* For C2H streaming use writeback results */
 			if (engine->streaming &&
@@ -3599,7 +4331,7 @@ ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 
 				/* finish the whole request */
 				if (engine->eop_flush)
-					nents = 0;
+					req->sw_desc_idx = req->sw_desc_cnt;
 			} else
 				done += xfer->len;
 
@@ -3620,19 +4352,8 @@ ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 			pr_info("xfer 0x%p,%u, s 0x%x timed out, ep 0x%llx.\n",
 				xfer, xfer->len, xfer->state, req->ep_addr);
 			rv = engine_status_read(engine, 0, 1);
-			if (rv < 0) {
+			if (rv < 0)
 				pr_err("Failed to read engine status\n");
-			} else if (rv == 0) {
-				//engine_status_dump(engine);
-				rv = transfer_abort(engine, xfer);
-				if (rv < 0) {
-					pr_err("Failed to stop engine\n");
-				} else if (rv == 0) {
-					rv = xdma_engine_stop(engine);
-					if (rv < 0)
-						pr_err("Failed to stop engine\n");
-				}
-			}
 			spin_unlock_irqrestore(&engine->lock, flags);
 
 #ifdef __LIBXDMA_DEBUG__
@@ -3643,19 +4364,22 @@ ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 			break;
 		}
 
+		if (rv < 0)
+			goto abort;
+
 		engine->desc_used -= xfer->desc_num;
 		transfer_destroy(xdev, xfer);
+		head = (head + 1) % XDMA_REQ_XFER_MAX;
+		inflight--;
+	}
+	mutex_unlock(&engine->desc_lock);
+	engine_latency_record(engine, lat_mode, start);
+	goto unmap_sgl;
 
-		/* use multiple transfers per request if we could not fit
-		 * all data within single descriptor chain.
-		 */
-		tfer_idx++;
-
-		if (rv < 0) {
-			mutex_unlock(&engine->desc_lock);
-			goto unmap_sgl;
-		}
-	} /* while (sg) */
+abort:
+	/* take the transfers of the request still in flight off the engine */
+	if (inflight)
+		xdma_request_abort(engine, req, head, inflight);
 	mutex_unlock(&engine->desc_lock);
 
 unmap_sgl:
@@ -3721,6 +4445,12 @@ ssize_t xdma_xfer_completion(void *cb_hndl, void *dev_hndl, int channel,
 	xdev = engine->xdev;
 	req = cb->req;
 
+	/* shared ring: accounted per request by the engine */
+	if (engine->ring) {
+		done = req->error ? req->error : req->done;
+		goto unmap_sgl;
+	}
+
 	nents = req->sw_desc_cnt;
 	while (nents) {
 		xfer = &req->tfer[tfer_idx];
@@ -3881,6 +4611,14 @@ ssize_t xdma_xfer_submit_nowait(void *cb_hndl, void *dev_hndl, int channel,
 	dbg_tfr("%s, len %u sg cnt %u.\n",
 		engine->name, req->total_len, req->sw_desc_cnt);
 
+	/* MM: completion is signalled for the whole request */
+	if (engine->ring) {
+		engine_ring_submit(engine, req);
+		if (engine->cmplthp)
+			xdma_kthread_wakeup(engine->cmplthp);
+		return -EIOCBQUEUED;
+	}
+
 	sg = sgt->sgl;
 	nents = req->sw_desc_cnt;
 	while (nents) {
@@ -3889,8 +4627,11 @@ ssize_t xdma_xfer_submit_nowait(void *cb_hndl, void *dev_hndl, int channel,
 
 		/* one transfer at a time */
 		xfer = &req->tfer[tfer_idx];
-		/* build transfer */
-		rv = transfer_init(engine, req, xfer);
+		/* build transfer, out of slots if the ring is mostly in use */
+		if (tfer_idx < XDMA_REQ_XFER_MAX)
+			rv = transfer_init(engine, req, xfer, engine->desc_max);
+		else
+			rv = -EBUSY;
 		if (rv < 0) {
 			pr_info("transfer_init failed\n");
 
@@ -4127,7 +4868,10 @@ static struct xdma_dev *alloc_dev_instance(struct pci_dev *pdev)
 	for (i = 0; i < XDMA_CHANNEL_NUM_MAX; i++, engine++) {
 		spin_lock_init(&engine->lock);
 		mutex_init(&engine->desc_lock);
+		mutex_init(&engine->poll_lock);
 		INIT_LIST_HEAD(&engine->transfer_list);
+		init_llist_head(&engine->req_llist);
+		INIT_LIST_HEAD(&engine->req_list);
 #if HAS_SWAKE_UP
 		init_swait_queue_head(&engine->shutdown_wq);
 		init_swait_queue_head(&engine->xdma_perf_wq);
@@ -4141,7 +4885,10 @@ static struct xdma_dev *alloc_dev_instance(struct pci_dev *pdev)
 	for (i = 0; i < XDMA_CHANNEL_NUM_MAX; i++, engine++) {
 		spin_lock_init(&engine->lock);
 		mutex_init(&engine->desc_lock);
+		mutex_init(&engine->poll_lock);
 		INIT_LIST_HEAD(&engine->transfer_list);
+		init_llist_head(&engine->req_llist);
+		INIT_LIST_HEAD(&engine->req_list);
 #if HAS_SWAKE_UP
 		init_swait_queue_head(&engine->shutdown_wq);
 		init_swait_queue_head(&engine->xdma_perf_wq);
@@ -29,8 +29,10 @@
 #include <linux/interrupt.h>
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
+#include <linux/llist.h>
 #include <linux/pci.h>
 #include <linux/workqueue.h>
+#include "xdma_latency.h"
 
 /* Add compatibility checking for RHEL versions */
 #if defined(RHEL_RELEASE_CODE)
@@ -75,8 +77,17 @@
 /* maximum amount of register space to map */
 #define XDMA_BAR_SIZE (0x8000UL)
 
-/* Use this definition to poll several times between calls to schedule */
-#define NUM_POLLS_PER_SCHED 100
+/*
+ * poll mode backoff: busy spin for poll_spin_us, then sleep with an interval
+ * growing from XDMA_POLL_USLEEP_MIN to XDMA_POLL_USLEEP_MAX until
+ * poll_sleep_us is up, then a jiffy at a time
+ */
+#define XDMA_POLL_USLEEP_MIN	(10)
+#define XDMA_POLL_USLEEP_MAX	(200)
+
+/* completion latency histogram, 1 << XDMA_LAT_SUB_BITS buckets per 2^n ns */
+#define XDMA_LAT_SUB_BITS	(2)
+#define XDMA_LAT_BUCKETS	(40 << XDMA_LAT_SUB_BITS)
 
 #define XDMA_CHANNEL_NUM_MAX (4)
 /*
@@ -437,6 +448,8 @@ struct sw_desc {
 /* Describes a (SG DMA) single transfer for the engine */
 #define XFER_FLAG_NEED_UNMAP		0x1
 #define XFER_FLAG_ST_C2H_EOP_RCVED	0x2	/* ST c2h only */ 
+#define XFER_FLAG_CHAIN			0x4	/* may follow a running xfer */
+#define XFER_FLAG_RING			0x8	/* retired by engine_service() */
 struct xdma_transfer {
 	struct list_head entry;		/* queue of non-completed transfers */
 	struct xdma_desc *desc_virt;	/* virt addr of the 1st descriptor */
@@ -462,8 +475,18 @@ struct xdma_transfer {
 	unsigned int len;
 	struct sg_table *sgt;
 	struct xdma_io_cb *cb;
+	struct xdma_request_cb *req;	/* owning request, XFER_FLAG_RING */
 };
 
+/* max. in-flight transfers per request, each takes 1/N of the ring */
+#define XDMA_REQ_XFER_MAX	4
+
+/*
+ * shared ring: how long the transfers of a timed out or interrupted request
+ * get to leave the engine before it is considered stuck and restarted
+ */
+#define XDMA_RING_DRAIN_MS	1000
+
 struct xdma_request_cb {
 	struct sg_table *sgt;
 	u64 ep_addr;
@@ -476,11 +499,28 @@ struct xdma_request_cb {
 	unsigned int sg_idx;
 	unsigned int sg_offset;
 
-	/* Use two transfers in case single request needs to be split */
-	struct xdma_transfer tfer[2];
+	/*
+	 * A request is split into up to XDMA_REQ_XFER_MAX transfers, chained
+	 * on the engine so that it only stops at the end of the request
+	 */
+	struct xdma_transfer tfer[XDMA_REQ_XFER_MAX];
 
 	struct xdma_io_cb *cb;
 
+	/* MM engines: shared descriptor ring, see engine_ring_fill() */
+	struct llist_node llnode;	/* on engine->req_llist once submitted */
+	struct list_head entry;		/* on engine->req_list until built */
+	enum transfer_state state;	/* request state, set when all done */
+	int error;			/* first error of its transfers */
+	unsigned int xfer_head;		/* oldest in-flight transfer slot */
+	unsigned int xfer_inflight;	/* transfers queued on the engine */
+	ssize_t done;			/* bytes of the completed transfers */
+#if	HAS_SWAKE_UP
+	struct swait_queue_head wq;
+#else
+	wait_queue_head_t wq;		/* wait queue for request completion */
+#endif
+
 	unsigned int sw_desc_idx;
 	unsigned int sw_desc_cnt;
 	struct sw_desc sdesc[0];
@@ -509,7 +549,7 @@ struct xdma_engine {
 	u8 running:1;		/* flag if the driver started engine */
 	u8 non_incr_addr:1;	/* flag if non-incremental addressing used */
 	u8 eop_flush:1;		/* st c2h only, flush up the data with eop */
-	u8 filler:1;
+	u8 ring:1;		/* MM only, descriptor ring shared by requests */
 
 	int max_extra_adj;	/* descriptor prefetch capability */
 	int desc_dequeued;	/* num descriptors of completed transfers */
@@ -549,6 +589,11 @@ struct xdma_engine {
 	int desc_idx;			/* current descriptor index */
 	int desc_used;			/* total descriptors used */
 
+	/* shared descriptor ring (MM), see engine_ring_fill() */
+	struct llist_head req_llist;	/* lockless queue of new requests */
+	struct list_head req_list;	/* requests not yet fully built */
+	int ring_hold;			/* ring drained for exclusive use */
+
 	/* for performance test support */
 	struct xdma_performance_ioctl *xdma_perf;	/* perf test control */
 #if	HAS_SWAKE_UP
@@ -563,6 +608,11 @@ struct xdma_engine {
 	/* pending work thread list */
 	/* cpu attached to intr_work */
 	unsigned int intr_work_cpu;
+	/* one poller of the writeback at a time, thread or submitter */
+	struct mutex poll_lock;
+
+	/* completion latency per XDMA_LAT_MODE_*, see engine_latency_get() */
+	atomic_t lat_hist[XDMA_LAT_MODES][XDMA_LAT_BUCKETS];
 };
 
 struct xdma_user_irq {
@@ -688,6 +738,8 @@ void get_perf_stats(struct xdma_engine *engine);
 
 int engine_addrmode_set(struct xdma_engine *engine, unsigned long arg);
 int engine_service_poll(struct xdma_engine *engine, u32 expected_desc_count);
+void engine_latency_get(struct xdma_engine *engine,
+			struct xdma_latency_stat *stat, bool reset);
 
 ssize_t xdma_xfer_aperture(struct xdma_engine *engine, bool write, u64 ep_addr,
 			unsigned int aperture, struct sg_table *sgt,
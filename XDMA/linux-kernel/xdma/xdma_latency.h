@@ -0,0 +1,40 @@
+/*
+ * This file is part of the Xilinx DMA IP Core driver for Linux
+ *
+ * Copyright (c) 2016-present,  Xilinx, Inc.
+ * All rights reserved.
+ *
+ * This source code is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * The full GNU General Public License is included in this distribution in
+ * the file called "COPYING".
+ */
+
+#ifndef _XDMA_LATENCY_H_
+#define _XDMA_LATENCY_H_
+
+/*
+ * completion latency statistics, shared by libxdma and the user space
+ * interface, see IOCTL_XDMA_PERF_LATENCY
+ */
+
+/* how a transfer completion was noticed */
+#define XDMA_LAT_MODE_IRQ	(0)	/* interrupt */
+#define XDMA_LAT_MODE_THREAD	(1)	/* poll mode, completion thread */
+#define XDMA_LAT_MODE_INLINE	(2)	/* poll mode, polled by the submitter */
+#define XDMA_LAT_MODES		(3)
+
+struct xdma_latency_stat {
+	uint64_t count;
+	uint64_t p50_ns;
+	uint64_t p99_ns;
+};
+
+#endif /* _XDMA_LATENCY_H_ */
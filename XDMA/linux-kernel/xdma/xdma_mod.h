@@ -70,6 +70,8 @@ struct xdma_cdev {
 	struct xdma_user_irq *user_irq;	/* IRQ value, if needed */
 	struct device *sys_device;	/* sysfs device */
 	spinlock_t lock;
+	struct list_head buf_list;	/* registered user buffers, sgdma */
+	u32 buf_handle;			/* last handle given out */
 };
 
 /* XDMA PCIe device specific book-keeping */
@@ -23,11 +23,65 @@
 
 #include <linux/kernel.h>
 #include <linux/slab.h>
+#include <linux/moduleparam.h>
+#include <linux/cpumask.h>
+#include <linux/topology.h>
+#include <linux/string.h>
 
 
 /* ********************* global variables *********************************** */
+/* one slot per possible cpu, a thread is started on first use */
 static struct xdma_kthread *cs_threads;
 static unsigned int thread_cnt;
+/* protects cs_threads, thread_cnt, poll_cpumask and thread_cpus */
+static DEFINE_MUTEX(thread_mutex);
+static struct cpumask poll_cpumask;
+/* scratch mask for xdma_thread_add_work() */
+static struct cpumask thread_cpus;
+
+static int poll_cpus_set(const char *val, const struct kernel_param *kp)
+{
+	cpumask_var_t mask;
+	char *buf;
+	int rv;
+
+	buf = kstrdup(val, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+	if (!zalloc_cpumask_var(&mask, GFP_KERNEL)) {
+		kfree(buf);
+		return -ENOMEM;
+	}
+
+	rv = cpulist_parse(strim(buf), mask);
+	if (!rv) {
+		/* engines are not moved between threads once assigned */
+		mutex_lock(&thread_mutex);
+		if (cs_threads)
+			rv = -EBUSY;
+		else
+			cpumask_copy(&poll_cpumask, mask);
+		mutex_unlock(&thread_mutex);
+	}
+
+	free_cpumask_var(mask);
+	kfree(buf);
+	return rv;
+}
+
+static int poll_cpus_get(char *buf, const struct kernel_param *kp)
+{
+	return scnprintf(buf, PAGE_SIZE, "%*pbl\n",
+			 cpumask_pr_args(&poll_cpumask));
+}
+
+static const struct kernel_param_ops poll_cpus_ops = {
+	.set = poll_cpus_set,
+	.get = poll_cpus_get,
+};
+module_param_cb(poll_cpus, &poll_cpus_ops, NULL, 0644);
+MODULE_PARM_DESC(poll_cpus,
+	"poll mode, cpu list for the completion threads, e.g. 2-3,6, cannot be changed while a device is bound, default: the cpus of the device's numa node");
 
 
 /* ********************* static function definitions ************************ */
@@ -48,13 +102,20 @@ static int xdma_thread_cmpl_status_pend(struct list_head *work_item)
 static int xdma_thread_cmpl_status_proc(struct list_head *work_item)
 {
 	struct xdma_engine *engine;
-	struct xdma_transfer * transfer;
+	struct xdma_transfer *transfer;
+	unsigned long flags;
+	u32 expected = 0;
 
 	engine = list_entry(work_item, struct xdma_engine, cmplthp_list);
-	transfer = list_entry(engine->transfer_list.next, struct xdma_transfer,
-			entry);
+	spin_lock_irqsave(&engine->lock, flags);
+	transfer = list_first_entry_or_null(&engine->transfer_list,
+					    struct xdma_transfer, entry);
 	if (transfer)
-		engine_service_poll(engine, transfer->desc_cmpl_th);
+		expected = transfer->desc_cmpl_th;
+	spin_unlock_irqrestore(&engine->lock, flags);
+
+	if (expected)
+		engine_service_poll(engine, expected);
 	return 0;
 }
 
@@ -154,7 +215,7 @@ int xdma_kthread_start(struct xdma_kthread *thp, char *name, int id)
 
 	thp->id = id;
 
-	spin_lock_init(&thp->lock);
+	mutex_init(&thp->lock);
 	INIT_LIST_HEAD(&thp->work_list);
 	init_waitqueue_head(&thp->waitq);
 
@@ -208,6 +269,8 @@ void xdma_thread_remove_work(struct xdma_engine *engine)
 	struct xdma_kthread *cmpl_thread;
 	unsigned long flags;
 
+	might_sleep();
+
 	spin_lock_irqsave(&engine->lock, flags);
 	cmpl_thread = engine->cmplthp;
 	engine->cmplthp = NULL;
@@ -234,35 +297,72 @@ void xdma_thread_remove_work(struct xdma_engine *engine)
 	}
 }
 
-void xdma_thread_add_work(struct xdma_engine *engine)
+/* cpus an engine's poller may run on: poll_cpus, else the device's node */
+static void xdma_thread_cpus(struct xdma_engine *engine, struct cpumask *cpus)
 {
-	struct xdma_kthread *thp = cs_threads;
+	int node = dev_to_node(&engine->xdev->pdev->dev);
+
+	cpumask_and(cpus, &poll_cpumask, cpu_online_mask);
+	if (cpumask_empty(cpus) && node != NUMA_NO_NODE)
+		cpumask_and(cpus, cpumask_of_node(node), cpu_online_mask);
+	if (cpumask_empty(cpus))
+		cpumask_copy(cpus, cpu_online_mask);
+}
+
+int xdma_thread_add_work(struct xdma_engine *engine)
+{
+	struct xdma_kthread *thp;
+	unsigned int cpu, idx = nr_cpu_ids;
 	unsigned int v = 0;
-	int i, idx = thread_cnt;
 	unsigned long flags;
 
+	might_sleep();
 
 	/* Polled mode only */
-	for (i = 0; i < thread_cnt; i++, thp++) {
-		lock_thread(thp);
-		if (idx == thread_cnt) {
-			v = thp->work_cnt;
-			idx = i;
-		} else if (!thp->work_cnt) {
-			idx = i;
-			unlock_thread(thp);
+	mutex_lock(&thread_mutex);
+	if (!cs_threads) {
+		mutex_unlock(&thread_mutex);
+		pr_err("%s, no cmpl status threads.\n", engine->name);
+		return -EINVAL;
+	}
+
+	xdma_thread_cpus(engine, &thread_cpus);
+	for_each_cpu(cpu, &thread_cpus) {
+		thp = cs_threads + cpu;
+		if (!thp->task || !thp->work_cnt) {
+			idx = cpu;
 			break;
-		} else if (thp->work_cnt < v)
-			idx = i;
-		unlock_thread(thp);
+		}
+		if (idx == nr_cpu_ids || thp->work_cnt < v) {
+			v = thp->work_cnt;
+			idx = cpu;
+		}
 	}
 
 	thp = cs_threads + idx;
+	if (!thp->task) {
+		int rv;
+
+		thp->cpu = idx;
+		thp->timeout = 0;
+		thp->fproc = xdma_thread_cmpl_status_proc;
+		thp->fpending = xdma_thread_cmpl_status_pend;
+		rv = xdma_kthread_start(thp, "cmpl_status_th", idx);
+		if (rv < 0) {
+			mutex_unlock(&thread_mutex);
+			pr_err("%s, cmpl status thread on cpu %u failed %d.\n",
+				engine->name, idx, rv);
+			return rv;
+		}
+		thread_cnt++;
+	}
+
 	lock_thread(thp);
 	list_add_tail(&engine->cmplthp_list, &thp->work_list);
 	engine->intr_work_cpu = idx;
 	thp->work_cnt++;
 	unlock_thread(thp);
+	mutex_unlock(&thread_mutex);
 
 	pr_info("%s 0x%p assigned to cmpl status thread %s,%u.\n",
 		engine->name, engine, thp->name, thp->work_cnt);
@@ -271,69 +371,50 @@ void xdma_thread_add_work(struct xdma_engine *engine)
 	spin_lock_irqsave(&engine->lock, flags);
 	engine->cmplthp = thp;
 	spin_unlock_irqrestore(&engine->lock, flags);
+
+	return 0;
 }
 
-int xdma_threads_create(unsigned int num_threads)
+int xdma_threads_create(void)
 {
-	struct xdma_kthread *thp;
-	int rv;
-	int cpu;
+	int rv = 0;
 
-	if (thread_cnt) {
+	mutex_lock(&thread_mutex);
+	if (cs_threads) {
 		pr_warn("threads already created!");
-		return 0;
+		goto out;
 	}
 
-	cs_threads = kzalloc(num_threads * sizeof(struct xdma_kthread),
-					GFP_KERNEL);
+	/* started on demand by xdma_thread_add_work() */
+	cs_threads = kcalloc(nr_cpu_ids, sizeof(struct xdma_kthread),
+			     GFP_KERNEL);
 	if (!cs_threads) {
-		pr_err("OOM, # threads %u.\n", num_threads);
-		return -ENOMEM;
-	}
-
-	/* N dma writeback monitoring threads */
-	thp = cs_threads;
-	for_each_online_cpu(cpu) {
-		pr_debug("index %d cpu %d online\n", thread_cnt, cpu);
-		thp->cpu = cpu;
-		thp->timeout = 0;
-		thp->fproc = xdma_thread_cmpl_status_proc;
-		thp->fpending = xdma_thread_cmpl_status_pend;
-		rv = xdma_kthread_start(thp, "cmpl_status_th", thread_cnt);
-		if (rv < 0)
-			goto cleanup_threads;
-
-		thread_cnt++;
-		if (thread_cnt == num_threads)
-			break;
-		thp++;
+		pr_err("OOM, # threads %u.\n", nr_cpu_ids);
+		rv = -ENOMEM;
 	}
 
-	return 0;
-
-cleanup_threads:
-	kfree(cs_threads);
-	cs_threads = NULL;
-	thread_cnt = 0;
-
+out:
+	mutex_unlock(&thread_mutex);
 	return rv;
 }
 
 void xdma_threads_destroy(void)
 {
-	int i;
-	struct xdma_kthread *thp;
+	unsigned int cpu;
 
-	if (!thread_cnt)
-		return;
+	mutex_lock(&thread_mutex);
+	if (!cs_threads)
+		goto out;
 
-	/* N dma writeback monitoring threads */
-	thp = cs_threads;
-	for (i = 0; i < thread_cnt; i++, thp++)
-		if (thp->fproc)
-			xdma_kthread_stop(thp);
+	/* the dma writeback monitoring threads started so far */
+	for (cpu = 0; cpu < nr_cpu_ids; cpu++)
+		if (cs_threads[cpu].task)
+			xdma_kthread_stop(cs_threads + cpu);
 
 	kfree(cs_threads);
 	cs_threads = NULL;
 	thread_cnt = 0;
+
+out:
+	mutex_unlock(&thread_mutex);
 }
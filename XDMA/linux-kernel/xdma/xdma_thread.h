@@ -26,6 +26,7 @@
  */
 #include <linux/version.h>
 #include <linux/spinlock.h>
+#include <linux/mutex.h>
 #include <linux/kthread.h>
 #include <linux/cpuset.h>
 #include <linux/signal.h>
@@ -40,13 +41,13 @@
 #define lock_thread(thp)	\
 	do { \
 		pr_debug("locking thp %s ...\n", (thp)->name); \
-		spin_lock(&(thp)->lock); \
+		mutex_lock(&(thp)->lock); \
 	} while (0)
 
 #define unlock_thread(thp)	\
 	do { \
 		pr_debug("unlock thp %s ...\n", (thp)->name); \
-		spin_unlock(&(thp)->lock); \
+		mutex_unlock(&(thp)->lock); \
 	} while (0)
 
 #define xdma_kthread_wakeup(thp)	\
@@ -59,9 +60,9 @@
 
 #else
 /** lock thread macro */
-#define lock_thread(thp)		spin_lock(&(thp)->lock)
+#define lock_thread(thp)		mutex_lock(&(thp)->lock)
 /** un lock thread macro */
-#define unlock_thread(thp)		spin_unlock(&(thp)->lock)
+#define unlock_thread(thp)		mutex_unlock(&(thp)->lock)
 #define xdma_kthread_wakeup(thp) \
 	do { \
 		thp->schedule = 1; \
@@ -76,8 +77,8 @@
  * @brief	xdma thread book keeping parameters
  */
 struct xdma_kthread {
-	/**  thread lock*/
-	spinlock_t lock;
+	/**  thread lock, held across the work, which may sleep polling */
+	struct mutex lock;
 	/**  name of the thread */
 	char name[16];
 	/**  cpu number for which the thread associated with */
@@ -111,9 +112,10 @@ struct xdma_kthread {
 
 /*****************************************************************************/
 /**
- * xdma_threads_create() - create xdma threads
+ * xdma_threads_create() - set up the per-cpu xdma threads, each one is
+ *                         started once the first engine is assigned to it
 *********/
-int xdma_threads_create(unsigned int num_threads);
+int xdma_threads_create(void);
 
 /*****************************************************************************/
 /**
@@ -128,6 +130,8 @@ void xdma_threads_destroy(void);
 /**
  * xdma_thread_remove_work() - handler to remove the attached work thread
  *
+ * Takes the thread mutex: process context only, from engine_destroy().
+ *
  * @param[in]	engine:	pointer to xdma_engine
  *
  * @return	none
@@ -136,12 +140,16 @@ void xdma_thread_remove_work(struct xdma_engine *engine);
 
 /*****************************************************************************/
 /**
- * xdma_thread_add_work() - handler to add a work thread
+ * xdma_thread_add_work() - assign the engine to the least loaded thread on
+ *                          the poll_cpus, or on the device's numa node
+ *
+ * May start the thread: process context only, from engine_init() when the
+ * device is probed.
  *
  * @param[in]	engine:	pointer to xdma_engine
  *
- * @return	none
+ * @return	0 on success, < 0 if no thread could be started
  *****************************************************************************/
-void xdma_thread_add_work(struct xdma_engine *engine);
+int xdma_thread_add_work(struct xdma_engine *engine);
 
 #endif /* #ifndef __XDMA_KTHREAD_H__ */